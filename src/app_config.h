@@ -12,3 +12,32 @@
 
 // Captive portal
 #define APP_CAPTIVE_PORTAL_ENABLE   1
+
+// Module limits. Runtime storage is allocated from the applied config, so these only bound it and
+// size a few small fixed tables (scheduler slots, MQTT status buffers). Override via build flags.
+#ifndef APP_MODULES_MAX_OUTPUTS
+#define APP_MODULES_MAX_OUTPUTS 16
+#endif
+#ifndef APP_MODULES_MAX_INPUTS
+#define APP_MODULES_MAX_INPUTS 8
+#endif
+#ifndef APP_MODULES_MAX_BUTTONS
+#define APP_MODULES_MAX_BUTTONS 8
+#endif
+// Inputs and buttons together; bounded by the free GPIOs of the supported boards.
+#ifndef APP_MODULES_MAX_INPUTS_AND_BUTTONS
+#define APP_MODULES_MAX_INPUTS_AND_BUTTONS 8
+#endif
+#ifndef APP_MODULES_MAX_SENSORS
+#define APP_MODULES_MAX_SENSORS 4
+#endif
+#ifndef APP_MODULES_MAX_DS18B20
+#define APP_MODULES_MAX_DS18B20 8
+#endif
+// Enough for a maximal config: one entity per output and button, two per counter input, up to three
+// per climate sensor and one per DS18B20 probe.
+#ifndef APP_MQTT_MAX_ENTITIES
+#define APP_MQTT_MAX_ENTITIES                                                                        \
+    (APP_MODULES_MAX_OUTPUTS + 2 * APP_MODULES_MAX_INPUTS_AND_BUTTONS + 3 * APP_MODULES_MAX_SENSORS + \
+     APP_MODULES_MAX_DS18B20)
+#endif
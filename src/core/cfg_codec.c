@@ -0,0 +1,262 @@
+#include "core/cfg_codec.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/hash_util.h"
+
+#define CODEC_MAX_DEPTH 16
+
+enum {
+    TAG_NULL = 0,
+    TAG_FALSE,
+    TAG_TRUE,
+    TAG_INT,
+    TAG_DOUBLE,
+    TAG_STRING,
+    TAG_ARRAY,
+    TAG_OBJECT,
+};
+
+// With buf == NULL the writer only counts, which sizes the output before the real pass.
+typedef struct {
+    uint8_t *buf;
+    size_t len;
+} codec_writer_t;
+
+typedef struct {
+    const uint8_t *data;
+    size_t len;
+    size_t pos;
+} codec_reader_t;
+
+static void put_bytes(codec_writer_t *w, const void *data, size_t n)
+{
+    if (w->buf) {
+        memcpy(w->buf + w->len, data, n);
+    }
+    w->len += n;
+}
+
+static void put_u8(codec_writer_t *w, uint8_t v)
+{
+    put_bytes(w, &v, 1);
+}
+
+static void put_varint(codec_writer_t *w, uint32_t v)
+{
+    while (v >= 0x80) {
+        put_u8(w, (uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    put_u8(w, (uint8_t)v);
+}
+
+static void put_string(codec_writer_t *w, const char *s)
+{
+    size_t n = strlen(s ? s : "");
+    put_varint(w, (uint32_t)n);
+    put_bytes(w, s ? s : "", n + 1);
+}
+
+static uint32_t count_children(const cJSON *item)
+{
+    uint32_t n = 0;
+    for (const cJSON *child = item->child; child; child = child->next) {
+        n++;
+    }
+    return n;
+}
+
+static bool encode_item(codec_writer_t *w, const cJSON *item, int depth)
+{
+    if (depth > CODEC_MAX_DEPTH) {
+        return false;
+    }
+
+    if (cJSON_IsObject(item) || cJSON_IsArray(item)) {
+        bool is_object = cJSON_IsObject(item);
+        put_u8(w, is_object ? TAG_OBJECT : TAG_ARRAY);
+        put_varint(w, count_children(item));
+        for (const cJSON *child = item->child; child; child = child->next) {
+            if (is_object) {
+                put_string(w, child->string);
+            }
+            if (!encode_item(w, child, depth + 1)) {
+                return false;
+            }
+        }
+    } else if (cJSON_IsString(item)) {
+        put_u8(w, TAG_STRING);
+        put_string(w, item->valuestring);
+    } else if (cJSON_IsNumber(item)) {
+        double v = item->valuedouble;
+        if (fabs(v) < 2147483648.0 && v == (double)(int32_t)v) {
+            int32_t i = (int32_t)v;
+            put_u8(w, TAG_INT);
+            put_varint(w, ((uint32_t)i << 1) ^ (uint32_t)(i >> 31));
+        } else {
+            put_u8(w, TAG_DOUBLE);
+            put_bytes(w, &v, sizeof(v));
+        }
+    } else if (cJSON_IsBool(item)) {
+        put_u8(w, cJSON_IsTrue(item) ? TAG_TRUE : TAG_FALSE);
+    } else {
+        put_u8(w, TAG_NULL);
+    }
+    return true;
+}
+
+esp_err_t cfg_codec_encode(const cJSON *item, size_t headroom, uint8_t **out, size_t *out_len)
+{
+    if (!item || !out || !out_len) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *out = NULL;
+    *out_len = 0;
+
+    codec_writer_t w = {.buf = NULL, .len = headroom};
+    if (!encode_item(&w, item, 0)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    uint8_t *buf = calloc(1, w.len);
+    if (!buf) {
+        return ESP_ERR_NO_MEM;
+    }
+    size_t total = w.len;
+    w.buf = buf;
+    w.len = headroom;
+    encode_item(&w, item, 0);
+
+    *out = buf;
+    *out_len = total;
+    return ESP_OK;
+}
+
+static bool get_u8(codec_reader_t *r, uint8_t *v)
+{
+    if (r->pos >= r->len) {
+        return false;
+    }
+    *v = r->data[r->pos++];
+    return true;
+}
+
+static bool get_varint(codec_reader_t *r, uint32_t *v)
+{
+    uint32_t result = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        uint8_t b = 0;
+        if (!get_u8(r, &b)) {
+            return false;
+        }
+        result |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            *v = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+static const char *get_string(codec_reader_t *r)
+{
+    uint32_t n = 0;
+    if (!get_varint(r, &n) || n >= r->len - r->pos || r->data[r->pos + n] != '\0') {
+        return NULL;
+    }
+    const char *s = (const char *)r->data + r->pos;
+    r->pos += n + 1;
+    return s;
+}
+
+static cJSON *decode_item(codec_reader_t *r, int depth)
+{
+    uint8_t tag = 0;
+    if (depth > CODEC_MAX_DEPTH || !get_u8(r, &tag)) {
+        return NULL;
+    }
+
+    switch (tag) {
+        case TAG_NULL:
+            return cJSON_CreateNull();
+        case TAG_FALSE:
+            return cJSON_CreateFalse();
+        case TAG_TRUE:
+            return cJSON_CreateTrue();
+        case TAG_INT: {
+            uint32_t z = 0;
+            if (!get_varint(r, &z)) {
+                return NULL;
+            }
+            return cJSON_CreateNumber((double)(int32_t)((z >> 1) ^ (0U - (z & 1U))));
+        }
+        case TAG_DOUBLE: {
+            double v = 0.0;
+            if (r->len - r->pos < sizeof(v)) {
+                return NULL;
+            }
+            memcpy(&v, r->data + r->pos, sizeof(v));
+            r->pos += sizeof(v);
+            return cJSON_CreateNumber(v);
+        }
+        case TAG_STRING: {
+            const char *s = get_string(r);
+            return s ? cJSON_CreateString(s) : NULL;
+        }
+        case TAG_ARRAY:
+        case TAG_OBJECT: {
+            uint32_t count = 0;
+            if (!get_varint(r, &count)) {
+                return NULL;
+            }
+            cJSON *container = tag == TAG_OBJECT ? cJSON_CreateObject() : cJSON_CreateArray();
+            if (!container) {
+                return NULL;
+            }
+            for (uint32_t i = 0; i < count; ++i) {
+                const char *key = NULL;
+                if (tag == TAG_OBJECT && !(key = get_string(r))) {
+                    cJSON_Delete(container);
+                    return NULL;
+                }
+                cJSON *child = decode_item(r, depth + 1);
+                if (!child) {
+                    cJSON_Delete(container);
+                    return NULL;
+                }
+                if (key) {
+                    cJSON_AddItemToObject(container, key, child);
+                } else {
+                    cJSON_AddItemToArray(container, child);
+                }
+            }
+            return container;
+        }
+        default:
+            return NULL;
+    }
+}
+
+esp_err_t cfg_codec_decode(const uint8_t *data, size_t len, cJSON **out)
+{
+    if (!data || !out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    codec_reader_t r = {.data = data, .len = len, .pos = 0};
+    *out = decode_item(&r, 0);
+    if (*out && r.pos != r.len) {
+        cJSON_Delete(*out);
+        *out = NULL;
+    }
+    return *out ? ESP_OK : ESP_ERR_INVALID_CRC;
+}
+
+uint32_t cfg_codec_hash(const uint8_t *data, size_t len)
+{
+    return hash_fnv1a(HASH_FNV1A_SEED, data, len);
+}
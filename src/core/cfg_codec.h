@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cJSON.h"
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Compact binary form of a cJSON tree used for config storage. Every value is a one-byte tag followed
+// by its payload; integers, lengths and counts are LEB128 varints and strings keep their terminator so
+// the decoder can hand them to cJSON without copying.
+
+// Encodes item into a malloc'd buffer. The first headroom bytes are left for the caller's header.
+esp_err_t cfg_codec_encode(const cJSON *item, size_t headroom, uint8_t **out, size_t *out_len);
+esp_err_t cfg_codec_decode(const uint8_t *data, size_t len, cJSON **out);
+
+// 32-bit FNV-1a, used to detect unchanged or corrupted sections.
+uint32_t cfg_codec_hash(const uint8_t *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -6,21 +6,32 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "app_config.h"
+#include "core/cfg_codec.h"
+#include "core/modules.h"
 #include "esp_log.h"
 #include "esp_mac.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "nvs.h"
 #include "soc/soc_caps.h"
 
 static const char *TAG = "cfg_json";
 static const char *NVS_NS = "cfg";
-static const char *NVS_KEY = "json";
+static const char *NVS_KEY_LEGACY_JSON = "json";
 
 #define CFG_SCHEMA_VERSION 2
-#define CFG_MAX_OUTPUTS 8
-#define CFG_MAX_INPUTS_AND_BUTTONS 8
-#define CFG_MAX_SENSORS 4
+#define CFG_MAX_OUTPUTS APP_MODULES_MAX_OUTPUTS
+#define CFG_MAX_INPUTS APP_MODULES_MAX_INPUTS
+#define CFG_MAX_BUTTONS APP_MODULES_MAX_BUTTONS
+#define CFG_MAX_INPUTS_AND_BUTTONS APP_MODULES_MAX_INPUTS_AND_BUTTONS
+#define CFG_MAX_SENSORS APP_MODULES_MAX_SENSORS
 #define SERVO_3WIRE_HOLD_MS_DEFAULT 1200
 
+// Each stored section blob is [format][hash LE32][cfg_codec payload].
+#define CFG_BLOB_FORMAT 1
+#define CFG_BLOB_HEADER_LEN 5
+
 static const int s_conservative_board_gpios[] = {0, 1, 3, 4, 5, 6, 7, 10};
 static const int s_luatos_board_gpios[] = {0, 1, 3, 4, 5, 6, 7, 10, 12, 13};
 
@@ -48,8 +59,34 @@ static const board_gpio_policy_t s_board_gpio_policies[] = {
     },
 };
 
+typedef struct {
+    const char *nvs_key;
+    // Root keys stored in this section; NULL collects every root key no other section claims.
+    const char *const *root_keys;
+} cfg_section_t;
+
+static const char *const s_section_conn_keys[] = {"connectivity", NULL};
+static const char *const s_section_outputs_keys[] = {"outputs", NULL};
+static const char *const s_section_inputs_keys[] = {"inputs", "buttons", NULL};
+static const char *const s_section_sensors_keys[] = {"sensors", NULL};
+
+static const cfg_section_t s_sections[] = {
+    {.nvs_key = "sec_core", .root_keys = NULL},
+    {.nvs_key = "sec_conn", .root_keys = s_section_conn_keys},
+    {.nvs_key = "sec_outputs", .root_keys = s_section_outputs_keys},
+    {.nvs_key = "sec_inputs", .root_keys = s_section_inputs_keys},
+    {.nvs_key = "sec_sensors", .root_keys = s_section_sensors_keys},
+};
+
+#define CFG_SECTION_COUNT (sizeof(s_sections) / sizeof(s_sections[0]))
+
 static cJSON *s_cfg = NULL;
+// Guards replacing s_cfg. Readers that outlive a single call (slow HTTP streams) take a copy under it.
+static SemaphoreHandle_t s_cfg_lock = NULL;
 static char s_last_error[192] = "";
+// Hash of what each section currently holds in NVS, so saves only rewrite sections that changed.
+static uint32_t s_section_hash[CFG_SECTION_COUNT];
+static bool s_section_stored[CFG_SECTION_COUNT];
 
 typedef struct {
     bool used;
@@ -78,6 +115,7 @@ typedef struct {
     int ledc_channel_count;
     int rmt_tx_blocks_used;
     int rmt_rx_blocks_used;
+    char spi_owner[40];
 } cfg_validation_t;
 
 static void set_error(const char *fmt, ...)
@@ -270,6 +308,18 @@ static bool is_valid_ws2812_color_order(const char *value)
     return false;
 }
 
+static const char *normalize_ws2812_effect(const char *value)
+{
+    const char *name;
+
+    for (int i = 0; value && (name = modules_ws2812_effect_name(i)) != NULL; ++i) {
+        if (strcmp(value, name) == 0) {
+            return name;
+        }
+    }
+    return "none";
+}
+
 static const char *normalize_ws2812_mode(const char *value)
 {
     if (value && strcmp(value, "mono_triplet") == 0) {
@@ -278,6 +328,14 @@ static const char *normalize_ws2812_mode(const char *value)
     return "rgb";
 }
 
+static const char *normalize_ws2812_driver(const char *value)
+{
+    if (value && strcmp(value, "spi") == 0) {
+        return "spi";
+    }
+    return "rmt";
+}
+
 static const char *normalize_ws2812_transition_style(const char *value)
 {
     if (value && strcmp(value, "fade") == 0) {
@@ -289,6 +347,17 @@ static const char *normalize_ws2812_transition_style(const char *value)
     return "none";
 }
 
+static const char *normalize_ws2812_easing(const char *value)
+{
+    if (value && strcmp(value, "ease_in_out") == 0) {
+        return "ease_in_out";
+    }
+    if (value && strcmp(value, "cie") == 0) {
+        return "cie";
+    }
+    return "linear";
+}
+
 static const char *normalize_pull_value(const char *value)
 {
     if (value && strcmp(value, "down") == 0) {
@@ -308,6 +377,14 @@ static const char *normalize_stepper_role(const char *value)
     return "generic";
 }
 
+static const char *normalize_stepper_pulse_engine(const char *value)
+{
+    if (value && strcmp(value, "rmt") == 0) {
+        return "rmt";
+    }
+    return "gpio";
+}
+
 static const char *normalize_output_mqtt_component(const char *value)
 {
     if (value && strcmp(value, "number") == 0) {
@@ -322,6 +399,14 @@ static const char *normalize_output_mqtt_component(const char *value)
     return "auto";
 }
 
+static const char *normalize_mqtt_state_mode(const char *value)
+{
+    if (value && strcmp(value, "json") == 0) {
+        return "json";
+    }
+    return "entity";
+}
+
 static const char *normalize_output_mqtt_number_mode(const char *value)
 {
     if (value && strcmp(value, "box") == 0) {
@@ -475,6 +560,21 @@ static bool reserve_rmt_blocks(cfg_validation_t *ctx, const char *owner, int tx_
     return true;
 }
 
+// The C3 has a single general-purpose SPI host (GPSPI2), so only one strip can use the SPI driver.
+static bool reserve_spi_host(cfg_validation_t *ctx, const char *owner)
+{
+    if (!ctx || !owner) {
+        set_error("Invalid SPI reservation request");
+        return false;
+    }
+    if (ctx->spi_owner[0]) {
+        set_error("%s cannot use SPI: the SPI host is already used by %s", owner, ctx->spi_owner);
+        return false;
+    }
+    snprintf(ctx->spi_owner, sizeof(ctx->spi_owner), "%s", owner);
+    return true;
+}
+
 static cJSON *create_empty_schema(void)
 {
     cJSON *root = cJSON_CreateObject();
@@ -509,6 +609,8 @@ static cJSON *create_empty_schema(void)
     cJSON_AddStringToObject(mqtt, "discovery_prefix", MQTT_DISCOVERY_PREFIX_DEFAULT);
     cJSON_AddBoolToObject(mqtt, "discovery", true);
     cJSON_AddBoolToObject(mqtt, "retain", true);
+    cJSON_AddStringToObject(mqtt, "state_mode", "entity");
+    cJSON_AddNumberToObject(mqtt, "state_window_ms", 200);
 
     cJSON *web = cJSON_AddObjectToObject(root, "web");
     cJSON *auth = cJSON_AddObjectToObject(web, "auth");
@@ -570,6 +672,71 @@ static bool append_action_json(cJSON *dst_parent, const char *key, const cJSON *
     return true;
 }
 
+static int clamp_int(int value, int min, int max)
+{
+    return value < min ? min : (value > max ? max : value);
+}
+
+static double clamp_double(double value, double min, double max)
+{
+    return value < min ? min : (value > max ? max : value);
+}
+
+static void add_rgb_object(cJSON *dst, const char *key, const cJSON *src, int r, int g, int b)
+{
+    cJSON *color = cJSON_AddObjectToObject(dst, key);
+    cJSON_AddNumberToObject(color, "r", clamp_int(jint(src, "r", r), 0, 255));
+    cJSON_AddNumberToObject(color, "g", clamp_int(jint(src, "g", g), 0, 255));
+    cJSON_AddNumberToObject(color, "b", clamp_int(jint(src, "b", b), 0, 255));
+}
+
+// Optional per-entity MQTT publish tuning. Only fields present in the source are kept, so absent
+// ones fall back to the firmware defaults.
+static bool append_mqtt_publish_json(cJSON *dst_parent, const cJSON *src_item, bool sensor)
+{
+    static const char *const metrics[] = {"temperature_c", "humidity_pct", "pressure_hpa"};
+    const cJSON *src = jobj(src_item, "mqtt_publish");
+
+    if (!cJSON_IsObject((cJSON *)src)) {
+        return true;
+    }
+    cJSON *dst = cJSON_AddObjectToObject(dst_parent, "mqtt_publish");
+    if (!dst) {
+        return false;
+    }
+
+    const cJSON *it = jobj(src, "throttle_ms");
+    if (cJSON_IsNumber(it)) {
+        cJSON_AddNumberToObject(dst, "throttle_ms", clamp_int(it->valueint, 0, 60000));
+    }
+    it = jobj(src, "heartbeat_sec");
+    if (cJSON_IsNumber(it)) {
+        cJSON_AddNumberToObject(dst, "heartbeat_sec", clamp_int(it->valueint, 0, 86400));
+    }
+    if (!sensor) {
+        return true;
+    }
+
+    const cJSON *src_deadband = jobj(src, "deadband");
+    if (cJSON_IsObject((cJSON *)src_deadband)) {
+        cJSON *deadband = cJSON_AddObjectToObject(dst, "deadband");
+        if (!deadband) {
+            return false;
+        }
+        for (size_t i = 0; i < sizeof(metrics) / sizeof(metrics[0]); ++i) {
+            it = jobj(src_deadband, metrics[i]);
+            if (cJSON_IsNumber(it)) {
+                cJSON_AddNumberToObject(deadband, metrics[i], clamp_double(it->valuedouble, 0.0, 1000.0));
+            }
+        }
+    }
+    it = jobj(src, "deadband_pct");
+    if (cJSON_IsNumber(it)) {
+        cJSON_AddNumberToObject(dst, "deadband_pct", clamp_double(it->valuedouble, 0.0, 100.0));
+    }
+    return true;
+}
+
 static cJSON *normalize_config(const cJSON *src)
 {
     cJSON *root = create_empty_schema();
@@ -637,6 +804,10 @@ static cJSON *normalize_config(const cJSON *src)
                                                       MQTT_DISCOVERY_PREFIX_DEFAULT)));
     cJSON_ReplaceItemInObject(mqtt, "discovery", cJSON_CreateBool(jbool(src_mqtt, "discovery", true)));
     cJSON_ReplaceItemInObject(mqtt, "retain", cJSON_CreateBool(jbool(src_mqtt, "retain", true)));
+    cJSON_ReplaceItemInObject(mqtt, "state_mode",
+                              cJSON_CreateString(normalize_mqtt_state_mode(jstr(src_mqtt, "state_mode", "entity"))));
+    cJSON_ReplaceItemInObject(mqtt, "state_window_ms",
+                              cJSON_CreateNumber(clamp_int(jint(src_mqtt, "state_window_ms", 200), 0, 5000)));
     cJSON_ReplaceItemInObject(web_auth, "enable", cJSON_CreateBool(jbool(src_web_auth, "enable", false)));
     cJSON_ReplaceItemInObject(web_auth, "password", cJSON_CreateString(jstr(src_web_auth, "password", "")));
 
@@ -749,6 +920,7 @@ static cJSON *normalize_config(const cJSON *src)
                 int pixel_count = jint(item, "pixel_count", 1);
                 int transition_ms = jint(item, "transition_ms", 300);
                 const char *mode = normalize_ws2812_mode(jstr(item, "mode", "rgb"));
+                const char *driver = normalize_ws2812_driver(jstr(item, "driver", "rmt"));
                 const char *transition_style = normalize_ws2812_transition_style(
                     jstr(item, "transition_style", "none"));
                 const char *color_order = jstr(item, "color_order", "GRB");
@@ -768,19 +940,49 @@ static cJSON *normalize_config(const cJSON *src)
                     color_order = "GRB";
                 }
                 if (enabled) {
-                    char rmt_owner[40] = {0};
-                    snprintf(rmt_owner, sizeof(rmt_owner), "ws2812:%s", id);
-                    if (!reserve_rmt_blocks(ctx, rmt_owner, 1, 0)) {
+                    char owner[40] = {0};
+                    snprintf(owner, sizeof(owner), "ws2812:%s", id);
+                    bool reserved = strcmp(driver, "spi") == 0 ? reserve_spi_host(ctx, owner)
+                                                               : reserve_rmt_blocks(ctx, owner, 1, 0);
+                    if (!reserved) {
                         return normalize_cleanup_and_fail(root, ctx);
                     }
                 }
                 cJSON_AddNumberToObject(dst, "pixel_count", pixel_count);
                 cJSON_AddStringToObject(dst, "mode", mode);
+                cJSON_AddStringToObject(dst, "driver", driver);
                 cJSON_AddStringToObject(dst, "color_order", color_order);
                 cJSON_AddStringToObject(dst, "transition_style", transition_style);
                 cJSON_AddNumberToObject(dst, "transition_ms", transition_ms);
+                cJSON_AddStringToObject(dst, "transition_easing",
+                                        normalize_ws2812_easing(jstr(item, "transition_easing", "linear")));
                 cJSON_AddBoolToObject(dst, "default_power_on", jbool(item, "default_power_on", false));
                 cJSON_AddBoolToObject(dst, "gamma_correction", jbool(item, "gamma_correction", false));
+                cJSON_AddStringToObject(dst, "effect",
+                                        strcmp(mode, "rgb") == 0 ? normalize_ws2812_effect(jstr(item, "effect", "none"))
+                                                                 : "none");
+                cJSON_AddNumberToObject(dst, "effect_fps", clamp_int(jint(item, "effect_fps", 30), 1, 60));
+                cJSON_AddNumberToObject(dst, "effect_speed", clamp_int(jint(item, "effect_speed", 64), 1, 255));
+                add_rgb_object(dst, "gradient_color", jobj(item, "gradient_color"), 0, 0, 255);
+                const cJSON *segments = jobj(item, "segments");
+                if (cJSON_IsArray((cJSON *)segments)) {
+                    cJSON *dst_segments = cJSON_AddArrayToObject(dst, "segments");
+                    int segment_count = cJSON_GetArraySize((cJSON *)segments);
+                    for (int seg_idx = 0; seg_idx < segment_count && cJSON_GetArraySize(dst_segments) < 8;
+                         ++seg_idx) {
+                        const cJSON *seg = cJSON_GetArrayItem((cJSON *)segments, seg_idx);
+                        int start = jint(seg, "start", 0);
+                        int count = jint(seg, "count", 0);
+                        if (!cJSON_IsObject((cJSON *)seg) || start < 0 || start >= pixel_count || count <= 0) {
+                            continue;
+                        }
+                        cJSON *dst_seg = cJSON_CreateObject();
+                        cJSON_AddNumberToObject(dst_seg, "start", start);
+                        cJSON_AddNumberToObject(dst_seg, "count", clamp_int(count, 1, pixel_count - start));
+                        add_rgb_object(dst_seg, "color", jobj(seg, "color"), 255, 255, 255);
+                        cJSON_AddItemToArray(dst_segments, dst_seg);
+                    }
+                }
             } else if (strcmp(type, "servo_3wire") == 0) {
                 int default_level = jint(item, "default_level", 0);
                 int min_us = jint(item, "min_us", 500);
@@ -989,6 +1191,7 @@ static cJSON *normalize_config(const cJSON *src)
                 int default_level = jint(item, "default_level", 0);
                 int steps_range = jint(item, "steps_range", 2048);
                 int speed_steps_per_sec = jint(item, "speed_steps_per_sec", 400);
+                int accel_steps_per_s2 = jint(item, "accel_steps_per_s2", 2000);
                 const char *home_pull = normalize_pull_value(jstr(item, "home_pull", "up"));
                 const char *role = normalize_stepper_role(jstr(item, "role", "generic"));
 
@@ -1028,6 +1231,12 @@ static cJSON *normalize_config(const cJSON *src)
                 if (speed_steps_per_sec > 1500) {
                     speed_steps_per_sec = 1500;
                 }
+                if (accel_steps_per_s2 < 0) {
+                    accel_steps_per_s2 = 0;
+                }
+                if (accel_steps_per_s2 > 100000) {
+                    accel_steps_per_s2 = 100000;
+                }
 
                 cJSON_AddStringToObject(dst, "role", role);
                 cJSON_AddNumberToObject(dst, "gpio_b", gpio_b);
@@ -1042,6 +1251,7 @@ static cJSON *normalize_config(const cJSON *src)
                 cJSON_AddNumberToObject(dst, "default_level", default_level);
                 cJSON_AddNumberToObject(dst, "steps_range", steps_range);
                 cJSON_AddNumberToObject(dst, "speed_steps_per_sec", speed_steps_per_sec);
+                cJSON_AddNumberToObject(dst, "accel_steps_per_s2", accel_steps_per_s2);
                 cJSON_AddBoolToObject(dst, "reverse_direction", jbool(item, "reverse_direction", false));
                 cJSON_AddBoolToObject(dst, "hold_enabled", jbool(item, "hold_enabled", false));
             } else if (strcmp(type, "stepper_a4988") == 0) {
@@ -1052,9 +1262,11 @@ static cJSON *normalize_config(const cJSON *src)
                 int default_level = jint(item, "default_level", 0);
                 int steps_range = jint(item, "steps_range", 200);
                 int speed_steps_per_sec = jint(item, "speed_steps_per_sec", 800);
+                int accel_steps_per_s2 = jint(item, "accel_steps_per_s2", 4000);
                 int step_pulse_us = jint(item, "step_pulse_us", 4);
                 const char *home_pull = normalize_pull_value(jstr(item, "home_pull", "up"));
                 const char *role = normalize_stepper_role(jstr(item, "role", "generic"));
+                const char *pulse_engine = normalize_stepper_pulse_engine(jstr(item, "pulse_engine", "gpio"));
 
                 char owner_b[40] = {0};
                 char owner_c[40] = {0};
@@ -1091,12 +1303,25 @@ static cJSON *normalize_config(const cJSON *src)
                 if (speed_steps_per_sec > 20000) {
                     speed_steps_per_sec = 20000;
                 }
+                if (accel_steps_per_s2 < 0) {
+                    accel_steps_per_s2 = 0;
+                }
+                if (accel_steps_per_s2 > 100000) {
+                    accel_steps_per_s2 = 100000;
+                }
                 if (step_pulse_us < 2) {
                     step_pulse_us = 2;
                 }
                 if (step_pulse_us > 20) {
                     step_pulse_us = 20;
                 }
+                if (enabled && strcmp(pulse_engine, "rmt") == 0) {
+                    char rmt_owner[40] = {0};
+                    snprintf(rmt_owner, sizeof(rmt_owner), "steppera-step:%s", id);
+                    if (!reserve_rmt_blocks(ctx, rmt_owner, 1, 0)) {
+                        return normalize_cleanup_and_fail(root, ctx);
+                    }
+                }
 
                 cJSON_AddStringToObject(dst, "role", role);
                 cJSON_AddNumberToObject(dst, "gpio_b", gpio_b);
@@ -1113,11 +1338,18 @@ static cJSON *normalize_config(const cJSON *src)
                 cJSON_AddNumberToObject(dst, "default_level", default_level);
                 cJSON_AddNumberToObject(dst, "steps_range", steps_range);
                 cJSON_AddNumberToObject(dst, "speed_steps_per_sec", speed_steps_per_sec);
+                cJSON_AddNumberToObject(dst, "accel_steps_per_s2", accel_steps_per_s2);
                 cJSON_AddNumberToObject(dst, "step_pulse_us", step_pulse_us);
+                cJSON_AddStringToObject(dst, "pulse_engine", pulse_engine);
                 cJSON_AddBoolToObject(dst, "reverse_direction", jbool(item, "reverse_direction", false));
                 cJSON_AddBoolToObject(dst, "hold_enabled", jbool(item, "hold_enabled", false));
             }
 
+            if (!append_mqtt_publish_json(dst, item, false)) {
+                cJSON_Delete(dst);
+                set_error("Out of memory while building MQTT publish settings");
+                return normalize_cleanup_and_fail(root, ctx);
+            }
             cJSON_AddItemToArray(outputs, dst);
         }
     } else {
@@ -1147,8 +1379,9 @@ static cJSON *normalize_config(const cJSON *src)
     int input_count = 0;
     if (cJSON_IsArray((cJSON *)src_inputs)) {
         input_count = cJSON_GetArraySize((cJSON *)src_inputs);
-        if (input_count > CFG_MAX_INPUTS_AND_BUTTONS) {
-            set_error("Too many inputs: max %d", CFG_MAX_INPUTS_AND_BUTTONS);
+        if (input_count > CFG_MAX_INPUTS || input_count > CFG_MAX_INPUTS_AND_BUTTONS) {
+            set_error("Too many inputs: max %d",
+                      CFG_MAX_INPUTS < CFG_MAX_INPUTS_AND_BUTTONS ? CFG_MAX_INPUTS : CFG_MAX_INPUTS_AND_BUTTONS);
             return normalize_cleanup_and_fail(root, ctx);
         }
 
@@ -1171,6 +1404,12 @@ static cJSON *normalize_config(const cJSON *src)
                 return normalize_cleanup_and_fail(root, ctx);
             }
 
+            const char *type = jstr(item, "type", "digital");
+            if (strcmp(type, "digital") != 0 && strcmp(type, "counter") != 0) {
+                set_error("Input %s uses unsupported type '%s'", id, type);
+                return normalize_cleanup_and_fail(root, ctx);
+            }
+
             const char *role = jstr(item, "role", "generic_binary");
             if (strcmp(role, "motion") != 0 &&
                 strcmp(role, "presence") != 0 &&
@@ -1190,12 +1429,22 @@ static cJSON *normalize_config(const cJSON *src)
             cJSON *dst = cJSON_CreateObject();
             cJSON_AddStringToObject(dst, "id", id);
             cJSON_AddStringToObject(dst, "name", jstr(item, "name", id));
-            cJSON_AddStringToObject(dst, "type", "digital");
+            cJSON_AddStringToObject(dst, "type", type);
             cJSON_AddBoolToObject(dst, "enabled", jbool(item, "enabled", true));
             cJSON_AddNumberToObject(dst, "gpio", gpio);
             cJSON_AddStringToObject(dst, "pull", pull);
             cJSON_AddBoolToObject(dst, "inverted", jbool(item, "inverted", false));
             cJSON_AddStringToObject(dst, "role", role);
+            cJSON_AddNumberToObject(dst, "debounce_ms", clamp_int(jint(item, "debounce_ms", 20), 0, 1000));
+            if (strcmp(type, "counter") == 0) {
+                cJSON_AddNumberToObject(dst, "rate_window_sec",
+                                        clamp_int(jint(item, "rate_window_sec", 60), 12, 3600));
+            }
+            if (!append_mqtt_publish_json(dst, item, false)) {
+                cJSON_Delete(dst);
+                set_error("Out of memory while building MQTT publish settings");
+                return normalize_cleanup_and_fail(root, ctx);
+            }
             cJSON_AddItemToArray(inputs, dst);
         }
     }
@@ -1204,6 +1453,10 @@ static cJSON *normalize_config(const cJSON *src)
     int button_count = 0;
     if (cJSON_IsArray((cJSON *)src_buttons)) {
         button_count = cJSON_GetArraySize((cJSON *)src_buttons);
+        if (button_count > CFG_MAX_BUTTONS) {
+            set_error("Too many buttons: max %d", CFG_MAX_BUTTONS);
+            return normalize_cleanup_and_fail(root, ctx);
+        }
         if ((button_count + input_count) > CFG_MAX_INPUTS_AND_BUTTONS) {
             set_error("Too many inputs/buttons combined: max %d", CFG_MAX_INPUTS_AND_BUTTONS);
             return normalize_cleanup_and_fail(root, ctx);
@@ -1242,11 +1495,18 @@ static cJSON *normalize_config(const cJSON *src)
             cJSON_AddStringToObject(dst, "pull", pull);
             cJSON_AddBoolToObject(dst, "inverted", jbool(item, "inverted", false));
             cJSON_AddNumberToObject(dst, "long_press_ms", jint(item, "long_press_ms", 1000));
+            cJSON_AddNumberToObject(dst, "debounce_ms", clamp_int(jint(item, "debounce_ms", 20), 0, 1000));
+            cJSON_AddNumberToObject(dst, "multi_click_ms", clamp_int(jint(item, "multi_click_ms", 300), 100, 1000));
+            cJSON_AddNumberToObject(dst, "hold_repeat_ms", clamp_int(jint(item, "hold_repeat_ms", 200), 50, 2000));
+            cJSON_AddNumberToObject(dst, "max_clicks", clamp_int(jint(item, "max_clicks", 0), 0, 3));
 
             cJSON *actions = cJSON_AddObjectToObject(dst, "actions");
             const cJSON *src_actions = jobj(item, "actions");
             if (!append_action_json(actions, "short", jobj(src_actions, "short")) ||
-                !append_action_json(actions, "long", jobj(src_actions, "long"))) {
+                !append_action_json(actions, "double", jobj(src_actions, "double")) ||
+                !append_action_json(actions, "triple", jobj(src_actions, "triple")) ||
+                !append_action_json(actions, "long", jobj(src_actions, "long")) ||
+                !append_action_json(actions, "hold", jobj(src_actions, "hold"))) {
                 set_error("Out of memory while building button actions");
                 return normalize_cleanup_and_fail(root, ctx);
             }
@@ -1348,6 +1608,11 @@ static cJSON *normalize_config(const cJSON *src)
                 cJSON_AddNumberToObject(dst, "poll_interval_sec", jint(item, "poll_interval_sec", 30));
             }
 
+            if (!append_mqtt_publish_json(dst, item, true)) {
+                cJSON_Delete(dst);
+                set_error("Out of memory while building MQTT publish settings");
+                return normalize_cleanup_and_fail(root, ctx);
+            }
             cJSON_AddItemToArray(sensors, dst);
         }
     }
@@ -1355,23 +1620,192 @@ static cJSON *normalize_config(const cJSON *src)
     return normalize_cleanup_success(root, ctx);
 }
 
-static esp_err_t nvs_write_string(const char *s)
+static bool section_owns_key(const cfg_section_t *section, const char *key)
+{
+    if (!key) {
+        return false;
+    }
+    if (section->root_keys) {
+        for (const char *const *k = section->root_keys; *k; ++k) {
+            if (strcmp(*k, key) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+    for (size_t i = 0; i < CFG_SECTION_COUNT; ++i) {
+        if (s_sections[i].root_keys && section_owns_key(&s_sections[i], key)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static esp_err_t encode_section(const cJSON *cfg, const cfg_section_t *section, uint8_t **out, size_t *out_len,
+                                uint32_t *out_hash)
 {
+    cJSON *view = cJSON_CreateObject();
+    if (!view) {
+        return ESP_ERR_NO_MEM;
+    }
+    for (cJSON *item = cfg->child; item; item = item->next) {
+        if (section_owns_key(section, item->string) && !cJSON_AddItemReferenceToObject(view, item->string, item)) {
+            cJSON_Delete(view);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    esp_err_t err = cfg_codec_encode(view, CFG_BLOB_HEADER_LEN, out, out_len);
+    cJSON_Delete(view);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    uint32_t hash = cfg_codec_hash(*out + CFG_BLOB_HEADER_LEN, *out_len - CFG_BLOB_HEADER_LEN);
+    (*out)[0] = CFG_BLOB_FORMAT;
+    for (int i = 0; i < 4; ++i) {
+        (*out)[1 + i] = (uint8_t)(hash >> (8 * i));
+    }
+    *out_hash = hash;
+    return ESP_OK;
+}
+
+static esp_err_t nvs_write_sections(const cJSON *cfg)
+{
+    uint32_t hashes[CFG_SECTION_COUNT];
+    bool dirty[CFG_SECTION_COUNT] = {0};
+    int written = 0;
+
     nvs_handle_t h = 0;
     esp_err_t err = nvs_open(NVS_NS, NVS_READWRITE, &h);
     if (err != ESP_OK) {
         return err;
     }
 
-    err = nvs_set_str(h, NVS_KEY, s);
-    if (err == ESP_OK) {
+    for (size_t i = 0; i < CFG_SECTION_COUNT && err == ESP_OK; ++i) {
+        uint8_t *blob = NULL;
+        size_t blob_len = 0;
+        err = encode_section(cfg, &s_sections[i], &blob, &blob_len, &hashes[i]);
+        if (err != ESP_OK) {
+            break;
+        }
+        if (!s_section_stored[i] || s_section_hash[i] != hashes[i]) {
+            err = nvs_set_blob(h, s_sections[i].nvs_key, blob, blob_len);
+            dirty[i] = true;
+            written++;
+        }
+        free(blob);
+    }
+    if (err == ESP_OK && written > 0) {
         err = nvs_commit(h);
     }
     nvs_close(h);
+
+    // Any failure forgets the cached hashes of the sections touched, so the next save retries them.
+    for (size_t i = 0; i < CFG_SECTION_COUNT; ++i) {
+        if (dirty[i]) {
+            s_section_stored[i] = err == ESP_OK;
+            s_section_hash[i] = hashes[i];
+        }
+    }
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "Config sections written: %d of %d", written, (int)CFG_SECTION_COUNT);
+    }
     return err;
 }
 
-static esp_err_t nvs_read_string(char **out)
+static esp_err_t read_section(nvs_handle_t h, size_t index, cJSON *root)
+{
+    size_t len = 0;
+    esp_err_t err = nvs_get_blob(h, s_sections[index].nvs_key, NULL, &len);
+    if (err != ESP_OK) {
+        return err;
+    }
+    if (len <= CFG_BLOB_HEADER_LEN) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    uint8_t *blob = malloc(len);
+    if (!blob) {
+        return ESP_ERR_NO_MEM;
+    }
+    err = nvs_get_blob(h, s_sections[index].nvs_key, blob, &len);
+    if (err != ESP_OK) {
+        free(blob);
+        return err;
+    }
+
+    uint32_t stored_hash = 0;
+    for (int i = 0; i < 4; ++i) {
+        stored_hash |= (uint32_t)blob[1 + i] << (8 * i);
+    }
+    cJSON *section = NULL;
+    if (blob[0] != CFG_BLOB_FORMAT) {
+        err = ESP_ERR_INVALID_VERSION;
+    } else if (cfg_codec_hash(blob + CFG_BLOB_HEADER_LEN, len - CFG_BLOB_HEADER_LEN) != stored_hash) {
+        err = ESP_ERR_INVALID_CRC;
+    } else {
+        err = cfg_codec_decode(blob + CFG_BLOB_HEADER_LEN, len - CFG_BLOB_HEADER_LEN, &section);
+    }
+    free(blob);
+    if (err == ESP_OK && !cJSON_IsObject(section)) {
+        err = ESP_ERR_INVALID_CRC;
+    }
+    if (err != ESP_OK) {
+        cJSON_Delete(section);
+        return err;
+    }
+
+    while (section->child) {
+        cJSON *item = cJSON_DetachItemViaPointer(section, section->child);
+        cJSON_DeleteItemFromObjectCaseSensitive(root, item->string);
+        cJSON_AddItemToObject(root, item->string, item);
+    }
+    cJSON_Delete(section);
+
+    s_section_stored[index] = true;
+    s_section_hash[index] = stored_hash;
+    return ESP_OK;
+}
+
+// Reassembles the config from whichever sections are present; normalize_config fills in the rest.
+static esp_err_t nvs_read_sections(cJSON **out)
+{
+    *out = NULL;
+    memset(s_section_stored, 0, sizeof(s_section_stored));
+
+    nvs_handle_t h = 0;
+    esp_err_t err = nvs_open(NVS_NS, NVS_READONLY, &h);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    cJSON *root = cJSON_CreateObject();
+    if (!root) {
+        nvs_close(h);
+        return ESP_ERR_NO_MEM;
+    }
+
+    int loaded = 0;
+    for (size_t i = 0; i < CFG_SECTION_COUNT; ++i) {
+        err = read_section(h, i, root);
+        if (err == ESP_OK) {
+            loaded++;
+        } else if (err != ESP_ERR_NVS_NOT_FOUND) {
+            ESP_LOGW(TAG, "Config section %s unreadable: %s", s_sections[i].nvs_key, esp_err_to_name(err));
+        }
+    }
+    nvs_close(h);
+
+    if (loaded == 0) {
+        cJSON_Delete(root);
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    *out = root;
+    return ESP_OK;
+}
+
+static esp_err_t nvs_read_legacy_json(cJSON **out)
 {
     *out = NULL;
 
@@ -1382,7 +1816,7 @@ static esp_err_t nvs_read_string(char **out)
     }
 
     size_t len = 0;
-    err = nvs_get_str(h, NVS_KEY, NULL, &len);
+    err = nvs_get_str(h, NVS_KEY_LEGACY_JSON, NULL, &len);
     if (err != ESP_OK) {
         nvs_close(h);
         return err;
@@ -1394,36 +1828,58 @@ static esp_err_t nvs_read_string(char **out)
         return ESP_ERR_NO_MEM;
     }
 
-    err = nvs_get_str(h, NVS_KEY, buf, &len);
+    err = nvs_get_str(h, NVS_KEY_LEGACY_JSON, buf, &len);
     nvs_close(h);
     if (err != ESP_OK) {
         free(buf);
         return err;
     }
 
-    *out = buf;
-    return ESP_OK;
+    *out = cJSON_Parse(buf);
+    free(buf);
+    return *out ? ESP_OK : ESP_ERR_INVALID_CRC;
 }
 
-static esp_err_t save_cfg_object(cJSON *cfg)
+static void nvs_erase_legacy_json(void)
 {
-    char *out = cJSON_PrintUnformatted(cfg);
-    if (!out) {
-        set_error("Out of memory while serializing config");
-        return ESP_ERR_NO_MEM;
+    nvs_handle_t h = 0;
+    if (nvs_open(NVS_NS, NVS_READWRITE, &h) != ESP_OK) {
+        return;
+    }
+    if (nvs_erase_key(h, NVS_KEY_LEGACY_JSON) == ESP_OK) {
+        nvs_commit(h);
+        ESP_LOGI(TAG, "Migrated legacy JSON config to sections");
+    }
+    nvs_close(h);
+}
+
+static void cfg_lock(void)
+{
+    if (!s_cfg_lock) {
+        s_cfg_lock = xSemaphoreCreateMutex();
     }
+    xSemaphoreTake(s_cfg_lock, portMAX_DELAY);
+}
+
+static void cfg_unlock(void)
+{
+    xSemaphoreGive(s_cfg_lock);
+}
 
-    esp_err_t err = nvs_write_string(out);
-    free(out);
+static esp_err_t save_cfg_object(cJSON *cfg)
+{
+    esp_err_t err = nvs_write_sections(cfg);
     if (err != ESP_OK) {
+        cJSON_Delete(cfg);
         set_error("NVS write failed: %s", esp_err_to_name(err));
         return err;
     }
 
-    if (s_cfg) {
-        cJSON_Delete(s_cfg);
-    }
+    cfg_lock();
+    cJSON *old = s_cfg;
     s_cfg = cfg;
+    cfg_unlock();
+    cJSON_Delete(old);
     clear_error();
     return ESP_OK;
 }
@@ -1433,29 +1889,51 @@ const cJSON *cfg_json_get(void)
     return s_cfg;
 }
 
+cJSON *cfg_json_get_copy(void)
+{
+    cfg_lock();
+    cJSON *copy = s_cfg ? cJSON_Duplicate(s_cfg, 1) : NULL;
+    cfg_unlock();
+    return copy;
+}
+
+esp_err_t cfg_json_visit(cfg_json_visitor_t fn, void *ctx)
+{
+    cfg_lock();
+    esp_err_t err = s_cfg ? fn(s_cfg, ctx) : ESP_ERR_INVALID_STATE;
+    cfg_unlock();
+    return err;
+}
+
 esp_err_t cfg_json_load_or_default(void)
 {
     clear_error();
 
-    char *json = NULL;
-    esp_err_t err = nvs_read_string(&json);
-    if (err == ESP_OK && json) {
-        cJSON *parsed = cJSON_Parse(json);
-        free(json);
-
-        if (parsed) {
-            cJSON *normalized = normalize_config(parsed);
-            cJSON_Delete(parsed);
-            if (normalized) {
-                ESP_LOGI(TAG, "Loaded config from NVS");
-                return save_cfg_object(normalized);
+    bool legacy = false;
+    cJSON *parsed = NULL;
+    esp_err_t err = nvs_read_sections(&parsed);
+    if (err == ESP_ERR_NVS_NOT_FOUND) {
+        err = nvs_read_legacy_json(&parsed);
+        legacy = err == ESP_OK;
+    }
+
+    if (err == ESP_OK) {
+        cJSON *normalized = normalize_config(parsed);
+        cJSON_Delete(parsed);
+        if (normalized) {
+            ESP_LOGI(TAG, "Loaded config from NVS");
+            // Unchanged sections hash the same as what is stored, so a normal boot writes nothing.
+            err = save_cfg_object(normalized);
+            if (err == ESP_OK && legacy) {
+                nvs_erase_legacy_json();
             }
-            ESP_LOGW(TAG, "Stored config invalid, using default: %s", cfg_json_last_error());
-        } else {
-            ESP_LOGW(TAG, "Stored config is invalid JSON, using default");
+            return err;
         }
-    } else {
+        ESP_LOGW(TAG, "Stored config invalid, using default: %s", cfg_json_last_error());
+    } else if (err == ESP_ERR_NVS_NOT_FOUND) {
         ESP_LOGW(TAG, "No config in NVS, using default");
+    } else {
+        ESP_LOGW(TAG, "Stored config unreadable (%s), using default", esp_err_to_name(err));
     }
 
     cJSON *def = create_empty_schema();
@@ -1513,17 +1991,21 @@ static bool replace_number(cJSON *obj, const char *key, int value)
     return cJSON_ReplaceItemInObject(obj, key, cJSON_CreateNumber(value)) != 0;
 }
 
+// Edits a copy so readers of the live tree never see it change underneath them.
 esp_err_t cfg_json_clear_connectivity(void)
 {
-    if (!cJSON_IsObject(s_cfg)) {
+    cJSON *cfg = cfg_json_get_copy();
+    if (!cJSON_IsObject(cfg)) {
+        cJSON_Delete(cfg);
         set_error("Config is not loaded");
         return ESP_ERR_INVALID_STATE;
     }
 
-    cJSON *connectivity = cJSON_GetObjectItemCaseSensitive(s_cfg, "connectivity");
+    cJSON *connectivity = cJSON_GetObjectItemCaseSensitive(cfg, "connectivity");
     cJSON *sta = cJSON_GetObjectItemCaseSensitive(connectivity, "sta");
     cJSON *mqtt = cJSON_GetObjectItemCaseSensitive(connectivity, "mqtt");
     if (!cJSON_IsObject(connectivity) || !cJSON_IsObject(sta) || !cJSON_IsObject(mqtt)) {
+        cJSON_Delete(cfg);
         set_error("Connectivity section is missing");
         return ESP_ERR_INVALID_STATE;
     }
@@ -1535,11 +2017,14 @@ esp_err_t cfg_json_clear_connectivity(void)
         !replace_number(mqtt, "port", 1883) ||
         !replace_string(mqtt, "user", "") ||
         !replace_string(mqtt, "pass", "")) {
+        cJSON_Delete(cfg);
         set_error("Out of memory while clearing connectivity");
         return ESP_ERR_NO_MEM;
     }
 
-    return cfg_json_set_and_save(s_cfg);
+    esp_err_t err = cfg_json_set_and_save(cfg);
+    cJSON_Delete(cfg);
+    return err;
 }
 
 esp_err_t cfg_json_factory_reset(void)
@@ -1561,6 +2046,7 @@ esp_err_t cfg_json_factory_reset(void)
         return err;
     }
 
+    memset(s_section_stored, 0, sizeof(s_section_stored));
     clear_error();
     return ESP_OK;
 }
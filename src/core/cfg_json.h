@@ -8,6 +8,13 @@ extern "C" {
 #endif
 
 const cJSON *cfg_json_get(void);
+// Deep copy of the current config taken under the config lock; the caller frees it. Use this when the
+// tree is read for longer than a call, e.g. while streaming it to a client.
+cJSON *cfg_json_get_copy(void);
+// Runs fn on the live config with the config lock held, so the tree can be read (streamed) without a
+// copy; fn must not call back into cfg_json. ESP_ERR_INVALID_STATE when no config is loaded.
+typedef esp_err_t (*cfg_json_visitor_t)(const cJSON *cfg, void *ctx);
+esp_err_t cfg_json_visit(cfg_json_visitor_t fn, void *ctx);
 const char *cfg_json_last_error(void);
 
 esp_err_t cfg_json_load_or_default(void);
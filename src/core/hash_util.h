@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HASH_FNV1A_SEED 2166136261u
+
+// 32-bit FNV-1a. Pass HASH_FNV1A_SEED, or a previous result to hash several pieces as one.
+static inline uint32_t hash_fnv1a(uint32_t h, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    for (size_t i = 0; i < len; ++i) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Clamps an elapsed esp_timer_get_time() difference into the uint32 microseconds the histograms use.
+static inline uint32_t hist_elapsed_us(int64_t elapsed_us)
+{
+    return elapsed_us > 0 ? (elapsed_us > UINT32_MAX ? UINT32_MAX : (uint32_t)elapsed_us) : 0;
+}
+
+// Log2 bucket: bucket 0 is below 2 us, bucket i is [2^i, 2^(i+1)) us and the last one is open-ended.
+static inline int hist_log2_bucket(uint32_t us, int buckets)
+{
+    int bucket = 0;
+    while (bucket < buckets - 1 && (us >> (bucket + 1)) != 0) {
+        bucket++;
+    }
+    return bucket;
+}
+
+#ifdef __cplusplus
+}
+#endif
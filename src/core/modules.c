@@ -13,6 +13,7 @@
 #include "ds18b20.h"
 #include "driver/gpio.h"
 #include "driver/ledc.h"
+#include "driver/rmt_tx.h"
 #include "esp_adc/adc_oneshot.h"
 #include "esp_check.h"
 #include "esp_log.h"
@@ -23,25 +24,68 @@
 #include "freertos/task.h"
 #include "i2c_bus.h"
 #include "led_strip.h"
+#include "nvs.h"
 #include "onewire_bus.h"
 #include "soc/soc_caps.h"
 #include "sht3x.h"
 
+#include "app_config.h"
 #include "app_watchdog.h"
+#include "core/hash_util.h"
+#include "core/hist_util.h"
+#include "core/motion.h"
+#include "core/perf_probe.h"
+#include "core/ws2812_render.h"
+#include "drivers/gpio_edge.h"
 
 static const char *TAG = "modules";
 
-#define MODULES_MAX_OUTPUTS 8
-#define MODULES_MAX_INPUTS 8
-#define MODULES_MAX_BUTTONS 8
-#define MODULES_MAX_SENSORS 4
-#define MODULES_MAX_DS18B20 8
+#define MODULES_MAX_OUTPUTS APP_MODULES_MAX_OUTPUTS
+#define MODULES_MAX_INPUTS APP_MODULES_MAX_INPUTS
+#define MODULES_MAX_BUTTONS APP_MODULES_MAX_BUTTONS
+#define MODULES_MAX_SENSORS APP_MODULES_MAX_SENSORS
+#define MODULES_MAX_DS18B20 APP_MODULES_MAX_DS18B20
+#define MODULES_ARENA_ALIGN 8
+// Open-addressing id index, kept at most half full.
+#define MODULES_OUTPUT_INDEX_SLOTS (2 * MODULES_MAX_OUTPUTS)
+#define MODULES_INPUT_INDEX_SLOTS (2 * MODULES_MAX_INPUTS)
+// Fallback sampling period for pins whose edge interrupt could not be installed.
 #define MODULES_POLL_PERIOD_MS 50
+#define MODULES_INPUT_DEBOUNCE_MS_DEFAULT 20
+#define MODULES_EDGE_SOURCE_BUTTON_BASE MODULES_MAX_INPUTS
+#define MODULES_COUNTER_RATE_BUCKETS 12
+#define MODULES_COUNTER_RATE_WINDOW_SEC_DEFAULT 60
+#define MODULES_COUNTER_PERSIST_MS 300000
+#define MODULES_COUNTER_NVS_NS "counters"
+#define MODULES_BUTTON_MIN_CLICK_MS 40
+#define MODULES_BUTTON_MULTI_CLICK_MS_DEFAULT 300
+#define MODULES_BUTTON_HOLD_REPEAT_MS_DEFAULT 200
+#define MODULES_SCHED_MAX_SLEEP_MS 1000
+#define MODULES_SCHED_SLOTS (MODULES_MAX_OUTPUTS + 1)
+#define MODULES_SCHED_INPUT_SLOT MODULES_MAX_OUTPUTS
+#define MODULES_WS2812_FRAME_MS 20
+#define MODULES_A4988_RMT_RESOLUTION_HZ 1000000
+#define MODULES_A4988_RMT_BATCH_SYMBOLS 256
+#define MODULES_A4988_RMT_BATCH_US 20000
+#define MODULES_A4988_RMT_HOME_BATCH_US 5000
+#define MODULES_STEPPER_GPIO_MAX_STEPS_PER_SEC 1000
 #define MODULES_SENSOR_TASK_PERIOD_MS 200
+#define MODULES_MAX_RUNTIME_CALLBACKS 4
 #define SERVO_3WIRE_HOLD_MS_DEFAULT 1200
 #define MODULES_DEFAULT_I2C_PORT I2C_NUM_0
 #define LEVEL_PCT_MAX 100
-#define WS2812_BRIGHTNESS_MAX 255
+#define WS2812_MAX_PIXELS 300
+#define WS2812_EFFECT_FPS_DEFAULT 30
+#define WS2812_EFFECT_FPS_MAX 60
+#define WS2812_EFFECT_SPEED_DEFAULT 64
+#define WS2812_EFFECT_SPEED_MAX 255
+
+// Change tracking and the scheduler kick mask keep one bit per entity (plus the input slot).
+_Static_assert(MODULES_MAX_OUTPUTS < 32, "APP_MODULES_MAX_OUTPUTS must be below 32");
+_Static_assert(MODULES_MAX_INPUTS <= 32, "APP_MODULES_MAX_INPUTS must be at most 32");
+_Static_assert(MODULES_MAX_BUTTONS <= 32, "APP_MODULES_MAX_BUTTONS must be at most 32");
+_Static_assert(MODULES_MAX_SENSORS <= 32, "APP_MODULES_MAX_SENSORS must be at most 32");
+_Static_assert(MODULES_MAX_INPUTS + MODULES_MAX_BUTTONS <= 256, "edge sources are tagged with one byte");
 
 typedef enum {
     OUTPUT_TYPE_NONE = 0,
@@ -60,6 +104,13 @@ typedef enum {
     WS2812_MODE_MONO_TRIPLET,
 } ws2812_mode_t;
 
+// SPI drives the strip from MOSI with DMA, so long strips need no refill interrupts; RMT stays the
+// default because the C3 has a single general-purpose SPI host.
+typedef enum {
+    WS2812_DRIVER_RMT = 0,
+    WS2812_DRIVER_SPI,
+} ws2812_driver_t;
+
 typedef enum {
     WS2812_TRANSITION_NONE = 0,
     WS2812_TRANSITION_FADE,
@@ -84,6 +135,186 @@ typedef struct {
     int step;
 } button_action_t;
 
+// Config keys under "actions"; "short" is the single click.
+typedef enum {
+    BUTTON_GESTURE_SINGLE = 0,
+    BUTTON_GESTURE_DOUBLE,
+    BUTTON_GESTURE_TRIPLE,
+    BUTTON_GESTURE_LONG,
+    BUTTON_GESTURE_HOLD,
+    BUTTON_GESTURE_COUNT,
+} button_gesture_t;
+
+static const char *const s_button_gesture_keys[BUTTON_GESTURE_COUNT] = {
+    "short", "double", "triple", "long", "hold",
+};
+static const char *const s_button_gesture_events[BUTTON_GESTURE_COUNT] = {
+    "single", "double", "triple", "long", "hold",
+};
+
+typedef struct {
+    int steps_range;
+    int speed_steps_per_sec;
+    int accel_steps_per_s2;
+    int target_level;
+    int current_level;
+    int target_position_steps;
+    int current_position_steps;
+    int64_t last_step_us;
+    motion_profile_t profile;
+} stepper_axis_t;
+
+typedef struct {
+    int active_level;
+    bool default_on;
+} relay_output_t;
+
+typedef struct {
+    bool inverted;
+    int freq_hz;
+    int level;
+    int max_level_pct;
+    int power_relay_gpio;
+    int power_relay_active_level;
+    ledc_channel_t channel;
+    ledc_timer_t timer;
+} pwm_output_t;
+
+typedef struct {
+    int pixel_count;
+    char color_order[8];
+    bool default_power_on;
+    int level;
+    uint8_t red;
+    uint8_t green;
+    uint8_t blue;
+    ws2812_mode_t mode;
+    ws2812_transition_style_t transition_style;
+    int transition_ms;
+    int applied_level;
+    uint8_t applied_red;
+    uint8_t applied_green;
+    uint8_t applied_blue;
+    ws2812_easing_t transition_easing;
+    ws2812_transition_t transition;
+    int64_t transition_started_us;
+    // Lit prefix of the last wipe frame, -1 for a full frame.
+    int transition_segments;
+    // Effects replace the solid fill in RGB mode, rendered from the applied color and level.
+    ws2812_effect_cfg_t fx;
+    int effect_fps;
+    bool effect_running;
+    int64_t effect_started_us;
+    int64_t effect_next_us;
+    uint32_t effect_frame;
+    ws2812_driver_t driver;
+    led_strip_handle_t strip;
+    // Wire-order frame (pixel_count * 3 bytes, carved from the runtime arena).
+    uint8_t *frame;
+    // Copy taken by the transmit task; frame_dirty marks a frame it has not picked up yet.
+    uint8_t *tx_frame;
+    bool frame_dirty;
+    ws2812_palette_t palette;
+} ws2812_output_t;
+
+typedef struct {
+    int level;
+    int min_us;
+    int max_us;
+    bool reverse_direction;
+    int hold_power_ms;
+    int64_t release_at_us;
+    ledc_channel_t channel;
+    ledc_timer_t timer;
+} servo_3wire_output_t;
+
+typedef struct {
+    int gpio_b;
+    int feedback_gpio;
+    int feedback_min_raw;
+    int feedback_max_raw;
+    int deadband_pct;
+    int move_timeout_ms;
+    bool reverse_direction;
+    adc_channel_t adc_channel;
+    int target_level;
+    int current_level;
+    int feedback_raw;
+    int drive_state;
+    bool moving;
+    bool timed_out;
+    int64_t drive_started_us;
+} servo_5wire_output_t;
+
+typedef struct {
+    int gpio_b;
+    int gpio_c;
+    int brightness_gpio;
+    uint8_t segment_map[8];
+    int level;
+    int blink_period_ms;
+    int timezone_offset_min;
+    bool default_on;
+    bool common_anode;
+    bool mirror_segments;
+    bool reverse_digits;
+    bool leading_zero;
+    bool blink_separator;
+    bool time_valid;
+    bool separator_on;
+    int display_hour;
+    int display_minute;
+    int64_t last_render_us;
+    char display_text[8];
+    uint8_t segments[4];
+    ledc_channel_t channel;
+    ledc_timer_t timer;
+} clock_4x4094_output_t;
+
+typedef struct {
+    int gpio_b;
+    int gpio_c;
+    int gpio_d;
+    int home_gpio;
+    gpio_pull_mode_t home_pull_mode;
+    bool home_inverted;
+    bool auto_home_on_boot;
+    bool reverse_direction;
+    bool hold_enabled;
+    int phase_index;
+    bool home_active;
+    bool homing;
+    bool homed;
+    bool moving;
+    stepper_axis_t axis;
+} stepper_28byj_output_t;
+
+typedef struct {
+    int gpio_b;
+    int gpio_c;
+    int home_gpio;
+    gpio_pull_mode_t home_pull_mode;
+    bool home_inverted;
+    bool auto_home_on_boot;
+    int enable_active_level;
+    int step_pulse_us;
+    bool reverse_direction;
+    bool hold_enabled;
+    bool home_active;
+    bool homing;
+    bool homed;
+    bool moving;
+    stepper_axis_t axis;
+    rmt_channel_handle_t rmt_chan;
+    rmt_encoder_handle_t rmt_encoder;
+    rmt_symbol_word_t *rmt_symbols;
+    int rmt_batch_steps[2];
+    int rmt_head;
+    int rmt_inflight;
+    int rmt_done_steps;
+    int rmt_planned_steps;
+} stepper_a4988_output_t;
+
 typedef struct {
     bool used;
     bool enabled;
@@ -103,151 +334,27 @@ typedef struct {
     uint8_t test_restore_red;
     uint8_t test_restore_green;
     uint8_t test_restore_blue;
+    // Type-specific state lives in the runtime arena, in one pool per output type. NULL for
+    // OUTPUT_TYPE_NONE.
     union {
-        struct {
-            int active_level;
-            bool default_on;
-        } relay;
-        struct {
-            bool inverted;
-            int freq_hz;
-            int level;
-            int max_level_pct;
-            int power_relay_gpio;
-            int power_relay_active_level;
-            ledc_channel_t channel;
-            ledc_timer_t timer;
-        } pwm;
-        struct {
-            int pixel_count;
-            char color_order[8];
-            bool default_power_on;
-            bool gamma_correction;
-            int level;
-            uint8_t red;
-            uint8_t green;
-            uint8_t blue;
-            ws2812_mode_t mode;
-            ws2812_transition_style_t transition_style;
-            int transition_ms;
-            int applied_level;
-            uint8_t applied_red;
-            uint8_t applied_green;
-            uint8_t applied_blue;
-            bool transition_active;
-            bool transition_use_wipe;
-            int64_t transition_started_us;
-            int64_t transition_duration_us;
-            int start_level;
-            int target_level;
-            uint8_t start_red;
-            uint8_t start_green;
-            uint8_t start_blue;
-            uint8_t target_red;
-            uint8_t target_green;
-            uint8_t target_blue;
-            led_strip_handle_t strip;
-        } ws2812;
-        struct {
-            int level;
-            int min_us;
-            int max_us;
-            bool reverse_direction;
-            int hold_power_ms;
-            int64_t release_at_us;
-            ledc_channel_t channel;
-            ledc_timer_t timer;
-        } servo_3wire;
-        struct {
-            int gpio_b;
-            int feedback_gpio;
-            int feedback_min_raw;
-            int feedback_max_raw;
-            int deadband_pct;
-            int move_timeout_ms;
-            bool reverse_direction;
-            adc_channel_t adc_channel;
-            int target_level;
-            int current_level;
-            int feedback_raw;
-            int drive_state;
-            bool moving;
-            bool timed_out;
-            int64_t drive_started_us;
-        } servo_5wire;
-        struct {
-            int gpio_b;
-            int gpio_c;
-            int brightness_gpio;
-            uint8_t segment_map[8];
-            int level;
-            int blink_period_ms;
-            int timezone_offset_min;
-            bool default_on;
-            bool common_anode;
-            bool mirror_segments;
-            bool reverse_digits;
-            bool leading_zero;
-            bool blink_separator;
-            bool time_valid;
-            bool separator_on;
-            int display_hour;
-            int display_minute;
-            int64_t last_render_us;
-            char display_text[8];
-            uint8_t segments[4];
-            ledc_channel_t channel;
-            ledc_timer_t timer;
-        } clock_4x4094;
-        struct {
-            int gpio_b;
-            int gpio_c;
-            int gpio_d;
-            int home_gpio;
-            gpio_pull_mode_t home_pull_mode;
-            bool home_inverted;
-            bool auto_home_on_boot;
-            int steps_range;
-            int speed_steps_per_sec;
-            bool reverse_direction;
-            bool hold_enabled;
-            int target_level;
-            int current_level;
-            int target_position_steps;
-            int current_position_steps;
-            int phase_index;
-            bool home_active;
-            bool homing;
-            bool homed;
-            bool moving;
-            int64_t last_step_us;
-        } stepper_28byj;
-        struct {
-            int gpio_b;
-            int gpio_c;
-            int home_gpio;
-            gpio_pull_mode_t home_pull_mode;
-            bool home_inverted;
-            bool auto_home_on_boot;
-            int enable_active_level;
-            int steps_range;
-            int speed_steps_per_sec;
-            int step_pulse_us;
-            bool reverse_direction;
-            bool hold_enabled;
-            int target_level;
-            int current_level;
-            int target_position_steps;
-            int current_position_steps;
-            bool home_active;
-            bool homing;
-            bool homed;
-            bool moving;
-            int64_t last_step_us;
-        } stepper_a4988;
+        void *state;
+        relay_output_t *relay;
+        pwm_output_t *pwm;
+        ws2812_output_t *ws2812;
+        servo_3wire_output_t *servo_3wire;
+        servo_5wire_output_t *servo_5wire;
+        clock_4x4094_output_t *clock_4x4094;
+        stepper_28byj_output_t *stepper_28byj;
+        stepper_a4988_output_t *stepper_a4988;
     } cfg;
 } output_runtime_t;
 
+typedef struct {
+    esp_err_t (*step)(output_runtime_t *out, int logical_direction);
+    bool (*home_active)(output_runtime_t *out);
+    void (*finish_home)(output_runtime_t *out);
+} stepper_driver_t;
+
 typedef struct {
     bool used;
     bool enabled;
@@ -258,8 +365,31 @@ typedef struct {
     bool inverted;
     gpio_pull_mode_t pull_mode;
     bool state;
+    // Leading-edge debounce: an accepted edge locks the pin for debounce_ms, then it is resampled once
+    // if anything moved in between (settle_pending).
+    int debounce_ms;
+    bool edge_capture;
+    bool settle_pending;
+    int64_t lockout_until_us;
+    // Pulse counter (type "counter"): edges are counted in the ISR (or by polling as a fallback) and
+    // folded into total once per rate bucket; the rate is the sum over the last bucket ring.
+    bool counter;
+    uint32_t polled_pulses;
+    uint64_t total;
+    uint64_t total_saved;
+    int rate_window_sec;
+    int64_t rate_tick_us;
+    uint32_t rate_buckets[MODULES_COUNTER_RATE_BUCKETS];
+    uint8_t rate_head;
+    uint8_t rate_filled;
+    float rate_per_min;
 } input_runtime_t;
 
+typedef struct {
+    char id[24];
+    uint64_t total;
+} counter_save_t;
+
 typedef struct {
     bool used;
     bool enabled;
@@ -269,11 +399,22 @@ typedef struct {
     bool inverted;
     gpio_pull_mode_t pull_mode;
     int long_press_ms;
+    int multi_click_ms;
+    int hold_repeat_ms;
+    int max_clicks;
     bool last_pressed;
     bool long_sent;
     int64_t pressed_since_us;
-    button_action_t short_action;
-    button_action_t long_action;
+    // Gesture state: clicks released so far in the current sequence, when the sequence closes if no
+    // further press arrives, and the next hold-repeat tick while held past long_press_ms.
+    int click_count;
+    int64_t click_deadline_us;
+    int64_t hold_next_us;
+    int debounce_ms;
+    bool edge_capture;
+    bool settle_pending;
+    int64_t lockout_until_us;
+    button_action_t actions[BUTTON_GESTURE_COUNT];
 } button_runtime_t;
 
 typedef struct {
@@ -323,6 +464,16 @@ typedef struct {
     char sensor_name[40];
 } ds18b20_bus_runtime_t;
 
+typedef struct {
+    onewire_bus_handle_t bus;
+    ds18b20_device_handle_t devices[MODULES_MAX_DS18B20];
+    onewire_device_address_t addresses[MODULES_MAX_DS18B20];
+    float temperatures[MODULES_MAX_DS18B20];
+    bool valid[MODULES_MAX_DS18B20];
+    int device_count;
+    bool rescanned;
+} ds18b20_sample_t;
+
 typedef struct {
     bool active;
     adc_oneshot_unit_handle_t handle;
@@ -342,27 +493,110 @@ typedef struct {
     int next_channel;
 } ledc_allocator_t;
 
+// Entity tables point into one arena allocated by modules_apply_config for the config at hand.
 typedef struct {
-    output_runtime_t outputs[MODULES_MAX_OUTPUTS];
+    void *arena;
+    size_t arena_size;
+    output_runtime_t *outputs;
     int output_count;
-    input_runtime_t inputs[MODULES_MAX_INPUTS];
+    input_runtime_t *inputs;
     int input_count;
-    button_runtime_t buttons[MODULES_MAX_BUTTONS];
+    button_runtime_t *buttons;
     int button_count;
-    sensor_runtime_t sensors[MODULES_MAX_SENSORS];
+    sensor_runtime_t *sensors;
     int sensor_count;
     i2c_runtime_t i2c;
     ds18b20_bus_runtime_t ds18b20;
     adc_runtime_t adc;
 } modules_runtime_t;
 
+// Bump allocator over the arena; with base NULL it only measures.
+typedef struct {
+    uint8_t *base;
+    size_t used;
+} runtime_arena_t;
+
+typedef struct {
+    const cJSON *outputs;
+    const cJSON *inputs;
+    const cJSON *buttons;
+    const cJSON *sensors;
+    int output_count;
+    int input_count;
+    int button_count;
+    int sensor_count;
+    output_type_t output_types[MODULES_MAX_OUTPUTS];
+    int ws2812_pixels[MODULES_MAX_OUTPUTS];
+    void *output_states[MODULES_MAX_OUTPUTS];
+} runtime_layout_t;
+
+typedef struct {
+    int64_t due_us;
+    int slot;
+} sched_entry_t;
+
+// Min-heap of wakeup deadlines: one slot per output plus one for input/button scanning.
+typedef struct {
+    sched_entry_t heap[MODULES_SCHED_SLOTS];
+    int pos[MODULES_SCHED_SLOTS];
+    int count;
+    bool resync;
+} scheduler_t;
+
+typedef enum {
+    CHANGE_KIND_OUTPUT = 0,
+    CHANGE_KIND_INPUT,
+    CHANGE_KIND_SENSOR,
+    CHANGE_KIND_BUTTON,
+    CHANGE_KIND_COUNT,
+} change_kind_t;
+
+typedef struct {
+    uint32_t seq;
+    uint8_t kind;
+    uint8_t index;
+} change_entry_t;
+
+// Dirty bits collect mutations while s_lock is held and are folded into the journal, one entry per
+// touched entity, before the lock is released. Entry N lives at journal[N % MODULES_CHANGE_JOURNAL_LEN].
+typedef struct {
+    uint32_t dirty[CHANGE_KIND_COUNT];
+    change_entry_t journal[MODULES_CHANGE_JOURNAL_LEN];
+    uint32_t seq;
+    uint32_t reset_seq;
+} change_journal_t;
+
+typedef struct {
+    modules_runtime_callback_t cb;
+    void *ctx;
+} runtime_listener_t;
+
 static modules_runtime_t s_runtime = {0};
 static char s_last_error[192] = "";
 static SemaphoreHandle_t s_lock = NULL;
+static SemaphoreHandle_t s_bus_lock = NULL;
+// Held while a WS2812 frame is on the wire and across reconfiguration, so strips are never deleted
+// mid-transfer. Order: s_bus_lock, then s_ws2812_tx_lock, then s_lock.
+static SemaphoreHandle_t s_ws2812_tx_lock = NULL;
+static TaskHandle_t s_ws2812_tx_task = NULL;
+static int64_t s_lock_taken_us = 0;
+static modules_lock_stats_t s_lock_stats = {0};
 static TaskHandle_t s_poll_task = NULL;
+static scheduler_t s_sched = {0};
+static esp_timer_handle_t s_sched_timer = NULL;
+static change_journal_t s_changes = {0};
+static portMUX_TYPE s_isr_mux = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t s_sched_kick_mask = 0;
+static bool s_edge_capture_ready = false;
+static int64_t s_counter_persist_due_us = 0;
+static modules_button_event_t s_button_events[MODULES_BUTTON_EVENT_LEN];
+static uint32_t s_button_event_seq = 0;
+static uint32_t s_edge_dropped_seen = 0;
 static TaskHandle_t s_sensor_task = NULL;
-static modules_runtime_callback_t s_runtime_cb = NULL;
-static void *s_runtime_cb_ctx = NULL;
+static runtime_listener_t s_runtime_listeners[MODULES_MAX_RUNTIME_CALLBACKS] = {0};
+// Slot holds entity index + 1, 0 when empty. Rebuilt by modules_apply_config.
+static uint8_t s_output_index[MODULES_OUTPUT_INDEX_SLOTS] = {0};
+static uint8_t s_input_index[MODULES_INPUT_INDEX_SLOTS] = {0};
 
 static void set_last_error(const char *fmt, ...)
 {
@@ -377,6 +611,26 @@ static void clear_last_error(void)
     s_last_error[0] = 0;
 }
 
+static void runtime_lock(void)
+{
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    s_lock_taken_us = esp_timer_get_time();
+}
+
+static void runtime_unlock(void)
+{
+    uint32_t hold_us = hist_elapsed_us(esp_timer_get_time() - s_lock_taken_us);
+    int bucket = hist_log2_bucket(hold_us, MODULES_LOCK_HIST_BUCKETS);
+
+    s_lock_stats.acquisitions++;
+    s_lock_stats.total_hold_us += hold_us;
+    s_lock_stats.hold_hist[bucket]++;
+    if (hold_us > s_lock_stats.max_hold_us) {
+        s_lock_stats.max_hold_us = hold_us;
+    }
+    xSemaphoreGive(s_lock);
+}
+
 static const cJSON *jobj(const cJSON *obj, const char *key);
 static const char *jstr(const cJSON *obj, const char *key, const char *def);
 static bool jbool(const cJSON *obj, const char *key, bool def);
@@ -389,9 +643,19 @@ static ws2812_mode_t ws2812_mode_from_text(const char *mode);
 static const char *ws2812_mode_to_text(ws2812_mode_t mode);
 static ws2812_transition_style_t ws2812_transition_style_from_text(const char *style);
 static const char *ws2812_transition_style_to_text(ws2812_transition_style_t style);
+static bool ws2812_effect_from_text(const char *name, ws2812_effect_t *out);
+static ws2812_easing_t ws2812_easing_from_text(const char *easing);
+static const char *ws2812_easing_to_text(ws2812_easing_t easing);
 static button_action_type_t button_action_type_from_text(const char *type);
 static const char *button_action_type_to_text(button_action_type_t type);
 static void notify_runtime_changed(void);
+static void mark_dirty_locked(change_kind_t kind, int index);
+static void mark_output_dirty_locked(const output_runtime_t *out);
+static void mark_button_dirty_locked(const button_runtime_t *btn);
+static bool commit_changes_locked(void);
+static void reset_changes_locked(void);
+static void collect_changes_locked(uint32_t since_seq, modules_changes_t *out);
+static cJSON *build_status_json_locked(const modules_changes_t *changes);
 static esp_err_t output_apply_physical_state(output_runtime_t *out);
 static esp_err_t set_output_power_locked(output_runtime_t *out, bool on);
 static esp_err_t set_output_level_locked(output_runtime_t *out, int level);
@@ -400,20 +664,27 @@ static esp_err_t set_master_output_locked(bool on);
 static bool is_any_output_on_locked(void);
 static output_runtime_t *find_output_locked(const char *id);
 static input_runtime_t *find_input_locked(const char *id);
+static int collect_counter_saves_locked(counter_save_t *saves);
+static void write_counter_saves(const counter_save_t *saves, int count);
+static void adopt_counter_saves_locked(const counter_save_t *saves, int count);
+static int64_t counter_bucket_us(const input_runtime_t *in);
 static cJSON *build_output_status_json(const output_runtime_t *out);
 static cJSON *build_input_status_json(const input_runtime_t *in);
 static cJSON *build_button_status_json(const button_runtime_t *btn);
+static bool button_is_pressed(const button_runtime_t *btn);
+static int64_t input_slot_deadline_locked(int64_t now_us);
 static cJSON *build_sensor_status_json(const sensor_runtime_t *sensor);
+static void fill_output_status(const output_runtime_t *out, modules_output_status_t *st);
+static bool append_sensor_status(const sensor_runtime_t *sensor, modules_status_snapshot_t *snap);
 static esp_err_t start_output_test_locked(output_runtime_t *out, int duration_ms);
 static bool process_output_test_locked(output_runtime_t *out, int64_t now_us);
 static esp_err_t ensure_i2c_bus_locked(int sda_gpio, int scl_gpio, int freq_hz);
 static esp_err_t ensure_ds18b20_bus_locked(const sensor_runtime_t *sensor);
 static esp_err_t ensure_adc_channel_locked(int gpio, adc_channel_t *out_channel);
-static esp_err_t read_sensor_locked(sensor_runtime_t *sensor);
+static esp_err_t read_sensor_sample(sensor_runtime_t *sample);
 static const char *normalize_output_mqtt_component(const char *value);
 static const char *normalize_output_mqtt_number_mode(const char *value);
-static esp_err_t enumerate_ds18b20_devices_locked(int gpio, bool *out_topology_changed);
-static esp_err_t read_ds18b20_locked(bool *out_topology_changed);
+static esp_err_t enumerate_ds18b20_devices_locked(void);
 static esp_err_t set_pwm_power_relay_locked(output_runtime_t *out, bool on);
 static bool output_supports_power_control(const output_runtime_t *out);
 static bool output_supports_level_control(const output_runtime_t *out);
@@ -434,6 +705,8 @@ static esp_err_t stepper_28byj_start_home_locked(output_runtime_t *out);
 static esp_err_t stepper_28byj_stop_locked(output_runtime_t *out);
 static esp_err_t stepper_a4988_set_enable_locked(output_runtime_t *out, bool enabled);
 static esp_err_t stepper_a4988_step_locked(output_runtime_t *out, int logical_direction);
+static void stepper_a4988_rmt_abort_locked(output_runtime_t *out);
+static bool stepper_a4988_busy_locked(const output_runtime_t *out);
 static bool stepper_a4988_home_active_locked(output_runtime_t *out);
 static void stepper_a4988_finish_home_locked(output_runtime_t *out);
 static esp_err_t stepper_a4988_start_home_locked(output_runtime_t *out);
@@ -449,7 +722,12 @@ static esp_err_t clock_4x4094_apply_state_locked(output_runtime_t *out, int64_t
 static bool update_clock_4x4094_locked(output_runtime_t *out, int64_t now_us);
 static esp_err_t render_ws2812_frame_locked(output_runtime_t *out, int level, uint8_t red, uint8_t green, uint8_t blue, int wipe_active_segments);
 static esp_err_t apply_ws2812_target_locked(output_runtime_t *out, bool allow_transition);
-static void update_ws2812_transitions_locked(int64_t now_us);
+static void update_ws2812_transition_locked(output_runtime_t *out, int64_t now_us);
+static bool ws2812_effect_animated(ws2812_effect_t effect);
+static bool ws2812_effect_wanted(const output_runtime_t *out);
+static esp_err_t render_ws2812_effect_locked(output_runtime_t *out);
+static void update_ws2812_effect_locked(output_runtime_t *out, int64_t now_us);
+static esp_err_t set_ws2812_effect_locked(output_runtime_t *out, const char *name);
 static bool output_uses_plain_gpio(output_type_t type);
 static esp_err_t ledc_allocator_acquire(ledc_allocator_t *alloc, int freq_hz, ledc_timer_bit_t duty_resolution,
                                         ledc_channel_t *out_channel, ledc_timer_t *out_timer);
@@ -590,6 +868,16 @@ static ws2812_mode_t ws2812_mode_from_text(const char *mode)
     return WS2812_MODE_RGB;
 }
 
+static ws2812_driver_t ws2812_driver_from_text(const char *driver)
+{
+    return strcmp(driver, "spi") == 0 ? WS2812_DRIVER_SPI : WS2812_DRIVER_RMT;
+}
+
+static const char *ws2812_driver_to_text(ws2812_driver_t driver)
+{
+    return driver == WS2812_DRIVER_SPI ? "spi" : "rmt";
+}
+
 static const char *ws2812_mode_to_text(ws2812_mode_t mode)
 {
     switch (mode) {
@@ -620,6 +908,46 @@ static const char *ws2812_transition_style_to_text(ws2812_transition_style_t sty
     }
 }
 
+static ws2812_easing_t ws2812_easing_from_text(const char *easing)
+{
+    if (strcmp(easing, "ease_in_out") == 0) {
+        return WS2812_EASING_EASE_IN_OUT;
+    }
+    if (strcmp(easing, "cie") == 0) {
+        return WS2812_EASING_CIE;
+    }
+    return WS2812_EASING_LINEAR;
+}
+
+static const char *ws2812_easing_to_text(ws2812_easing_t easing)
+{
+    switch (easing) {
+        case WS2812_EASING_EASE_IN_OUT: return "ease_in_out";
+        case WS2812_EASING_CIE: return "cie";
+        case WS2812_EASING_LINEAR:
+        default: return "linear";
+    }
+}
+
+static bool ws2812_effect_from_text(const char *name, ws2812_effect_t *out)
+{
+    for (int i = 0; name && i < WS2812_EFFECT_COUNT; ++i) {
+        if (strcmp(name, ws2812_effect_name((ws2812_effect_t)i)) == 0) {
+            *out = (ws2812_effect_t)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char *modules_ws2812_effect_name(int index)
+{
+    if (index < 0 || index >= WS2812_EFFECT_COUNT) {
+        return NULL;
+    }
+    return ws2812_effect_name((ws2812_effect_t)index);
+}
+
 static button_action_type_t button_action_type_from_text(const char *type)
 {
     if (strcmp(type, "toggle_output") == 0) {
@@ -662,9 +990,57 @@ static const char *button_action_type_to_text(button_action_type_t type)
 
 static void notify_runtime_changed(void)
 {
-    if (s_runtime_cb) {
-        s_runtime_cb(s_runtime_cb_ctx);
+    for (int i = 0; i < MODULES_MAX_RUNTIME_CALLBACKS; ++i) {
+        if (s_runtime_listeners[i].cb) {
+            s_runtime_listeners[i].cb(s_runtime_listeners[i].ctx);
+        }
+    }
+}
+
+static void mark_dirty_locked(change_kind_t kind, int index)
+{
+    if (index >= 0 && index < 32) {
+        s_changes.dirty[kind] |= 1UL << index;
+    }
+}
+
+static void mark_output_dirty_locked(const output_runtime_t *out)
+{
+    mark_dirty_locked(CHANGE_KIND_OUTPUT, (int)(out - s_runtime.outputs));
+}
+
+static void mark_button_dirty_locked(const button_runtime_t *btn)
+{
+    mark_dirty_locked(CHANGE_KIND_BUTTON, (int)(btn - s_runtime.buttons));
+}
+
+static bool commit_changes_locked(void)
+{
+    bool any = false;
+
+    for (int kind = 0; kind < CHANGE_KIND_COUNT; ++kind) {
+        uint32_t dirty = s_changes.dirty[kind];
+        s_changes.dirty[kind] = 0;
+        while (dirty != 0) {
+            int index = __builtin_ctz(dirty);
+            change_entry_t *entry;
+
+            dirty &= dirty - 1;
+            s_changes.seq++;
+            entry = &s_changes.journal[s_changes.seq % MODULES_CHANGE_JOURNAL_LEN];
+            entry->seq = s_changes.seq;
+            entry->kind = (uint8_t)kind;
+            entry->index = (uint8_t)index;
+            any = true;
+        }
     }
+    return any;
+}
+
+static void reset_changes_locked(void)
+{
+    memset(s_changes.dirty, 0, sizeof(s_changes.dirty));
+    s_changes.reset_seq = ++s_changes.seq;
 }
 
 static bool output_uses_plain_gpio(output_type_t type)
@@ -759,28 +1135,28 @@ static const char *cover_state_text_locked(const output_runtime_t *out)
     }
 
     if (out->type == OUTPUT_TYPE_STEPPER_28BYJ) {
-        if (out->cfg.stepper_28byj.homing) {
+        if (out->cfg.stepper_28byj->homing) {
             return "homing";
         }
-        if (out->cfg.stepper_28byj.home_gpio >= 0 && !out->cfg.stepper_28byj.homed) {
+        if (out->cfg.stepper_28byj->home_gpio >= 0 && !out->cfg.stepper_28byj->homed) {
             return "not_homed";
         }
-        if (out->cfg.stepper_28byj.moving) {
-            return (out->cfg.stepper_28byj.target_level >= out->cfg.stepper_28byj.current_level) ?
+        if (out->cfg.stepper_28byj->moving) {
+            return (out->cfg.stepper_28byj->axis.target_level >= out->cfg.stepper_28byj->axis.current_level) ?
                 "opening" : "closing";
         }
         return "stopped";
     }
 
     if (out->type == OUTPUT_TYPE_STEPPER_A4988) {
-        if (out->cfg.stepper_a4988.homing) {
+        if (out->cfg.stepper_a4988->homing) {
             return "homing";
         }
-        if (out->cfg.stepper_a4988.home_gpio >= 0 && !out->cfg.stepper_a4988.homed) {
+        if (out->cfg.stepper_a4988->home_gpio >= 0 && !out->cfg.stepper_a4988->homed) {
             return "not_homed";
         }
-        if (out->cfg.stepper_a4988.moving) {
-            return (out->cfg.stepper_a4988.target_level >= out->cfg.stepper_a4988.current_level) ?
+        if (out->cfg.stepper_a4988->moving) {
+            return (out->cfg.stepper_a4988->axis.target_level >= out->cfg.stepper_a4988->axis.current_level) ?
                 "opening" : "closing";
         }
     }
@@ -864,9 +1240,9 @@ static void clock_4x4094_shift_byte_locked(output_runtime_t *out, uint8_t value)
 {
     for (int bit = 7; bit >= 0; --bit) {
         (void)gpio_set_level((gpio_num_t)out->gpio, (value >> bit) & 0x01);
-        (void)gpio_set_level((gpio_num_t)out->cfg.clock_4x4094.gpio_b, 1);
+        (void)gpio_set_level((gpio_num_t)out->cfg.clock_4x4094->gpio_b, 1);
         esp_rom_delay_us(1);
-        (void)gpio_set_level((gpio_num_t)out->cfg.clock_4x4094.gpio_b, 0);
+        (void)gpio_set_level((gpio_num_t)out->cfg.clock_4x4094->gpio_b, 0);
     }
 }
 
@@ -888,7 +1264,7 @@ static void clock_4x4094_build_display_locked(output_runtime_t *out, int64_t now
         digits[1] = '8';
         digits[2] = '8';
         digits[3] = '8';
-        separator = out->cfg.clock_4x4094.blink_separator;
+        separator = out->cfg.clock_4x4094->blink_separator;
         snprintf(text, 8, "88:88");
         *time_valid = valid;
         *separator_on = separator;
@@ -912,7 +1288,7 @@ static void clock_4x4094_build_display_locked(output_runtime_t *out, int64_t now
         return;
     }
 
-    time_t shifted = time(NULL) + ((time_t)out->cfg.clock_4x4094.timezone_offset_min * 60);
+    time_t shifted = time(NULL) + ((time_t)out->cfg.clock_4x4094->timezone_offset_min * 60);
     struct tm tm_now = {0};
     gmtime_r(&shifted, &tm_now);
 
@@ -920,14 +1296,14 @@ static void clock_4x4094_build_display_locked(output_runtime_t *out, int64_t now
     digits[1] = (char)('0' + (tm_now.tm_hour % 10));
     digits[2] = (char)('0' + (tm_now.tm_min / 10));
     digits[3] = (char)('0' + (tm_now.tm_min % 10));
-    if (!out->cfg.clock_4x4094.leading_zero && tm_now.tm_hour < 10) {
+    if (!out->cfg.clock_4x4094->leading_zero && tm_now.tm_hour < 10) {
         digits[0] = ' ';
     }
 
-    if (!out->cfg.clock_4x4094.blink_separator) {
+    if (!out->cfg.clock_4x4094->blink_separator) {
         separator = true;
     } else {
-        int64_t blink_period_us = (int64_t)out->cfg.clock_4x4094.blink_period_ms * 1000LL;
+        int64_t blink_period_us = (int64_t)out->cfg.clock_4x4094->blink_period_ms * 1000LL;
         int64_t half_period_us = blink_period_us / 2LL;
         if (half_period_us <= 0LL) {
             half_period_us = 1000000LL;
@@ -956,53 +1332,53 @@ static esp_err_t clock_4x4094_apply_state_locked(output_runtime_t *out, int64_t
     clock_4x4094_build_display_locked(out, now_us, digits, text, &time_valid, &separator_on);
 
     for (int i = 0; i < 4; ++i) {
-        int src_index = out->cfg.clock_4x4094.reverse_digits ? (3 - i) : i;
+        int src_index = out->cfg.clock_4x4094->reverse_digits ? (3 - i) : i;
         bool dot = separator_on && i == 2;
         frame[i] = clock_4x4094_encode_char(digits[src_index], dot);
-        if (out->cfg.clock_4x4094.mirror_segments) {
+        if (out->cfg.clock_4x4094->mirror_segments) {
             frame[i] = clock_4x4094_mirror_segments(frame[i]);
         }
-        frame[i] = clock_4x4094_remap_segments(frame[i], out->cfg.clock_4x4094.segment_map);
-        if (out->cfg.clock_4x4094.common_anode) {
+        frame[i] = clock_4x4094_remap_segments(frame[i], out->cfg.clock_4x4094->segment_map);
+        if (out->cfg.clock_4x4094->common_anode) {
             frame[i] = (uint8_t)~frame[i];
         }
-        if (frame[i] != out->cfg.clock_4x4094.segments[i]) {
+        if (frame[i] != out->cfg.clock_4x4094->segments[i]) {
             frame_changed = true;
         }
     }
 
     status_changed = force_render ||
                      frame_changed ||
-                     out->cfg.clock_4x4094.time_valid != time_valid ||
-                     out->cfg.clock_4x4094.separator_on != separator_on ||
-                     strcmp(out->cfg.clock_4x4094.display_text, text) != 0;
+                     out->cfg.clock_4x4094->time_valid != time_valid ||
+                     out->cfg.clock_4x4094->separator_on != separator_on ||
+                     strcmp(out->cfg.clock_4x4094->display_text, text) != 0;
 
     if (frame_changed || force_render) {
-        (void)gpio_set_level((gpio_num_t)out->cfg.clock_4x4094.gpio_c, 0);
+        (void)gpio_set_level((gpio_num_t)out->cfg.clock_4x4094->gpio_c, 0);
         // Bytes are shifted from the furthest register to the nearest one.
         for (int i = 3; i >= 0; --i) {
             clock_4x4094_shift_byte_locked(out, frame[i]);
         }
-        (void)gpio_set_level((gpio_num_t)out->cfg.clock_4x4094.gpio_c, 1);
+        (void)gpio_set_level((gpio_num_t)out->cfg.clock_4x4094->gpio_c, 1);
         esp_rom_delay_us(1);
-        (void)gpio_set_level((gpio_num_t)out->cfg.clock_4x4094.gpio_c, 0);
-        memcpy(out->cfg.clock_4x4094.segments, frame, sizeof(frame));
+        (void)gpio_set_level((gpio_num_t)out->cfg.clock_4x4094->gpio_c, 0);
+        memcpy(out->cfg.clock_4x4094->segments, frame, sizeof(frame));
     }
 
-    out->cfg.clock_4x4094.time_valid = time_valid;
-    out->cfg.clock_4x4094.separator_on = separator_on;
-    snprintf(out->cfg.clock_4x4094.display_text, sizeof(out->cfg.clock_4x4094.display_text), "%s", text);
+    out->cfg.clock_4x4094->time_valid = time_valid;
+    out->cfg.clock_4x4094->separator_on = separator_on;
+    snprintf(out->cfg.clock_4x4094->display_text, sizeof(out->cfg.clock_4x4094->display_text), "%s", text);
     if (time_valid && out->power) {
-        time_t shifted = time(NULL) + ((time_t)out->cfg.clock_4x4094.timezone_offset_min * 60);
+        time_t shifted = time(NULL) + ((time_t)out->cfg.clock_4x4094->timezone_offset_min * 60);
         struct tm tm_now = {0};
         gmtime_r(&shifted, &tm_now);
-        out->cfg.clock_4x4094.display_hour = tm_now.tm_hour;
-        out->cfg.clock_4x4094.display_minute = tm_now.tm_min;
+        out->cfg.clock_4x4094->display_hour = tm_now.tm_hour;
+        out->cfg.clock_4x4094->display_minute = tm_now.tm_min;
     } else {
-        out->cfg.clock_4x4094.display_hour = -1;
-        out->cfg.clock_4x4094.display_minute = -1;
+        out->cfg.clock_4x4094->display_hour = -1;
+        out->cfg.clock_4x4094->display_minute = -1;
     }
-    out->cfg.clock_4x4094.last_render_us = now_us;
+    out->cfg.clock_4x4094->last_render_us = now_us;
 
     return status_changed ? ESP_OK : ESP_ERR_NO_MEM;
 }
@@ -1022,11 +1398,11 @@ static esp_err_t clock_4x4094_apply_brightness_locked(output_runtime_t *out)
     if (!out || out->type != OUTPUT_TYPE_CLOCK_4X4094) {
         return ESP_ERR_INVALID_ARG;
     }
-    if (out->cfg.clock_4x4094.brightness_gpio < 0) {
+    if (out->cfg.clock_4x4094->brightness_gpio < 0) {
         return ESP_OK;
     }
 
-    requested = out->power ? out->cfg.clock_4x4094.level : 0;
+    requested = out->power ? out->cfg.clock_4x4094->level : 0;
     if (requested < 0) {
         requested = 0;
     }
@@ -1035,18 +1411,18 @@ static esp_err_t clock_4x4094_apply_brightness_locked(output_runtime_t *out)
     }
 
     duty = (uint32_t)((requested * (int)max_duty) / 100);
-    ESP_ERROR_CHECK(ledc_set_duty(LEDC_LOW_SPEED_MODE, out->cfg.clock_4x4094.channel, duty));
-    return ledc_update_duty(LEDC_LOW_SPEED_MODE, out->cfg.clock_4x4094.channel);
+    ESP_ERROR_CHECK(ledc_set_duty(LEDC_LOW_SPEED_MODE, out->cfg.clock_4x4094->channel, duty));
+    return ledc_update_duty(LEDC_LOW_SPEED_MODE, out->cfg.clock_4x4094->channel);
 }
 
 static esp_err_t set_pwm_power_relay_locked(output_runtime_t *out, bool on)
 {
-    if (!out || out->type != OUTPUT_TYPE_PWM || out->cfg.pwm.power_relay_gpio < 0) {
+    if (!out || out->type != OUTPUT_TYPE_PWM || out->cfg.pwm->power_relay_gpio < 0) {
         return ESP_OK;
     }
 
-    int level = on ? out->cfg.pwm.power_relay_active_level : (1 - out->cfg.pwm.power_relay_active_level);
-    return gpio_set_level(out->cfg.pwm.power_relay_gpio, level);
+    int level = on ? out->cfg.pwm->power_relay_active_level : (1 - out->cfg.pwm->power_relay_active_level);
+    return gpio_set_level(out->cfg.pwm->power_relay_gpio, level);
 }
 
 static esp_err_t ensure_adc_channel_locked(int gpio, adc_channel_t *out_channel)
@@ -1106,7 +1482,7 @@ static esp_err_t servo_5wire_set_drive_locked(output_runtime_t *out, int logical
         drive = 0;
     }
 
-    if (out->cfg.servo_5wire.reverse_direction) {
+    if (out->cfg.servo_5wire->reverse_direction) {
         drive = -drive;
     }
 
@@ -1119,8 +1495,8 @@ static esp_err_t servo_5wire_set_drive_locked(output_runtime_t *out, int logical
     }
 
     ESP_RETURN_ON_ERROR(gpio_set_level((gpio_num_t)out->gpio, level_a), TAG, "servo a drive failed");
-    ESP_RETURN_ON_ERROR(gpio_set_level((gpio_num_t)out->cfg.servo_5wire.gpio_b, level_b), TAG, "servo b drive failed");
-    out->cfg.servo_5wire.drive_state = logical_direction > 0 ? 1 : (logical_direction < 0 ? -1 : 0);
+    ESP_RETURN_ON_ERROR(gpio_set_level((gpio_num_t)out->cfg.servo_5wire->gpio_b, level_b), TAG, "servo b drive failed");
+    out->cfg.servo_5wire->drive_state = logical_direction > 0 ? 1 : (logical_direction < 0 ? -1 : 0);
     return ESP_OK;
 }
 
@@ -1134,8 +1510,8 @@ static int servo_5wire_feedback_to_level_locked(const output_runtime_t *out, int
         return 0;
     }
 
-    min_raw = out->cfg.servo_5wire.feedback_min_raw;
-    max_raw = out->cfg.servo_5wire.feedback_max_raw;
+    min_raw = out->cfg.servo_5wire->feedback_min_raw;
+    max_raw = out->cfg.servo_5wire->feedback_max_raw;
     if (min_raw == max_raw) {
         return 0;
     }
@@ -1165,20 +1541,20 @@ static esp_err_t servo_5wire_read_feedback_locked(output_runtime_t *out, int *ou
     }
 
     for (int i = 0; i < 4; ++i) {
-        ESP_RETURN_ON_ERROR(adc_oneshot_read(s_runtime.adc.handle, out->cfg.servo_5wire.adc_channel, &raw),
+        ESP_RETURN_ON_ERROR(adc_oneshot_read(s_runtime.adc.handle, out->cfg.servo_5wire->adc_channel, &raw),
                             TAG, "servo feedback read failed");
         sum += raw;
     }
 
     raw = sum / 4;
-    out->cfg.servo_5wire.feedback_raw = raw;
-    out->cfg.servo_5wire.current_level = servo_5wire_feedback_to_level_locked(out, raw);
+    out->cfg.servo_5wire->feedback_raw = raw;
+    out->cfg.servo_5wire->current_level = servo_5wire_feedback_to_level_locked(out, raw);
 
     if (out_raw) {
         *out_raw = raw;
     }
     if (out_level) {
-        *out_level = out->cfg.servo_5wire.current_level;
+        *out_level = out->cfg.servo_5wire->current_level;
     }
     return ESP_OK;
 }
@@ -1193,16 +1569,16 @@ static bool update_servo_3wire_release_locked(output_runtime_t *out, int64_t now
     if (!out->power || out->test_active) {
         return false;
     }
-    if (out->cfg.servo_3wire.hold_power_ms <= 0 || out->cfg.servo_3wire.release_at_us <= 0) {
+    if (out->cfg.servo_3wire->hold_power_ms <= 0 || out->cfg.servo_3wire->release_at_us <= 0) {
         return false;
     }
-    if (now_us < out->cfg.servo_3wire.release_at_us) {
+    if (now_us < out->cfg.servo_3wire->release_at_us) {
         return false;
     }
 
-    out->cfg.servo_3wire.release_at_us = 0;
+    out->cfg.servo_3wire->release_at_us = 0;
     out->power = false;
-    err = ledc_stop(LEDC_LOW_SPEED_MODE, out->cfg.servo_3wire.channel, 0);
+    err = ledc_stop(LEDC_LOW_SPEED_MODE, out->cfg.servo_3wire->channel, 0);
     if (err != ESP_OK) {
         ESP_LOGW(TAG, "servo release failed for %s: %s", out->id, esp_err_to_name(err));
     }
@@ -1223,54 +1599,54 @@ static bool update_servo_5wire_control_locked(output_runtime_t *out, int64_t now
         return false;
     }
 
-    previous_level = out->cfg.servo_5wire.current_level;
-    previous_moving = out->cfg.servo_5wire.moving;
-    previous_timeout = out->cfg.servo_5wire.timed_out;
+    previous_level = out->cfg.servo_5wire->current_level;
+    previous_moving = out->cfg.servo_5wire->moving;
+    previous_timeout = out->cfg.servo_5wire->timed_out;
 
     if (servo_5wire_read_feedback_locked(out, NULL, &current_level) != ESP_OK) {
         (void)servo_5wire_set_drive_locked(out, 0);
-        out->cfg.servo_5wire.moving = false;
+        out->cfg.servo_5wire->moving = false;
         return previous_moving;
     }
 
-    error = out->cfg.servo_5wire.target_level - current_level;
-    if (error > out->cfg.servo_5wire.deadband_pct) {
+    error = out->cfg.servo_5wire->target_level - current_level;
+    if (error > out->cfg.servo_5wire->deadband_pct) {
         direction = 1;
-    } else if (error < -out->cfg.servo_5wire.deadband_pct) {
+    } else if (error < -out->cfg.servo_5wire->deadband_pct) {
         direction = -1;
     }
 
     if (direction == 0) {
         (void)servo_5wire_set_drive_locked(out, 0);
-        out->cfg.servo_5wire.moving = false;
-        out->cfg.servo_5wire.timed_out = false;
-        out->cfg.servo_5wire.drive_started_us = 0;
-    } else if (out->cfg.servo_5wire.timed_out) {
+        out->cfg.servo_5wire->moving = false;
+        out->cfg.servo_5wire->timed_out = false;
+        out->cfg.servo_5wire->drive_started_us = 0;
+    } else if (out->cfg.servo_5wire->timed_out) {
         (void)servo_5wire_set_drive_locked(out, 0);
-        out->cfg.servo_5wire.moving = false;
+        out->cfg.servo_5wire->moving = false;
     } else {
-        if (!out->cfg.servo_5wire.moving || out->cfg.servo_5wire.drive_state != direction) {
-            out->cfg.servo_5wire.drive_started_us = now_us;
-            out->cfg.servo_5wire.timed_out = false;
+        if (!out->cfg.servo_5wire->moving || out->cfg.servo_5wire->drive_state != direction) {
+            out->cfg.servo_5wire->drive_started_us = now_us;
+            out->cfg.servo_5wire->timed_out = false;
         }
 
-        if (out->cfg.servo_5wire.drive_started_us > 0 &&
-            (now_us - out->cfg.servo_5wire.drive_started_us) >= ((int64_t)out->cfg.servo_5wire.move_timeout_ms * 1000LL)) {
+        if (out->cfg.servo_5wire->drive_started_us > 0 &&
+            (now_us - out->cfg.servo_5wire->drive_started_us) >= ((int64_t)out->cfg.servo_5wire->move_timeout_ms * 1000LL)) {
             (void)servo_5wire_set_drive_locked(out, 0);
-            out->cfg.servo_5wire.moving = false;
-            out->cfg.servo_5wire.timed_out = true;
-            out->cfg.servo_5wire.drive_started_us = 0;
+            out->cfg.servo_5wire->moving = false;
+            out->cfg.servo_5wire->timed_out = true;
+            out->cfg.servo_5wire->drive_started_us = 0;
         } else {
             (void)servo_5wire_set_drive_locked(out, direction);
-            out->cfg.servo_5wire.moving = true;
-            out->cfg.servo_5wire.timed_out = false;
+            out->cfg.servo_5wire->moving = true;
+            out->cfg.servo_5wire->timed_out = false;
         }
     }
 
-    changed = previous_level != out->cfg.servo_5wire.current_level ||
-              previous_moving != out->cfg.servo_5wire.moving ||
-              previous_timeout != out->cfg.servo_5wire.timed_out;
-    out->power = out->cfg.servo_5wire.moving;
+    changed = previous_level != out->cfg.servo_5wire->current_level ||
+              previous_moving != out->cfg.servo_5wire->moving ||
+              previous_timeout != out->cfg.servo_5wire->timed_out;
+    out->power = out->cfg.servo_5wire->moving;
     return changed;
 }
 
@@ -1302,6 +1678,117 @@ static int stepper_position_to_level(int position_steps, int steps_range)
     return (position_steps * 100 + (steps_range / 2)) / steps_range;
 }
 
+// GPIO stepping is paced by the poll task, so it keeps the old 1 ms step floor; RMT is hardware timed.
+static void stepper_axis_init_profile(stepper_axis_t *axis, bool hardware_timed)
+{
+    int max_steps_per_sec = axis->speed_steps_per_sec;
+
+    if (!hardware_timed && max_steps_per_sec > MODULES_STEPPER_GPIO_MAX_STEPS_PER_SEC) {
+        max_steps_per_sec = MODULES_STEPPER_GPIO_MAX_STEPS_PER_SEC;
+    }
+    motion_profile_init(&axis->profile, max_steps_per_sec, axis->accel_steps_per_s2);
+}
+
+static bool stepper_axis_busy(const stepper_axis_t *axis)
+{
+    return axis->current_position_steps != axis->target_position_steps || motion_profile_running(&axis->profile);
+}
+
+static void stepper_axis_move_by(stepper_axis_t *axis, int delta_steps)
+{
+    axis->current_position_steps += delta_steps;
+    if (axis->current_position_steps < 0) {
+        axis->current_position_steps = 0;
+    }
+    if (axis->current_position_steps > axis->steps_range) {
+        axis->current_position_steps = axis->steps_range;
+    }
+    axis->current_level = stepper_position_to_level(axis->current_position_steps, axis->steps_range);
+}
+
+// Nearest position the axis can brake to when it has already been commanded up to from_position.
+static int stepper_axis_stop_position(const stepper_axis_t *axis, int from_position)
+{
+    int position = from_position + axis->profile.dir * motion_profile_stop_distance(&axis->profile);
+
+    if (position < 0) {
+        position = 0;
+    }
+    if (position > axis->steps_range) {
+        position = axis->steps_range;
+    }
+    return position;
+}
+
+static void stepper_axis_begin_stop(stepper_axis_t *axis, int from_position)
+{
+    axis->target_position_steps = stepper_axis_stop_position(axis, from_position);
+    axis->target_level = stepper_position_to_level(axis->target_position_steps, axis->steps_range);
+}
+
+// Issues the steps that are due by now_us through driver->step, paced by the axis motion profile.
+static bool stepper_axis_run_locked(output_runtime_t *out, stepper_axis_t *axis, int home_gpio,
+                                    const stepper_driver_t *driver, int64_t now_us)
+{
+    bool changed = false;
+
+    for (int i = 0; i < 64; ++i) {
+        int remaining = axis->target_position_steps - axis->current_position_steps;
+        int64_t interval_us;
+        int dir;
+
+        if (!motion_profile_running(&axis->profile)) {
+            if (remaining == 0) {
+                break;
+            }
+            motion_profile_start(&axis->profile, remaining);
+            axis->last_step_us = 0;
+        }
+        dir = axis->profile.dir;
+        interval_us = motion_profile_interval_us(&axis->profile);
+        if (axis->last_step_us <= 0) {
+            axis->last_step_us = now_us - interval_us;
+        }
+        if (now_us < axis->last_step_us + interval_us) {
+            break;
+        }
+
+        if (home_gpio >= 0 && dir < 0 && driver->home_active(out)) {
+            driver->finish_home(out);
+            changed = true;
+            break;
+        }
+        if (driver->step(out, dir) != ESP_OK) {
+            break;
+        }
+
+        stepper_axis_move_by(axis, dir);
+        axis->last_step_us += interval_us;
+        motion_profile_advance(&axis->profile, (axis->target_position_steps - axis->current_position_steps) * dir);
+        changed = true;
+
+        if (home_gpio >= 0 && dir < 0 && driver->home_active(out)) {
+            driver->finish_home(out);
+            break;
+        }
+    }
+    return changed;
+}
+
+static int64_t stepper_axis_next_deadline(const stepper_axis_t *axis, int home_gpio, int64_t now_us)
+{
+    if (motion_profile_running(&axis->profile) && axis->last_step_us > 0) {
+        return axis->last_step_us + motion_profile_interval_us(&axis->profile);
+    }
+    if (stepper_axis_busy(axis)) {
+        return now_us;
+    }
+    if (home_gpio >= 0) {
+        return now_us + (MODULES_POLL_PERIOD_MS * 1000LL);
+    }
+    return 0;
+}
+
 static esp_err_t stepper_28byj_apply_phase_locked(output_runtime_t *out, int phase_index)
 {
     static const uint8_t k_half_step[8][4] = {
@@ -1325,10 +1812,10 @@ static esp_err_t stepper_28byj_apply_phase_locked(output_runtime_t *out, int pha
     }
 
     ESP_RETURN_ON_ERROR(gpio_set_level((gpio_num_t)out->gpio, k_half_step[phase_index][0]), TAG, "stepper 28byj phase a failed");
-    ESP_RETURN_ON_ERROR(gpio_set_level((gpio_num_t)out->cfg.stepper_28byj.gpio_b, k_half_step[phase_index][1]), TAG, "stepper 28byj phase b failed");
-    ESP_RETURN_ON_ERROR(gpio_set_level((gpio_num_t)out->cfg.stepper_28byj.gpio_c, k_half_step[phase_index][2]), TAG, "stepper 28byj phase c failed");
-    ESP_RETURN_ON_ERROR(gpio_set_level((gpio_num_t)out->cfg.stepper_28byj.gpio_d, k_half_step[phase_index][3]), TAG, "stepper 28byj phase d failed");
-    out->cfg.stepper_28byj.phase_index = phase_index;
+    ESP_RETURN_ON_ERROR(gpio_set_level((gpio_num_t)out->cfg.stepper_28byj->gpio_b, k_half_step[phase_index][1]), TAG, "stepper 28byj phase b failed");
+    ESP_RETURN_ON_ERROR(gpio_set_level((gpio_num_t)out->cfg.stepper_28byj->gpio_c, k_half_step[phase_index][2]), TAG, "stepper 28byj phase c failed");
+    ESP_RETURN_ON_ERROR(gpio_set_level((gpio_num_t)out->cfg.stepper_28byj->gpio_d, k_half_step[phase_index][3]), TAG, "stepper 28byj phase d failed");
+    out->cfg.stepper_28byj->phase_index = phase_index;
     return ESP_OK;
 }
 
@@ -1339,24 +1826,24 @@ static esp_err_t stepper_28byj_release_locked(output_runtime_t *out)
     }
 
     ESP_RETURN_ON_ERROR(gpio_set_level((gpio_num_t)out->gpio, 0), TAG, "stepper 28byj release a failed");
-    ESP_RETURN_ON_ERROR(gpio_set_level((gpio_num_t)out->cfg.stepper_28byj.gpio_b, 0), TAG, "stepper 28byj release b failed");
-    ESP_RETURN_ON_ERROR(gpio_set_level((gpio_num_t)out->cfg.stepper_28byj.gpio_c, 0), TAG, "stepper 28byj release c failed");
-    return gpio_set_level((gpio_num_t)out->cfg.stepper_28byj.gpio_d, 0);
+    ESP_RETURN_ON_ERROR(gpio_set_level((gpio_num_t)out->cfg.stepper_28byj->gpio_b, 0), TAG, "stepper 28byj release b failed");
+    ESP_RETURN_ON_ERROR(gpio_set_level((gpio_num_t)out->cfg.stepper_28byj->gpio_c, 0), TAG, "stepper 28byj release c failed");
+    return gpio_set_level((gpio_num_t)out->cfg.stepper_28byj->gpio_d, 0);
 }
 
 static bool stepper_28byj_home_active_locked(output_runtime_t *out)
 {
     bool active = false;
 
-    if (!out || out->type != OUTPUT_TYPE_STEPPER_28BYJ || out->cfg.stepper_28byj.home_gpio < 0) {
+    if (!out || out->type != OUTPUT_TYPE_STEPPER_28BYJ || out->cfg.stepper_28byj->home_gpio < 0) {
         return false;
     }
 
-    active = gpio_get_level((gpio_num_t)out->cfg.stepper_28byj.home_gpio) != 0;
-    if (out->cfg.stepper_28byj.home_inverted) {
+    active = gpio_get_level((gpio_num_t)out->cfg.stepper_28byj->home_gpio) != 0;
+    if (out->cfg.stepper_28byj->home_inverted) {
         active = !active;
     }
-    out->cfg.stepper_28byj.home_active = active;
+    out->cfg.stepper_28byj->home_active = active;
     return active;
 }
 
@@ -1366,18 +1853,19 @@ static void stepper_28byj_finish_home_locked(output_runtime_t *out)
         return;
     }
 
-    out->cfg.stepper_28byj.current_position_steps = 0;
-    out->cfg.stepper_28byj.target_position_steps = 0;
-    out->cfg.stepper_28byj.current_level = 0;
-    out->cfg.stepper_28byj.target_level = 0;
-    out->cfg.stepper_28byj.last_step_us = 0;
-    out->cfg.stepper_28byj.homing = false;
-    out->cfg.stepper_28byj.homed = true;
-    out->cfg.stepper_28byj.home_active = true;
-    out->cfg.stepper_28byj.moving = false;
+    motion_profile_halt(&out->cfg.stepper_28byj->axis.profile);
+    out->cfg.stepper_28byj->axis.current_position_steps = 0;
+    out->cfg.stepper_28byj->axis.target_position_steps = 0;
+    out->cfg.stepper_28byj->axis.current_level = 0;
+    out->cfg.stepper_28byj->axis.target_level = 0;
+    out->cfg.stepper_28byj->axis.last_step_us = 0;
+    out->cfg.stepper_28byj->homing = false;
+    out->cfg.stepper_28byj->homed = true;
+    out->cfg.stepper_28byj->home_active = true;
+    out->cfg.stepper_28byj->moving = false;
 
-    if (out->cfg.stepper_28byj.hold_enabled) {
-        (void)stepper_28byj_apply_phase_locked(out, out->cfg.stepper_28byj.phase_index);
+    if (out->cfg.stepper_28byj->hold_enabled) {
+        (void)stepper_28byj_apply_phase_locked(out, out->cfg.stepper_28byj->phase_index);
         out->power = true;
     } else {
         (void)stepper_28byj_release_locked(out);
@@ -1390,7 +1878,7 @@ static esp_err_t stepper_28byj_start_home_locked(output_runtime_t *out)
     if (!out || out->type != OUTPUT_TYPE_STEPPER_28BYJ) {
         return ESP_ERR_INVALID_ARG;
     }
-    if (out->cfg.stepper_28byj.home_gpio < 0) {
+    if (out->cfg.stepper_28byj->home_gpio < 0) {
         return ESP_ERR_NOT_SUPPORTED;
     }
 
@@ -1399,12 +1887,12 @@ static esp_err_t stepper_28byj_start_home_locked(output_runtime_t *out)
         return ESP_OK;
     }
 
-    out->cfg.stepper_28byj.homing = true;
-    out->cfg.stepper_28byj.homed = false;
-    out->cfg.stepper_28byj.target_position_steps = 0;
-    out->cfg.stepper_28byj.target_level = 0;
-    out->cfg.stepper_28byj.last_step_us = 0;
-    out->cfg.stepper_28byj.moving = true;
+    out->cfg.stepper_28byj->homing = true;
+    out->cfg.stepper_28byj->homed = false;
+    out->cfg.stepper_28byj->axis.target_position_steps = 0;
+    out->cfg.stepper_28byj->axis.target_level = 0;
+    out->cfg.stepper_28byj->axis.last_step_us = 0;
+    out->cfg.stepper_28byj->moving = true;
     out->power = true;
     return ESP_OK;
 }
@@ -1415,16 +1903,22 @@ static esp_err_t stepper_28byj_stop_locked(output_runtime_t *out)
         return ESP_ERR_INVALID_ARG;
     }
 
-    out->cfg.stepper_28byj.homing = false;
-    out->cfg.stepper_28byj.target_position_steps = out->cfg.stepper_28byj.current_position_steps;
-    out->cfg.stepper_28byj.target_level = out->cfg.stepper_28byj.current_level;
-    out->cfg.stepper_28byj.moving = false;
-    out->cfg.stepper_28byj.last_step_us = 0;
-    out->power = out->cfg.stepper_28byj.hold_enabled;
-    if (!out->cfg.stepper_28byj.hold_enabled) {
+    if (motion_profile_running(&out->cfg.stepper_28byj->axis.profile)) {
+        out->cfg.stepper_28byj->homing = false;
+        stepper_axis_begin_stop(&out->cfg.stepper_28byj->axis, out->cfg.stepper_28byj->axis.current_position_steps);
+        return ESP_OK;
+    }
+
+    out->cfg.stepper_28byj->homing = false;
+    out->cfg.stepper_28byj->axis.target_position_steps = out->cfg.stepper_28byj->axis.current_position_steps;
+    out->cfg.stepper_28byj->axis.target_level = out->cfg.stepper_28byj->axis.current_level;
+    out->cfg.stepper_28byj->moving = false;
+    out->cfg.stepper_28byj->axis.last_step_us = 0;
+    out->power = out->cfg.stepper_28byj->hold_enabled;
+    if (!out->cfg.stepper_28byj->hold_enabled) {
         return stepper_28byj_release_locked(out);
     }
-    return stepper_28byj_apply_phase_locked(out, out->cfg.stepper_28byj.phase_index);
+    return stepper_28byj_apply_phase_locked(out, out->cfg.stepper_28byj->phase_index);
 }
 
 static esp_err_t stepper_a4988_set_enable_locked(output_runtime_t *out, bool enabled)
@@ -1432,210 +1926,422 @@ static esp_err_t stepper_a4988_set_enable_locked(output_runtime_t *out, bool ena
     if (!out || out->type != OUTPUT_TYPE_STEPPER_A4988) {
         return ESP_ERR_INVALID_ARG;
     }
-    if (out->cfg.stepper_a4988.gpio_c < 0) {
+    if (out->cfg.stepper_a4988->gpio_c < 0) {
         return ESP_OK;
     }
-    return gpio_set_level((gpio_num_t)out->cfg.stepper_a4988.gpio_c,
-                          enabled ? out->cfg.stepper_a4988.enable_active_level
-                                  : (1 - out->cfg.stepper_a4988.enable_active_level));
+    return gpio_set_level((gpio_num_t)out->cfg.stepper_a4988->gpio_c,
+                          enabled ? out->cfg.stepper_a4988->enable_active_level
+                                  : (1 - out->cfg.stepper_a4988->enable_active_level));
 }
 
-static esp_err_t stepper_a4988_step_locked(output_runtime_t *out, int logical_direction)
+static esp_err_t stepper_a4988_set_direction_locked(output_runtime_t *out, int logical_direction)
 {
-    int dir_level;
+    int dir_level = logical_direction > 0 ? 1 : 0;
 
-    if (!out || out->type != OUTPUT_TYPE_STEPPER_A4988 || logical_direction == 0) {
-        return ESP_ERR_INVALID_ARG;
+    if (out->cfg.stepper_a4988->reverse_direction) {
+        dir_level = 1 - dir_level;
     }
+    return gpio_set_level((gpio_num_t)out->cfg.stepper_a4988->gpio_b, dir_level);
+}
 
-    dir_level = logical_direction > 0 ? 1 : 0;
-    if (out->cfg.stepper_a4988.reverse_direction) {
-        dir_level = 1 - dir_level;
+static esp_err_t stepper_a4988_step_locked(output_runtime_t *out, int logical_direction)
+{
+    if (!out || out->type != OUTPUT_TYPE_STEPPER_A4988 || logical_direction == 0) {
+        return ESP_ERR_INVALID_ARG;
     }
 
-    ESP_RETURN_ON_ERROR(gpio_set_level((gpio_num_t)out->cfg.stepper_a4988.gpio_b, dir_level), TAG, "stepper a4988 dir failed");
+    ESP_RETURN_ON_ERROR(stepper_a4988_set_direction_locked(out, logical_direction), TAG, "stepper a4988 dir failed");
     ESP_RETURN_ON_ERROR(stepper_a4988_set_enable_locked(out, true), TAG, "stepper a4988 enable failed");
     ESP_RETURN_ON_ERROR(gpio_set_level((gpio_num_t)out->gpio, 1), TAG, "stepper a4988 step high failed");
-    esp_rom_delay_us((uint32_t)out->cfg.stepper_a4988.step_pulse_us);
+    esp_rom_delay_us((uint32_t)out->cfg.stepper_a4988->step_pulse_us);
     ESP_RETURN_ON_ERROR(gpio_set_level((gpio_num_t)out->gpio, 0), TAG, "stepper a4988 step low failed");
-    esp_rom_delay_us((uint32_t)out->cfg.stepper_a4988.step_pulse_us);
+    esp_rom_delay_us((uint32_t)out->cfg.stepper_a4988->step_pulse_us);
     return ESP_OK;
 }
 
-static bool stepper_a4988_home_active_locked(output_runtime_t *out)
+// Runs in ISR context: account the finished batch and let the poll task plan the next one.
+static bool stepper_a4988_rmt_done_cb(rmt_channel_handle_t channel, const rmt_tx_done_event_data_t *edata, void *user_ctx)
 {
-    bool active = false;
+    output_runtime_t *out = (output_runtime_t *)user_ctx;
+    BaseType_t woken = pdFALSE;
 
-    if (!out || out->type != OUTPUT_TYPE_STEPPER_A4988 || out->cfg.stepper_a4988.home_gpio < 0) {
-        return false;
+    (void)channel;
+    (void)edata;
+
+    portENTER_CRITICAL_ISR(&s_isr_mux);
+    if (out->cfg.stepper_a4988->rmt_inflight > 0) {
+        out->cfg.stepper_a4988->rmt_done_steps += out->cfg.stepper_a4988->rmt_batch_steps[out->cfg.stepper_a4988->rmt_head];
+        out->cfg.stepper_a4988->rmt_head ^= 1;
+        out->cfg.stepper_a4988->rmt_inflight--;
     }
+    s_sched_kick_mask |= 1UL << (uint32_t)(out - s_runtime.outputs);
+    portEXIT_CRITICAL_ISR(&s_isr_mux);
 
-    active = gpio_get_level((gpio_num_t)out->cfg.stepper_a4988.home_gpio) != 0;
-    if (out->cfg.stepper_a4988.home_inverted) {
-        active = !active;
+    if (s_poll_task) {
+        vTaskNotifyGiveFromISR(s_poll_task, &woken);
     }
-    out->cfg.stepper_a4988.home_active = active;
-    return active;
+    return woken == pdTRUE;
 }
 
-static void stepper_a4988_finish_home_locked(output_runtime_t *out)
+static void stepper_a4988_rmt_deinit(output_runtime_t *out)
 {
-    if (!out || out->type != OUTPUT_TYPE_STEPPER_A4988) {
-        return;
+    if (out->cfg.stepper_a4988->rmt_chan) {
+        (void)rmt_disable(out->cfg.stepper_a4988->rmt_chan);
+        (void)rmt_del_channel(out->cfg.stepper_a4988->rmt_chan);
+        out->cfg.stepper_a4988->rmt_chan = NULL;
     }
-
-    out->cfg.stepper_a4988.current_position_steps = 0;
-    out->cfg.stepper_a4988.target_position_steps = 0;
-    out->cfg.stepper_a4988.current_level = 0;
-    out->cfg.stepper_a4988.target_level = 0;
-    out->cfg.stepper_a4988.last_step_us = 0;
-    out->cfg.stepper_a4988.homing = false;
-    out->cfg.stepper_a4988.homed = true;
-    out->cfg.stepper_a4988.home_active = true;
-    out->cfg.stepper_a4988.moving = false;
-
-    if (out->cfg.stepper_a4988.hold_enabled) {
-        (void)stepper_a4988_set_enable_locked(out, true);
-        out->power = true;
-    } else {
-        (void)stepper_a4988_set_enable_locked(out, false);
-        out->power = false;
+    if (out->cfg.stepper_a4988->rmt_encoder) {
+        (void)rmt_del_encoder(out->cfg.stepper_a4988->rmt_encoder);
+        out->cfg.stepper_a4988->rmt_encoder = NULL;
     }
+    free(out->cfg.stepper_a4988->rmt_symbols);
+    out->cfg.stepper_a4988->rmt_symbols = NULL;
 }
 
-static esp_err_t stepper_a4988_start_home_locked(output_runtime_t *out)
+static esp_err_t stepper_a4988_rmt_init(output_runtime_t *out)
 {
-    if (!out || out->type != OUTPUT_TYPE_STEPPER_A4988) {
-        return ESP_ERR_INVALID_ARG;
+    rmt_tx_channel_config_t tx_cfg = {
+        .gpio_num = out->gpio,
+        .clk_src = RMT_CLK_SRC_DEFAULT,
+        .resolution_hz = MODULES_A4988_RMT_RESOLUTION_HZ,
+        .mem_block_symbols = SOC_RMT_MEM_WORDS_PER_CHANNEL,
+        .trans_queue_depth = 4,
+    };
+    rmt_copy_encoder_config_t encoder_cfg = {0};
+    rmt_tx_event_callbacks_t cbs = {
+        .on_trans_done = stepper_a4988_rmt_done_cb,
+    };
+    esp_err_t err;
+
+    out->cfg.stepper_a4988->rmt_symbols = calloc(2 * MODULES_A4988_RMT_BATCH_SYMBOLS, sizeof(rmt_symbol_word_t));
+    if (!out->cfg.stepper_a4988->rmt_symbols) {
+        return ESP_ERR_NO_MEM;
     }
-    if (out->cfg.stepper_a4988.home_gpio < 0) {
-        return ESP_ERR_NOT_SUPPORTED;
+    err = rmt_new_tx_channel(&tx_cfg, &out->cfg.stepper_a4988->rmt_chan);
+    if (err == ESP_OK) {
+        err = rmt_new_copy_encoder(&encoder_cfg, &out->cfg.stepper_a4988->rmt_encoder);
     }
-
-    if (stepper_a4988_home_active_locked(out)) {
-        stepper_a4988_finish_home_locked(out);
-        return ESP_OK;
+    if (err == ESP_OK) {
+        err = rmt_tx_register_event_callbacks(out->cfg.stepper_a4988->rmt_chan, &cbs, out);
     }
-
-    out->cfg.stepper_a4988.homing = true;
-    out->cfg.stepper_a4988.homed = false;
-    out->cfg.stepper_a4988.target_position_steps = 0;
-    out->cfg.stepper_a4988.target_level = 0;
-    out->cfg.stepper_a4988.last_step_us = 0;
-    out->cfg.stepper_a4988.moving = true;
-    out->power = true;
+    if (err == ESP_OK) {
+        err = rmt_enable(out->cfg.stepper_a4988->rmt_chan);
+    }
+    if (err != ESP_OK) {
+        stepper_a4988_rmt_deinit(out);
+        return err;
+    }
+    out->cfg.stepper_a4988->rmt_planned_steps = out->cfg.stepper_a4988->axis.current_position_steps;
     return ESP_OK;
 }
 
-static esp_err_t stepper_a4988_stop_locked(output_runtime_t *out)
+static bool stepper_a4988_rmt_commit_locked(output_runtime_t *out)
 {
-    if (!out || out->type != OUTPUT_TYPE_STEPPER_A4988) {
-        return ESP_ERR_INVALID_ARG;
-    }
+    int done_steps;
 
-    out->cfg.stepper_a4988.homing = false;
-    out->cfg.stepper_a4988.target_position_steps = out->cfg.stepper_a4988.current_position_steps;
-    out->cfg.stepper_a4988.target_level = out->cfg.stepper_a4988.current_level;
-    out->cfg.stepper_a4988.moving = false;
-    out->cfg.stepper_a4988.last_step_us = 0;
-    out->power = out->cfg.stepper_a4988.hold_enabled;
-    return stepper_a4988_set_enable_locked(out, out->cfg.stepper_a4988.hold_enabled);
+    portENTER_CRITICAL(&s_isr_mux);
+    done_steps = out->cfg.stepper_a4988->rmt_done_steps;
+    out->cfg.stepper_a4988->rmt_done_steps = 0;
+    portEXIT_CRITICAL(&s_isr_mux);
+
+    if (done_steps == 0) {
+        return false;
+    }
+    stepper_axis_move_by(&out->cfg.stepper_a4988->axis, done_steps);
+    return true;
 }
 
-static bool update_stepper_28byj_control_locked(output_runtime_t *out, int64_t now_us)
+// Drops queued pulses; steps already emitted by a cut-short batch are lost, so only use this where the
+// position is re-established anyway (homing) or the channel is going away.
+static void stepper_a4988_rmt_abort_locked(output_runtime_t *out)
 {
-    bool changed = false;
-    bool previous_home_active;
-    bool previous_homing;
-    bool previous_homed;
-    bool previous_moving;
-    int speed;
-    int64_t step_interval_us;
-    int steps_due = 0;
-
-    if (!out || out->type != OUTPUT_TYPE_STEPPER_28BYJ || !out->enabled || !out->supported) {
-        return false;
+    if (!out->cfg.stepper_a4988->rmt_chan) {
+        return;
     }
 
-    previous_home_active = out->cfg.stepper_28byj.home_active;
-    previous_homing = out->cfg.stepper_28byj.homing;
-    previous_homed = out->cfg.stepper_28byj.homed;
-    previous_moving = out->cfg.stepper_28byj.moving;
+    (void)rmt_disable(out->cfg.stepper_a4988->rmt_chan);
+    portENTER_CRITICAL(&s_isr_mux);
+    out->cfg.stepper_a4988->rmt_inflight = 0;
+    out->cfg.stepper_a4988->rmt_head = 0;
+    portEXIT_CRITICAL(&s_isr_mux);
+    (void)stepper_a4988_rmt_commit_locked(out);
+    motion_profile_halt(&out->cfg.stepper_a4988->axis.profile);
+    out->cfg.stepper_a4988->rmt_planned_steps = out->cfg.stepper_a4988->axis.current_position_steps;
+    (void)rmt_enable(out->cfg.stepper_a4988->rmt_chan);
+}
 
-    if (out->cfg.stepper_28byj.home_gpio >= 0 && stepper_28byj_home_active_locked(out)) {
-        if (out->cfg.stepper_28byj.homing ||
-            (out->cfg.stepper_28byj.current_position_steps > 0 &&
-             out->cfg.stepper_28byj.target_position_steps <= out->cfg.stepper_28byj.current_position_steps)) {
-            stepper_28byj_finish_home_locked(out);
-        } else {
-            out->cfg.stepper_28byj.homed = true;
-        }
+static bool stepper_a4988_busy_locked(const output_runtime_t *out)
+{
+    if (stepper_axis_busy(&out->cfg.stepper_a4988->axis)) {
+        return true;
     }
+    return out->cfg.stepper_a4988->rmt_chan &&
+           (out->cfg.stepper_a4988->rmt_inflight > 0 ||
+            out->cfg.stepper_a4988->rmt_planned_steps != out->cfg.stepper_a4988->axis.current_position_steps);
+}
 
-    speed = out->cfg.stepper_28byj.speed_steps_per_sec;
-    if (speed < 1) {
-        speed = 1;
+static bool stepper_a4988_rmt_can_plan_locked(const output_runtime_t *out)
+{
+    int remaining = out->cfg.stepper_a4988->axis.target_position_steps - out->cfg.stepper_a4988->rmt_planned_steps;
+
+    if (!out->cfg.stepper_a4988->rmt_chan || out->cfg.stepper_a4988->rmt_inflight >= 2) {
+        return false;
+    }
+    if (motion_profile_running(&out->cfg.stepper_a4988->axis.profile)) {
+        return true;
     }
-    step_interval_us = 1000000LL / speed;
-    if (step_interval_us < 1000LL) {
-        step_interval_us = 1000LL;
+    if (remaining == 0) {
+        return false;
     }
+    // DIR may only flip once the pulses already queued for the old direction are out.
+    return out->cfg.stepper_a4988->rmt_inflight == 0 || (remaining > 0 ? 1 : -1) == out->cfg.stepper_a4988->axis.profile.dir;
+}
 
-    if (out->cfg.stepper_28byj.current_position_steps != out->cfg.stepper_28byj.target_position_steps) {
-        if (out->cfg.stepper_28byj.last_step_us <= 0) {
-            out->cfg.stepper_28byj.last_step_us = now_us - step_interval_us;
-        }
-        if (now_us >= out->cfg.stepper_28byj.last_step_us + step_interval_us) {
-            steps_due = (int)((now_us - out->cfg.stepper_28byj.last_step_us) / step_interval_us);
-            if (steps_due < 1) {
-                steps_due = 1;
-            }
-            if (steps_due > 64) {
-                steps_due = 64;
+static int stepper_a4988_rmt_encode_step(rmt_symbol_word_t *symbols, uint32_t interval_us, uint32_t pulse_us)
+{
+    uint32_t low_us = interval_us - pulse_us;
+    uint32_t first_low_us = low_us > 32767U ? 32767U : low_us;
+    int count = 0;
+
+    symbols[count++] = (rmt_symbol_word_t){
+        .level0 = 1,
+        .duration0 = pulse_us,
+        .level1 = 0,
+        .duration1 = first_low_us,
+    };
+    low_us -= first_low_us;
+    // A zero duration terminates the frame, so a 1 us leftover is simply dropped.
+    while (low_us >= 2) {
+        uint32_t chunk_us = low_us > 65534U ? 65534U : low_us;
+        symbols[count++] = (rmt_symbol_word_t){
+            .level0 = 0,
+            .duration0 = chunk_us / 2,
+            .level1 = 0,
+            .duration1 = chunk_us - chunk_us / 2,
+        };
+        low_us -= chunk_us;
+    }
+    return count;
+}
+
+// Queues the next batch of the axis motion profile, continuing from the last planned position.
+static bool stepper_a4988_rmt_plan_locked(output_runtime_t *out)
+{
+    motion_profile_t *profile = &out->cfg.stepper_a4988->axis.profile;
+    uint32_t pulse_us = (uint32_t)out->cfg.stepper_a4988->step_pulse_us;
+    int remaining = out->cfg.stepper_a4988->axis.target_position_steps - out->cfg.stepper_a4988->rmt_planned_steps;
+    rmt_transmit_config_t tx_cfg = {
+        .loop_count = 0,
+    };
+    rmt_symbol_word_t *symbols;
+    int64_t window_us;
+    int64_t elapsed_us = 0;
+    int symbol_count = 0;
+    int steps = 0;
+    int dir;
+    int buffer;
+    esp_err_t err;
+
+    if (!motion_profile_running(profile)) {
+        if (remaining == 0) {
+            return false;
+        }
+        dir = remaining > 0 ? 1 : -1;
+        if (dir != profile->dir) {
+            if (out->cfg.stepper_a4988->rmt_inflight > 0 ||
+                stepper_a4988_set_direction_locked(out, dir) != ESP_OK) {
+                return false;
             }
         }
+        motion_profile_start(profile, dir);
     }
+    dir = profile->dir;
+    (void)stepper_a4988_set_enable_locked(out, true);
 
-    while (steps_due-- > 0 &&
-           out->cfg.stepper_28byj.current_position_steps != out->cfg.stepper_28byj.target_position_steps) {
-        int logical_direction = (out->cfg.stepper_28byj.target_position_steps > out->cfg.stepper_28byj.current_position_steps) ? 1 : -1;
-        int phase_delta = out->cfg.stepper_28byj.reverse_direction ? -logical_direction : logical_direction;
-        int next_phase = out->cfg.stepper_28byj.phase_index + phase_delta;
+    window_us = (out->cfg.stepper_a4988->home_gpio >= 0 && dir < 0) ? MODULES_A4988_RMT_HOME_BATCH_US
+                                                                    : MODULES_A4988_RMT_BATCH_US;
+    portENTER_CRITICAL(&s_isr_mux);
+    buffer = (out->cfg.stepper_a4988->rmt_head + out->cfg.stepper_a4988->rmt_inflight) & 1;
+    portEXIT_CRITICAL(&s_isr_mux);
+    symbols = &out->cfg.stepper_a4988->rmt_symbols[buffer * MODULES_A4988_RMT_BATCH_SYMBOLS];
 
-        if (out->cfg.stepper_28byj.home_gpio >= 0 && logical_direction < 0 && stepper_28byj_home_active_locked(out)) {
-            stepper_28byj_finish_home_locked(out);
-            changed = true;
-            break;
-        }
+    while (motion_profile_running(profile) && elapsed_us < window_us &&
+           symbol_count + 4 <= MODULES_A4988_RMT_BATCH_SYMBOLS) {
+        uint32_t interval_us = motion_profile_interval_us(profile);
 
-        if (stepper_28byj_apply_phase_locked(out, next_phase) != ESP_OK) {
-            break;
-        }
+        symbol_count += stepper_a4988_rmt_encode_step(&symbols[symbol_count], interval_us, pulse_us);
+        steps++;
+        elapsed_us += interval_us;
+        motion_profile_advance(profile, (out->cfg.stepper_a4988->axis.target_position_steps -
+                                         (out->cfg.stepper_a4988->rmt_planned_steps + steps * dir)) * dir);
+    }
 
-        out->cfg.stepper_28byj.current_position_steps += logical_direction;
-        if (out->cfg.stepper_28byj.current_position_steps < 0) {
-            out->cfg.stepper_28byj.current_position_steps = 0;
-        }
-        if (out->cfg.stepper_28byj.current_position_steps > out->cfg.stepper_28byj.steps_range) {
-            out->cfg.stepper_28byj.current_position_steps = out->cfg.stepper_28byj.steps_range;
-        }
-        out->cfg.stepper_28byj.current_level =
-            stepper_position_to_level(out->cfg.stepper_28byj.current_position_steps, out->cfg.stepper_28byj.steps_range);
-        out->cfg.stepper_28byj.last_step_us += step_interval_us;
-        changed = true;
+    portENTER_CRITICAL(&s_isr_mux);
+    out->cfg.stepper_a4988->rmt_batch_steps[buffer] = steps * dir;
+    out->cfg.stepper_a4988->rmt_inflight++;
+    portEXIT_CRITICAL(&s_isr_mux);
+
+    err = rmt_transmit(out->cfg.stepper_a4988->rmt_chan, out->cfg.stepper_a4988->rmt_encoder, symbols,
+                       (size_t)symbol_count * sizeof(rmt_symbol_word_t), &tx_cfg);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "A4988 %s pulse batch failed: %s", out->id, esp_err_to_name(err));
+        portENTER_CRITICAL(&s_isr_mux);
+        out->cfg.stepper_a4988->rmt_inflight--;
+        portEXIT_CRITICAL(&s_isr_mux);
+        stepper_a4988_rmt_abort_locked(out);
+        out->cfg.stepper_a4988->axis.target_position_steps = out->cfg.stepper_a4988->axis.current_position_steps;
+        out->cfg.stepper_a4988->axis.target_level = out->cfg.stepper_a4988->axis.current_level;
+        return false;
+    }
+    out->cfg.stepper_a4988->rmt_planned_steps += steps * dir;
+    return true;
+}
+
+static bool stepper_a4988_home_active_locked(output_runtime_t *out)
+{
+    bool active = false;
+
+    if (!out || out->type != OUTPUT_TYPE_STEPPER_A4988 || out->cfg.stepper_a4988->home_gpio < 0) {
+        return false;
+    }
+
+    active = gpio_get_level((gpio_num_t)out->cfg.stepper_a4988->home_gpio) != 0;
+    if (out->cfg.stepper_a4988->home_inverted) {
+        active = !active;
+    }
+    out->cfg.stepper_a4988->home_active = active;
+    return active;
+}
+
+static void stepper_a4988_finish_home_locked(output_runtime_t *out)
+{
+    if (!out || out->type != OUTPUT_TYPE_STEPPER_A4988) {
+        return;
+    }
+
+    stepper_a4988_rmt_abort_locked(out);
+    motion_profile_halt(&out->cfg.stepper_a4988->axis.profile);
+    out->cfg.stepper_a4988->axis.current_position_steps = 0;
+    out->cfg.stepper_a4988->axis.target_position_steps = 0;
+    out->cfg.stepper_a4988->rmt_planned_steps = 0;
+    out->cfg.stepper_a4988->axis.current_level = 0;
+    out->cfg.stepper_a4988->axis.target_level = 0;
+    out->cfg.stepper_a4988->axis.last_step_us = 0;
+    out->cfg.stepper_a4988->homing = false;
+    out->cfg.stepper_a4988->homed = true;
+    out->cfg.stepper_a4988->home_active = true;
+    out->cfg.stepper_a4988->moving = false;
+
+    if (out->cfg.stepper_a4988->hold_enabled) {
+        (void)stepper_a4988_set_enable_locked(out, true);
+        out->power = true;
+    } else {
+        (void)stepper_a4988_set_enable_locked(out, false);
+        out->power = false;
+    }
+}
+
+static esp_err_t stepper_a4988_start_home_locked(output_runtime_t *out)
+{
+    if (!out || out->type != OUTPUT_TYPE_STEPPER_A4988) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (out->cfg.stepper_a4988->home_gpio < 0) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    if (stepper_a4988_home_active_locked(out)) {
+        stepper_a4988_finish_home_locked(out);
+        return ESP_OK;
+    }
+
+    out->cfg.stepper_a4988->homing = true;
+    out->cfg.stepper_a4988->homed = false;
+    out->cfg.stepper_a4988->axis.target_position_steps = 0;
+    out->cfg.stepper_a4988->axis.target_level = 0;
+    out->cfg.stepper_a4988->axis.last_step_us = 0;
+    out->cfg.stepper_a4988->moving = true;
+    out->power = true;
+    return ESP_OK;
+}
+
+static esp_err_t stepper_a4988_stop_locked(output_runtime_t *out)
+{
+    if (!out || out->type != OUTPUT_TYPE_STEPPER_A4988) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (motion_profile_running(&out->cfg.stepper_a4988->axis.profile)) {
+        // Ramp down instead of cutting the pulse train; with RMT the hardware is ahead of current_position_steps.
+        out->cfg.stepper_a4988->homing = false;
+        stepper_axis_begin_stop(&out->cfg.stepper_a4988->axis,
+                                out->cfg.stepper_a4988->rmt_chan ? out->cfg.stepper_a4988->rmt_planned_steps
+                                                                : out->cfg.stepper_a4988->axis.current_position_steps);
+        return ESP_OK;
+    }
+
+    out->cfg.stepper_a4988->homing = false;
+    out->cfg.stepper_a4988->axis.target_position_steps = out->cfg.stepper_a4988->axis.current_position_steps;
+    out->cfg.stepper_a4988->axis.target_level = out->cfg.stepper_a4988->axis.current_level;
+    out->cfg.stepper_a4988->moving = false;
+    out->cfg.stepper_a4988->axis.last_step_us = 0;
+    out->power = out->cfg.stepper_a4988->hold_enabled;
+    return stepper_a4988_set_enable_locked(out, out->cfg.stepper_a4988->hold_enabled);
+}
+
+static esp_err_t stepper_28byj_step_locked(output_runtime_t *out, int logical_direction)
+{
+    int phase_delta = out->cfg.stepper_28byj->reverse_direction ? -logical_direction : logical_direction;
+
+    return stepper_28byj_apply_phase_locked(out, out->cfg.stepper_28byj->phase_index + phase_delta);
+}
+
+static const stepper_driver_t k_stepper_28byj_driver = {
+    .step = stepper_28byj_step_locked,
+    .home_active = stepper_28byj_home_active_locked,
+    .finish_home = stepper_28byj_finish_home_locked,
+};
+
+static const stepper_driver_t k_stepper_a4988_driver = {
+    .step = stepper_a4988_step_locked,
+    .home_active = stepper_a4988_home_active_locked,
+    .finish_home = stepper_a4988_finish_home_locked,
+};
+
+static bool update_stepper_28byj_control_locked(output_runtime_t *out, int64_t now_us)
+{
+    bool changed = false;
+    bool previous_home_active;
+    bool previous_homing;
+    bool previous_homed;
+    bool previous_moving;
+
+    if (!out || out->type != OUTPUT_TYPE_STEPPER_28BYJ || !out->enabled || !out->supported) {
+        return false;
+    }
+
+    previous_home_active = out->cfg.stepper_28byj->home_active;
+    previous_homing = out->cfg.stepper_28byj->homing;
+    previous_homed = out->cfg.stepper_28byj->homed;
+    previous_moving = out->cfg.stepper_28byj->moving;
 
-        if (out->cfg.stepper_28byj.home_gpio >= 0 && logical_direction < 0 && stepper_28byj_home_active_locked(out)) {
+    if (out->cfg.stepper_28byj->home_gpio >= 0 && stepper_28byj_home_active_locked(out)) {
+        if (out->cfg.stepper_28byj->homing ||
+            (out->cfg.stepper_28byj->axis.current_position_steps > 0 &&
+             out->cfg.stepper_28byj->axis.target_position_steps <= out->cfg.stepper_28byj->axis.current_position_steps)) {
             stepper_28byj_finish_home_locked(out);
-            break;
+        } else {
+            out->cfg.stepper_28byj->homed = true;
         }
     }
 
-    out->cfg.stepper_28byj.moving =
-        out->cfg.stepper_28byj.current_position_steps != out->cfg.stepper_28byj.target_position_steps;
+    changed = stepper_axis_run_locked(out, &out->cfg.stepper_28byj->axis, out->cfg.stepper_28byj->home_gpio,
+                                      &k_stepper_28byj_driver, now_us);
+    out->cfg.stepper_28byj->moving = stepper_axis_busy(&out->cfg.stepper_28byj->axis);
 
-    if (!out->cfg.stepper_28byj.moving) {
-        if (out->cfg.stepper_28byj.hold_enabled) {
-            (void)stepper_28byj_apply_phase_locked(out, out->cfg.stepper_28byj.phase_index);
+    if (!out->cfg.stepper_28byj->moving) {
+        if (out->cfg.stepper_28byj->hold_enabled) {
+            (void)stepper_28byj_apply_phase_locked(out, out->cfg.stepper_28byj->phase_index);
             out->power = true;
         } else {
             (void)stepper_28byj_release_locked(out);
@@ -1646,10 +2352,10 @@ static bool update_stepper_28byj_control_locked(output_runtime_t *out, int64_t n
     }
 
     changed = changed ||
-              previous_home_active != out->cfg.stepper_28byj.home_active ||
-              previous_homing != out->cfg.stepper_28byj.homing ||
-              previous_homed != out->cfg.stepper_28byj.homed ||
-              previous_moving != out->cfg.stepper_28byj.moving;
+              previous_home_active != out->cfg.stepper_28byj->home_active ||
+              previous_homing != out->cfg.stepper_28byj->homing ||
+              previous_homed != out->cfg.stepper_28byj->homed ||
+              previous_moving != out->cfg.stepper_28byj->moving;
 
     return changed;
 }
@@ -1661,90 +2367,42 @@ static bool update_stepper_a4988_control_locked(output_runtime_t *out, int64_t n
     bool previous_homing;
     bool previous_homed;
     bool previous_moving;
-    int speed;
-    int64_t step_interval_us;
-    int steps_due = 0;
 
     if (!out || out->type != OUTPUT_TYPE_STEPPER_A4988 || !out->enabled || !out->supported) {
         return false;
     }
 
-    previous_home_active = out->cfg.stepper_a4988.home_active;
-    previous_homing = out->cfg.stepper_a4988.homing;
-    previous_homed = out->cfg.stepper_a4988.homed;
-    previous_moving = out->cfg.stepper_a4988.moving;
-
-    if (out->cfg.stepper_a4988.home_gpio >= 0 && stepper_a4988_home_active_locked(out)) {
-        if (out->cfg.stepper_a4988.homing ||
-            (out->cfg.stepper_a4988.current_position_steps > 0 &&
-             out->cfg.stepper_a4988.target_position_steps <= out->cfg.stepper_a4988.current_position_steps)) {
-            stepper_a4988_finish_home_locked(out);
-        } else {
-            out->cfg.stepper_a4988.homed = true;
-        }
-    }
-
-    speed = out->cfg.stepper_a4988.speed_steps_per_sec;
-    if (speed < 1) {
-        speed = 1;
-    }
-    step_interval_us = 1000000LL / speed;
-    if (step_interval_us < 1000LL) {
-        step_interval_us = 1000LL;
-    }
+    previous_home_active = out->cfg.stepper_a4988->home_active;
+    previous_homing = out->cfg.stepper_a4988->homing;
+    previous_homed = out->cfg.stepper_a4988->homed;
+    previous_moving = out->cfg.stepper_a4988->moving;
 
-    if (out->cfg.stepper_a4988.current_position_steps != out->cfg.stepper_a4988.target_position_steps) {
-        if (out->cfg.stepper_a4988.last_step_us <= 0) {
-            out->cfg.stepper_a4988.last_step_us = now_us - step_interval_us;
-        }
-        if (now_us >= out->cfg.stepper_a4988.last_step_us + step_interval_us) {
-            steps_due = (int)((now_us - out->cfg.stepper_a4988.last_step_us) / step_interval_us);
-            if (steps_due < 1) {
-                steps_due = 1;
-            }
-            if (steps_due > 64) {
-                steps_due = 64;
-            }
-        }
+    if (out->cfg.stepper_a4988->rmt_chan) {
+        changed = stepper_a4988_rmt_commit_locked(out);
     }
 
-    while (steps_due-- > 0 &&
-           out->cfg.stepper_a4988.current_position_steps != out->cfg.stepper_a4988.target_position_steps) {
-        int logical_direction = (out->cfg.stepper_a4988.target_position_steps > out->cfg.stepper_a4988.current_position_steps) ? 1 : -1;
-
-        if (out->cfg.stepper_a4988.home_gpio >= 0 && logical_direction < 0 && stepper_a4988_home_active_locked(out)) {
+    if (out->cfg.stepper_a4988->home_gpio >= 0 && stepper_a4988_home_active_locked(out)) {
+        if (out->cfg.stepper_a4988->homing ||
+            (out->cfg.stepper_a4988->axis.current_position_steps > 0 &&
+             out->cfg.stepper_a4988->axis.target_position_steps <= out->cfg.stepper_a4988->axis.current_position_steps)) {
             stepper_a4988_finish_home_locked(out);
-            changed = true;
-            break;
-        }
-
-        if (stepper_a4988_step_locked(out, logical_direction) != ESP_OK) {
-            break;
-        }
-
-        out->cfg.stepper_a4988.current_position_steps += logical_direction;
-        if (out->cfg.stepper_a4988.current_position_steps < 0) {
-            out->cfg.stepper_a4988.current_position_steps = 0;
-        }
-        if (out->cfg.stepper_a4988.current_position_steps > out->cfg.stepper_a4988.steps_range) {
-            out->cfg.stepper_a4988.current_position_steps = out->cfg.stepper_a4988.steps_range;
+        } else {
+            out->cfg.stepper_a4988->homed = true;
         }
-        out->cfg.stepper_a4988.current_level =
-            stepper_position_to_level(out->cfg.stepper_a4988.current_position_steps, out->cfg.stepper_a4988.steps_range);
-        out->cfg.stepper_a4988.last_step_us += step_interval_us;
-        changed = true;
+    }
 
-        if (out->cfg.stepper_a4988.home_gpio >= 0 && logical_direction < 0 && stepper_a4988_home_active_locked(out)) {
-            stepper_a4988_finish_home_locked(out);
-            break;
+    if (out->cfg.stepper_a4988->rmt_chan) {
+        while (stepper_a4988_rmt_can_plan_locked(out) && stepper_a4988_rmt_plan_locked(out)) {
         }
+    } else {
+        changed = stepper_axis_run_locked(out, &out->cfg.stepper_a4988->axis, out->cfg.stepper_a4988->home_gpio,
+                                          &k_stepper_a4988_driver, now_us) || changed;
     }
 
-    out->cfg.stepper_a4988.moving =
-        out->cfg.stepper_a4988.current_position_steps != out->cfg.stepper_a4988.target_position_steps;
+    out->cfg.stepper_a4988->moving = stepper_a4988_busy_locked(out);
 
-    if (!out->cfg.stepper_a4988.moving) {
-        if (out->cfg.stepper_a4988.hold_enabled) {
+    if (!out->cfg.stepper_a4988->moving) {
+        if (out->cfg.stepper_a4988->hold_enabled) {
             (void)stepper_a4988_set_enable_locked(out, true);
             out->power = true;
         } else {
@@ -1756,10 +2414,10 @@ static bool update_stepper_a4988_control_locked(output_runtime_t *out, int64_t n
     }
 
     changed = changed ||
-              previous_home_active != out->cfg.stepper_a4988.home_active ||
-              previous_homing != out->cfg.stepper_a4988.homing ||
-              previous_homed != out->cfg.stepper_a4988.homed ||
-              previous_moving != out->cfg.stepper_a4988.moving;
+              previous_home_active != out->cfg.stepper_a4988->home_active ||
+              previous_homing != out->cfg.stepper_a4988->homing ||
+              previous_homed != out->cfg.stepper_a4988->homed ||
+              previous_moving != out->cfg.stepper_a4988->moving;
 
     return changed;
 }
@@ -1783,14 +2441,13 @@ static bool ws2812_color_order_valid(const char *order)
     return false;
 }
 
-static uint8_t ws2812_channel_value(char channel, uint8_t red, uint8_t green, uint8_t blue)
+static int ws2812_pixel_count(const cJSON *item)
 {
-    switch (channel) {
-        case 'R': return red;
-        case 'G': return green;
-        case 'B': return blue;
-        default: return 0;
+    int count = jint(item, "pixel_count", 1);
+    if (count < 1) {
+        return 1;
     }
+    return count > WS2812_MAX_PIXELS ? WS2812_MAX_PIXELS : count;
 }
 
 static int clamp_level_pct(int level)
@@ -1815,6 +2472,53 @@ static int clamp_ws2812_brightness(int brightness)
     return brightness;
 }
 
+static void ws2812_rgb_from_json(const cJSON *color, uint8_t rgb[3], uint8_t r, uint8_t g, uint8_t b)
+{
+    rgb[0] = (uint8_t)clamp_ws2812_brightness(jint(color, "r", r));
+    rgb[1] = (uint8_t)clamp_ws2812_brightness(jint(color, "g", g));
+    rgb[2] = (uint8_t)clamp_ws2812_brightness(jint(color, "b", b));
+}
+
+static void configure_ws2812_effect(ws2812_output_t *ws, const cJSON *item)
+{
+    const cJSON *segments = jobj(item, "segments");
+    int count = cJSON_IsArray((cJSON *)segments) ? cJSON_GetArraySize((cJSON *)segments) : 0;
+
+    if (!ws2812_effect_from_text(jstr(item, "effect", "none"), &ws->fx.effect) || ws->mode != WS2812_MODE_RGB) {
+        ws->fx.effect = WS2812_EFFECT_NONE;
+    }
+    ws->effect_fps = jint(item, "effect_fps", WS2812_EFFECT_FPS_DEFAULT);
+    if (ws->effect_fps < 1) {
+        ws->effect_fps = 1;
+    }
+    if (ws->effect_fps > WS2812_EFFECT_FPS_MAX) {
+        ws->effect_fps = WS2812_EFFECT_FPS_MAX;
+    }
+    ws->fx.speed = jint(item, "effect_speed", WS2812_EFFECT_SPEED_DEFAULT);
+    if (ws->fx.speed < 1) {
+        ws->fx.speed = 1;
+    }
+    if (ws->fx.speed > WS2812_EFFECT_SPEED_MAX) {
+        ws->fx.speed = WS2812_EFFECT_SPEED_MAX;
+    }
+    ws2812_rgb_from_json(jobj(item, "gradient_color"), ws->fx.gradient_rgb, 0, 0, 255);
+
+    ws->fx.segment_count = 0;
+    for (int i = 0; i < count && ws->fx.segment_count < WS2812_MAX_SEGMENTS; ++i) {
+        const cJSON *seg = cJSON_GetArrayItem((cJSON *)segments, i);
+        int start = jint(seg, "start", 0);
+        int len = jint(seg, "count", 0);
+        if (start < 0 || start >= ws->pixel_count || len <= 0) {
+            continue;
+        }
+        ws2812_segment_t *dst = &ws->fx.segments[ws->fx.segment_count++];
+        dst->start = (uint16_t)start;
+        dst->count = (uint16_t)(len > ws->pixel_count - start ? ws->pixel_count - start : len);
+        ws2812_rgb_from_json(jobj(seg, "color"), dst->rgb, 255, 255, 255);
+    }
+    ws->effect_running = false;
+}
+
 static int ws2812_brightness_from_percent(int level_pct)
 {
     int clamped = clamp_level_pct(level_pct);
@@ -1827,104 +2531,37 @@ static int ws2812_percent_from_brightness(int brightness)
     return (clamped * LEVEL_PCT_MAX + (WS2812_BRIGHTNESS_MAX / 2)) / WS2812_BRIGHTNESS_MAX;
 }
 
-static uint8_t ws2812_apply_gamma(uint8_t value)
-{
-    static const uint8_t k_gamma_lut[256] = {
-          0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,
-          1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
-          3,   3,   3,   3,   3,   4,   4,   4,   4,   5,   5,   5,   5,   6,   6,   6,
-          6,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,  10,  11,  11,  11,  12,
-         12,  13,  13,  13,  14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,
-         20,  20,  21,  22,  22,  23,  23,  24,  25,  25,  26,  26,  27,  28,  28,  29,
-         30,  30,  31,  32,  33,  33,  34,  35,  35,  36,  37,  38,  39,  39,  40,  41,
-         42,  43,  43,  44,  45,  46,  47,  48,  49,  49,  50,  51,  52,  53,  54,  55,
-         56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,  68,  69,  70,  71,
-         73,  74,  75,  76,  77,  78,  79,  81,  82,  83,  84,  85,  87,  88,  89,  90,
-         91,  93,  94,  95,  97,  98,  99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
-        113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
-        137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
-        163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
-        192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
-        223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255,
-    };
-
-    return k_gamma_lut[value];
-}
-
-static esp_err_t ws2812_set_pixel_ordered(output_runtime_t *out, int index, uint8_t red, uint8_t green, uint8_t blue)
+// Rendering only publishes the frame; the transfer happens in modules_ws2812_tx_task without s_lock.
+static void ws2812_queue_frame_locked(ws2812_output_t *ws, int64_t render_start_us)
 {
-    const char *order = ws2812_color_order_valid(out->cfg.ws2812.color_order) ? out->cfg.ws2812.color_order : "GRB";
-    if (out->cfg.ws2812.gamma_correction) {
-        red = ws2812_apply_gamma(red);
-        green = ws2812_apply_gamma(green);
-        blue = ws2812_apply_gamma(blue);
+    perf_probe_record_units(PERF_PROBE_WS2812_RENDER, render_start_us, (uint32_t)ws->pixel_count);
+    ws->frame_dirty = true;
+    if (s_ws2812_tx_task) {
+        xTaskNotifyGive(s_ws2812_tx_task);
     }
-    uint8_t wire_0 = ws2812_channel_value(order[0], red, green, blue);
-    uint8_t wire_1 = ws2812_channel_value(order[1], red, green, blue);
-    uint8_t wire_2 = ws2812_channel_value(order[2], red, green, blue);
-
-    return led_strip_set_pixel(out->cfg.ws2812.strip, (uint32_t)index, wire_1, wire_0, wire_2);
 }
 
 static esp_err_t render_ws2812_frame_locked(output_runtime_t *out, int level, uint8_t red, uint8_t green, uint8_t blue, int wipe_active_segments)
 {
-    if (!out || out->type != OUTPUT_TYPE_WS2812 || !out->cfg.ws2812.strip) {
+    if (!out || out->type != OUTPUT_TYPE_WS2812 || !out->cfg.ws2812->strip || !out->cfg.ws2812->frame) {
         return ESP_ERR_INVALID_STATE;
     }
 
-    level = clamp_ws2812_brightness(level);
-
-    if (level <= 0) {
-        ESP_ERROR_CHECK(led_strip_clear(out->cfg.ws2812.strip));
-        return ESP_OK;
-    }
+    ws2812_output_t *ws = out->cfg.ws2812;
+    int64_t start_us = esp_timer_get_time();
 
-    if (out->cfg.ws2812.mode == WS2812_MODE_MONO_TRIPLET) {
-        int total_segments = out->cfg.ws2812.pixel_count * 3;
-        int active_segments = wipe_active_segments;
-        uint8_t mono = (uint8_t)level;
-        const char *order = ws2812_color_order_valid(out->cfg.ws2812.color_order) ? out->cfg.ws2812.color_order : "GRB";
-
-        if (active_segments < 0 || active_segments > total_segments) {
-            active_segments = total_segments;
-        }
-
-        for (int pixel = 0; pixel < out->cfg.ws2812.pixel_count; ++pixel) {
-            uint8_t pixel_r = 0;
-            uint8_t pixel_g = 0;
-            uint8_t pixel_b = 0;
-
-            for (int slot = 0; slot < 3; ++slot) {
-                int seg_index = (pixel * 3) + slot;
-                uint8_t channel_level = (seg_index < active_segments) ? mono : 0;
-                switch (order[slot]) {
-                    case 'R':
-                        pixel_r = channel_level;
-                        break;
-                    case 'G':
-                        pixel_g = channel_level;
-                        break;
-                    case 'B':
-                        pixel_b = channel_level;
-                        break;
-                    default:
-                        break;
-                }
-            }
+    level = clamp_ws2812_brightness(level);
 
-            ESP_ERROR_CHECK(ws2812_set_pixel_ordered(out, pixel, pixel_r, pixel_g, pixel_b));
-        }
+    if (ws->mode == WS2812_MODE_MONO_TRIPLET) {
+        // Every wire byte is its own segment, so a wipe is a lit prefix of the frame.
+        ws2812_render_mono(&ws->palette, ws->frame, ws->pixel_count, level, wipe_active_segments);
     } else {
-        uint8_t scaled_r = (uint8_t)(((uint32_t)red * (uint32_t)level) / WS2812_BRIGHTNESS_MAX);
-        uint8_t scaled_g = (uint8_t)(((uint32_t)green * (uint32_t)level) / WS2812_BRIGHTNESS_MAX);
-        uint8_t scaled_b = (uint8_t)(((uint32_t)blue * (uint32_t)level) / WS2812_BRIGHTNESS_MAX);
-
-        for (int i = 0; i < out->cfg.ws2812.pixel_count; ++i) {
-            ESP_ERROR_CHECK(ws2812_set_pixel_ordered(out, i, scaled_r, scaled_g, scaled_b));
-        }
+        const uint8_t rgb[3] = {red, green, blue};
+        ws2812_render_solid(&ws->palette, ws->frame, ws->pixel_count, level, rgb);
     }
 
-    return led_strip_refresh(out->cfg.ws2812.strip);
+    ws2812_queue_frame_locked(ws, start_us);
+    return ESP_OK;
 }
 
 static esp_err_t apply_ws2812_target_locked(output_runtime_t *out, bool allow_transition)
@@ -1936,137 +2573,195 @@ static esp_err_t apply_ws2812_target_locked(output_runtime_t *out, bool allow_tr
         return ESP_ERR_INVALID_ARG;
     }
 
-    target_level = out->power ? out->cfg.ws2812.level : 0;
-    wants_wipe = (out->cfg.ws2812.mode == WS2812_MODE_MONO_TRIPLET) &&
-                 (out->cfg.ws2812.transition_style == WS2812_TRANSITION_WIPE) &&
-                 ((out->cfg.ws2812.applied_level == 0 && target_level > 0) ||
-                  (out->cfg.ws2812.applied_level > 0 && target_level == 0));
-
-    if (out->cfg.ws2812.applied_level == target_level &&
-        out->cfg.ws2812.applied_red == out->cfg.ws2812.red &&
-        out->cfg.ws2812.applied_green == out->cfg.ws2812.green &&
-        out->cfg.ws2812.applied_blue == out->cfg.ws2812.blue) {
-        out->cfg.ws2812.transition_active = false;
-        out->cfg.ws2812.transition_use_wipe = false;
-        return render_ws2812_frame_locked(out, out->cfg.ws2812.applied_level,
-                                          out->cfg.ws2812.applied_red,
-                                          out->cfg.ws2812.applied_green,
-                                          out->cfg.ws2812.applied_blue, -1);
-    }
-
-    if (!allow_transition || out->cfg.ws2812.transition_style == WS2812_TRANSITION_NONE ||
-        out->cfg.ws2812.transition_ms <= 0) {
-        out->cfg.ws2812.transition_active = false;
-        out->cfg.ws2812.transition_use_wipe = false;
-        out->cfg.ws2812.applied_level = target_level;
-        out->cfg.ws2812.applied_red = out->cfg.ws2812.red;
-        out->cfg.ws2812.applied_green = out->cfg.ws2812.green;
-        out->cfg.ws2812.applied_blue = out->cfg.ws2812.blue;
-        return render_ws2812_frame_locked(out, out->cfg.ws2812.applied_level,
-                                          out->cfg.ws2812.applied_red,
-                                          out->cfg.ws2812.applied_green,
-                                          out->cfg.ws2812.applied_blue, -1);
-    }
-
-    out->cfg.ws2812.transition_active = true;
-    out->cfg.ws2812.transition_use_wipe = wants_wipe;
-    out->cfg.ws2812.transition_started_us = esp_timer_get_time();
-    out->cfg.ws2812.transition_duration_us = (int64_t)out->cfg.ws2812.transition_ms * 1000LL;
-    out->cfg.ws2812.start_level = out->cfg.ws2812.applied_level;
-    out->cfg.ws2812.target_level = target_level;
-    out->cfg.ws2812.start_red = out->cfg.ws2812.applied_red;
-    out->cfg.ws2812.start_green = out->cfg.ws2812.applied_green;
-    out->cfg.ws2812.start_blue = out->cfg.ws2812.applied_blue;
-    out->cfg.ws2812.target_red = out->cfg.ws2812.red;
-    out->cfg.ws2812.target_green = out->cfg.ws2812.green;
-    out->cfg.ws2812.target_blue = out->cfg.ws2812.blue;
+    if (ws2812_effect_wanted(out)) {
+        ws2812_output_t *ws = out->cfg.ws2812;
+        ws->transition.active = false;
+        ws->applied_level = ws->level;
+        ws->applied_red = ws->red;
+        ws->applied_green = ws->green;
+        ws->applied_blue = ws->blue;
+        if (!ws->effect_running) {
+            ws->effect_running = true;
+            ws->effect_started_us = esp_timer_get_time();
+            ws->effect_next_us = ws->effect_started_us;
+            ws->effect_frame = 0;
+        }
+        return render_ws2812_effect_locked(out);
+    }
+    if (out->cfg.ws2812->effect_running) {
+        // Fading from an effect would first snap to the solid color, so leave it directly.
+        out->cfg.ws2812->effect_running = false;
+        allow_transition = false;
+    }
+
+    target_level = out->power ? out->cfg.ws2812->level : 0;
+    wants_wipe = (out->cfg.ws2812->mode == WS2812_MODE_MONO_TRIPLET) &&
+                 (out->cfg.ws2812->transition_style == WS2812_TRANSITION_WIPE) &&
+                 ((out->cfg.ws2812->applied_level == 0 && target_level > 0) ||
+                  (out->cfg.ws2812->applied_level > 0 && target_level == 0));
+
+    if (out->cfg.ws2812->applied_level == target_level &&
+        out->cfg.ws2812->applied_red == out->cfg.ws2812->red &&
+        out->cfg.ws2812->applied_green == out->cfg.ws2812->green &&
+        out->cfg.ws2812->applied_blue == out->cfg.ws2812->blue) {
+        out->cfg.ws2812->transition.active = false;
+        return render_ws2812_frame_locked(out, out->cfg.ws2812->applied_level,
+                                          out->cfg.ws2812->applied_red,
+                                          out->cfg.ws2812->applied_green,
+                                          out->cfg.ws2812->applied_blue, -1);
+    }
+
+    if (!allow_transition || out->cfg.ws2812->transition_style == WS2812_TRANSITION_NONE ||
+        out->cfg.ws2812->transition_ms <= 0) {
+        out->cfg.ws2812->transition.active = false;
+        out->cfg.ws2812->applied_level = target_level;
+        out->cfg.ws2812->applied_red = out->cfg.ws2812->red;
+        out->cfg.ws2812->applied_green = out->cfg.ws2812->green;
+        out->cfg.ws2812->applied_blue = out->cfg.ws2812->blue;
+        return render_ws2812_frame_locked(out, out->cfg.ws2812->applied_level,
+                                          out->cfg.ws2812->applied_red,
+                                          out->cfg.ws2812->applied_green,
+                                          out->cfg.ws2812->applied_blue, -1);
+    }
+
+    ws2812_output_t *ws = out->cfg.ws2812;
+    const uint8_t start_rgb[3] = {ws->applied_red, ws->applied_green, ws->applied_blue};
+    const uint8_t target_rgb[3] = {ws->red, ws->green, ws->blue};
+
+    ws2812_transition_start(&ws->transition, ws->transition_ms, ws->transition_easing, wants_wipe, ws->applied_level,
+                            start_rgb, target_level, target_rgb);
+    ws->transition_started_us = esp_timer_get_time();
+    ws->transition_segments = -1;
     return ESP_OK;
 }
 
-static void update_ws2812_transitions_locked(int64_t now_us)
+// Runs every frame period while a transition is active, but only renders (and so refreshes the strip)
+// when the quantized level, color or wipe position differs from the last frame.
+static void update_ws2812_transition_locked(output_runtime_t *out, int64_t now_us)
 {
-    for (int i = 0; i < s_runtime.output_count; ++i) {
-        output_runtime_t *out = &s_runtime.outputs[i];
-        int64_t elapsed_us;
-        int level;
-        uint8_t red;
-        uint8_t green;
-        uint8_t blue;
+    ws2812_output_t *ws;
+    ws2812_transition_frame_t step;
 
-        if (!out->used || !out->enabled || out->type != OUTPUT_TYPE_WS2812 || !out->cfg.ws2812.transition_active) {
-            continue;
-        }
+    if (!out->used || !out->enabled || out->type != OUTPUT_TYPE_WS2812 || !out->cfg.ws2812->transition.active) {
+        return;
+    }
 
-        elapsed_us = now_us - out->cfg.ws2812.transition_started_us;
-        if (elapsed_us < 0) {
-            elapsed_us = 0;
-        }
+    ws = out->cfg.ws2812;
+    ws2812_transition_step(&ws->transition, now_us - ws->transition_started_us, ws->pixel_count, &step);
+    if (step.level == ws->applied_level && step.rgb[0] == ws->applied_red && step.rgb[1] == ws->applied_green &&
+        step.rgb[2] == ws->applied_blue && step.segments == ws->transition_segments) {
+        return;
+    }
+    ws->applied_level = step.level;
+    ws->applied_red = step.rgb[0];
+    ws->applied_green = step.rgb[1];
+    ws->applied_blue = step.rgb[2];
+    ws->transition_segments = step.segments;
+    (void)render_ws2812_frame_locked(out, step.level, step.rgb[0], step.rgb[1], step.rgb[2], step.segments);
+}
 
-        if (elapsed_us >= out->cfg.ws2812.transition_duration_us) {
-            out->cfg.ws2812.transition_active = false;
-            out->cfg.ws2812.transition_use_wipe = false;
-            out->cfg.ws2812.applied_level = out->cfg.ws2812.target_level;
-            out->cfg.ws2812.applied_red = out->cfg.ws2812.target_red;
-            out->cfg.ws2812.applied_green = out->cfg.ws2812.target_green;
-            out->cfg.ws2812.applied_blue = out->cfg.ws2812.target_blue;
-            (void)render_ws2812_frame_locked(out, out->cfg.ws2812.applied_level,
-                                             out->cfg.ws2812.applied_red,
-                                             out->cfg.ws2812.applied_green,
-                                             out->cfg.ws2812.applied_blue, -1);
-            continue;
-        }
+static bool ws2812_effect_animated(ws2812_effect_t effect)
+{
+    return effect == WS2812_EFFECT_RAINBOW || effect == WS2812_EFFECT_CHASE ||
+           effect == WS2812_EFFECT_TWINKLE || effect == WS2812_EFFECT_BREATHE;
+}
+
+// Effects need per-pixel color, so mono_triplet strips and output tests keep the solid fill.
+static bool ws2812_effect_wanted(const output_runtime_t *out)
+{
+    const ws2812_output_t *ws = out->cfg.ws2812;
 
-        if (out->cfg.ws2812.transition_use_wipe) {
-            int total_segments = out->cfg.ws2812.pixel_count * 3;
-            int active_segments;
-            bool turning_on = (out->cfg.ws2812.start_level == 0 && out->cfg.ws2812.target_level > 0);
+    return ws->fx.effect != WS2812_EFFECT_NONE && ws->mode == WS2812_MODE_RGB && out->power && ws->level > 0 &&
+           !out->test_active;
+}
 
-            if (turning_on) {
-                active_segments = (int)((elapsed_us * total_segments + out->cfg.ws2812.transition_duration_us - 1) /
-                                        out->cfg.ws2812.transition_duration_us);
-            } else {
-                active_segments = total_segments -
-                                  (int)((elapsed_us * total_segments + out->cfg.ws2812.transition_duration_us - 1) /
-                                        out->cfg.ws2812.transition_duration_us);
-            }
+static esp_err_t render_ws2812_effect_locked(output_runtime_t *out)
+{
+    if (!out || out->type != OUTPUT_TYPE_WS2812 || !out->cfg.ws2812->strip || !out->cfg.ws2812->frame) {
+        return ESP_ERR_INVALID_STATE;
+    }
 
-            if (active_segments < 0) {
-                active_segments = 0;
-            }
-            if (active_segments > total_segments) {
-                active_segments = total_segments;
-            }
+    ws2812_output_t *ws = out->cfg.ws2812;
+    const uint8_t base[3] = {ws->applied_red, ws->applied_green, ws->applied_blue};
+    int64_t start_us = esp_timer_get_time();
 
-            out->cfg.ws2812.applied_level = turning_on ? out->cfg.ws2812.target_level : out->cfg.ws2812.start_level;
-            out->cfg.ws2812.applied_red = out->cfg.ws2812.target_red;
-            out->cfg.ws2812.applied_green = out->cfg.ws2812.target_green;
-            out->cfg.ws2812.applied_blue = out->cfg.ws2812.target_blue;
-            (void)render_ws2812_frame_locked(out, out->cfg.ws2812.applied_level,
-                                             out->cfg.ws2812.applied_red,
-                                             out->cfg.ws2812.applied_green,
-                                             out->cfg.ws2812.applied_blue,
-                                             active_segments);
-            continue;
-        }
+    if (!ws2812_render_effect(&ws->palette, ws->frame, ws->pixel_count, &ws->fx,
+                              clamp_ws2812_brightness(ws->applied_level), base, ws->effect_frame)) {
+        return render_ws2812_frame_locked(out, ws->applied_level, ws->applied_red, ws->applied_green,
+                                          ws->applied_blue, -1);
+    }
+    ws2812_queue_frame_locked(ws, start_us);
+    return ESP_OK;
+}
+
+// The frame index comes from the clock, so a late wakeup skips frames instead of slowing the effect.
+static void update_ws2812_effect_locked(output_runtime_t *out, int64_t now_us)
+{
+    ws2812_output_t *ws = out->cfg.ws2812;
+    uint32_t frame;
 
-        level = out->cfg.ws2812.start_level +
-                (int)(((int64_t)(out->cfg.ws2812.target_level - out->cfg.ws2812.start_level) * elapsed_us) /
-                      out->cfg.ws2812.transition_duration_us);
-        red = (uint8_t)(out->cfg.ws2812.start_red +
-                        (int)(((int64_t)(out->cfg.ws2812.target_red - out->cfg.ws2812.start_red) * elapsed_us) /
-                              out->cfg.ws2812.transition_duration_us));
-        green = (uint8_t)(out->cfg.ws2812.start_green +
-                          (int)(((int64_t)(out->cfg.ws2812.target_green - out->cfg.ws2812.start_green) * elapsed_us) /
-                                out->cfg.ws2812.transition_duration_us));
-        blue = (uint8_t)(out->cfg.ws2812.start_blue +
-                         (int)(((int64_t)(out->cfg.ws2812.target_blue - out->cfg.ws2812.start_blue) * elapsed_us) /
-                               out->cfg.ws2812.transition_duration_us));
+    if (!out->used || !out->enabled || !ws->effect_running || !ws2812_effect_animated(ws->fx.effect) ||
+        now_us < ws->effect_next_us) {
+        return;
+    }
+
+    frame = (uint32_t)(((now_us - ws->effect_started_us) * ws->effect_fps) / 1000000LL);
+    ws->effect_next_us = ws->effect_started_us + (((int64_t)frame + 1) * 1000000LL + ws->effect_fps - 1) / ws->effect_fps;
+    if (frame != ws->effect_frame) {
+        ws->effect_frame = frame;
+        (void)render_ws2812_effect_locked(out);
+    }
+}
+
+static esp_err_t set_ws2812_effect_locked(output_runtime_t *out, const char *name)
+{
+    ws2812_effect_t effect;
+
+    if (!ws2812_effect_from_text(name, &effect)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (out->cfg.ws2812->mode != WS2812_MODE_RGB && effect != WS2812_EFFECT_NONE) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    if (effect != out->cfg.ws2812->fx.effect) {
+        out->cfg.ws2812->fx.effect = effect;
+        out->cfg.ws2812->effect_running = false;
+    }
+    return apply_ws2812_target_locked(out, false);
+}
+
+static uint32_t id_index_slot(const char *id, int slots)
+{
+    return hash_fnv1a(HASH_FNV1A_SEED, id, strlen(id)) % (uint32_t)slots;
+}
+
+// Duplicate ids keep the first entity, matching the old linear scan.
+static void id_index_insert(uint8_t *index, int slots, const char *id, int entity)
+{
+    if (!id[0]) {
+        return;
+    }
+    for (uint32_t slot = id_index_slot(id, slots);; slot = (slot + 1) % (uint32_t)slots) {
+        if (index[slot] == 0) {
+            index[slot] = (uint8_t)(entity + 1);
+            return;
+        }
+    }
+}
 
-        out->cfg.ws2812.applied_level = level;
-        out->cfg.ws2812.applied_red = red;
-        out->cfg.ws2812.applied_green = green;
-        out->cfg.ws2812.applied_blue = blue;
-        (void)render_ws2812_frame_locked(out, level, red, green, blue, -1);
+static void rebuild_id_index_locked(void)
+{
+    memset(s_output_index, 0, sizeof(s_output_index));
+    memset(s_input_index, 0, sizeof(s_input_index));
+    for (int i = 0; i < s_runtime.output_count; ++i) {
+        if (s_runtime.outputs[i].used) {
+            id_index_insert(s_output_index, MODULES_OUTPUT_INDEX_SLOTS, s_runtime.outputs[i].id, i);
+        }
+    }
+    for (int i = 0; i < s_runtime.input_count; ++i) {
+        if (s_runtime.inputs[i].used) {
+            id_index_insert(s_input_index, MODULES_INPUT_INDEX_SLOTS, s_runtime.inputs[i].id, i);
+        }
     }
 }
 
@@ -2075,9 +2770,11 @@ static output_runtime_t *find_output_locked(const char *id)
     if (!id || !id[0]) {
         return NULL;
     }
-    for (int i = 0; i < s_runtime.output_count; ++i) {
-        if (s_runtime.outputs[i].used && strcmp(s_runtime.outputs[i].id, id) == 0) {
-            return &s_runtime.outputs[i];
+    for (uint32_t slot = id_index_slot(id, MODULES_OUTPUT_INDEX_SLOTS); s_output_index[slot] != 0;
+         slot = (slot + 1) % MODULES_OUTPUT_INDEX_SLOTS) {
+        output_runtime_t *out = &s_runtime.outputs[s_output_index[slot] - 1];
+        if (strcmp(out->id, id) == 0) {
+            return out;
         }
     }
     return NULL;
@@ -2088,9 +2785,11 @@ static input_runtime_t *find_input_locked(const char *id)
     if (!id || !id[0]) {
         return NULL;
     }
-    for (int i = 0; i < s_runtime.input_count; ++i) {
-        if (s_runtime.inputs[i].used && strcmp(s_runtime.inputs[i].id, id) == 0) {
-            return &s_runtime.inputs[i];
+    for (uint32_t slot = id_index_slot(id, MODULES_INPUT_INDEX_SLOTS); s_input_index[slot] != 0;
+         slot = (slot + 1) % MODULES_INPUT_INDEX_SLOTS) {
+        input_runtime_t *in = &s_runtime.inputs[s_input_index[slot] - 1];
+        if (strcmp(in->id, id) == 0) {
+            return in;
         }
     }
     return NULL;
@@ -2104,11 +2803,11 @@ static esp_err_t output_apply_physical_state(output_runtime_t *out)
 
     switch (out->type) {
         case OUTPUT_TYPE_RELAY: {
-            int level = out->power ? out->cfg.relay.active_level : (1 - out->cfg.relay.active_level);
+            int level = out->power ? out->cfg.relay->active_level : (1 - out->cfg.relay->active_level);
             return gpio_set_level(out->gpio, level);
         }
         case OUTPUT_TYPE_PWM: {
-            int level = out->cfg.pwm.level;
+            int level = out->cfg.pwm->level;
             uint32_t duty = 0;
             const uint32_t max_duty = (1U << LEDC_TIMER_13_BIT) - 1U;
             int requested = out->power ? level : 0;
@@ -2122,7 +2821,7 @@ static esp_err_t output_apply_physical_state(output_runtime_t *out)
                 requested = 100;
             }
 
-            limited = (requested * out->cfg.pwm.max_level_pct) / 100;
+            limited = (requested * out->cfg.pwm->max_level_pct) / 100;
             if (limited < 0) {
                 limited = 0;
             }
@@ -2138,12 +2837,12 @@ static esp_err_t output_apply_physical_state(output_runtime_t *out)
                 }
             }
 
-            if (out->cfg.pwm.inverted) {
+            if (out->cfg.pwm->inverted) {
                 limited = 100 - limited;
             }
             duty = (uint32_t)((limited * (int)max_duty) / 100);
-            ESP_ERROR_CHECK(ledc_set_duty(LEDC_LOW_SPEED_MODE, out->cfg.pwm.channel, duty));
-            esp_err_t err = ledc_update_duty(LEDC_LOW_SPEED_MODE, out->cfg.pwm.channel);
+            ESP_ERROR_CHECK(ledc_set_duty(LEDC_LOW_SPEED_MODE, out->cfg.pwm->channel, duty));
+            esp_err_t err = ledc_update_duty(LEDC_LOW_SPEED_MODE, out->cfg.pwm->channel);
             if (err != ESP_OK) {
                 return err;
             }
@@ -2159,14 +2858,14 @@ static esp_err_t output_apply_physical_state(output_runtime_t *out)
         case OUTPUT_TYPE_WS2812:
             return apply_ws2812_target_locked(out, true);
         case OUTPUT_TYPE_SERVO_3WIRE: {
-            int level = out->cfg.servo_3wire.level;
+            int level = out->cfg.servo_3wire->level;
             int pulse_us;
             uint32_t duty;
             const uint32_t max_duty = (1U << LEDC_TIMER_13_BIT) - 1U;
 
             if (!out->power) {
-                out->cfg.servo_3wire.release_at_us = 0;
-                return ledc_stop(LEDC_LOW_SPEED_MODE, out->cfg.servo_3wire.channel, 0);
+                out->cfg.servo_3wire->release_at_us = 0;
+                return ledc_stop(LEDC_LOW_SPEED_MODE, out->cfg.servo_3wire->channel, 0);
             }
             if (level < 0) {
                 level = 0;
@@ -2174,22 +2873,22 @@ static esp_err_t output_apply_physical_state(output_runtime_t *out)
             if (level > 100) {
                 level = 100;
             }
-            if (out->cfg.servo_3wire.reverse_direction) {
+            if (out->cfg.servo_3wire->reverse_direction) {
                 level = 100 - level;
             }
 
-            pulse_us = out->cfg.servo_3wire.min_us +
-                       (int)(((int64_t)(out->cfg.servo_3wire.max_us - out->cfg.servo_3wire.min_us) * level) / 100LL);
+            pulse_us = out->cfg.servo_3wire->min_us +
+                       (int)(((int64_t)(out->cfg.servo_3wire->max_us - out->cfg.servo_3wire->min_us) * level) / 100LL);
             duty = (uint32_t)(((int64_t)pulse_us * (int64_t)max_duty) / 20000LL);
-            ESP_RETURN_ON_ERROR(ledc_set_duty(LEDC_LOW_SPEED_MODE, out->cfg.servo_3wire.channel, duty),
+            ESP_RETURN_ON_ERROR(ledc_set_duty(LEDC_LOW_SPEED_MODE, out->cfg.servo_3wire->channel, duty),
                                 TAG, "servo duty set failed for %s", out->id);
-            ESP_RETURN_ON_ERROR(ledc_update_duty(LEDC_LOW_SPEED_MODE, out->cfg.servo_3wire.channel),
+            ESP_RETURN_ON_ERROR(ledc_update_duty(LEDC_LOW_SPEED_MODE, out->cfg.servo_3wire->channel),
                                 TAG, "servo duty update failed for %s", out->id);
-            if (out->cfg.servo_3wire.hold_power_ms > 0) {
-                out->cfg.servo_3wire.release_at_us =
-                    esp_timer_get_time() + ((int64_t)out->cfg.servo_3wire.hold_power_ms * 1000LL);
+            if (out->cfg.servo_3wire->hold_power_ms > 0) {
+                out->cfg.servo_3wire->release_at_us =
+                    esp_timer_get_time() + ((int64_t)out->cfg.servo_3wire->hold_power_ms * 1000LL);
             } else {
-                out->cfg.servo_3wire.release_at_us = 0;
+                out->cfg.servo_3wire->release_at_us = 0;
             }
             return ESP_OK;
         }
@@ -2216,6 +2915,7 @@ static esp_err_t set_output_power_locked(output_runtime_t *out, bool on)
     if (!output_supports_power_control(out)) {
         return ESP_ERR_INVALID_ARG;
     }
+    mark_output_dirty_locked(out);
     out->power = on;
     return output_apply_physical_state(out);
 }
@@ -2225,54 +2925,51 @@ static esp_err_t set_output_level_locked(output_runtime_t *out, int level)
     if (!out || !out->enabled) {
         return ESP_ERR_INVALID_STATE;
     }
+    mark_output_dirty_locked(out);
     level = clamp_level_pct(level);
 
     if (out->type == OUTPUT_TYPE_PWM) {
-        out->cfg.pwm.level = level;
+        out->cfg.pwm->level = level;
         out->power = (level > 0);
     } else if (out->type == OUTPUT_TYPE_WS2812) {
         return set_output_brightness_locked(out, ws2812_brightness_from_percent(level));
     } else if (out->type == OUTPUT_TYPE_SERVO_3WIRE) {
-        out->cfg.servo_3wire.level = level;
+        out->cfg.servo_3wire->level = level;
         out->power = true;
     } else if (out->type == OUTPUT_TYPE_SERVO_5WIRE) {
-        out->cfg.servo_5wire.target_level = level;
-        out->cfg.servo_5wire.timed_out = false;
-        out->power = out->cfg.servo_5wire.moving;
+        out->cfg.servo_5wire->target_level = level;
+        out->cfg.servo_5wire->timed_out = false;
+        out->power = out->cfg.servo_5wire->moving;
     } else if (out->type == OUTPUT_TYPE_CLOCK_4X4094) {
-        out->cfg.clock_4x4094.level = level;
+        out->cfg.clock_4x4094->level = level;
         out->power = (level > 0);
         return output_apply_physical_state(out);
     } else if (out->type == OUTPUT_TYPE_STEPPER_28BYJ) {
-        out->cfg.stepper_28byj.homing = false;
-        out->cfg.stepper_28byj.target_level = level;
-        out->cfg.stepper_28byj.target_position_steps = stepper_level_to_position(level, out->cfg.stepper_28byj.steps_range);
-        if (out->cfg.stepper_28byj.home_gpio >= 0 && level == 0 && stepper_28byj_home_active_locked(out)) {
+        out->cfg.stepper_28byj->homing = false;
+        out->cfg.stepper_28byj->axis.target_level = level;
+        out->cfg.stepper_28byj->axis.target_position_steps = stepper_level_to_position(level, out->cfg.stepper_28byj->axis.steps_range);
+        if (out->cfg.stepper_28byj->home_gpio >= 0 && level == 0 && stepper_28byj_home_active_locked(out)) {
             stepper_28byj_finish_home_locked(out);
             return ESP_OK;
         }
-        out->cfg.stepper_28byj.last_step_us = 0;
-        out->cfg.stepper_28byj.moving =
-            out->cfg.stepper_28byj.current_position_steps != out->cfg.stepper_28byj.target_position_steps;
-        out->power = out->cfg.stepper_28byj.moving || out->cfg.stepper_28byj.hold_enabled;
-        if (!out->cfg.stepper_28byj.moving && !out->cfg.stepper_28byj.hold_enabled) {
+        out->cfg.stepper_28byj->moving = stepper_axis_busy(&out->cfg.stepper_28byj->axis);
+        out->power = out->cfg.stepper_28byj->moving || out->cfg.stepper_28byj->hold_enabled;
+        if (!out->cfg.stepper_28byj->moving && !out->cfg.stepper_28byj->hold_enabled) {
             (void)stepper_28byj_release_locked(out);
             out->power = false;
         }
         return ESP_OK;
     } else if (out->type == OUTPUT_TYPE_STEPPER_A4988) {
-        out->cfg.stepper_a4988.homing = false;
-        out->cfg.stepper_a4988.target_level = level;
-        out->cfg.stepper_a4988.target_position_steps = stepper_level_to_position(level, out->cfg.stepper_a4988.steps_range);
-        if (out->cfg.stepper_a4988.home_gpio >= 0 && level == 0 && stepper_a4988_home_active_locked(out)) {
+        out->cfg.stepper_a4988->homing = false;
+        out->cfg.stepper_a4988->axis.target_level = level;
+        out->cfg.stepper_a4988->axis.target_position_steps = stepper_level_to_position(level, out->cfg.stepper_a4988->axis.steps_range);
+        if (out->cfg.stepper_a4988->home_gpio >= 0 && level == 0 && stepper_a4988_home_active_locked(out)) {
             stepper_a4988_finish_home_locked(out);
             return ESP_OK;
         }
-        out->cfg.stepper_a4988.last_step_us = 0;
-        out->cfg.stepper_a4988.moving =
-            out->cfg.stepper_a4988.current_position_steps != out->cfg.stepper_a4988.target_position_steps;
-        out->power = out->cfg.stepper_a4988.moving || out->cfg.stepper_a4988.hold_enabled;
-        if (!out->cfg.stepper_a4988.moving && !out->cfg.stepper_a4988.hold_enabled) {
+        out->cfg.stepper_a4988->moving = stepper_a4988_busy_locked(out);
+        out->power = out->cfg.stepper_a4988->moving || out->cfg.stepper_a4988->hold_enabled;
+        if (!out->cfg.stepper_a4988->moving && !out->cfg.stepper_a4988->hold_enabled) {
             (void)stepper_a4988_set_enable_locked(out, false);
             out->power = false;
         }
@@ -2295,8 +2992,9 @@ static esp_err_t set_output_brightness_locked(output_runtime_t *out, int brightn
         return ESP_ERR_INVALID_STATE;
     }
 
+    mark_output_dirty_locked(out);
     brightness = clamp_ws2812_brightness(brightness);
-    out->cfg.ws2812.level = brightness;
+    out->cfg.ws2812->level = brightness;
     out->power = (brightness > 0);
     return output_apply_physical_state(out);
 }
@@ -2324,28 +3022,28 @@ static esp_err_t start_output_test_locked(output_runtime_t *out, int duration_ms
 
         switch (out->type) {
             case OUTPUT_TYPE_PWM:
-                out->test_restore_level = out->cfg.pwm.level;
+                out->test_restore_level = out->cfg.pwm->level;
                 break;
             case OUTPUT_TYPE_WS2812:
-                out->test_restore_level = out->cfg.ws2812.level;
-                out->test_restore_red = out->cfg.ws2812.red;
-                out->test_restore_green = out->cfg.ws2812.green;
-                out->test_restore_blue = out->cfg.ws2812.blue;
+                out->test_restore_level = out->cfg.ws2812->level;
+                out->test_restore_red = out->cfg.ws2812->red;
+                out->test_restore_green = out->cfg.ws2812->green;
+                out->test_restore_blue = out->cfg.ws2812->blue;
                 break;
             case OUTPUT_TYPE_SERVO_3WIRE:
-                out->test_restore_level = out->cfg.servo_3wire.level;
+                out->test_restore_level = out->cfg.servo_3wire->level;
                 break;
             case OUTPUT_TYPE_SERVO_5WIRE:
-                out->test_restore_level = out->cfg.servo_5wire.target_level;
+                out->test_restore_level = out->cfg.servo_5wire->target_level;
                 break;
             case OUTPUT_TYPE_CLOCK_4X4094:
-                out->test_restore_level = out->cfg.clock_4x4094.level;
+                out->test_restore_level = out->cfg.clock_4x4094->level;
                 break;
             case OUTPUT_TYPE_STEPPER_28BYJ:
-                out->test_restore_level = out->cfg.stepper_28byj.target_level;
+                out->test_restore_level = out->cfg.stepper_28byj->axis.target_level;
                 break;
             case OUTPUT_TYPE_STEPPER_A4988:
-                out->test_restore_level = out->cfg.stepper_a4988.target_level;
+                out->test_restore_level = out->cfg.stepper_a4988->axis.target_level;
                 break;
             default:
                 break;
@@ -2360,37 +3058,37 @@ static esp_err_t start_output_test_locked(output_runtime_t *out, int duration_ms
             out->power = true;
             return output_apply_physical_state(out);
         case OUTPUT_TYPE_PWM:
-            out->cfg.pwm.level = 100;
+            out->cfg.pwm->level = 100;
             out->power = true;
             return output_apply_physical_state(out);
         case OUTPUT_TYPE_WS2812:
-            out->cfg.ws2812.transition_active = false;
-            out->cfg.ws2812.level = WS2812_BRIGHTNESS_MAX;
-            out->cfg.ws2812.red = 255;
-            out->cfg.ws2812.green = 255;
-            out->cfg.ws2812.blue = 255;
+            out->cfg.ws2812->transition.active = false;
+            out->cfg.ws2812->level = WS2812_BRIGHTNESS_MAX;
+            out->cfg.ws2812->red = 255;
+            out->cfg.ws2812->green = 255;
+            out->cfg.ws2812->blue = 255;
             out->power = true;
             return apply_ws2812_target_locked(out, false);
         case OUTPUT_TYPE_SERVO_3WIRE:
-            test_level = out->cfg.servo_3wire.level > 50 ? 0 : 100;
-            out->cfg.servo_3wire.level = test_level;
+            test_level = out->cfg.servo_3wire->level > 50 ? 0 : 100;
+            out->cfg.servo_3wire->level = test_level;
             out->power = true;
             return output_apply_physical_state(out);
         case OUTPUT_TYPE_SERVO_5WIRE:
-            test_level = out->cfg.servo_5wire.current_level > 50 ? 0 : 100;
-            out->cfg.servo_5wire.target_level = test_level;
-            out->cfg.servo_5wire.timed_out = false;
+            test_level = out->cfg.servo_5wire->current_level > 50 ? 0 : 100;
+            out->cfg.servo_5wire->target_level = test_level;
+            out->cfg.servo_5wire->timed_out = false;
             (void)update_servo_5wire_control_locked(out, esp_timer_get_time());
             return ESP_OK;
         case OUTPUT_TYPE_CLOCK_4X4094:
             out->power = true;
-            out->cfg.clock_4x4094.level = 100;
+            out->cfg.clock_4x4094->level = 100;
             return output_apply_physical_state(out);
         case OUTPUT_TYPE_STEPPER_28BYJ:
-            test_level = out->cfg.stepper_28byj.current_level > 50 ? 0 : 100;
+            test_level = out->cfg.stepper_28byj->axis.current_level > 50 ? 0 : 100;
             return set_output_level_locked(out, test_level);
         case OUTPUT_TYPE_STEPPER_A4988:
-            test_level = out->cfg.stepper_a4988.current_level > 50 ? 0 : 100;
+            test_level = out->cfg.stepper_a4988->axis.current_level > 50 ? 0 : 100;
             return set_output_level_locked(out, test_level);
         default:
             out->test_active = false;
@@ -2419,33 +3117,33 @@ static bool process_output_test_locked(output_runtime_t *out, int64_t now_us)
             err = output_apply_physical_state(out);
             break;
         case OUTPUT_TYPE_PWM:
-            out->cfg.pwm.level = out->test_restore_level;
+            out->cfg.pwm->level = out->test_restore_level;
             out->power = out->test_restore_power;
             err = output_apply_physical_state(out);
             break;
         case OUTPUT_TYPE_WS2812:
-            out->cfg.ws2812.transition_active = false;
-            out->cfg.ws2812.level = out->test_restore_level;
-            out->cfg.ws2812.red = out->test_restore_red;
-            out->cfg.ws2812.green = out->test_restore_green;
-            out->cfg.ws2812.blue = out->test_restore_blue;
+            out->cfg.ws2812->transition.active = false;
+            out->cfg.ws2812->level = out->test_restore_level;
+            out->cfg.ws2812->red = out->test_restore_red;
+            out->cfg.ws2812->green = out->test_restore_green;
+            out->cfg.ws2812->blue = out->test_restore_blue;
             out->power = out->test_restore_power;
             err = apply_ws2812_target_locked(out, false);
             break;
         case OUTPUT_TYPE_SERVO_3WIRE:
-            out->cfg.servo_3wire.level = out->test_restore_level;
+            out->cfg.servo_3wire->level = out->test_restore_level;
             out->power = true;
             err = output_apply_physical_state(out);
             break;
         case OUTPUT_TYPE_SERVO_5WIRE:
-            out->cfg.servo_5wire.target_level = out->test_restore_level;
-            out->cfg.servo_5wire.timed_out = false;
+            out->cfg.servo_5wire->target_level = out->test_restore_level;
+            out->cfg.servo_5wire->timed_out = false;
             (void)update_servo_5wire_control_locked(out, now_us);
             err = ESP_OK;
             break;
         case OUTPUT_TYPE_CLOCK_4X4094:
             out->power = out->test_restore_power;
-            out->cfg.clock_4x4094.level = out->test_restore_level;
+            out->cfg.clock_4x4094->level = out->test_restore_level;
             err = output_apply_physical_state(out);
             break;
         case OUTPUT_TYPE_STEPPER_28BYJ:
@@ -2464,68 +3162,71 @@ static bool process_output_test_locked(output_runtime_t *out, int64_t now_us)
     return true;
 }
 
-static void clear_runtime_locked(void)
+// Returns the counter totals still to be written, at most MODULES_MAX_INPUTS; the caller writes them
+// with write_counter_saves once the runtime lock is released.
+static int clear_runtime_locked(counter_save_t *saves)
 {
     for (int i = 0; i < s_runtime.output_count; ++i) {
         output_runtime_t *out = &s_runtime.outputs[i];
         if (!out->used) {
             continue;
         }
-        if (out->type == OUTPUT_TYPE_WS2812 && out->cfg.ws2812.strip) {
-            (void)led_strip_clear(out->cfg.ws2812.strip);
-            (void)led_strip_del(out->cfg.ws2812.strip);
-            out->cfg.ws2812.strip = NULL;
+        if (out->type == OUTPUT_TYPE_WS2812 && out->cfg.ws2812->strip) {
+            (void)led_strip_clear(out->cfg.ws2812->strip);
+            (void)led_strip_del(out->cfg.ws2812->strip);
+            out->cfg.ws2812->strip = NULL;
         }
         if (out->type == OUTPUT_TYPE_PWM) {
-            (void)ledc_stop(LEDC_LOW_SPEED_MODE, out->cfg.pwm.channel, 0);
-            if (out->cfg.pwm.power_relay_gpio >= 0) {
-                gpio_reset_pin((gpio_num_t)out->cfg.pwm.power_relay_gpio);
+            (void)ledc_stop(LEDC_LOW_SPEED_MODE, out->cfg.pwm->channel, 0);
+            if (out->cfg.pwm->power_relay_gpio >= 0) {
+                gpio_reset_pin((gpio_num_t)out->cfg.pwm->power_relay_gpio);
             }
         }
         if (out->type == OUTPUT_TYPE_SERVO_3WIRE) {
-            (void)ledc_stop(LEDC_LOW_SPEED_MODE, out->cfg.servo_3wire.channel, 0);
+            (void)ledc_stop(LEDC_LOW_SPEED_MODE, out->cfg.servo_3wire->channel, 0);
         }
-        if (out->type == OUTPUT_TYPE_SERVO_5WIRE && out->cfg.servo_5wire.gpio_b >= 0) {
+        if (out->type == OUTPUT_TYPE_SERVO_5WIRE && out->cfg.servo_5wire->gpio_b >= 0) {
             (void)servo_5wire_set_drive_locked(out, 0);
-            gpio_reset_pin((gpio_num_t)out->cfg.servo_5wire.gpio_b);
+            gpio_reset_pin((gpio_num_t)out->cfg.servo_5wire->gpio_b);
         }
         if (out->type == OUTPUT_TYPE_CLOCK_4X4094) {
-            if (out->cfg.clock_4x4094.brightness_gpio >= 0) {
-                (void)ledc_stop(LEDC_LOW_SPEED_MODE, out->cfg.clock_4x4094.channel, 0);
-                gpio_reset_pin((gpio_num_t)out->cfg.clock_4x4094.brightness_gpio);
+            if (out->cfg.clock_4x4094->brightness_gpio >= 0) {
+                (void)ledc_stop(LEDC_LOW_SPEED_MODE, out->cfg.clock_4x4094->channel, 0);
+                gpio_reset_pin((gpio_num_t)out->cfg.clock_4x4094->brightness_gpio);
             }
-            if (out->cfg.clock_4x4094.gpio_b >= 0) {
-                gpio_reset_pin((gpio_num_t)out->cfg.clock_4x4094.gpio_b);
+            if (out->cfg.clock_4x4094->gpio_b >= 0) {
+                gpio_reset_pin((gpio_num_t)out->cfg.clock_4x4094->gpio_b);
             }
-            if (out->cfg.clock_4x4094.gpio_c >= 0) {
-                gpio_reset_pin((gpio_num_t)out->cfg.clock_4x4094.gpio_c);
+            if (out->cfg.clock_4x4094->gpio_c >= 0) {
+                gpio_reset_pin((gpio_num_t)out->cfg.clock_4x4094->gpio_c);
             }
         }
         if (out->type == OUTPUT_TYPE_STEPPER_28BYJ) {
             (void)stepper_28byj_release_locked(out);
-            if (out->cfg.stepper_28byj.gpio_b >= 0) {
-                gpio_reset_pin((gpio_num_t)out->cfg.stepper_28byj.gpio_b);
+            if (out->cfg.stepper_28byj->gpio_b >= 0) {
+                gpio_reset_pin((gpio_num_t)out->cfg.stepper_28byj->gpio_b);
             }
-            if (out->cfg.stepper_28byj.gpio_c >= 0) {
-                gpio_reset_pin((gpio_num_t)out->cfg.stepper_28byj.gpio_c);
+            if (out->cfg.stepper_28byj->gpio_c >= 0) {
+                gpio_reset_pin((gpio_num_t)out->cfg.stepper_28byj->gpio_c);
             }
-            if (out->cfg.stepper_28byj.gpio_d >= 0) {
-                gpio_reset_pin((gpio_num_t)out->cfg.stepper_28byj.gpio_d);
+            if (out->cfg.stepper_28byj->gpio_d >= 0) {
+                gpio_reset_pin((gpio_num_t)out->cfg.stepper_28byj->gpio_d);
             }
-            if (out->cfg.stepper_28byj.home_gpio >= 0) {
-                gpio_reset_pin((gpio_num_t)out->cfg.stepper_28byj.home_gpio);
+            if (out->cfg.stepper_28byj->home_gpio >= 0) {
+                gpio_reset_pin((gpio_num_t)out->cfg.stepper_28byj->home_gpio);
             }
         }
         if (out->type == OUTPUT_TYPE_STEPPER_A4988) {
+            stepper_a4988_rmt_deinit(out);
             (void)stepper_a4988_set_enable_locked(out, false);
-            if (out->cfg.stepper_a4988.gpio_b >= 0) {
-                gpio_reset_pin((gpio_num_t)out->cfg.stepper_a4988.gpio_b);
+            if (out->cfg.stepper_a4988->gpio_b >= 0) {
+                gpio_reset_pin((gpio_num_t)out->cfg.stepper_a4988->gpio_b);
             }
-            if (out->cfg.stepper_a4988.gpio_c >= 0) {
-                gpio_reset_pin((gpio_num_t)out->cfg.stepper_a4988.gpio_c);
+            if (out->cfg.stepper_a4988->gpio_c >= 0) {
+                gpio_reset_pin((gpio_num_t)out->cfg.stepper_a4988->gpio_c);
             }
-            if (out->cfg.stepper_a4988.home_gpio >= 0) {
-                gpio_reset_pin((gpio_num_t)out->cfg.stepper_a4988.home_gpio);
+            if (out->cfg.stepper_a4988->home_gpio >= 0) {
+                gpio_reset_pin((gpio_num_t)out->cfg.stepper_a4988->home_gpio);
             }
         }
         if (out->gpio >= 0) {
@@ -2533,17 +3234,36 @@ static void clear_runtime_locked(void)
         }
     }
 
+    // Reconfiguration must not lose pulses counted since the last periodic save.
     for (int i = 0; i < s_runtime.input_count; ++i) {
+        if (s_runtime.inputs[i].counter && s_runtime.inputs[i].edge_capture) {
+            s_runtime.inputs[i].total += gpio_edge_take_count((uint8_t)i);
+        }
+    }
+    int save_count = collect_counter_saves_locked(saves);
+
+    for (int i = 0; i < s_runtime.input_count; ++i) {
+        if (s_runtime.inputs[i].edge_capture) {
+            gpio_edge_remove(s_runtime.inputs[i].gpio);
+        }
         if (s_runtime.inputs[i].used && s_runtime.inputs[i].gpio >= 0) {
             gpio_reset_pin((gpio_num_t)s_runtime.inputs[i].gpio);
         }
     }
     for (int i = 0; i < s_runtime.button_count; ++i) {
+        if (s_runtime.buttons[i].edge_capture) {
+            gpio_edge_remove(s_runtime.buttons[i].gpio);
+        }
         if (s_runtime.buttons[i].used && s_runtime.buttons[i].gpio >= 0) {
             gpio_reset_pin((gpio_num_t)s_runtime.buttons[i].gpio);
         }
     }
 
+    // Queued edges are tagged with indexes of the runtime being torn down.
+    gpio_edge_event_t stale;
+    while (gpio_edge_pop(&stale)) {
+    }
+
     for (int i = 0; i < s_runtime.sensor_count; ++i) {
         sensor_runtime_t *sensor = &s_runtime.sensors[i];
         if (!sensor->used) {
@@ -2576,34 +3296,149 @@ static void clear_runtime_locked(void)
         s_runtime.adc.handle = NULL;
     }
 
+    free(s_runtime.arena);
     memset(&s_runtime, 0, sizeof(s_runtime));
+    rebuild_id_index_locked();
+
+    return save_count;
 }
 
-static esp_err_t configure_output(output_runtime_t *out, const cJSON *item, ledc_allocator_t *ledc_alloc)
+static void *arena_take(runtime_arena_t *arena, size_t size)
 {
-    memset(out, 0, sizeof(*out));
-    out->used = true;
-    out->enabled = jbool(item, "enabled", true);
-    out->type = output_type_from_text(jstr(item, "type", "relay"));
-    out->gpio = jint(item, "gpio", -1);
-    out->supported = true;
-    snprintf(out->id, sizeof(out->id), "%s", jstr(item, "id", ""));
-    snprintf(out->name, sizeof(out->name), "%s", jstr(item, "name", out->id));
-    snprintf(out->role, sizeof(out->role), "%s", jstr(item, "role", "generic"));
-    snprintf(out->mqtt_component, sizeof(out->mqtt_component), "%s",
-             normalize_output_mqtt_component(jstr(item, "mqtt_component", "auto")));
-    snprintf(out->mqtt_number_mode, sizeof(out->mqtt_number_mode), "%s",
-             normalize_output_mqtt_number_mode(jstr(item, "mqtt_number_mode", "slider")));
-
-    if (!out->enabled) {
-        return ESP_OK;
-    }
+    size_t offset = (arena->used + MODULES_ARENA_ALIGN - 1) & ~(size_t)(MODULES_ARENA_ALIGN - 1);
+    arena->used = offset + size;
+    return arena->base && size > 0 ? arena->base + offset : NULL;
+}
 
-    if (output_uses_plain_gpio(out->type)) {
-        gpio_config_t io = {
-            .pin_bit_mask = 1ULL << out->gpio,
-            .mode = GPIO_MODE_OUTPUT,
-            .pull_up_en = GPIO_PULLUP_DISABLE,
+static size_t output_state_size(output_type_t type)
+{
+    switch (type) {
+        case OUTPUT_TYPE_RELAY:
+            return sizeof(relay_output_t);
+        case OUTPUT_TYPE_PWM:
+            return sizeof(pwm_output_t);
+        case OUTPUT_TYPE_WS2812:
+            return sizeof(ws2812_output_t);
+        case OUTPUT_TYPE_SERVO_3WIRE:
+            return sizeof(servo_3wire_output_t);
+        case OUTPUT_TYPE_SERVO_5WIRE:
+            return sizeof(servo_5wire_output_t);
+        case OUTPUT_TYPE_CLOCK_4X4094:
+            return sizeof(clock_4x4094_output_t);
+        case OUTPUT_TYPE_STEPPER_28BYJ:
+            return sizeof(stepper_28byj_output_t);
+        case OUTPUT_TYPE_STEPPER_A4988:
+            return sizeof(stepper_a4988_output_t);
+        default:
+            return 0;
+    }
+}
+
+static int config_array_count(const cJSON *items, int max)
+{
+    int count = cJSON_IsArray((cJSON *)items) ? cJSON_GetArraySize((cJSON *)items) : 0;
+    return count > max ? max : count;
+}
+
+static void plan_runtime_layout(runtime_layout_t *layout, const cJSON *cfg)
+{
+    memset(layout, 0, sizeof(*layout));
+    layout->outputs = jobj(cfg, "outputs");
+    layout->inputs = jobj(cfg, "inputs");
+    layout->buttons = jobj(cfg, "buttons");
+    layout->sensors = jobj(cfg, "sensors");
+    layout->output_count = config_array_count(layout->outputs, MODULES_MAX_OUTPUTS);
+    layout->input_count = config_array_count(layout->inputs, MODULES_MAX_INPUTS);
+    layout->button_count = config_array_count(layout->buttons, MODULES_MAX_BUTTONS);
+    layout->sensor_count = config_array_count(layout->sensors, MODULES_MAX_SENSORS);
+    for (int i = 0; i < layout->output_count; ++i) {
+        const cJSON *item = cJSON_GetArrayItem((cJSON *)layout->outputs, i);
+        layout->output_types[i] = output_type_from_text(jstr(item, "type", "relay"));
+        if (layout->output_types[i] == OUTPUT_TYPE_WS2812) {
+            layout->ws2812_pixels[i] = ws2812_pixel_count(item);
+        }
+    }
+}
+
+// Entity tables first, then one pool per output type so state of the same kind stays contiguous.
+static void carve_runtime_arena(runtime_arena_t *arena, runtime_layout_t *layout)
+{
+    bool placed[MODULES_MAX_OUTPUTS] = {0};
+
+    s_runtime.outputs = arena_take(arena, (size_t)layout->output_count * sizeof(output_runtime_t));
+    s_runtime.inputs = arena_take(arena, (size_t)layout->input_count * sizeof(input_runtime_t));
+    s_runtime.buttons = arena_take(arena, (size_t)layout->button_count * sizeof(button_runtime_t));
+    s_runtime.sensors = arena_take(arena, (size_t)layout->sensor_count * sizeof(sensor_runtime_t));
+    for (int i = 0; i < layout->output_count; ++i) {
+        if (placed[i]) {
+            continue;
+        }
+        for (int j = i; j < layout->output_count; ++j) {
+            if (layout->output_types[j] == layout->output_types[i]) {
+                layout->output_states[j] = arena_take(arena, output_state_size(layout->output_types[j]));
+                placed[j] = true;
+            }
+        }
+    }
+    for (int i = 0; i < layout->output_count; ++i) {
+        if (layout->output_types[i] != OUTPUT_TYPE_WS2812) {
+            continue;
+        }
+        size_t frame_len = (size_t)layout->ws2812_pixels[i] * WS2812_BYTES_PER_PIXEL;
+        uint8_t *frame = arena_take(arena, frame_len);
+        uint8_t *tx_frame = arena_take(arena, frame_len);
+        if (layout->output_states[i]) {
+            ((ws2812_output_t *)layout->output_states[i])->frame = frame;
+            ((ws2812_output_t *)layout->output_states[i])->tx_frame = tx_frame;
+        }
+    }
+}
+
+static esp_err_t alloc_runtime_arena_locked(runtime_layout_t *layout)
+{
+    runtime_arena_t arena = {0};
+
+    carve_runtime_arena(&arena, layout);
+    if (arena.used > 0) {
+        arena.base = calloc(1, arena.used);
+        if (!arena.base) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    s_runtime.arena = arena.base;
+    s_runtime.arena_size = arena.used;
+    arena.used = 0;
+    carve_runtime_arena(&arena, layout);
+    return ESP_OK;
+}
+
+static esp_err_t configure_output(output_runtime_t *out, const cJSON *item, void *state,
+                                 ledc_allocator_t *ledc_alloc)
+{
+    memset(out, 0, sizeof(*out));
+    out->used = true;
+    out->enabled = jbool(item, "enabled", true);
+    out->type = output_type_from_text(jstr(item, "type", "relay"));
+    out->cfg.state = state;
+    out->gpio = jint(item, "gpio", -1);
+    out->supported = true;
+    snprintf(out->id, sizeof(out->id), "%s", jstr(item, "id", ""));
+    snprintf(out->name, sizeof(out->name), "%s", jstr(item, "name", out->id));
+    snprintf(out->role, sizeof(out->role), "%s", jstr(item, "role", "generic"));
+    snprintf(out->mqtt_component, sizeof(out->mqtt_component), "%s",
+             normalize_output_mqtt_component(jstr(item, "mqtt_component", "auto")));
+    snprintf(out->mqtt_number_mode, sizeof(out->mqtt_number_mode), "%s",
+             normalize_output_mqtt_number_mode(jstr(item, "mqtt_number_mode", "slider")));
+
+    if (!out->enabled) {
+        return ESP_OK;
+    }
+
+    if (output_uses_plain_gpio(out->type)) {
+        gpio_config_t io = {
+            .pin_bit_mask = 1ULL << out->gpio,
+            .mode = GPIO_MODE_OUTPUT,
+            .pull_up_en = GPIO_PULLUP_DISABLE,
             .pull_down_en = GPIO_PULLDOWN_DISABLE,
             .intr_type = GPIO_INTR_DISABLE,
         };
@@ -2611,35 +3446,35 @@ static esp_err_t configure_output(output_runtime_t *out, const cJSON *item, ledc
     }
 
     if (out->type == OUTPUT_TYPE_RELAY) {
-        out->cfg.relay.active_level = jint(item, "active_level", 1) ? 1 : 0;
-        out->cfg.relay.default_on = jbool(item, "default_on", false);
-        out->power = out->cfg.relay.default_on;
+        out->cfg.relay->active_level = jint(item, "active_level", 1) ? 1 : 0;
+        out->cfg.relay->default_on = jbool(item, "default_on", false);
+        out->power = out->cfg.relay->default_on;
         return output_apply_physical_state(out);
     }
 
     if (out->type == OUTPUT_TYPE_PWM) {
-        out->cfg.pwm.freq_hz = jint(item, "freq_hz", 1000);
-        out->cfg.pwm.inverted = jbool(item, "inverted", false);
-        out->cfg.pwm.level = jint(item, "default_level", 0);
-        out->cfg.pwm.max_level_pct = jint(item, "max_level_pct", 100);
-        if (out->cfg.pwm.max_level_pct < 1) {
-            out->cfg.pwm.max_level_pct = 1;
-        }
-        if (out->cfg.pwm.max_level_pct > 100) {
-            out->cfg.pwm.max_level_pct = 100;
-        }
-        out->cfg.pwm.power_relay_gpio = jint(item, "power_relay_gpio", -1);
-        out->cfg.pwm.power_relay_active_level = jint(item, "power_relay_active_level", 1) ? 1 : 0;
-        ESP_RETURN_ON_ERROR(ledc_allocator_acquire(ledc_alloc, out->cfg.pwm.freq_hz, LEDC_TIMER_13_BIT,
-                                                   &out->cfg.pwm.channel, &out->cfg.pwm.timer),
+        out->cfg.pwm->freq_hz = jint(item, "freq_hz", 1000);
+        out->cfg.pwm->inverted = jbool(item, "inverted", false);
+        out->cfg.pwm->level = jint(item, "default_level", 0);
+        out->cfg.pwm->max_level_pct = jint(item, "max_level_pct", 100);
+        if (out->cfg.pwm->max_level_pct < 1) {
+            out->cfg.pwm->max_level_pct = 1;
+        }
+        if (out->cfg.pwm->max_level_pct > 100) {
+            out->cfg.pwm->max_level_pct = 100;
+        }
+        out->cfg.pwm->power_relay_gpio = jint(item, "power_relay_gpio", -1);
+        out->cfg.pwm->power_relay_active_level = jint(item, "power_relay_active_level", 1) ? 1 : 0;
+        ESP_RETURN_ON_ERROR(ledc_allocator_acquire(ledc_alloc, out->cfg.pwm->freq_hz, LEDC_TIMER_13_BIT,
+                                                   &out->cfg.pwm->channel, &out->cfg.pwm->timer),
                             TAG, "LEDC exhausted for PWM output %s", out->id);
-        out->power = out->cfg.pwm.level > 0;
+        out->power = out->cfg.pwm->level > 0;
 
         ledc_timer_config_t timer_cfg = {
             .speed_mode = LEDC_LOW_SPEED_MODE,
-            .timer_num = out->cfg.pwm.timer,
+            .timer_num = out->cfg.pwm->timer,
             .duty_resolution = LEDC_TIMER_13_BIT,
-            .freq_hz = out->cfg.pwm.freq_hz,
+            .freq_hz = out->cfg.pwm->freq_hz,
             .clk_cfg = LEDC_AUTO_CLK,
         };
         ESP_RETURN_ON_ERROR(ledc_timer_config(&timer_cfg), TAG, "LEDC timer config failed for %s", out->id);
@@ -2647,17 +3482,17 @@ static esp_err_t configure_output(output_runtime_t *out, const cJSON *item, ledc
         ledc_channel_config_t chan_cfg = {
             .gpio_num = out->gpio,
             .speed_mode = LEDC_LOW_SPEED_MODE,
-            .channel = out->cfg.pwm.channel,
+            .channel = out->cfg.pwm->channel,
             .intr_type = LEDC_INTR_DISABLE,
-            .timer_sel = out->cfg.pwm.timer,
+            .timer_sel = out->cfg.pwm->timer,
             .duty = 0,
             .hpoint = 0,
         };
         ESP_RETURN_ON_ERROR(ledc_channel_config(&chan_cfg), TAG, "LEDC channel config failed for %s", out->id);
 
-        if (out->cfg.pwm.power_relay_gpio >= 0) {
+        if (out->cfg.pwm->power_relay_gpio >= 0) {
             gpio_config_t relay_io = {
-                .pin_bit_mask = 1ULL << out->cfg.pwm.power_relay_gpio,
+                .pin_bit_mask = 1ULL << out->cfg.pwm->power_relay_gpio,
                 .mode = GPIO_MODE_OUTPUT,
                 .pull_up_en = GPIO_PULLUP_DISABLE,
                 .pull_down_en = GPIO_PULLDOWN_DISABLE,
@@ -2670,42 +3505,42 @@ static esp_err_t configure_output(output_runtime_t *out, const cJSON *item, ledc
     }
 
     if (out->type == OUTPUT_TYPE_SERVO_3WIRE) {
-        out->cfg.servo_3wire.level = jint(item, "default_level", 0);
-        out->cfg.servo_3wire.min_us = jint(item, "min_us", 500);
-        out->cfg.servo_3wire.max_us = jint(item, "max_us", 2500);
-        out->cfg.servo_3wire.reverse_direction = jbool(item, "reverse_direction", false);
-        out->cfg.servo_3wire.hold_power_ms = jint(item, "hold_power_ms", SERVO_3WIRE_HOLD_MS_DEFAULT);
-        if (out->cfg.servo_3wire.level < 0) {
-            out->cfg.servo_3wire.level = 0;
+        out->cfg.servo_3wire->level = jint(item, "default_level", 0);
+        out->cfg.servo_3wire->min_us = jint(item, "min_us", 500);
+        out->cfg.servo_3wire->max_us = jint(item, "max_us", 2500);
+        out->cfg.servo_3wire->reverse_direction = jbool(item, "reverse_direction", false);
+        out->cfg.servo_3wire->hold_power_ms = jint(item, "hold_power_ms", SERVO_3WIRE_HOLD_MS_DEFAULT);
+        if (out->cfg.servo_3wire->level < 0) {
+            out->cfg.servo_3wire->level = 0;
         }
-        if (out->cfg.servo_3wire.level > 100) {
-            out->cfg.servo_3wire.level = 100;
+        if (out->cfg.servo_3wire->level > 100) {
+            out->cfg.servo_3wire->level = 100;
         }
-        if (out->cfg.servo_3wire.min_us < 400) {
-            out->cfg.servo_3wire.min_us = 400;
+        if (out->cfg.servo_3wire->min_us < 400) {
+            out->cfg.servo_3wire->min_us = 400;
         }
-        if (out->cfg.servo_3wire.max_us > 2600) {
-            out->cfg.servo_3wire.max_us = 2600;
+        if (out->cfg.servo_3wire->max_us > 2600) {
+            out->cfg.servo_3wire->max_us = 2600;
         }
-        if (out->cfg.servo_3wire.max_us <= out->cfg.servo_3wire.min_us) {
-            out->cfg.servo_3wire.max_us = out->cfg.servo_3wire.min_us + 100;
+        if (out->cfg.servo_3wire->max_us <= out->cfg.servo_3wire->min_us) {
+            out->cfg.servo_3wire->max_us = out->cfg.servo_3wire->min_us + 100;
         }
-        if (out->cfg.servo_3wire.hold_power_ms < 0) {
-            out->cfg.servo_3wire.hold_power_ms = 0;
+        if (out->cfg.servo_3wire->hold_power_ms < 0) {
+            out->cfg.servo_3wire->hold_power_ms = 0;
         }
-        if (out->cfg.servo_3wire.hold_power_ms > 10000) {
-            out->cfg.servo_3wire.hold_power_ms = 10000;
+        if (out->cfg.servo_3wire->hold_power_ms > 10000) {
+            out->cfg.servo_3wire->hold_power_ms = 10000;
         }
-        out->cfg.servo_3wire.release_at_us = 0;
+        out->cfg.servo_3wire->release_at_us = 0;
 
         ESP_RETURN_ON_ERROR(ledc_allocator_acquire(ledc_alloc, 50, LEDC_TIMER_13_BIT,
-                                                   &out->cfg.servo_3wire.channel, &out->cfg.servo_3wire.timer),
+                                                   &out->cfg.servo_3wire->channel, &out->cfg.servo_3wire->timer),
                             TAG, "LEDC exhausted for servo output %s", out->id);
         out->power = true;
 
         ledc_timer_config_t timer_cfg = {
             .speed_mode = LEDC_LOW_SPEED_MODE,
-            .timer_num = out->cfg.servo_3wire.timer,
+            .timer_num = out->cfg.servo_3wire->timer,
             .duty_resolution = LEDC_TIMER_13_BIT,
             .freq_hz = 50,
             .clk_cfg = LEDC_AUTO_CLK,
@@ -2715,9 +3550,9 @@ static esp_err_t configure_output(output_runtime_t *out, const cJSON *item, ledc
         ledc_channel_config_t chan_cfg = {
             .gpio_num = out->gpio,
             .speed_mode = LEDC_LOW_SPEED_MODE,
-            .channel = out->cfg.servo_3wire.channel,
+            .channel = out->cfg.servo_3wire->channel,
             .intr_type = LEDC_INTR_DISABLE,
-            .timer_sel = out->cfg.servo_3wire.timer,
+            .timer_sel = out->cfg.servo_3wire->timer,
             .duty = 0,
             .hpoint = 0,
         };
@@ -2726,48 +3561,48 @@ static esp_err_t configure_output(output_runtime_t *out, const cJSON *item, ledc
     }
 
     if (out->type == OUTPUT_TYPE_SERVO_5WIRE) {
-        out->cfg.servo_5wire.gpio_b = jint(item, "gpio_b", -1);
-        out->cfg.servo_5wire.feedback_gpio = jint(item, "feedback_gpio", -1);
-        out->cfg.servo_5wire.feedback_min_raw = jint(item, "feedback_min_raw", 300);
-        out->cfg.servo_5wire.feedback_max_raw = jint(item, "feedback_max_raw", 3700);
-        out->cfg.servo_5wire.deadband_pct = jint(item, "deadband_pct", 2);
-        out->cfg.servo_5wire.move_timeout_ms = jint(item, "move_timeout_ms", 15000);
-        out->cfg.servo_5wire.reverse_direction = jbool(item, "reverse_direction", false);
-        out->cfg.servo_5wire.target_level = jint(item, "default_level", 0);
-        out->cfg.servo_5wire.feedback_raw = 0;
-        out->cfg.servo_5wire.current_level = 0;
-        out->cfg.servo_5wire.drive_state = 0;
-        out->cfg.servo_5wire.moving = false;
-        out->cfg.servo_5wire.timed_out = false;
-        if (out->cfg.servo_5wire.target_level < 0) {
-            out->cfg.servo_5wire.target_level = 0;
-        }
-        if (out->cfg.servo_5wire.target_level > 100) {
-            out->cfg.servo_5wire.target_level = 100;
-        }
-        if (out->cfg.servo_5wire.deadband_pct < 1) {
-            out->cfg.servo_5wire.deadband_pct = 1;
-        }
-        if (out->cfg.servo_5wire.deadband_pct > 20) {
-            out->cfg.servo_5wire.deadband_pct = 20;
-        }
-        if (out->cfg.servo_5wire.move_timeout_ms < 1000) {
-            out->cfg.servo_5wire.move_timeout_ms = 1000;
-        }
-        if (out->cfg.servo_5wire.move_timeout_ms > 60000) {
-            out->cfg.servo_5wire.move_timeout_ms = 60000;
+        out->cfg.servo_5wire->gpio_b = jint(item, "gpio_b", -1);
+        out->cfg.servo_5wire->feedback_gpio = jint(item, "feedback_gpio", -1);
+        out->cfg.servo_5wire->feedback_min_raw = jint(item, "feedback_min_raw", 300);
+        out->cfg.servo_5wire->feedback_max_raw = jint(item, "feedback_max_raw", 3700);
+        out->cfg.servo_5wire->deadband_pct = jint(item, "deadband_pct", 2);
+        out->cfg.servo_5wire->move_timeout_ms = jint(item, "move_timeout_ms", 15000);
+        out->cfg.servo_5wire->reverse_direction = jbool(item, "reverse_direction", false);
+        out->cfg.servo_5wire->target_level = jint(item, "default_level", 0);
+        out->cfg.servo_5wire->feedback_raw = 0;
+        out->cfg.servo_5wire->current_level = 0;
+        out->cfg.servo_5wire->drive_state = 0;
+        out->cfg.servo_5wire->moving = false;
+        out->cfg.servo_5wire->timed_out = false;
+        if (out->cfg.servo_5wire->target_level < 0) {
+            out->cfg.servo_5wire->target_level = 0;
+        }
+        if (out->cfg.servo_5wire->target_level > 100) {
+            out->cfg.servo_5wire->target_level = 100;
+        }
+        if (out->cfg.servo_5wire->deadband_pct < 1) {
+            out->cfg.servo_5wire->deadband_pct = 1;
+        }
+        if (out->cfg.servo_5wire->deadband_pct > 20) {
+            out->cfg.servo_5wire->deadband_pct = 20;
+        }
+        if (out->cfg.servo_5wire->move_timeout_ms < 1000) {
+            out->cfg.servo_5wire->move_timeout_ms = 1000;
+        }
+        if (out->cfg.servo_5wire->move_timeout_ms > 60000) {
+            out->cfg.servo_5wire->move_timeout_ms = 60000;
         }
 
         gpio_config_t io_b = {
-            .pin_bit_mask = 1ULL << out->cfg.servo_5wire.gpio_b,
+            .pin_bit_mask = 1ULL << out->cfg.servo_5wire->gpio_b,
             .mode = GPIO_MODE_OUTPUT,
             .pull_up_en = GPIO_PULLUP_DISABLE,
             .pull_down_en = GPIO_PULLDOWN_DISABLE,
             .intr_type = GPIO_INTR_DISABLE,
         };
         ESP_RETURN_ON_ERROR(gpio_config(&io_b), TAG, "servo gpio setup failed for %s", out->id);
-        ESP_RETURN_ON_ERROR(ensure_adc_channel_locked(out->cfg.servo_5wire.feedback_gpio,
-                                                     &out->cfg.servo_5wire.adc_channel),
+        ESP_RETURN_ON_ERROR(ensure_adc_channel_locked(out->cfg.servo_5wire->feedback_gpio,
+                                                     &out->cfg.servo_5wire->adc_channel),
                             TAG, "servo adc setup failed for %s", out->id);
         out->supported = true;
         out->power = false;
@@ -2777,79 +3612,79 @@ static esp_err_t configure_output(output_runtime_t *out, const cJSON *item, ledc
     }
 
     if (out->type == OUTPUT_TYPE_CLOCK_4X4094) {
-        out->cfg.clock_4x4094.gpio_b = jint(item, "gpio_b", -1);
-        out->cfg.clock_4x4094.gpio_c = jint(item, "gpio_c", -1);
-        out->cfg.clock_4x4094.brightness_gpio = jint(item, "brightness_gpio", -1);
-        out->cfg.clock_4x4094.segment_map[0] = (uint8_t)(jint(item, "segment_a", 1) - 1);
-        out->cfg.clock_4x4094.segment_map[1] = (uint8_t)(jint(item, "segment_b", 2) - 1);
-        out->cfg.clock_4x4094.segment_map[2] = (uint8_t)(jint(item, "segment_c", 3) - 1);
-        out->cfg.clock_4x4094.segment_map[3] = (uint8_t)(jint(item, "segment_d", 4) - 1);
-        out->cfg.clock_4x4094.segment_map[4] = (uint8_t)(jint(item, "segment_e", 5) - 1);
-        out->cfg.clock_4x4094.segment_map[5] = (uint8_t)(jint(item, "segment_f", 6) - 1);
-        out->cfg.clock_4x4094.segment_map[6] = (uint8_t)(jint(item, "segment_g", 7) - 1);
-        out->cfg.clock_4x4094.segment_map[7] = (uint8_t)(jint(item, "segment_dp", 8) - 1);
-        out->cfg.clock_4x4094.level = jint(item, "default_level", 100);
-        out->cfg.clock_4x4094.blink_period_ms = jint(item, "blink_period_ms", 2000);
-        out->cfg.clock_4x4094.timezone_offset_min = jint(item, "timezone_offset_min", 0);
-        out->cfg.clock_4x4094.default_on = jbool(item, "default_on", true);
-        out->cfg.clock_4x4094.common_anode = jbool(item, "common_anode", false);
-        out->cfg.clock_4x4094.mirror_segments = jbool(item, "mirror_segments", true);
-        out->cfg.clock_4x4094.reverse_digits = jbool(item, "reverse_digits", false);
-        out->cfg.clock_4x4094.leading_zero = jbool(item, "leading_zero", true);
-        out->cfg.clock_4x4094.blink_separator = jbool(item, "blink_separator", true);
-        out->cfg.clock_4x4094.time_valid = false;
-        out->cfg.clock_4x4094.separator_on = false;
-        out->cfg.clock_4x4094.display_hour = -1;
-        out->cfg.clock_4x4094.display_minute = -1;
-        out->cfg.clock_4x4094.last_render_us = 0;
-        memset(out->cfg.clock_4x4094.display_text, 0, sizeof(out->cfg.clock_4x4094.display_text));
-        memset(out->cfg.clock_4x4094.segments, 0, sizeof(out->cfg.clock_4x4094.segments));
-
-        if (out->cfg.clock_4x4094.timezone_offset_min < -720) {
-            out->cfg.clock_4x4094.timezone_offset_min = -720;
-        }
-        if (out->cfg.clock_4x4094.timezone_offset_min > 840) {
-            out->cfg.clock_4x4094.timezone_offset_min = 840;
-        }
-        if (out->cfg.clock_4x4094.level < 0) {
-            out->cfg.clock_4x4094.level = 0;
-        }
-        if (out->cfg.clock_4x4094.level > 100) {
-            out->cfg.clock_4x4094.level = 100;
-        }
-        if (out->cfg.clock_4x4094.blink_period_ms < 200) {
-            out->cfg.clock_4x4094.blink_period_ms = 200;
-        }
-        if (out->cfg.clock_4x4094.blink_period_ms > 10000) {
-            out->cfg.clock_4x4094.blink_period_ms = 10000;
+        out->cfg.clock_4x4094->gpio_b = jint(item, "gpio_b", -1);
+        out->cfg.clock_4x4094->gpio_c = jint(item, "gpio_c", -1);
+        out->cfg.clock_4x4094->brightness_gpio = jint(item, "brightness_gpio", -1);
+        out->cfg.clock_4x4094->segment_map[0] = (uint8_t)(jint(item, "segment_a", 1) - 1);
+        out->cfg.clock_4x4094->segment_map[1] = (uint8_t)(jint(item, "segment_b", 2) - 1);
+        out->cfg.clock_4x4094->segment_map[2] = (uint8_t)(jint(item, "segment_c", 3) - 1);
+        out->cfg.clock_4x4094->segment_map[3] = (uint8_t)(jint(item, "segment_d", 4) - 1);
+        out->cfg.clock_4x4094->segment_map[4] = (uint8_t)(jint(item, "segment_e", 5) - 1);
+        out->cfg.clock_4x4094->segment_map[5] = (uint8_t)(jint(item, "segment_f", 6) - 1);
+        out->cfg.clock_4x4094->segment_map[6] = (uint8_t)(jint(item, "segment_g", 7) - 1);
+        out->cfg.clock_4x4094->segment_map[7] = (uint8_t)(jint(item, "segment_dp", 8) - 1);
+        out->cfg.clock_4x4094->level = jint(item, "default_level", 100);
+        out->cfg.clock_4x4094->blink_period_ms = jint(item, "blink_period_ms", 2000);
+        out->cfg.clock_4x4094->timezone_offset_min = jint(item, "timezone_offset_min", 0);
+        out->cfg.clock_4x4094->default_on = jbool(item, "default_on", true);
+        out->cfg.clock_4x4094->common_anode = jbool(item, "common_anode", false);
+        out->cfg.clock_4x4094->mirror_segments = jbool(item, "mirror_segments", true);
+        out->cfg.clock_4x4094->reverse_digits = jbool(item, "reverse_digits", false);
+        out->cfg.clock_4x4094->leading_zero = jbool(item, "leading_zero", true);
+        out->cfg.clock_4x4094->blink_separator = jbool(item, "blink_separator", true);
+        out->cfg.clock_4x4094->time_valid = false;
+        out->cfg.clock_4x4094->separator_on = false;
+        out->cfg.clock_4x4094->display_hour = -1;
+        out->cfg.clock_4x4094->display_minute = -1;
+        out->cfg.clock_4x4094->last_render_us = 0;
+        memset(out->cfg.clock_4x4094->display_text, 0, sizeof(out->cfg.clock_4x4094->display_text));
+        memset(out->cfg.clock_4x4094->segments, 0, sizeof(out->cfg.clock_4x4094->segments));
+
+        if (out->cfg.clock_4x4094->timezone_offset_min < -720) {
+            out->cfg.clock_4x4094->timezone_offset_min = -720;
+        }
+        if (out->cfg.clock_4x4094->timezone_offset_min > 840) {
+            out->cfg.clock_4x4094->timezone_offset_min = 840;
+        }
+        if (out->cfg.clock_4x4094->level < 0) {
+            out->cfg.clock_4x4094->level = 0;
+        }
+        if (out->cfg.clock_4x4094->level > 100) {
+            out->cfg.clock_4x4094->level = 100;
+        }
+        if (out->cfg.clock_4x4094->blink_period_ms < 200) {
+            out->cfg.clock_4x4094->blink_period_ms = 200;
+        }
+        if (out->cfg.clock_4x4094->blink_period_ms > 10000) {
+            out->cfg.clock_4x4094->blink_period_ms = 10000;
         }
         for (int seg = 0; seg < 8; ++seg) {
-            if (out->cfg.clock_4x4094.segment_map[seg] > 7U) {
-                out->cfg.clock_4x4094.segment_map[seg] = (uint8_t)seg;
+            if (out->cfg.clock_4x4094->segment_map[seg] > 7U) {
+                out->cfg.clock_4x4094->segment_map[seg] = (uint8_t)seg;
             }
         }
-        if (out->cfg.clock_4x4094.gpio_b < 0 || out->cfg.clock_4x4094.gpio_c < 0) {
+        if (out->cfg.clock_4x4094->gpio_b < 0 || out->cfg.clock_4x4094->gpio_c < 0) {
             return ESP_ERR_INVALID_ARG;
         }
 
         gpio_config_t extra_io = {
-            .pin_bit_mask = (1ULL << out->cfg.clock_4x4094.gpio_b) |
-                            (1ULL << out->cfg.clock_4x4094.gpio_c),
+            .pin_bit_mask = (1ULL << out->cfg.clock_4x4094->gpio_b) |
+                            (1ULL << out->cfg.clock_4x4094->gpio_c),
             .mode = GPIO_MODE_OUTPUT,
             .pull_up_en = GPIO_PULLUP_DISABLE,
             .pull_down_en = GPIO_PULLDOWN_DISABLE,
             .intr_type = GPIO_INTR_DISABLE,
         };
         ESP_RETURN_ON_ERROR(gpio_config(&extra_io), TAG, "clock gpio setup failed for %s", out->id);
-        ESP_RETURN_ON_ERROR(gpio_set_level((gpio_num_t)out->cfg.clock_4x4094.gpio_b, 0), TAG, "clock clk init failed for %s", out->id);
-        ESP_RETURN_ON_ERROR(gpio_set_level((gpio_num_t)out->cfg.clock_4x4094.gpio_c, 0), TAG, "clock latch init failed for %s", out->id);
-        if (out->cfg.clock_4x4094.brightness_gpio >= 0) {
+        ESP_RETURN_ON_ERROR(gpio_set_level((gpio_num_t)out->cfg.clock_4x4094->gpio_b, 0), TAG, "clock clk init failed for %s", out->id);
+        ESP_RETURN_ON_ERROR(gpio_set_level((gpio_num_t)out->cfg.clock_4x4094->gpio_c, 0), TAG, "clock latch init failed for %s", out->id);
+        if (out->cfg.clock_4x4094->brightness_gpio >= 0) {
             ESP_RETURN_ON_ERROR(ledc_allocator_acquire(ledc_alloc, 1000, LEDC_TIMER_13_BIT,
-                                                       &out->cfg.clock_4x4094.channel, &out->cfg.clock_4x4094.timer),
+                                                       &out->cfg.clock_4x4094->channel, &out->cfg.clock_4x4094->timer),
                                 TAG, "LEDC exhausted for clock output %s", out->id);
             ledc_timer_config_t timer_cfg = {
                 .speed_mode = LEDC_LOW_SPEED_MODE,
-                .timer_num = out->cfg.clock_4x4094.timer,
+                .timer_num = out->cfg.clock_4x4094->timer,
                 .duty_resolution = LEDC_TIMER_13_BIT,
                 .freq_hz = 1000,
                 .clk_cfg = LEDC_AUTO_CLK,
@@ -2857,17 +3692,17 @@ static esp_err_t configure_output(output_runtime_t *out, const cJSON *item, ledc
             ESP_RETURN_ON_ERROR(ledc_timer_config(&timer_cfg), TAG, "clock LEDC timer config failed for %s", out->id);
 
             ledc_channel_config_t chan_cfg = {
-                .gpio_num = out->cfg.clock_4x4094.brightness_gpio,
+                .gpio_num = out->cfg.clock_4x4094->brightness_gpio,
                 .speed_mode = LEDC_LOW_SPEED_MODE,
-                .channel = out->cfg.clock_4x4094.channel,
+                .channel = out->cfg.clock_4x4094->channel,
                 .intr_type = LEDC_INTR_DISABLE,
-                .timer_sel = out->cfg.clock_4x4094.timer,
+                .timer_sel = out->cfg.clock_4x4094->timer,
                 .duty = 0,
                 .hpoint = 0,
             };
             ESP_RETURN_ON_ERROR(ledc_channel_config(&chan_cfg), TAG, "clock LEDC channel config failed for %s", out->id);
         }
-        out->power = out->cfg.clock_4x4094.default_on && out->cfg.clock_4x4094.level > 0;
+        out->power = out->cfg.clock_4x4094->default_on && out->cfg.clock_4x4094->level > 0;
         return output_apply_physical_state(out);
     }
 
@@ -2875,66 +3710,74 @@ static esp_err_t configure_output(output_runtime_t *out, const cJSON *item, ledc
         if (strcmp(out->role, "cover") != 0) {
             snprintf(out->role, sizeof(out->role), "%s", "generic");
         }
-        out->cfg.stepper_28byj.gpio_b = jint(item, "gpio_b", -1);
-        out->cfg.stepper_28byj.gpio_c = jint(item, "gpio_c", -1);
-        out->cfg.stepper_28byj.gpio_d = jint(item, "gpio_d", -1);
-        out->cfg.stepper_28byj.home_gpio = jint(item, "home_gpio", -1);
-        out->cfg.stepper_28byj.home_pull_mode = pull_mode_from_text(jstr(item, "home_pull", "up"));
-        out->cfg.stepper_28byj.home_inverted = jbool(item, "home_inverted", false);
-        out->cfg.stepper_28byj.auto_home_on_boot = jbool(item, "auto_home_on_boot", false);
-        out->cfg.stepper_28byj.steps_range = jint(item, "steps_range", 2048);
-        out->cfg.stepper_28byj.speed_steps_per_sec = jint(item, "speed_steps_per_sec", 400);
-        out->cfg.stepper_28byj.reverse_direction = jbool(item, "reverse_direction", false);
-        out->cfg.stepper_28byj.hold_enabled = jbool(item, "hold_enabled", false);
-        out->cfg.stepper_28byj.target_level = jint(item, "default_level", 0);
-        if (out->cfg.stepper_28byj.steps_range < 32) {
-            out->cfg.stepper_28byj.steps_range = 32;
-        }
-        if (out->cfg.stepper_28byj.steps_range > 200000) {
-            out->cfg.stepper_28byj.steps_range = 200000;
-        }
-        if (out->cfg.stepper_28byj.speed_steps_per_sec < 10) {
-            out->cfg.stepper_28byj.speed_steps_per_sec = 10;
-        }
-        if (out->cfg.stepper_28byj.speed_steps_per_sec > 1500) {
-            out->cfg.stepper_28byj.speed_steps_per_sec = 1500;
-        }
-        if (out->cfg.stepper_28byj.target_level < 0) {
-            out->cfg.stepper_28byj.target_level = 0;
-        }
-        if (out->cfg.stepper_28byj.target_level > 100) {
-            out->cfg.stepper_28byj.target_level = 100;
-        }
-        if (out->cfg.stepper_28byj.gpio_b < 0 || out->cfg.stepper_28byj.gpio_c < 0 || out->cfg.stepper_28byj.gpio_d < 0) {
+        out->cfg.stepper_28byj->gpio_b = jint(item, "gpio_b", -1);
+        out->cfg.stepper_28byj->gpio_c = jint(item, "gpio_c", -1);
+        out->cfg.stepper_28byj->gpio_d = jint(item, "gpio_d", -1);
+        out->cfg.stepper_28byj->home_gpio = jint(item, "home_gpio", -1);
+        out->cfg.stepper_28byj->home_pull_mode = pull_mode_from_text(jstr(item, "home_pull", "up"));
+        out->cfg.stepper_28byj->home_inverted = jbool(item, "home_inverted", false);
+        out->cfg.stepper_28byj->auto_home_on_boot = jbool(item, "auto_home_on_boot", false);
+        out->cfg.stepper_28byj->axis.steps_range = jint(item, "steps_range", 2048);
+        out->cfg.stepper_28byj->axis.speed_steps_per_sec = jint(item, "speed_steps_per_sec", 400);
+        out->cfg.stepper_28byj->axis.accel_steps_per_s2 = jint(item, "accel_steps_per_s2", 2000);
+        out->cfg.stepper_28byj->reverse_direction = jbool(item, "reverse_direction", false);
+        out->cfg.stepper_28byj->hold_enabled = jbool(item, "hold_enabled", false);
+        out->cfg.stepper_28byj->axis.target_level = jint(item, "default_level", 0);
+        if (out->cfg.stepper_28byj->axis.steps_range < 32) {
+            out->cfg.stepper_28byj->axis.steps_range = 32;
+        }
+        if (out->cfg.stepper_28byj->axis.steps_range > 200000) {
+            out->cfg.stepper_28byj->axis.steps_range = 200000;
+        }
+        if (out->cfg.stepper_28byj->axis.speed_steps_per_sec < 10) {
+            out->cfg.stepper_28byj->axis.speed_steps_per_sec = 10;
+        }
+        if (out->cfg.stepper_28byj->axis.accel_steps_per_s2 < 0) {
+            out->cfg.stepper_28byj->axis.accel_steps_per_s2 = 0;
+        }
+        if (out->cfg.stepper_28byj->axis.accel_steps_per_s2 > 100000) {
+            out->cfg.stepper_28byj->axis.accel_steps_per_s2 = 100000;
+        }
+        if (out->cfg.stepper_28byj->axis.speed_steps_per_sec > 1500) {
+            out->cfg.stepper_28byj->axis.speed_steps_per_sec = 1500;
+        }
+        if (out->cfg.stepper_28byj->axis.target_level < 0) {
+            out->cfg.stepper_28byj->axis.target_level = 0;
+        }
+        if (out->cfg.stepper_28byj->axis.target_level > 100) {
+            out->cfg.stepper_28byj->axis.target_level = 100;
+        }
+        if (out->cfg.stepper_28byj->gpio_b < 0 || out->cfg.stepper_28byj->gpio_c < 0 || out->cfg.stepper_28byj->gpio_d < 0) {
             return ESP_ERR_INVALID_ARG;
         }
-        out->cfg.stepper_28byj.target_position_steps =
-            stepper_level_to_position(out->cfg.stepper_28byj.target_level, out->cfg.stepper_28byj.steps_range);
-        out->cfg.stepper_28byj.current_position_steps = out->cfg.stepper_28byj.target_position_steps;
-        out->cfg.stepper_28byj.current_level = out->cfg.stepper_28byj.target_level;
-        out->cfg.stepper_28byj.phase_index = out->cfg.stepper_28byj.current_position_steps % 8;
-        out->cfg.stepper_28byj.home_active = false;
-        out->cfg.stepper_28byj.homing = false;
-        out->cfg.stepper_28byj.homed = false;
-        out->cfg.stepper_28byj.moving = false;
-        out->cfg.stepper_28byj.last_step_us = 0;
+        out->cfg.stepper_28byj->axis.target_position_steps =
+            stepper_level_to_position(out->cfg.stepper_28byj->axis.target_level, out->cfg.stepper_28byj->axis.steps_range);
+        out->cfg.stepper_28byj->axis.current_position_steps = out->cfg.stepper_28byj->axis.target_position_steps;
+        out->cfg.stepper_28byj->axis.current_level = out->cfg.stepper_28byj->axis.target_level;
+        stepper_axis_init_profile(&out->cfg.stepper_28byj->axis, false);
+        out->cfg.stepper_28byj->phase_index = out->cfg.stepper_28byj->axis.current_position_steps % 8;
+        out->cfg.stepper_28byj->home_active = false;
+        out->cfg.stepper_28byj->homing = false;
+        out->cfg.stepper_28byj->homed = false;
+        out->cfg.stepper_28byj->moving = false;
+        out->cfg.stepper_28byj->axis.last_step_us = 0;
 
         gpio_config_t extra_io = {
-            .pin_bit_mask = (1ULL << out->cfg.stepper_28byj.gpio_b) |
-                            (1ULL << out->cfg.stepper_28byj.gpio_c) |
-                            (1ULL << out->cfg.stepper_28byj.gpio_d),
+            .pin_bit_mask = (1ULL << out->cfg.stepper_28byj->gpio_b) |
+                            (1ULL << out->cfg.stepper_28byj->gpio_c) |
+                            (1ULL << out->cfg.stepper_28byj->gpio_d),
             .mode = GPIO_MODE_OUTPUT,
             .pull_up_en = GPIO_PULLUP_DISABLE,
             .pull_down_en = GPIO_PULLDOWN_DISABLE,
             .intr_type = GPIO_INTR_DISABLE,
         };
         ESP_RETURN_ON_ERROR(gpio_config(&extra_io), TAG, "stepper gpio setup failed for %s", out->id);
-        if (out->cfg.stepper_28byj.home_gpio >= 0) {
+        if (out->cfg.stepper_28byj->home_gpio >= 0) {
             gpio_config_t home_io = {
-                .pin_bit_mask = 1ULL << out->cfg.stepper_28byj.home_gpio,
+                .pin_bit_mask = 1ULL << out->cfg.stepper_28byj->home_gpio,
                 .mode = GPIO_MODE_INPUT,
-                .pull_up_en = (out->cfg.stepper_28byj.home_pull_mode == GPIO_PULLUP_ONLY) ? GPIO_PULLUP_ENABLE : GPIO_PULLUP_DISABLE,
-                .pull_down_en = (out->cfg.stepper_28byj.home_pull_mode == GPIO_PULLDOWN_ONLY) ? GPIO_PULLDOWN_ENABLE : GPIO_PULLDOWN_DISABLE,
+                .pull_up_en = (out->cfg.stepper_28byj->home_pull_mode == GPIO_PULLUP_ONLY) ? GPIO_PULLUP_ENABLE : GPIO_PULLUP_DISABLE,
+                .pull_down_en = (out->cfg.stepper_28byj->home_pull_mode == GPIO_PULLDOWN_ONLY) ? GPIO_PULLDOWN_ENABLE : GPIO_PULLDOWN_DISABLE,
                 .intr_type = GPIO_INTR_DISABLE,
             };
             ESP_RETURN_ON_ERROR(gpio_config(&home_io), TAG, "stepper home gpio setup failed for %s", out->id);
@@ -2942,13 +3785,13 @@ static esp_err_t configure_output(output_runtime_t *out, const cJSON *item, ledc
                 stepper_28byj_finish_home_locked(out);
                 return ESP_OK;
             }
-            if (out->cfg.stepper_28byj.auto_home_on_boot) {
+            if (out->cfg.stepper_28byj->auto_home_on_boot) {
                 ESP_RETURN_ON_ERROR(stepper_28byj_start_home_locked(out), TAG, "stepper home init failed for %s", out->id);
                 return ESP_OK;
             }
         }
-        if (out->cfg.stepper_28byj.hold_enabled) {
-            ESP_RETURN_ON_ERROR(stepper_28byj_apply_phase_locked(out, out->cfg.stepper_28byj.phase_index),
+        if (out->cfg.stepper_28byj->hold_enabled) {
+            ESP_RETURN_ON_ERROR(stepper_28byj_apply_phase_locked(out, out->cfg.stepper_28byj->phase_index),
                                 TAG, "stepper hold init failed for %s", out->id);
             out->power = true;
         } else {
@@ -2962,59 +3805,66 @@ static esp_err_t configure_output(output_runtime_t *out, const cJSON *item, ledc
         if (strcmp(out->role, "cover") != 0) {
             snprintf(out->role, sizeof(out->role), "%s", "generic");
         }
-        out->cfg.stepper_a4988.gpio_b = jint(item, "gpio_b", -1);
-        out->cfg.stepper_a4988.gpio_c = jint(item, "gpio_c", -1);
-        out->cfg.stepper_a4988.home_gpio = jint(item, "home_gpio", -1);
-        out->cfg.stepper_a4988.home_pull_mode = pull_mode_from_text(jstr(item, "home_pull", "up"));
-        out->cfg.stepper_a4988.home_inverted = jbool(item, "home_inverted", false);
-        out->cfg.stepper_a4988.auto_home_on_boot = jbool(item, "auto_home_on_boot", false);
-        out->cfg.stepper_a4988.enable_active_level = jint(item, "enable_active_level", 0) ? 1 : 0;
-        out->cfg.stepper_a4988.steps_range = jint(item, "steps_range", 200);
-        out->cfg.stepper_a4988.speed_steps_per_sec = jint(item, "speed_steps_per_sec", 800);
-        out->cfg.stepper_a4988.step_pulse_us = jint(item, "step_pulse_us", 4);
-        out->cfg.stepper_a4988.reverse_direction = jbool(item, "reverse_direction", false);
-        out->cfg.stepper_a4988.hold_enabled = jbool(item, "hold_enabled", false);
-        out->cfg.stepper_a4988.target_level = jint(item, "default_level", 0);
-        if (out->cfg.stepper_a4988.steps_range < 32) {
-            out->cfg.stepper_a4988.steps_range = 32;
+        out->cfg.stepper_a4988->gpio_b = jint(item, "gpio_b", -1);
+        out->cfg.stepper_a4988->gpio_c = jint(item, "gpio_c", -1);
+        out->cfg.stepper_a4988->home_gpio = jint(item, "home_gpio", -1);
+        out->cfg.stepper_a4988->home_pull_mode = pull_mode_from_text(jstr(item, "home_pull", "up"));
+        out->cfg.stepper_a4988->home_inverted = jbool(item, "home_inverted", false);
+        out->cfg.stepper_a4988->auto_home_on_boot = jbool(item, "auto_home_on_boot", false);
+        out->cfg.stepper_a4988->enable_active_level = jint(item, "enable_active_level", 0) ? 1 : 0;
+        out->cfg.stepper_a4988->axis.steps_range = jint(item, "steps_range", 200);
+        out->cfg.stepper_a4988->axis.speed_steps_per_sec = jint(item, "speed_steps_per_sec", 800);
+        out->cfg.stepper_a4988->axis.accel_steps_per_s2 = jint(item, "accel_steps_per_s2", 4000);
+        out->cfg.stepper_a4988->step_pulse_us = jint(item, "step_pulse_us", 4);
+        out->cfg.stepper_a4988->reverse_direction = jbool(item, "reverse_direction", false);
+        out->cfg.stepper_a4988->hold_enabled = jbool(item, "hold_enabled", false);
+        out->cfg.stepper_a4988->axis.target_level = jint(item, "default_level", 0);
+        if (out->cfg.stepper_a4988->axis.steps_range < 32) {
+            out->cfg.stepper_a4988->axis.steps_range = 32;
+        }
+        if (out->cfg.stepper_a4988->axis.steps_range > 200000) {
+            out->cfg.stepper_a4988->axis.steps_range = 200000;
+        }
+        if (out->cfg.stepper_a4988->axis.speed_steps_per_sec < 10) {
+            out->cfg.stepper_a4988->axis.speed_steps_per_sec = 10;
         }
-        if (out->cfg.stepper_a4988.steps_range > 200000) {
-            out->cfg.stepper_a4988.steps_range = 200000;
+        if (out->cfg.stepper_a4988->axis.accel_steps_per_s2 < 0) {
+            out->cfg.stepper_a4988->axis.accel_steps_per_s2 = 0;
         }
-        if (out->cfg.stepper_a4988.speed_steps_per_sec < 10) {
-            out->cfg.stepper_a4988.speed_steps_per_sec = 10;
+        if (out->cfg.stepper_a4988->axis.accel_steps_per_s2 > 100000) {
+            out->cfg.stepper_a4988->axis.accel_steps_per_s2 = 100000;
         }
-        if (out->cfg.stepper_a4988.speed_steps_per_sec > 20000) {
-            out->cfg.stepper_a4988.speed_steps_per_sec = 20000;
+        if (out->cfg.stepper_a4988->axis.speed_steps_per_sec > 20000) {
+            out->cfg.stepper_a4988->axis.speed_steps_per_sec = 20000;
         }
-        if (out->cfg.stepper_a4988.step_pulse_us < 2) {
-            out->cfg.stepper_a4988.step_pulse_us = 2;
+        if (out->cfg.stepper_a4988->step_pulse_us < 2) {
+            out->cfg.stepper_a4988->step_pulse_us = 2;
         }
-        if (out->cfg.stepper_a4988.step_pulse_us > 20) {
-            out->cfg.stepper_a4988.step_pulse_us = 20;
+        if (out->cfg.stepper_a4988->step_pulse_us > 20) {
+            out->cfg.stepper_a4988->step_pulse_us = 20;
         }
-        if (out->cfg.stepper_a4988.target_level < 0) {
-            out->cfg.stepper_a4988.target_level = 0;
+        if (out->cfg.stepper_a4988->axis.target_level < 0) {
+            out->cfg.stepper_a4988->axis.target_level = 0;
         }
-        if (out->cfg.stepper_a4988.target_level > 100) {
-            out->cfg.stepper_a4988.target_level = 100;
+        if (out->cfg.stepper_a4988->axis.target_level > 100) {
+            out->cfg.stepper_a4988->axis.target_level = 100;
         }
-        if (out->cfg.stepper_a4988.gpio_b < 0) {
+        if (out->cfg.stepper_a4988->gpio_b < 0) {
             return ESP_ERR_INVALID_ARG;
         }
-        out->cfg.stepper_a4988.target_position_steps =
-            stepper_level_to_position(out->cfg.stepper_a4988.target_level, out->cfg.stepper_a4988.steps_range);
-        out->cfg.stepper_a4988.current_position_steps = out->cfg.stepper_a4988.target_position_steps;
-        out->cfg.stepper_a4988.current_level = out->cfg.stepper_a4988.target_level;
-        out->cfg.stepper_a4988.home_active = false;
-        out->cfg.stepper_a4988.homing = false;
-        out->cfg.stepper_a4988.homed = false;
-        out->cfg.stepper_a4988.moving = false;
-        out->cfg.stepper_a4988.last_step_us = 0;
+        out->cfg.stepper_a4988->axis.target_position_steps =
+            stepper_level_to_position(out->cfg.stepper_a4988->axis.target_level, out->cfg.stepper_a4988->axis.steps_range);
+        out->cfg.stepper_a4988->axis.current_position_steps = out->cfg.stepper_a4988->axis.target_position_steps;
+        out->cfg.stepper_a4988->axis.current_level = out->cfg.stepper_a4988->axis.target_level;
+        out->cfg.stepper_a4988->home_active = false;
+        out->cfg.stepper_a4988->homing = false;
+        out->cfg.stepper_a4988->homed = false;
+        out->cfg.stepper_a4988->moving = false;
+        out->cfg.stepper_a4988->axis.last_step_us = 0;
 
         gpio_config_t extra_io = {
-            .pin_bit_mask = (1ULL << out->cfg.stepper_a4988.gpio_b) |
-                            ((out->cfg.stepper_a4988.gpio_c >= 0) ? (1ULL << out->cfg.stepper_a4988.gpio_c) : 0),
+            .pin_bit_mask = (1ULL << out->cfg.stepper_a4988->gpio_b) |
+                            ((out->cfg.stepper_a4988->gpio_c >= 0) ? (1ULL << out->cfg.stepper_a4988->gpio_c) : 0),
             .mode = GPIO_MODE_OUTPUT,
             .pull_up_en = GPIO_PULLUP_DISABLE,
             .pull_down_en = GPIO_PULLDOWN_DISABLE,
@@ -3022,12 +3872,20 @@ static esp_err_t configure_output(output_runtime_t *out, const cJSON *item, ledc
         };
         ESP_RETURN_ON_ERROR(gpio_config(&extra_io), TAG, "A4988 gpio setup failed for %s", out->id);
         ESP_RETURN_ON_ERROR(gpio_set_level((gpio_num_t)out->gpio, 0), TAG, "A4988 step gpio init failed for %s", out->id);
-        if (out->cfg.stepper_a4988.home_gpio >= 0) {
+        if (strcmp(jstr(item, "pulse_engine", "gpio"), "rmt") == 0) {
+            esp_err_t rmt_err = stepper_a4988_rmt_init(out);
+            if (rmt_err != ESP_OK) {
+                ESP_LOGW(TAG, "A4988 %s: RMT pulse engine unavailable (%s), using GPIO stepping",
+                         out->id, esp_err_to_name(rmt_err));
+            }
+        }
+        stepper_axis_init_profile(&out->cfg.stepper_a4988->axis, out->cfg.stepper_a4988->rmt_chan != NULL);
+        if (out->cfg.stepper_a4988->home_gpio >= 0) {
             gpio_config_t home_io = {
-                .pin_bit_mask = 1ULL << out->cfg.stepper_a4988.home_gpio,
+                .pin_bit_mask = 1ULL << out->cfg.stepper_a4988->home_gpio,
                 .mode = GPIO_MODE_INPUT,
-                .pull_up_en = (out->cfg.stepper_a4988.home_pull_mode == GPIO_PULLUP_ONLY) ? GPIO_PULLUP_ENABLE : GPIO_PULLUP_DISABLE,
-                .pull_down_en = (out->cfg.stepper_a4988.home_pull_mode == GPIO_PULLDOWN_ONLY) ? GPIO_PULLDOWN_ENABLE : GPIO_PULLDOWN_DISABLE,
+                .pull_up_en = (out->cfg.stepper_a4988->home_pull_mode == GPIO_PULLUP_ONLY) ? GPIO_PULLUP_ENABLE : GPIO_PULLUP_DISABLE,
+                .pull_down_en = (out->cfg.stepper_a4988->home_pull_mode == GPIO_PULLDOWN_ONLY) ? GPIO_PULLDOWN_ENABLE : GPIO_PULLDOWN_DISABLE,
                 .intr_type = GPIO_INTR_DISABLE,
             };
             ESP_RETURN_ON_ERROR(gpio_config(&home_io), TAG, "A4988 home gpio setup failed for %s", out->id);
@@ -3035,12 +3893,12 @@ static esp_err_t configure_output(output_runtime_t *out, const cJSON *item, ledc
                 stepper_a4988_finish_home_locked(out);
                 return ESP_OK;
             }
-            if (out->cfg.stepper_a4988.auto_home_on_boot) {
+            if (out->cfg.stepper_a4988->auto_home_on_boot) {
                 ESP_RETURN_ON_ERROR(stepper_a4988_start_home_locked(out), TAG, "A4988 home init failed for %s", out->id);
                 return ESP_OK;
             }
         }
-        if (out->cfg.stepper_a4988.hold_enabled) {
+        if (out->cfg.stepper_a4988->hold_enabled) {
             ESP_RETURN_ON_ERROR(stepper_a4988_set_enable_locked(out, true), TAG, "A4988 enable init failed for %s", out->id);
             out->power = true;
         } else {
@@ -3051,62 +3909,213 @@ static esp_err_t configure_output(output_runtime_t *out, const cJSON *item, ledc
     }
 
     if (out->type == OUTPUT_TYPE_WS2812) {
-        out->cfg.ws2812.pixel_count = jint(item, "pixel_count", 1);
-        snprintf(out->cfg.ws2812.color_order, sizeof(out->cfg.ws2812.color_order), "%s",
+        // Must match the frame size planned in plan_runtime_layout.
+        out->cfg.ws2812->pixel_count = ws2812_pixel_count(item);
+        snprintf(out->cfg.ws2812->color_order, sizeof(out->cfg.ws2812->color_order), "%s",
                  jstr(item, "color_order", "GRB"));
-        if (!ws2812_color_order_valid(out->cfg.ws2812.color_order)) {
-            snprintf(out->cfg.ws2812.color_order, sizeof(out->cfg.ws2812.color_order), "%s", "GRB");
-        }
-        out->cfg.ws2812.default_power_on = jbool(item, "default_power_on", false);
-        out->cfg.ws2812.gamma_correction = jbool(item, "gamma_correction", false);
-        out->cfg.ws2812.mode = ws2812_mode_from_text(jstr(item, "mode", "rgb"));
-        out->cfg.ws2812.transition_style = ws2812_transition_style_from_text(jstr(item, "transition_style", "none"));
-        out->cfg.ws2812.transition_ms = jint(item, "transition_ms", 300);
-        if (out->cfg.ws2812.transition_ms < 0) {
-            out->cfg.ws2812.transition_ms = 0;
-        }
-        if (out->cfg.ws2812.transition_ms > 5000) {
-            out->cfg.ws2812.transition_ms = 5000;
-        }
-        out->cfg.ws2812.level = out->cfg.ws2812.default_power_on ? WS2812_BRIGHTNESS_MAX : 0;
-        out->cfg.ws2812.red = 255;
-        out->cfg.ws2812.green = 255;
-        out->cfg.ws2812.blue = 255;
-        out->cfg.ws2812.applied_level = out->cfg.ws2812.level;
-        out->cfg.ws2812.applied_red = out->cfg.ws2812.red;
-        out->cfg.ws2812.applied_green = out->cfg.ws2812.green;
-        out->cfg.ws2812.applied_blue = out->cfg.ws2812.blue;
-        out->power = out->cfg.ws2812.default_power_on;
+        if (!ws2812_color_order_valid(out->cfg.ws2812->color_order)) {
+            snprintf(out->cfg.ws2812->color_order, sizeof(out->cfg.ws2812->color_order), "%s", "GRB");
+        }
+        ws2812_palette_init(&out->cfg.ws2812->palette, out->cfg.ws2812->color_order,
+                            jbool(item, "gamma_correction", false));
+        out->cfg.ws2812->default_power_on = jbool(item, "default_power_on", false);
+        out->cfg.ws2812->driver = ws2812_driver_from_text(jstr(item, "driver", "rmt"));
+        out->cfg.ws2812->mode = ws2812_mode_from_text(jstr(item, "mode", "rgb"));
+        out->cfg.ws2812->transition_style = ws2812_transition_style_from_text(jstr(item, "transition_style", "none"));
+        out->cfg.ws2812->transition_ms = jint(item, "transition_ms", 300);
+        out->cfg.ws2812->transition_easing = ws2812_easing_from_text(jstr(item, "transition_easing", "linear"));
+        if (out->cfg.ws2812->transition_ms < 0) {
+            out->cfg.ws2812->transition_ms = 0;
+        }
+        if (out->cfg.ws2812->transition_ms > 5000) {
+            out->cfg.ws2812->transition_ms = 5000;
+        }
+        configure_ws2812_effect(out->cfg.ws2812, item);
+        out->cfg.ws2812->level = out->cfg.ws2812->default_power_on ? WS2812_BRIGHTNESS_MAX : 0;
+        out->cfg.ws2812->red = 255;
+        out->cfg.ws2812->green = 255;
+        out->cfg.ws2812->blue = 255;
+        out->cfg.ws2812->applied_level = out->cfg.ws2812->level;
+        out->cfg.ws2812->applied_red = out->cfg.ws2812->red;
+        out->cfg.ws2812->applied_green = out->cfg.ws2812->green;
+        out->cfg.ws2812->applied_blue = out->cfg.ws2812->blue;
+        out->power = out->cfg.ws2812->default_power_on;
         led_strip_config_t strip_cfg = {
             .strip_gpio_num = out->gpio,
-            .max_leds = (uint32_t)out->cfg.ws2812.pixel_count,
+            .max_leds = (uint32_t)out->cfg.ws2812->pixel_count,
             .led_pixel_format = LED_PIXEL_FORMAT_GRB,
             .led_model = LED_MODEL_WS2812,
             .flags = {
                 .invert_out = false,
             },
         };
-        led_strip_rmt_config_t rmt_cfg = {
-            .clk_src = RMT_CLK_SRC_DEFAULT,
-            .resolution_hz = 10 * 1000 * 1000,
-            // Keep WS2812 within one C3 RMT TX block so DS18B20 can still allocate its 1-Wire TX channel.
-            .mem_block_symbols = SOC_RMT_MEM_WORDS_PER_CHANNEL,
-            .flags = {
-                .with_dma = false,
-            },
-        };
-        ESP_RETURN_ON_ERROR(led_strip_new_rmt_device(&strip_cfg, &rmt_cfg, &out->cfg.ws2812.strip),
-                            TAG, "WS2812 init failed for %s", out->id);
+        if (out->cfg.ws2812->driver == WS2812_DRIVER_SPI) {
+            led_strip_spi_config_t spi_cfg = {
+                .clk_src = SPI_CLK_SRC_DEFAULT,
+                .spi_bus = SPI2_HOST,
+                .flags = {
+                    .with_dma = true,
+                },
+            };
+            ESP_RETURN_ON_ERROR(led_strip_new_spi_device(&strip_cfg, &spi_cfg, &out->cfg.ws2812->strip),
+                                TAG, "WS2812 SPI init failed for %s", out->id);
+        } else {
+            led_strip_rmt_config_t rmt_cfg = {
+                .clk_src = RMT_CLK_SRC_DEFAULT,
+                .resolution_hz = 10 * 1000 * 1000,
+                // Keep WS2812 within one C3 RMT TX block so DS18B20 can still allocate its 1-Wire TX channel.
+                .mem_block_symbols = SOC_RMT_MEM_WORDS_PER_CHANNEL,
+                .flags = {
+                    .with_dma = false,
+                },
+            };
+            ESP_RETURN_ON_ERROR(led_strip_new_rmt_device(&strip_cfg, &rmt_cfg, &out->cfg.ws2812->strip),
+                                TAG, "WS2812 init failed for %s", out->id);
+        }
         out->supported = true;
-        return render_ws2812_frame_locked(out, out->cfg.ws2812.applied_level,
-                                          out->cfg.ws2812.applied_red,
-                                          out->cfg.ws2812.applied_green,
-                                          out->cfg.ws2812.applied_blue, -1);
+        return render_ws2812_frame_locked(out, out->cfg.ws2812->applied_level,
+                                          out->cfg.ws2812->applied_red,
+                                          out->cfg.ws2812->applied_green,
+                                          out->cfg.ws2812->applied_blue, -1);
     }
 
     return ESP_ERR_INVALID_ARG;
 }
 
+static int clamp_debounce_ms(int ms)
+{
+    if (ms < 0) {
+        return 0;
+    }
+    return ms > 1000 ? 1000 : ms;
+}
+
+// Falls back to periodic sampling when the pin cannot get an edge interrupt.
+static bool attach_edge_capture(int gpio, uint8_t source, const char *id)
+{
+    if (!s_edge_capture_ready) {
+        return false;
+    }
+    esp_err_t err = gpio_edge_add(gpio, source);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "edge capture unavailable for %s, polling instead: %s", id, esp_err_to_name(err));
+        return false;
+    }
+    return true;
+}
+
+static int clamp_rate_window_sec(int sec)
+{
+    if (sec < MODULES_COUNTER_RATE_BUCKETS) {
+        return MODULES_COUNTER_RATE_BUCKETS;
+    }
+    return sec > 3600 ? 3600 : sec;
+}
+
+static void counter_nvs_key(const char *id, char *key, size_t key_len)
+{
+    snprintf(key, key_len, "c%08" PRIx32, hash_fnv1a(HASH_FNV1A_SEED, id, strlen(id)));
+}
+
+static uint64_t load_counter_total(const char *id)
+{
+    nvs_handle_t h;
+    char key[16];
+    uint64_t total = 0;
+
+    if (nvs_open(MODULES_COUNTER_NVS_NS, NVS_READONLY, &h) != ESP_OK) {
+        return 0;
+    }
+    counter_nvs_key(id, key, sizeof(key));
+    if (nvs_get_u64(h, key, &total) != ESP_OK) {
+        total = 0;
+    }
+    nvs_close(h);
+    return total;
+}
+
+static int collect_counter_saves_locked(counter_save_t *saves)
+{
+    int count = 0;
+
+    for (int i = 0; i < s_runtime.input_count; ++i) {
+        const input_runtime_t *in = &s_runtime.inputs[i];
+        if (!in->used || !in->counter || in->total == in->total_saved) {
+            continue;
+        }
+        snprintf(saves[count].id, sizeof(saves[count].id), "%s", in->id);
+        saves[count].total = in->total;
+        count++;
+    }
+    return count;
+}
+
+static void write_counter_saves(const counter_save_t *saves, int count)
+{
+    nvs_handle_t h;
+    char key[16];
+
+    if (count <= 0) {
+        return;
+    }
+    esp_err_t err = nvs_open(MODULES_COUNTER_NVS_NS, NVS_READWRITE, &h);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "counter save failed: %s", esp_err_to_name(err));
+        return;
+    }
+    for (int i = 0; i < count && err == ESP_OK; ++i) {
+        counter_nvs_key(saves[i].id, key, sizeof(key));
+        err = nvs_set_u64(h, key, saves[i].total);
+    }
+    if (err == ESP_OK) {
+        err = nvs_commit(h);
+    }
+    nvs_close(h);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "counter save failed: %s", esp_err_to_name(err));
+    }
+}
+
+// A reconfiguration writes the old totals only after releasing the lock, so counters configured in the
+// meantime loaded stale values from NVS; take the pending totals instead. They are marked saved since
+// the caller writes them next.
+static void adopt_counter_saves_locked(const counter_save_t *saves, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        input_runtime_t *in = find_input_locked(saves[i].id);
+        if (in && in->counter) {
+            in->total = saves[i].total;
+            in->total_saved = saves[i].total;
+        }
+    }
+}
+
+// Flash writes happen outside the runtime lock; only counters still holding the written total are
+// marked saved, so a reconfiguration in between just causes one extra write later.
+static void persist_counters(void)
+{
+    counter_save_t saves[MODULES_MAX_INPUTS];
+    int count;
+
+    runtime_lock();
+    count = collect_counter_saves_locked(saves);
+    runtime_unlock();
+    if (count == 0) {
+        return;
+    }
+
+    write_counter_saves(saves, count);
+
+    runtime_lock();
+    for (int i = 0; i < count; ++i) {
+        input_runtime_t *in = find_input_locked(saves[i].id);
+        if (in && in->counter && in->total >= saves[i].total) {
+            in->total_saved = saves[i].total;
+        }
+    }
+    runtime_unlock();
+}
+
 static esp_err_t configure_input(input_runtime_t *in, const cJSON *item)
 {
     memset(in, 0, sizeof(*in));
@@ -3118,6 +4127,14 @@ static esp_err_t configure_input(input_runtime_t *in, const cJSON *item)
     snprintf(in->id, sizeof(in->id), "%s", jstr(item, "id", ""));
     snprintf(in->name, sizeof(in->name), "%s", jstr(item, "name", in->id));
     snprintf(in->role, sizeof(in->role), "%s", jstr(item, "role", "generic_binary"));
+    in->debounce_ms = clamp_debounce_ms(jint(item, "debounce_ms", MODULES_INPUT_DEBOUNCE_MS_DEFAULT));
+    in->counter = strcmp(jstr(item, "type", "digital"), "counter") == 0;
+    if (in->counter) {
+        in->rate_window_sec = clamp_rate_window_sec(
+            jint(item, "rate_window_sec", MODULES_COUNTER_RATE_WINDOW_SEC_DEFAULT));
+        in->total = load_counter_total(in->id);
+        in->total_saved = in->total;
+    }
 
     if (!in->enabled) {
         return ESP_OK;
@@ -3135,6 +4152,23 @@ static esp_err_t configure_input(input_runtime_t *in, const cJSON *item)
     if (in->inverted) {
         in->state = !in->state;
     }
+    if (in->counter) {
+        int index = (int)(in - s_runtime.inputs);
+        in->rate_tick_us = esp_timer_get_time() + counter_bucket_us(in);
+        if (s_edge_capture_ready) {
+            // The active edge is the one that makes the input read as on.
+            esp_err_t err = gpio_edge_add_counter(in->gpio, (uint8_t)index, !in->inverted,
+                                                  (uint32_t)in->debounce_ms * 1000U);
+            if (err == ESP_OK) {
+                in->edge_capture = true;
+            } else {
+                ESP_LOGW(TAG, "pulse counting unavailable for %s, polling instead: %s", in->id,
+                         esp_err_to_name(err));
+            }
+        }
+        return ESP_OK;
+    }
+    in->edge_capture = attach_edge_capture(in->gpio, (uint8_t)(in - s_runtime.inputs), in->id);
     return ESP_OK;
 }
 
@@ -3162,12 +4196,30 @@ static esp_err_t configure_button(button_runtime_t *btn, const cJSON *item)
     btn->inverted = jbool(item, "inverted", false);
     btn->pull_mode = pull_mode_from_text(jstr(item, "pull", "up"));
     btn->long_press_ms = jint(item, "long_press_ms", 1000);
+    btn->debounce_ms = clamp_debounce_ms(jint(item, "debounce_ms", MODULES_INPUT_DEBOUNCE_MS_DEFAULT));
     snprintf(btn->id, sizeof(btn->id), "%s", jstr(item, "id", ""));
     snprintf(btn->name, sizeof(btn->name), "%s", jstr(item, "name", btn->id));
+    btn->multi_click_ms = jint(item, "multi_click_ms", MODULES_BUTTON_MULTI_CLICK_MS_DEFAULT);
+    btn->hold_repeat_ms = jint(item, "hold_repeat_ms", MODULES_BUTTON_HOLD_REPEAT_MS_DEFAULT);
+    if (btn->hold_repeat_ms < 20) {
+        btn->hold_repeat_ms = 20;
+    }
 
     const cJSON *actions = jobj(item, "actions");
-    parse_button_action(&btn->short_action, jobj(actions, "short"));
-    parse_button_action(&btn->long_action, jobj(actions, "long"));
+    for (int g = 0; g < BUTTON_GESTURE_COUNT; ++g) {
+        parse_button_action(&btn->actions[g], jobj(actions, s_button_gesture_keys[g]));
+    }
+    // Waiting for a second click delays the single click, so by default only wait as long as a
+    // configured multi-click action needs.
+    btn->max_clicks = jint(item, "max_clicks", 0);
+    if (btn->max_clicks <= 0) {
+        btn->max_clicks = btn->actions[BUTTON_GESTURE_TRIPLE].type != ACTION_NONE   ? 3
+                          : btn->actions[BUTTON_GESTURE_DOUBLE].type != ACTION_NONE ? 2
+                                                                                    : 1;
+    }
+    if (btn->max_clicks > 3) {
+        btn->max_clicks = 3;
+    }
 
     if (!btn->enabled) {
         return ESP_OK;
@@ -3181,6 +4233,9 @@ static esp_err_t configure_button(button_runtime_t *btn, const cJSON *item)
         .intr_type = GPIO_INTR_DISABLE,
     };
     ESP_ERROR_CHECK(gpio_config(&io));
+    btn->last_pressed = button_is_pressed(btn);
+    btn->edge_capture = attach_edge_capture(
+        btn->gpio, (uint8_t)(MODULES_EDGE_SOURCE_BUTTON_BASE + (btn - s_runtime.buttons)), btn->id);
     return ESP_OK;
 }
 
@@ -3240,41 +4295,42 @@ static esp_err_t ensure_ds18b20_bus_locked(const sensor_runtime_t *sensor)
     snprintf(s_runtime.ds18b20.sensor_id, sizeof(s_runtime.ds18b20.sensor_id), "%s", sensor->id);
     snprintf(s_runtime.ds18b20.sensor_name, sizeof(s_runtime.ds18b20.sensor_name), "%s", sensor->name);
 
-    return enumerate_ds18b20_devices_locked(sensor->gpio, NULL);
+    return enumerate_ds18b20_devices_locked();
 }
 
-static esp_err_t enumerate_ds18b20_devices_locked(int gpio, bool *out_topology_changed)
+static esp_err_t scan_ds18b20_devices(onewire_bus_handle_t bus, ds18b20_device_handle_t *devices,
+                                      onewire_device_address_t *addresses, int *out_count)
 {
-    ds18b20_device_handle_t new_devices[MODULES_MAX_DS18B20] = {0};
-    uint64_t new_addresses[MODULES_MAX_DS18B20] = {0};
     onewire_device_iter_handle_t iter = NULL;
     onewire_device_t dev = {0};
-    int new_count = 0;
-    bool topology_changed = false;
-
-    if (out_topology_changed) {
-        *out_topology_changed = false;
-    }
-    if (!s_runtime.ds18b20.bus) {
-        return ESP_ERR_INVALID_STATE;
-    }
+    int count = 0;
 
-    ESP_RETURN_ON_ERROR(onewire_new_device_iter(s_runtime.ds18b20.bus, &iter), TAG, "create 1-wire iterator failed");
-    while (new_count < MODULES_MAX_DS18B20 && onewire_device_iter_get_next(iter, &dev) == ESP_OK) {
+    *out_count = 0;
+    ESP_RETURN_ON_ERROR(onewire_new_device_iter(bus, &iter), TAG, "create 1-wire iterator failed");
+    while (count < MODULES_MAX_DS18B20 && onewire_device_iter_get_next(iter, &dev) == ESP_OK) {
         ds18b20_config_t ds_cfg = {};
-        if (ds18b20_new_device_from_enumeration(&dev, &ds_cfg, &new_devices[new_count]) == ESP_OK) {
-            (void)ds18b20_set_resolution(new_devices[new_count], DS18B20_RESOLUTION_12B);
-            new_addresses[new_count] = dev.address;
-            new_count++;
+        if (ds18b20_new_device_from_enumeration(&dev, &ds_cfg, &devices[count]) == ESP_OK) {
+            (void)ds18b20_set_resolution(devices[count], DS18B20_RESOLUTION_12B);
+            addresses[count] = dev.address;
+            count++;
         }
     }
     (void)onewire_del_device_iter(iter);
 
-    if (new_count != s_runtime.ds18b20.device_count) {
+    *out_count = count;
+    return ESP_OK;
+}
+
+static bool install_ds18b20_devices_locked(const ds18b20_device_handle_t *devices,
+                                           const onewire_device_address_t *addresses, int count)
+{
+    bool topology_changed = false;
+
+    if (count != s_runtime.ds18b20.device_count) {
         topology_changed = true;
     } else {
-        for (int i = 0; i < new_count; ++i) {
-            if (new_addresses[i] != s_runtime.ds18b20.addresses[i]) {
+        for (int i = 0; i < count; ++i) {
+            if (addresses[i] != s_runtime.ds18b20.addresses[i]) {
                 topology_changed = true;
                 break;
             }
@@ -3291,16 +4347,29 @@ static esp_err_t enumerate_ds18b20_devices_locked(int gpio, bool *out_topology_c
     memset(s_runtime.ds18b20.valid, 0, sizeof(s_runtime.ds18b20.valid));
     memset(s_runtime.ds18b20.temperatures, 0, sizeof(s_runtime.ds18b20.temperatures));
 
-    for (int i = 0; i < new_count; ++i) {
-        s_runtime.ds18b20.devices[i] = new_devices[i];
-        s_runtime.ds18b20.addresses[i] = new_addresses[i];
+    for (int i = 0; i < count; ++i) {
+        s_runtime.ds18b20.devices[i] = devices[i];
+        s_runtime.ds18b20.addresses[i] = addresses[i];
     }
-    s_runtime.ds18b20.device_count = new_count;
-    if (out_topology_changed) {
-        *out_topology_changed = topology_changed;
+    s_runtime.ds18b20.device_count = count;
+
+    ESP_LOGI(TAG, "Discovered %d DS18B20 device(s) on GPIO%d", count, s_runtime.ds18b20.gpio);
+    return topology_changed;
+}
+
+static esp_err_t enumerate_ds18b20_devices_locked(void)
+{
+    ds18b20_device_handle_t new_devices[MODULES_MAX_DS18B20] = {0};
+    onewire_device_address_t new_addresses[MODULES_MAX_DS18B20] = {0};
+    int new_count = 0;
+
+    if (!s_runtime.ds18b20.bus) {
+        return ESP_ERR_INVALID_STATE;
     }
 
-    ESP_LOGI(TAG, "Discovered %d DS18B20 device(s) on GPIO%d", new_count, gpio);
+    ESP_RETURN_ON_ERROR(scan_ds18b20_devices(s_runtime.ds18b20.bus, new_devices, new_addresses, &new_count),
+                        TAG, "ds18 bus scan failed");
+    (void)install_ds18b20_devices_locked(new_devices, new_addresses, new_count);
     return ESP_OK;
 }
 
@@ -3414,17 +4483,17 @@ static esp_err_t execute_button_action_locked(const button_action_t *action)
             }
             int level = 0;
             if (out->type == OUTPUT_TYPE_PWM) {
-                level = out->cfg.pwm.level;
+                level = out->cfg.pwm->level;
             } else if (out->type == OUTPUT_TYPE_WS2812) {
-                level = ws2812_percent_from_brightness(out->cfg.ws2812.level);
+                level = ws2812_percent_from_brightness(out->cfg.ws2812->level);
             } else if (out->type == OUTPUT_TYPE_SERVO_3WIRE) {
-                level = out->cfg.servo_3wire.level;
+                level = out->cfg.servo_3wire->level;
             } else if (out->type == OUTPUT_TYPE_SERVO_5WIRE) {
-                level = out->cfg.servo_5wire.target_level;
+                level = out->cfg.servo_5wire->target_level;
             } else if (out->type == OUTPUT_TYPE_STEPPER_28BYJ) {
-                level = out->cfg.stepper_28byj.target_level;
+                level = out->cfg.stepper_28byj->axis.target_level;
             } else if (out->type == OUTPUT_TYPE_STEPPER_A4988) {
-                level = out->cfg.stepper_a4988.target_level;
+                level = out->cfg.stepper_a4988->axis.target_level;
             }
             level += (action->type == ACTION_DIM_STEP_UP) ? action->step : -action->step;
             return set_output_level_locked(out, level);
@@ -3436,235 +4505,844 @@ static esp_err_t execute_button_action_locked(const button_action_t *action)
     }
 }
 
-static esp_err_t read_sensor_locked(sensor_runtime_t *sensor)
+// Runs without s_lock on a private copy of the sensor; s_bus_lock keeps the driver handles alive.
+static esp_err_t read_sensor_sample(sensor_runtime_t *sample)
 {
-    if (!sensor || !sensor->enabled || !sensor->supported) {
+    if (!sample || !sample->enabled || !sample->supported) {
         return ESP_ERR_INVALID_STATE;
     }
 
     esp_err_t err = ESP_OK;
-    if (strcmp(sensor->type, "aht20") == 0) {
+    if (strcmp(sample->type, "aht20") == 0) {
         uint32_t t_raw = 0;
         uint32_t h_raw = 0;
-        err = aht20_read_temperature_humidity(sensor->dev.aht20, &t_raw, &sensor->temperature_c, &h_raw, &sensor->humidity_pct);
-        sensor->data_valid = (err == ESP_OK);
+        err = aht20_read_temperature_humidity(sample->dev.aht20, &t_raw, &sample->temperature_c, &h_raw, &sample->humidity_pct);
+        sample->data_valid = (err == ESP_OK);
         return err;
     }
-    if (strcmp(sensor->type, "sht3x") == 0) {
-        err = sht3x_get_single_shot(sensor->dev.sht3x, &sensor->temperature_c, &sensor->humidity_pct);
-        sensor->data_valid = (err == ESP_OK);
+    if (strcmp(sample->type, "sht3x") == 0) {
+        err = sht3x_get_single_shot(sample->dev.sht3x, &sample->temperature_c, &sample->humidity_pct);
+        sample->data_valid = (err == ESP_OK);
         return err;
     }
-    if (strcmp(sensor->type, "bme280") == 0) {
-        err = bme280_read_temperature(sensor->dev.bme280, &sensor->temperature_c);
+    if (strcmp(sample->type, "bme280") == 0) {
+        err = bme280_read_temperature(sample->dev.bme280, &sample->temperature_c);
         if (err == ESP_OK) {
-            err = bme280_read_humidity(sensor->dev.bme280, &sensor->humidity_pct);
+            err = bme280_read_humidity(sample->dev.bme280, &sample->humidity_pct);
         }
         if (err == ESP_OK) {
-            err = bme280_read_pressure(sensor->dev.bme280, &sensor->pressure_hpa);
+            err = bme280_read_pressure(sample->dev.bme280, &sample->pressure_hpa);
             if (err == ESP_OK) {
-                sensor->pressure_hpa /= 100.0f;
+                sample->pressure_hpa /= 100.0f;
             }
         }
-        sensor->data_valid = (err == ESP_OK);
+        sample->data_valid = (err == ESP_OK);
         return err;
     }
     return ESP_ERR_NOT_SUPPORTED;
 }
 
-static esp_err_t read_ds18b20_locked(bool *out_topology_changed)
+static void snapshot_ds18b20_locked(ds18b20_sample_t *sample)
 {
-    if (out_topology_changed) {
-        *out_topology_changed = false;
+    memset(sample, 0, sizeof(*sample));
+    sample->bus = s_runtime.ds18b20.bus;
+    sample->device_count = s_runtime.ds18b20.device_count;
+    for (int i = 0; i < sample->device_count; ++i) {
+        sample->devices[i] = s_runtime.ds18b20.devices[i];
+        sample->addresses[i] = s_runtime.ds18b20.addresses[i];
     }
-    if (!s_runtime.ds18b20.active || !s_runtime.ds18b20.bus) {
+}
+
+// Trigger, wait and read stages of the DS18B20 pipeline; called without s_lock.
+static esp_err_t read_ds18b20_sample(ds18b20_sample_t *sample)
+{
+    if (!sample->bus) {
         return ESP_ERR_INVALID_STATE;
     }
-    if (s_runtime.ds18b20.device_count == 0) {
-        bool topology_changed = false;
-        ESP_RETURN_ON_ERROR(enumerate_ds18b20_devices_locked(s_runtime.ds18b20.gpio, &topology_changed),
+    if (sample->device_count == 0) {
+        ESP_RETURN_ON_ERROR(scan_ds18b20_devices(sample->bus, sample->devices, sample->addresses, &sample->device_count),
                             TAG, "ds18 bus rescan failed");
-        if (out_topology_changed) {
-            *out_topology_changed = topology_changed;
-        }
-        if (s_runtime.ds18b20.device_count == 0) {
+        sample->rescanned = true;
+        if (sample->device_count == 0) {
             return ESP_ERR_NOT_FOUND;
         }
     }
 
     app_watchdog_reset_current_task("modules_sensor");
-    ESP_RETURN_ON_ERROR(ds18b20_trigger_temperature_conversion_for_all(s_runtime.ds18b20.bus),
+    ESP_RETURN_ON_ERROR(ds18b20_trigger_temperature_conversion_for_all(sample->bus),
                         TAG, "ds18 conversion failed");
 
-    for (int i = 0; i < s_runtime.ds18b20.device_count; ++i) {
+    for (int i = 0; i < sample->device_count; ++i) {
         app_watchdog_reset_current_task("modules_sensor");
-        esp_err_t err = ds18b20_get_temperature(s_runtime.ds18b20.devices[i], &s_runtime.ds18b20.temperatures[i]);
-        s_runtime.ds18b20.valid[i] = (err == ESP_OK);
+        esp_err_t err = ds18b20_get_temperature(sample->devices[i], &sample->temperatures[i]);
+        sample->valid[i] = (err == ESP_OK);
         if (err != ESP_OK) {
             ESP_LOGW(TAG, "DS18B20[%016" PRIX64 "] read failed: %s",
-                     (uint64_t)s_runtime.ds18b20.addresses[i], esp_err_to_name(err));
+                     (uint64_t)sample->addresses[i], esp_err_to_name(err));
         }
     }
 
     return ESP_OK;
 }
 
-static void modules_poll_task(void *arg)
+static bool commit_ds18b20_sample_locked(const ds18b20_sample_t *sample, esp_err_t read_err)
 {
-    (void)arg;
-    app_watchdog_register_current_task("modules_poll");
-
-    while (1) {
-        bool changed = false;
-        int64_t now_us = esp_timer_get_time();
+    bool changed = false;
 
-        xSemaphoreTake(s_lock, portMAX_DELAY);
-        update_ws2812_transitions_locked(now_us);
-        for (int i = 0; i < s_runtime.output_count; ++i) {
-            output_runtime_t *out = &s_runtime.outputs[i];
-            if (!out->used || !out->enabled || !out->test_active) {
-                continue;
-            }
-            if (process_output_test_locked(out, now_us)) {
-                changed = true;
-            }
-        }
-        for (int i = 0; i < s_runtime.output_count; ++i) {
-            output_runtime_t *out = &s_runtime.outputs[i];
-            if (!out->used || !out->enabled || out->type != OUTPUT_TYPE_SERVO_5WIRE) {
-                continue;
-            }
-            if (update_servo_5wire_control_locked(out, now_us)) {
-                changed = true;
-            }
-        }
-        for (int i = 0; i < s_runtime.output_count; ++i) {
-            output_runtime_t *out = &s_runtime.outputs[i];
-            if (!out->used || !out->enabled || out->type != OUTPUT_TYPE_SERVO_3WIRE) {
-                continue;
-            }
-            if (update_servo_3wire_release_locked(out, now_us)) {
-                changed = true;
-            }
-        }
-        for (int i = 0; i < s_runtime.output_count; ++i) {
-            output_runtime_t *out = &s_runtime.outputs[i];
-            if (!out->used || !out->enabled) {
-                continue;
-            }
-            if (out->type == OUTPUT_TYPE_CLOCK_4X4094) {
-                if (update_clock_4x4094_locked(out, now_us)) {
-                    changed = true;
-                }
-            } else if (out->type == OUTPUT_TYPE_STEPPER_28BYJ) {
-                if (update_stepper_28byj_control_locked(out, now_us)) {
-                    changed = true;
-                }
-            } else if (out->type == OUTPUT_TYPE_STEPPER_A4988) {
-                if (update_stepper_a4988_control_locked(out, now_us)) {
-                    changed = true;
-                }
-            }
-        }
-        for (int i = 0; i < s_runtime.input_count; ++i) {
-            input_runtime_t *in = &s_runtime.inputs[i];
-            if (!in->used || !in->enabled) {
-                continue;
-            }
-            bool state = gpio_get_level((gpio_num_t)in->gpio) != 0;
-            if (in->inverted) {
-                state = !state;
-            }
-            if (state != in->state) {
-                in->state = state;
-                changed = true;
-            }
+    if (sample->rescanned) {
+        changed = install_ds18b20_devices_locked(sample->devices, sample->addresses, sample->device_count);
+    }
+    if (read_err == ESP_OK) {
+        for (int i = 0; i < sample->device_count; ++i) {
+            s_runtime.ds18b20.valid[i] = sample->valid[i];
+            s_runtime.ds18b20.temperatures[i] = sample->temperatures[i];
         }
+        changed = true;
+    }
+    return changed;
+}
 
-        for (int i = 0; i < s_runtime.button_count; ++i) {
-            button_runtime_t *btn = &s_runtime.buttons[i];
-            if (!btn->used || !btn->enabled) {
-                continue;
-            }
-            bool pressed = button_is_pressed(btn);
-
-            if (pressed && !btn->last_pressed) {
-                btn->pressed_since_us = now_us;
-                btn->long_sent = false;
-            } else if (!pressed && btn->last_pressed) {
-                int held_ms = (btn->pressed_since_us > 0) ? (int)((now_us - btn->pressed_since_us) / 1000) : 0;
-                if (!btn->long_sent && held_ms >= 40) {
-                    if (execute_button_action_locked(&btn->short_action) == ESP_OK) {
-                        changed = true;
-                    }
-                }
-                btn->pressed_since_us = 0;
-            } else if (pressed && !btn->long_sent && btn->pressed_since_us > 0) {
-                int held_ms = (int)((now_us - btn->pressed_since_us) / 1000);
-                if (held_ms >= btn->long_press_ms) {
-                    btn->long_sent = true;
-                    if (execute_button_action_locked(&btn->long_action) == ESP_OK) {
-                        changed = true;
-                    }
-                }
-            }
-
-            btn->last_pressed = pressed;
-        }
-        xSemaphoreGive(s_lock);
+static void sched_swap(int a, int b)
+{
+    sched_entry_t tmp = s_sched.heap[a];
+    s_sched.heap[a] = s_sched.heap[b];
+    s_sched.heap[b] = tmp;
+    s_sched.pos[s_sched.heap[a].slot] = a;
+    s_sched.pos[s_sched.heap[b].slot] = b;
+}
 
-        if (changed) {
-            notify_runtime_changed();
+static void sched_sift_up(int i)
+{
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (s_sched.heap[parent].due_us <= s_sched.heap[i].due_us) {
+            break;
         }
-
-        app_watchdog_reset_current_task("modules_poll");
-        vTaskDelay(pdMS_TO_TICKS(MODULES_POLL_PERIOD_MS));
+        sched_swap(i, parent);
+        i = parent;
     }
 }
 
-static void modules_sensor_task(void *arg)
+static void sched_sift_down(int i)
 {
-    (void)arg;
-    app_watchdog_register_current_task("modules_sensor");
-
     while (1) {
-        bool changed = false;
-        int64_t now_us = esp_timer_get_time();
+        int left = (2 * i) + 1;
+        int right = left + 1;
+        int smallest = i;
 
-        xSemaphoreTake(s_lock, portMAX_DELAY);
-        if (s_runtime.ds18b20.active &&
-            (s_runtime.ds18b20.next_poll_us == 0 || now_us >= s_runtime.ds18b20.next_poll_us)) {
-            bool topology_changed = false;
-            if (read_ds18b20_locked(&topology_changed) == ESP_OK || topology_changed) {
-                changed = true;
-            }
-            s_runtime.ds18b20.next_poll_us = esp_timer_get_time() +
-                                             ((int64_t)s_runtime.ds18b20.poll_interval_sec * 1000000LL);
+        if (left < s_sched.count && s_sched.heap[left].due_us < s_sched.heap[smallest].due_us) {
+            smallest = left;
         }
-
-        for (int i = 0; i < s_runtime.sensor_count; ++i) {
-            sensor_runtime_t *sensor = &s_runtime.sensors[i];
-            if (!sensor->used || !sensor->enabled || !sensor->supported) {
-                continue;
+        if (right < s_sched.count && s_sched.heap[right].due_us < s_sched.heap[smallest].due_us) {
+            smallest = right;
+        }
+        if (smallest == i) {
+            break;
+        }
+        sched_swap(i, smallest);
+        i = smallest;
+    }
+}
+
+static void sched_reset_locked(void)
+{
+    memset(&s_sched, 0, sizeof(s_sched));
+    for (int slot = 0; slot < MODULES_SCHED_SLOTS; ++slot) {
+        s_sched.pos[slot] = -1;
+    }
+    s_sched.resync = true;
+}
+
+// due_us == 0 removes the slot from the heap.
+static void sched_set_locked(int slot, int64_t due_us)
+{
+    int i = s_sched.pos[slot];
+
+    if (due_us <= 0) {
+        if (i < 0) {
+            return;
+        }
+        int last = --s_sched.count;
+        s_sched.pos[slot] = -1;
+        if (i != last) {
+            s_sched.heap[i] = s_sched.heap[last];
+            s_sched.pos[s_sched.heap[i].slot] = i;
+            sched_sift_down(i);
+            sched_sift_up(s_sched.pos[s_sched.heap[i].slot]);
+        }
+        return;
+    }
+
+    if (i < 0) {
+        i = s_sched.count++;
+        s_sched.heap[i].slot = slot;
+        s_sched.pos[slot] = i;
+    }
+    s_sched.heap[i].due_us = due_us;
+    sched_sift_up(i);
+    sched_sift_down(s_sched.pos[slot]);
+}
+
+static int64_t earliest_deadline(int64_t a, int64_t b)
+{
+    if (a <= 0) {
+        return b;
+    }
+    if (b <= 0) {
+        return a;
+    }
+    return a < b ? a : b;
+}
+
+static int64_t clock_4x4094_next_tick_us(const output_runtime_t *out, int64_t now_us)
+{
+    int64_t half_period_us = ((int64_t)out->cfg.clock_4x4094->blink_period_ms * 1000LL) / 2LL;
+
+    if (!out->power || !out->cfg.clock_4x4094->blink_separator || half_period_us <= 0 ||
+        half_period_us > 1000000LL) {
+        half_period_us = 1000000LL;
+    }
+    return ((now_us / half_period_us) + 1) * half_period_us;
+}
+
+static int64_t output_next_deadline_locked(const output_runtime_t *out, int64_t now_us)
+{
+    int64_t due_us = 0;
+
+    if (!out->used || !out->enabled) {
+        return 0;
+    }
+    if (out->test_active) {
+        due_us = out->test_restore_at_us;
+    }
+    if (!out->supported) {
+        return due_us;
+    }
+
+    switch (out->type) {
+        case OUTPUT_TYPE_WS2812:
+            if (out->cfg.ws2812->transition.active) {
+                due_us = earliest_deadline(due_us, now_us + (MODULES_WS2812_FRAME_MS * 1000LL));
+            }
+            if (out->cfg.ws2812->effect_running && ws2812_effect_animated(out->cfg.ws2812->fx.effect)) {
+                due_us = earliest_deadline(due_us, out->cfg.ws2812->effect_next_us);
+            }
+            break;
+        case OUTPUT_TYPE_SERVO_3WIRE:
+            if (out->power && !out->test_active && out->cfg.servo_3wire->hold_power_ms > 0) {
+                due_us = earliest_deadline(due_us, out->cfg.servo_3wire->release_at_us);
+            }
+            break;
+        case OUTPUT_TYPE_SERVO_5WIRE:
+            due_us = earliest_deadline(due_us, now_us + (MODULES_POLL_PERIOD_MS * 1000LL));
+            break;
+        case OUTPUT_TYPE_CLOCK_4X4094:
+            due_us = earliest_deadline(due_us, clock_4x4094_next_tick_us(out, now_us));
+            break;
+        case OUTPUT_TYPE_STEPPER_28BYJ:
+            due_us = earliest_deadline(due_us, stepper_axis_next_deadline(&out->cfg.stepper_28byj->axis,
+                                                                          out->cfg.stepper_28byj->home_gpio, now_us));
+            break;
+        case OUTPUT_TYPE_STEPPER_A4988:
+            if (out->cfg.stepper_a4988->rmt_chan) {
+                // Batch completions kick the slot from the RMT ISR; only planning and the endstop need a deadline.
+                if (stepper_a4988_rmt_can_plan_locked(out)) {
+                    due_us = now_us;
+                } else if (out->cfg.stepper_a4988->home_gpio >= 0) {
+                    due_us = earliest_deadline(due_us, now_us + (MODULES_POLL_PERIOD_MS * 1000LL));
+                }
+            } else {
+                due_us = earliest_deadline(due_us, stepper_axis_next_deadline(&out->cfg.stepper_a4988->axis,
+                                                                              out->cfg.stepper_a4988->home_gpio, now_us));
+            }
+            break;
+        default:
+            break;
+    }
+    return due_us;
+}
+
+static int64_t sched_slot_deadline_locked(int slot, int64_t now_us)
+{
+    if (slot == MODULES_SCHED_INPUT_SLOT) {
+        return input_slot_deadline_locked(now_us);
+    }
+    if (slot >= s_runtime.output_count) {
+        return 0;
+    }
+    return output_next_deadline_locked(&s_runtime.outputs[slot], now_us);
+}
+
+static bool service_output_locked(output_runtime_t *out, int64_t now_us)
+{
+    bool changed = false;
+
+    if (!out->used || !out->enabled) {
+        return false;
+    }
+    if (out->type == OUTPUT_TYPE_WS2812) {
+        update_ws2812_transition_locked(out, now_us);
+        update_ws2812_effect_locked(out, now_us);
+    }
+    if (out->test_active && process_output_test_locked(out, now_us)) {
+        changed = true;
+    }
+
+    switch (out->type) {
+        case OUTPUT_TYPE_SERVO_5WIRE:
+            changed = update_servo_5wire_control_locked(out, now_us) || changed;
+            break;
+        case OUTPUT_TYPE_SERVO_3WIRE:
+            changed = update_servo_3wire_release_locked(out, now_us) || changed;
+            break;
+        case OUTPUT_TYPE_CLOCK_4X4094:
+            changed = update_clock_4x4094_locked(out, now_us) || changed;
+            break;
+        case OUTPUT_TYPE_STEPPER_28BYJ:
+            changed = update_stepper_28byj_control_locked(out, now_us) || changed;
+            break;
+        case OUTPUT_TYPE_STEPPER_A4988:
+            changed = update_stepper_a4988_control_locked(out, now_us) || changed;
+            break;
+        default:
+            break;
+    }
+    return changed;
+}
+
+// Debounce is leading-edge: the first edge after a quiet period is taken at once, later edges inside
+// debounce_ms only mark the pin for a resample when the lockout ends.
+static int64_t counter_bucket_us(const input_runtime_t *in)
+{
+    return (int64_t)in->rate_window_sec * 1000000LL / MODULES_COUNTER_RATE_BUCKETS;
+}
+
+static bool service_counter_locked(int index, int64_t now_us)
+{
+    input_runtime_t *in = &s_runtime.inputs[index];
+
+    if (!in->edge_capture) {
+        bool state = (gpio_get_level((gpio_num_t)in->gpio) != 0) != in->inverted;
+        if (state && !in->state) {
+            in->polled_pulses++;
+        }
+        in->state = state;
+    }
+    if (now_us < in->rate_tick_us) {
+        return false;
+    }
+
+    uint32_t pulses = in->edge_capture ? gpio_edge_take_count((uint8_t)index) : in->polled_pulses;
+    uint64_t sum = 0;
+    float rate;
+
+    in->polled_pulses = 0;
+    in->total += pulses;
+    in->rate_buckets[in->rate_head] = pulses;
+    in->rate_head = (uint8_t)((in->rate_head + 1) % MODULES_COUNTER_RATE_BUCKETS);
+    if (in->rate_filled < MODULES_COUNTER_RATE_BUCKETS) {
+        in->rate_filled++;
+    }
+    for (int i = 0; i < in->rate_filled; ++i) {
+        sum += in->rate_buckets[i];
+    }
+    rate = (float)((double)sum * 60.0 * MODULES_COUNTER_RATE_BUCKETS /
+                   ((double)in->rate_filled * (double)in->rate_window_sec));
+
+    in->rate_tick_us += counter_bucket_us(in);
+    if (in->rate_tick_us <= now_us) {
+        in->rate_tick_us = now_us + counter_bucket_us(in);
+    }
+    if (pulses == 0 && rate == in->rate_per_min) {
+        return false;
+    }
+    in->rate_per_min = rate;
+    mark_dirty_locked(CHANGE_KIND_INPUT, index);
+    return true;
+}
+
+static bool input_apply_level_locked(int index, bool level, int64_t event_us)
+{
+    input_runtime_t *in = &s_runtime.inputs[index];
+    bool state = in->inverted ? !level : level;
+
+    if (event_us < in->lockout_until_us) {
+        in->settle_pending = true;
+        return false;
+    }
+    if (state == in->state) {
+        return false;
+    }
+    in->state = state;
+    in->lockout_until_us = event_us + (int64_t)in->debounce_ms * 1000LL;
+    mark_dirty_locked(CHANGE_KIND_INPUT, index);
+    return true;
+}
+
+static void record_button_event_locked(const button_runtime_t *btn, button_gesture_t gesture, int64_t event_us)
+{
+    modules_button_event_t *ev = &s_button_events[s_button_event_seq % MODULES_BUTTON_EVENT_LEN];
+
+    s_button_event_seq++;
+    ev->seq = s_button_event_seq;
+    ev->time_us = event_us;
+    ev->gesture = s_button_gesture_events[gesture];
+    snprintf(ev->id, sizeof(ev->id), "%s", btn->id);
+}
+
+// Every gesture except hold-repeat ticks is also journaled as an event, so listeners get notified
+// even when no local action is bound.
+static bool fire_button_gesture_locked(button_runtime_t *btn, button_gesture_t gesture, int64_t event_us)
+{
+    bool changed = false;
+
+    if (gesture != BUTTON_GESTURE_HOLD) {
+        record_button_event_locked(btn, gesture, event_us);
+        mark_button_dirty_locked(btn);
+        changed = true;
+    }
+    if (btn->actions[gesture].type != ACTION_NONE &&
+        execute_button_action_locked(&btn->actions[gesture]) == ESP_OK) {
+        changed = true;
+        s_sched.resync = true;
+    }
+    return changed;
+}
+
+static bool button_apply_level_locked(button_runtime_t *btn, bool level, int64_t event_us)
+{
+    bool pressed = btn->inverted ? !level : level;
+
+    if (event_us < btn->lockout_until_us) {
+        btn->settle_pending = true;
+        return false;
+    }
+    if (pressed == btn->last_pressed) {
+        return false;
+    }
+    btn->lockout_until_us = event_us + (int64_t)btn->debounce_ms * 1000LL;
+
+    if (pressed) {
+        btn->pressed_since_us = event_us;
+        btn->long_sent = false;
+        btn->click_deadline_us = 0;
+    } else {
+        int64_t held_us = (btn->pressed_since_us > 0) ? event_us - btn->pressed_since_us : 0;
+        if (btn->long_sent) {
+            btn->click_count = 0;
+        } else if (held_us >= MODULES_BUTTON_MIN_CLICK_MS * 1000LL) {
+            btn->click_count++;
+        }
+        if (btn->click_count >= btn->max_clicks) {
+            (void)fire_button_gesture_locked(btn, (button_gesture_t)(btn->click_count - 1), event_us);
+            btn->click_count = 0;
+        } else if (btn->click_count > 0) {
+            btn->click_deadline_us = event_us + (int64_t)btn->multi_click_ms * 1000LL;
+        }
+        btn->pressed_since_us = 0;
+        btn->hold_next_us = 0;
+    }
+    btn->last_pressed = pressed;
+    mark_button_dirty_locked(btn);
+    return true;
+}
+
+// Gesture timers driven from service_inputs_locked: closing a click sequence, long press and hold repeat.
+static bool service_button_gestures_locked(button_runtime_t *btn, int64_t now_us)
+{
+    bool changed = false;
+
+    if (!btn->last_pressed && btn->click_count > 0 && btn->click_deadline_us > 0 &&
+        now_us >= btn->click_deadline_us) {
+        changed = fire_button_gesture_locked(btn, (button_gesture_t)(btn->click_count - 1), now_us);
+        btn->click_count = 0;
+        btn->click_deadline_us = 0;
+    }
+    if (!btn->last_pressed || btn->pressed_since_us <= 0) {
+        return changed;
+    }
+
+    int64_t long_at_us = btn->pressed_since_us + (int64_t)btn->long_press_ms * 1000LL;
+    if (!btn->long_sent && now_us >= long_at_us) {
+        btn->long_sent = true;
+        btn->click_count = 0;
+        changed = fire_button_gesture_locked(btn, BUTTON_GESTURE_LONG, now_us) || changed;
+        if (btn->actions[BUTTON_GESTURE_HOLD].type != ACTION_NONE) {
+            btn->hold_next_us = long_at_us;
+        }
+    }
+    if (btn->hold_next_us > 0 && now_us >= btn->hold_next_us) {
+        changed = fire_button_gesture_locked(btn, BUTTON_GESTURE_HOLD, now_us) || changed;
+        btn->hold_next_us += (int64_t)btn->hold_repeat_ms * 1000LL;
+        if (btn->hold_next_us <= now_us) {
+            btn->hold_next_us = now_us + (int64_t)btn->hold_repeat_ms * 1000LL;
+        }
+    }
+    return changed;
+}
+
+static bool drain_edge_events_locked(void)
+{
+    gpio_edge_event_t ev;
+    bool changed = false;
+    bool drained = false;
+
+    while (gpio_edge_pop(&ev)) {
+        drained = true;
+        if (ev.source < MODULES_EDGE_SOURCE_BUTTON_BASE) {
+            if (ev.source < s_runtime.input_count && s_runtime.inputs[ev.source].edge_capture) {
+                changed = input_apply_level_locked(ev.source, ev.level != 0, ev.time_us) || changed;
+            }
+        } else {
+            int index = ev.source - MODULES_EDGE_SOURCE_BUTTON_BASE;
+            if (index < s_runtime.button_count && s_runtime.buttons[index].edge_capture) {
+                changed = button_apply_level_locked(&s_runtime.buttons[index], ev.level != 0, ev.time_us) || changed;
+            }
+        }
+    }
+
+    // Lost edges leave the tracked state unknown; resample every captured pin on the next input pass.
+    uint32_t dropped = gpio_edge_dropped();
+    if (dropped != s_edge_dropped_seen) {
+        s_edge_dropped_seen = dropped;
+        for (int i = 0; i < s_runtime.input_count; ++i) {
+            s_runtime.inputs[i].settle_pending = s_runtime.inputs[i].edge_capture;
+        }
+        for (int i = 0; i < s_runtime.button_count; ++i) {
+            s_runtime.buttons[i].settle_pending = s_runtime.buttons[i].edge_capture;
+        }
+        drained = true;
+    }
+
+    if (drained) {
+        int64_t now_us = esp_timer_get_time();
+        sched_set_locked(MODULES_SCHED_INPUT_SLOT, sched_slot_deadline_locked(MODULES_SCHED_INPUT_SLOT, now_us));
+    }
+    return changed;
+}
+
+// Edge-captured pins are only sampled here when a debounce lockout ends with settle_pending set; the
+// rest are polled every MODULES_POLL_PERIOD_MS.
+static bool service_inputs_locked(int64_t now_us)
+{
+    bool changed = false;
+
+    for (int i = 0; i < s_runtime.input_count; ++i) {
+        input_runtime_t *in = &s_runtime.inputs[i];
+        if (!in->used || !in->enabled) {
+            continue;
+        }
+        if (in->counter) {
+            changed = service_counter_locked(i, now_us) || changed;
+            continue;
+        }
+        if (in->edge_capture && !(in->settle_pending && now_us >= in->lockout_until_us)) {
+            continue;
+        }
+        in->settle_pending = false;
+        changed = input_apply_level_locked(i, gpio_get_level((gpio_num_t)in->gpio) != 0, now_us) || changed;
+    }
+
+    for (int i = 0; i < s_runtime.button_count; ++i) {
+        button_runtime_t *btn = &s_runtime.buttons[i];
+        if (!btn->used || !btn->enabled) {
+            continue;
+        }
+        if (!btn->edge_capture || (btn->settle_pending && now_us >= btn->lockout_until_us)) {
+            btn->settle_pending = false;
+            changed = button_apply_level_locked(btn, gpio_get_level((gpio_num_t)btn->gpio) != 0, now_us) || changed;
+        }
+
+        changed = service_button_gestures_locked(btn, now_us) || changed;
+    }
+    return changed;
+}
+
+// Zero when every pin is edge-captured and nothing is settling or held, so idle inputs cost nothing.
+static int64_t input_slot_deadline_locked(int64_t now_us)
+{
+    int64_t due_us = 0;
+
+    for (int i = 0; i < s_runtime.input_count; ++i) {
+        const input_runtime_t *in = &s_runtime.inputs[i];
+        if (!in->used || !in->enabled) {
+            continue;
+        }
+        if (in->counter) {
+            due_us = earliest_deadline(due_us, in->rate_tick_us);
+        }
+        if (!in->edge_capture) {
+            due_us = earliest_deadline(due_us, now_us + (MODULES_POLL_PERIOD_MS * 1000LL));
+        } else if (in->settle_pending) {
+            due_us = earliest_deadline(due_us, in->lockout_until_us);
+        }
+    }
+    for (int i = 0; i < s_runtime.button_count; ++i) {
+        const button_runtime_t *btn = &s_runtime.buttons[i];
+        if (!btn->used || !btn->enabled) {
+            continue;
+        }
+        if (!btn->edge_capture) {
+            due_us = earliest_deadline(due_us, now_us + (MODULES_POLL_PERIOD_MS * 1000LL));
+        } else if (btn->settle_pending) {
+            due_us = earliest_deadline(due_us, btn->lockout_until_us);
+        }
+        if (!btn->last_pressed && btn->click_count > 0) {
+            due_us = earliest_deadline(due_us, btn->click_deadline_us);
+        }
+        if (btn->hold_next_us > 0) {
+            due_us = earliest_deadline(due_us, btn->hold_next_us);
+        }
+        if (btn->last_pressed && !btn->long_sent && btn->pressed_since_us > 0) {
+            due_us = earliest_deadline(due_us, btn->pressed_since_us + (int64_t)btn->long_press_ms * 1000LL);
+        }
+    }
+    return due_us;
+}
+
+static void wake_poll_task(void)
+{
+    if (s_poll_task) {
+        xTaskNotifyGive(s_poll_task);
+    }
+}
+
+static void sched_timer_cb(void *arg)
+{
+    (void)arg;
+    wake_poll_task();
+}
+
+static void sched_wait_until(int64_t due_us)
+{
+    TickType_t timeout = pdMS_TO_TICKS(MODULES_SCHED_MAX_SLEEP_MS);
+
+    if (due_us > 0) {
+        int64_t delay_us = due_us - esp_timer_get_time();
+        if (delay_us <= 0) {
+            return;
+        }
+        if (delay_us < (MODULES_SCHED_MAX_SLEEP_MS * 1000LL)) {
+            (void)esp_timer_stop(s_sched_timer);
+            if (esp_timer_start_once(s_sched_timer, (uint64_t)delay_us) != ESP_OK) {
+                timeout = 1;
             }
-            if (strcmp(sensor->type, "ds18b20_bus") == 0) {
-                continue;
+        }
+    }
+    (void)ulTaskNotifyTake(pdTRUE, timeout);
+}
+
+// One pass of the poll task: drains edges, services every due schedule slot and publishes the
+// changes. Returns when the next slot is due (0 when nothing is scheduled).
+static int64_t modules_poll_once(void)
+{
+    bool changed = false;
+    int64_t next_due_us = 0;
+
+    runtime_lock();
+    int64_t now_us = esp_timer_get_time();
+    uint32_t kicked;
+    portENTER_CRITICAL(&s_isr_mux);
+    kicked = s_sched_kick_mask;
+    s_sched_kick_mask = 0;
+    portEXIT_CRITICAL(&s_isr_mux);
+    for (int slot = 0; kicked != 0 && slot < MODULES_SCHED_SLOTS; ++slot) {
+        if (kicked & (1UL << slot)) {
+            sched_set_locked(slot, now_us);
+        }
+    }
+    changed = drain_edge_events_locked() || changed;
+    if (s_sched.resync) {
+        s_sched.resync = false;
+        for (int slot = 0; slot < MODULES_SCHED_SLOTS; ++slot) {
+            sched_set_locked(slot, sched_slot_deadline_locked(slot, now_us));
+        }
+    }
+    while (s_sched.count > 0 && s_sched.heap[0].due_us <= now_us) {
+        int slot = s_sched.heap[0].slot;
+        int64_t due_us;
+
+        if (slot == MODULES_SCHED_INPUT_SLOT) {
+            changed = service_inputs_locked(now_us) || changed;
+        } else if (service_output_locked(&s_runtime.outputs[slot], now_us)) {
+            mark_dirty_locked(CHANGE_KIND_OUTPUT, slot);
+            changed = true;
+        }
+        due_us = sched_slot_deadline_locked(slot, now_us);
+        if (due_us > 0 && due_us <= now_us) {
+            // Still behind (e.g. stepper catch-up cap); come back on the next pass instead of spinning here.
+            due_us = now_us + 1;
+        }
+        sched_set_locked(slot, due_us);
+    }
+    if (s_sched.resync) {
+        next_due_us = now_us;
+    } else if (s_sched.count > 0) {
+        next_due_us = s_sched.heap[0].due_us;
+    }
+    changed = commit_changes_locked() || changed;
+    perf_probe_record(PERF_PROBE_MODULES_POLL, now_us);
+    runtime_unlock();
+
+    if (changed) {
+        notify_runtime_changed();
+    }
+    return next_due_us;
+}
+
+static void modules_poll_task(void *arg)
+{
+    (void)arg;
+    app_watchdog_register_current_task("modules_poll");
+
+    while (1) {
+        int64_t next_due_us = modules_poll_once();
+
+        app_watchdog_reset_current_task("modules_poll");
+        sched_wait_until(next_due_us);
+    }
+}
+
+// Picks up the newest frame of each strip and transmits it with only s_ws2812_tx_lock held, so the
+// poll task keeps running while a long strip is on the wire. Frames rendered meanwhile coalesce.
+static void modules_ws2812_tx_task(void *arg)
+{
+    (void)arg;
+
+    while (1) {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        xSemaphoreTake(s_ws2812_tx_lock, portMAX_DELAY);
+        for (int i = 0;; ++i) {
+            led_strip_handle_t strip = NULL;
+            const uint8_t *frame = NULL;
+            int pixel_count = 0;
+            char id[24] = {0};
+
+            runtime_lock();
+            if (i >= s_runtime.output_count) {
+                runtime_unlock();
+                break;
             }
-            if (sensor->next_poll_us != 0 && now_us < sensor->next_poll_us) {
-                continue;
+            output_runtime_t *out = &s_runtime.outputs[i];
+            if (out->used && out->type == OUTPUT_TYPE_WS2812 && out->cfg.ws2812->strip &&
+                out->cfg.ws2812->frame_dirty) {
+                ws2812_output_t *ws = out->cfg.ws2812;
+                memcpy(ws->tx_frame, ws->frame, (size_t)ws->pixel_count * WS2812_BYTES_PER_PIXEL);
+                ws->frame_dirty = false;
+                strip = ws->strip;
+                frame = ws->tx_frame;
+                pixel_count = ws->pixel_count;
+                snprintf(id, sizeof(id), "%s", out->id);
             }
-            if (read_sensor_locked(sensor) == ESP_OK) {
-                changed = true;
+            runtime_unlock();
+
+            if (strip) {
+                int64_t start_us = esp_timer_get_time();
+                esp_err_t err = ws2812_transmit(strip, frame, pixel_count);
+                perf_probe_record_units(PERF_PROBE_WS2812_TX, start_us, (uint32_t)pixel_count);
+                if (err != ESP_OK) {
+                    ESP_LOGW(TAG, "WS2812 refresh failed for %s: %s", id, esp_err_to_name(err));
+                }
             }
-            sensor->next_poll_us = esp_timer_get_time() + ((int64_t)sensor->poll_interval_sec * 1000000LL);
-            app_watchdog_reset_current_task("modules_sensor");
         }
-        xSemaphoreGive(s_lock);
+        xSemaphoreGive(s_ws2812_tx_lock);
+    }
+}
+
+// One pass of the sensor task: reads every due sensor with only s_bus_lock held, then commits the
+// samples and persists counters when that is due.
+static void modules_sensor_once(void)
+{
+    bool changed = false;
+    int64_t now_us = esp_timer_get_time();
+    bool ds18b20_due = false;
+    ds18b20_sample_t ds18b20_sample;
+    sensor_runtime_t samples[MODULES_MAX_SENSORS];
+    int sample_index[MODULES_MAX_SENSORS];
+    int sample_count = 0;
+
+    xSemaphoreTake(s_bus_lock, portMAX_DELAY);
+
+    runtime_lock();
+    if (s_runtime.ds18b20.active &&
+        (s_runtime.ds18b20.next_poll_us == 0 || now_us >= s_runtime.ds18b20.next_poll_us)) {
+        ds18b20_due = true;
+        snapshot_ds18b20_locked(&ds18b20_sample);
+    }
+    for (int i = 0; i < s_runtime.sensor_count; ++i) {
+        const sensor_runtime_t *sensor = &s_runtime.sensors[i];
+        if (!sensor->used || !sensor->enabled || !sensor->supported) {
+            continue;
+        }
+        if (strcmp(sensor->type, "ds18b20_bus") == 0) {
+            continue;
+        }
+        if (sensor->next_poll_us != 0 && now_us < sensor->next_poll_us) {
+            continue;
+        }
+        samples[sample_count] = *sensor;
+        sample_index[sample_count] = i;
+        sample_count++;
+    }
+    runtime_unlock();
+
+    esp_err_t ds18b20_err = ESP_ERR_INVALID_STATE;
+    if (ds18b20_due) {
+        ds18b20_err = read_ds18b20_sample(&ds18b20_sample);
+    }
+    esp_err_t sample_err[MODULES_MAX_SENSORS];
+    for (int i = 0; i < sample_count; ++i) {
+        sample_err[i] = read_sensor_sample(&samples[i]);
+        app_watchdog_reset_current_task("modules_sensor");
+    }
 
-        if (changed) {
-            notify_runtime_changed();
+    runtime_lock();
+    if (ds18b20_due) {
+        if (commit_ds18b20_sample_locked(&ds18b20_sample, ds18b20_err)) {
+            for (int i = 0; i < s_runtime.sensor_count; ++i) {
+                if (strcmp(s_runtime.sensors[i].type, "ds18b20_bus") == 0) {
+                    mark_dirty_locked(CHANGE_KIND_SENSOR, i);
+                }
+            }
+            changed = true;
+        }
+        s_runtime.ds18b20.next_poll_us = esp_timer_get_time() +
+                                         ((int64_t)s_runtime.ds18b20.poll_interval_sec * 1000000LL);
+    }
+    for (int i = 0; i < sample_count; ++i) {
+        sensor_runtime_t *sensor = &s_runtime.sensors[sample_index[i]];
+        sensor->data_valid = samples[i].data_valid;
+        sensor->temperature_c = samples[i].temperature_c;
+        sensor->humidity_pct = samples[i].humidity_pct;
+        sensor->pressure_hpa = samples[i].pressure_hpa;
+        if (sample_err[i] == ESP_OK) {
+            mark_dirty_locked(CHANGE_KIND_SENSOR, sample_index[i]);
+            changed = true;
         }
+        sensor->next_poll_us = esp_timer_get_time() + ((int64_t)sensor->poll_interval_sec * 1000000LL);
+    }
+    (void)commit_changes_locked();
+    runtime_unlock();
+
+    xSemaphoreGive(s_bus_lock);
+
+    if (changed) {
+        notify_runtime_changed();
+    }
 
+    if (now_us >= s_counter_persist_due_us) {
+        persist_counters();
+        s_counter_persist_due_us = now_us + (MODULES_COUNTER_PERSIST_MS * 1000LL);
+    }
+}
+
+static void modules_sensor_task(void *arg)
+{
+    (void)arg;
+    app_watchdog_register_current_task("modules_sensor");
+
+    while (1) {
+        modules_sensor_once();
         app_watchdog_reset_current_task("modules_sensor");
         vTaskDelay(pdMS_TO_TICKS(MODULES_SENSOR_TASK_PERIOD_MS));
     }
@@ -3720,139 +5398,153 @@ static cJSON *build_output_status_json(const output_runtime_t *out)
     cJSON_AddBoolToObject(obj, "test_active", out->test_active);
 
     if (out->type == OUTPUT_TYPE_RELAY) {
-        cJSON_AddNumberToObject(obj, "active_level", out->cfg.relay.active_level);
+        cJSON_AddNumberToObject(obj, "active_level", out->cfg.relay->active_level);
     } else if (out->type == OUTPUT_TYPE_PWM) {
-        cJSON_AddNumberToObject(obj, "level", out->cfg.pwm.level);
-        cJSON_AddNumberToObject(obj, "freq_hz", out->cfg.pwm.freq_hz);
-        cJSON_AddNumberToObject(obj, "max_level_pct", out->cfg.pwm.max_level_pct);
-        cJSON_AddBoolToObject(obj, "inverted", out->cfg.pwm.inverted);
-        if (out->cfg.pwm.power_relay_gpio >= 0) {
-            cJSON_AddNumberToObject(obj, "power_relay_gpio", out->cfg.pwm.power_relay_gpio);
-            cJSON_AddNumberToObject(obj, "power_relay_active_level", out->cfg.pwm.power_relay_active_level);
-            cJSON_AddBoolToObject(obj, "power_relay_on", out->power && out->cfg.pwm.level > 0);
+        cJSON_AddNumberToObject(obj, "level", out->cfg.pwm->level);
+        cJSON_AddNumberToObject(obj, "freq_hz", out->cfg.pwm->freq_hz);
+        cJSON_AddNumberToObject(obj, "max_level_pct", out->cfg.pwm->max_level_pct);
+        cJSON_AddBoolToObject(obj, "inverted", out->cfg.pwm->inverted);
+        if (out->cfg.pwm->power_relay_gpio >= 0) {
+            cJSON_AddNumberToObject(obj, "power_relay_gpio", out->cfg.pwm->power_relay_gpio);
+            cJSON_AddNumberToObject(obj, "power_relay_active_level", out->cfg.pwm->power_relay_active_level);
+            cJSON_AddBoolToObject(obj, "power_relay_on", out->power && out->cfg.pwm->level > 0);
         }
     } else if (out->type == OUTPUT_TYPE_WS2812) {
-        cJSON_AddNumberToObject(obj, "level", ws2812_percent_from_brightness(out->cfg.ws2812.level));
-        cJSON_AddNumberToObject(obj, "brightness", out->cfg.ws2812.level);
-        cJSON_AddNumberToObject(obj, "pixel_count", out->cfg.ws2812.pixel_count);
-        cJSON_AddStringToObject(obj, "mode", ws2812_mode_to_text(out->cfg.ws2812.mode));
-        cJSON_AddStringToObject(obj, "color_order", out->cfg.ws2812.color_order);
-        cJSON_AddBoolToObject(obj, "gamma_correction", out->cfg.ws2812.gamma_correction);
-        cJSON_AddStringToObject(obj, "transition_style", ws2812_transition_style_to_text(out->cfg.ws2812.transition_style));
-        cJSON_AddNumberToObject(obj, "transition_ms", out->cfg.ws2812.transition_ms);
-        if (out->cfg.ws2812.mode == WS2812_MODE_RGB) {
+        cJSON_AddNumberToObject(obj, "level", ws2812_percent_from_brightness(out->cfg.ws2812->level));
+        cJSON_AddNumberToObject(obj, "brightness", out->cfg.ws2812->level);
+        cJSON_AddNumberToObject(obj, "pixel_count", out->cfg.ws2812->pixel_count);
+        cJSON_AddStringToObject(obj, "mode", ws2812_mode_to_text(out->cfg.ws2812->mode));
+        cJSON_AddStringToObject(obj, "color_order", out->cfg.ws2812->color_order);
+        cJSON_AddBoolToObject(obj, "gamma_correction", out->cfg.ws2812->palette.gamma_correction);
+        cJSON_AddStringToObject(obj, "driver", ws2812_driver_to_text(out->cfg.ws2812->driver));
+        cJSON_AddStringToObject(obj, "transition_style", ws2812_transition_style_to_text(out->cfg.ws2812->transition_style));
+        cJSON_AddNumberToObject(obj, "transition_ms", out->cfg.ws2812->transition_ms);
+        cJSON_AddStringToObject(obj, "transition_easing", ws2812_easing_to_text(out->cfg.ws2812->transition_easing));
+        if (out->cfg.ws2812->frame) {
+            // Lets a rendered frame be compared against a known-good one without a strip attached.
+            cJSON_AddNumberToObject(obj, "frame_fnv",
+                                    hash_fnv1a(HASH_FNV1A_SEED, out->cfg.ws2812->frame,
+                                               (size_t)out->cfg.ws2812->pixel_count * WS2812_BYTES_PER_PIXEL));
+        }
+        if (out->cfg.ws2812->mode == WS2812_MODE_RGB) {
             cJSON *color = cJSON_AddObjectToObject(obj, "color");
-            cJSON_AddNumberToObject(color, "r", out->cfg.ws2812.red);
-            cJSON_AddNumberToObject(color, "g", out->cfg.ws2812.green);
-            cJSON_AddNumberToObject(color, "b", out->cfg.ws2812.blue);
+            cJSON_AddNumberToObject(color, "r", out->cfg.ws2812->red);
+            cJSON_AddNumberToObject(color, "g", out->cfg.ws2812->green);
+            cJSON_AddNumberToObject(color, "b", out->cfg.ws2812->blue);
+            cJSON_AddStringToObject(obj, "effect", ws2812_effect_name(out->cfg.ws2812->fx.effect));
+            cJSON_AddNumberToObject(obj, "effect_fps", out->cfg.ws2812->effect_fps);
+            cJSON_AddNumberToObject(obj, "effect_speed", out->cfg.ws2812->fx.speed);
         }
     } else if (out->type == OUTPUT_TYPE_SERVO_3WIRE) {
-        cJSON_AddNumberToObject(obj, "level", out->cfg.servo_3wire.level);
-        cJSON_AddNumberToObject(obj, "min_us", out->cfg.servo_3wire.min_us);
-        cJSON_AddNumberToObject(obj, "max_us", out->cfg.servo_3wire.max_us);
-        cJSON_AddNumberToObject(obj, "hold_power_ms", out->cfg.servo_3wire.hold_power_ms);
-        cJSON_AddBoolToObject(obj, "reverse_direction", out->cfg.servo_3wire.reverse_direction);
+        cJSON_AddNumberToObject(obj, "level", out->cfg.servo_3wire->level);
+        cJSON_AddNumberToObject(obj, "min_us", out->cfg.servo_3wire->min_us);
+        cJSON_AddNumberToObject(obj, "max_us", out->cfg.servo_3wire->max_us);
+        cJSON_AddNumberToObject(obj, "hold_power_ms", out->cfg.servo_3wire->hold_power_ms);
+        cJSON_AddBoolToObject(obj, "reverse_direction", out->cfg.servo_3wire->reverse_direction);
     } else if (out->type == OUTPUT_TYPE_SERVO_5WIRE) {
-        cJSON_AddNumberToObject(obj, "level", out->cfg.servo_5wire.current_level);
-        cJSON_AddNumberToObject(obj, "target_level", out->cfg.servo_5wire.target_level);
-        cJSON_AddNumberToObject(obj, "gpio_b", out->cfg.servo_5wire.gpio_b);
-        cJSON_AddNumberToObject(obj, "feedback_gpio", out->cfg.servo_5wire.feedback_gpio);
-        cJSON_AddNumberToObject(obj, "feedback_raw", out->cfg.servo_5wire.feedback_raw);
-        cJSON_AddNumberToObject(obj, "feedback_min_raw", out->cfg.servo_5wire.feedback_min_raw);
-        cJSON_AddNumberToObject(obj, "feedback_max_raw", out->cfg.servo_5wire.feedback_max_raw);
-        cJSON_AddNumberToObject(obj, "deadband_pct", out->cfg.servo_5wire.deadband_pct);
-        cJSON_AddNumberToObject(obj, "move_timeout_ms", out->cfg.servo_5wire.move_timeout_ms);
-        cJSON_AddBoolToObject(obj, "reverse_direction", out->cfg.servo_5wire.reverse_direction);
-        cJSON_AddBoolToObject(obj, "moving", out->cfg.servo_5wire.moving);
-        cJSON_AddBoolToObject(obj, "timed_out", out->cfg.servo_5wire.timed_out);
+        cJSON_AddNumberToObject(obj, "level", out->cfg.servo_5wire->current_level);
+        cJSON_AddNumberToObject(obj, "target_level", out->cfg.servo_5wire->target_level);
+        cJSON_AddNumberToObject(obj, "gpio_b", out->cfg.servo_5wire->gpio_b);
+        cJSON_AddNumberToObject(obj, "feedback_gpio", out->cfg.servo_5wire->feedback_gpio);
+        cJSON_AddNumberToObject(obj, "feedback_raw", out->cfg.servo_5wire->feedback_raw);
+        cJSON_AddNumberToObject(obj, "feedback_min_raw", out->cfg.servo_5wire->feedback_min_raw);
+        cJSON_AddNumberToObject(obj, "feedback_max_raw", out->cfg.servo_5wire->feedback_max_raw);
+        cJSON_AddNumberToObject(obj, "deadband_pct", out->cfg.servo_5wire->deadband_pct);
+        cJSON_AddNumberToObject(obj, "move_timeout_ms", out->cfg.servo_5wire->move_timeout_ms);
+        cJSON_AddBoolToObject(obj, "reverse_direction", out->cfg.servo_5wire->reverse_direction);
+        cJSON_AddBoolToObject(obj, "moving", out->cfg.servo_5wire->moving);
+        cJSON_AddBoolToObject(obj, "timed_out", out->cfg.servo_5wire->timed_out);
     } else if (out->type == OUTPUT_TYPE_CLOCK_4X4094) {
-        cJSON_AddNumberToObject(obj, "level", out->cfg.clock_4x4094.level);
-        cJSON_AddNumberToObject(obj, "brightness", (out->cfg.clock_4x4094.level * 255) / 100);
-        cJSON_AddNumberToObject(obj, "gpio_b", out->cfg.clock_4x4094.gpio_b);
-        cJSON_AddNumberToObject(obj, "gpio_c", out->cfg.clock_4x4094.gpio_c);
-        if (out->cfg.clock_4x4094.brightness_gpio >= 0) {
-            cJSON_AddNumberToObject(obj, "brightness_gpio", out->cfg.clock_4x4094.brightness_gpio);
-        }
-        cJSON_AddNumberToObject(obj, "timezone_offset_min", out->cfg.clock_4x4094.timezone_offset_min);
-        cJSON_AddNumberToObject(obj, "blink_period_ms", out->cfg.clock_4x4094.blink_period_ms);
-        cJSON_AddBoolToObject(obj, "default_on", out->cfg.clock_4x4094.default_on);
-        cJSON_AddBoolToObject(obj, "common_anode", out->cfg.clock_4x4094.common_anode);
-        cJSON_AddBoolToObject(obj, "mirror_segments", out->cfg.clock_4x4094.mirror_segments);
-        cJSON_AddBoolToObject(obj, "reverse_digits", out->cfg.clock_4x4094.reverse_digits);
-        cJSON_AddBoolToObject(obj, "leading_zero", out->cfg.clock_4x4094.leading_zero);
-        cJSON_AddBoolToObject(obj, "blink_separator", out->cfg.clock_4x4094.blink_separator);
-        cJSON_AddNumberToObject(obj, "segment_a", out->cfg.clock_4x4094.segment_map[0] + 1);
-        cJSON_AddNumberToObject(obj, "segment_b", out->cfg.clock_4x4094.segment_map[1] + 1);
-        cJSON_AddNumberToObject(obj, "segment_c", out->cfg.clock_4x4094.segment_map[2] + 1);
-        cJSON_AddNumberToObject(obj, "segment_d", out->cfg.clock_4x4094.segment_map[3] + 1);
-        cJSON_AddNumberToObject(obj, "segment_e", out->cfg.clock_4x4094.segment_map[4] + 1);
-        cJSON_AddNumberToObject(obj, "segment_f", out->cfg.clock_4x4094.segment_map[5] + 1);
-        cJSON_AddNumberToObject(obj, "segment_g", out->cfg.clock_4x4094.segment_map[6] + 1);
-        cJSON_AddNumberToObject(obj, "segment_dp", out->cfg.clock_4x4094.segment_map[7] + 1);
-        cJSON_AddBoolToObject(obj, "time_valid", out->cfg.clock_4x4094.time_valid);
-        cJSON_AddBoolToObject(obj, "separator_on", out->cfg.clock_4x4094.separator_on);
-        cJSON_AddStringToObject(obj, "display_text", out->cfg.clock_4x4094.display_text);
-        if (out->cfg.clock_4x4094.display_hour >= 0) {
-            cJSON_AddNumberToObject(obj, "display_hour", out->cfg.clock_4x4094.display_hour);
-            cJSON_AddNumberToObject(obj, "display_minute", out->cfg.clock_4x4094.display_minute);
+        cJSON_AddNumberToObject(obj, "level", out->cfg.clock_4x4094->level);
+        cJSON_AddNumberToObject(obj, "brightness", (out->cfg.clock_4x4094->level * 255) / 100);
+        cJSON_AddNumberToObject(obj, "gpio_b", out->cfg.clock_4x4094->gpio_b);
+        cJSON_AddNumberToObject(obj, "gpio_c", out->cfg.clock_4x4094->gpio_c);
+        if (out->cfg.clock_4x4094->brightness_gpio >= 0) {
+            cJSON_AddNumberToObject(obj, "brightness_gpio", out->cfg.clock_4x4094->brightness_gpio);
+        }
+        cJSON_AddNumberToObject(obj, "timezone_offset_min", out->cfg.clock_4x4094->timezone_offset_min);
+        cJSON_AddNumberToObject(obj, "blink_period_ms", out->cfg.clock_4x4094->blink_period_ms);
+        cJSON_AddBoolToObject(obj, "default_on", out->cfg.clock_4x4094->default_on);
+        cJSON_AddBoolToObject(obj, "common_anode", out->cfg.clock_4x4094->common_anode);
+        cJSON_AddBoolToObject(obj, "mirror_segments", out->cfg.clock_4x4094->mirror_segments);
+        cJSON_AddBoolToObject(obj, "reverse_digits", out->cfg.clock_4x4094->reverse_digits);
+        cJSON_AddBoolToObject(obj, "leading_zero", out->cfg.clock_4x4094->leading_zero);
+        cJSON_AddBoolToObject(obj, "blink_separator", out->cfg.clock_4x4094->blink_separator);
+        cJSON_AddNumberToObject(obj, "segment_a", out->cfg.clock_4x4094->segment_map[0] + 1);
+        cJSON_AddNumberToObject(obj, "segment_b", out->cfg.clock_4x4094->segment_map[1] + 1);
+        cJSON_AddNumberToObject(obj, "segment_c", out->cfg.clock_4x4094->segment_map[2] + 1);
+        cJSON_AddNumberToObject(obj, "segment_d", out->cfg.clock_4x4094->segment_map[3] + 1);
+        cJSON_AddNumberToObject(obj, "segment_e", out->cfg.clock_4x4094->segment_map[4] + 1);
+        cJSON_AddNumberToObject(obj, "segment_f", out->cfg.clock_4x4094->segment_map[5] + 1);
+        cJSON_AddNumberToObject(obj, "segment_g", out->cfg.clock_4x4094->segment_map[6] + 1);
+        cJSON_AddNumberToObject(obj, "segment_dp", out->cfg.clock_4x4094->segment_map[7] + 1);
+        cJSON_AddBoolToObject(obj, "time_valid", out->cfg.clock_4x4094->time_valid);
+        cJSON_AddBoolToObject(obj, "separator_on", out->cfg.clock_4x4094->separator_on);
+        cJSON_AddStringToObject(obj, "display_text", out->cfg.clock_4x4094->display_text);
+        if (out->cfg.clock_4x4094->display_hour >= 0) {
+            cJSON_AddNumberToObject(obj, "display_hour", out->cfg.clock_4x4094->display_hour);
+            cJSON_AddNumberToObject(obj, "display_minute", out->cfg.clock_4x4094->display_minute);
         }
     } else if (out->type == OUTPUT_TYPE_STEPPER_28BYJ) {
-        cJSON_AddNumberToObject(obj, "level", out->cfg.stepper_28byj.current_level);
-        cJSON_AddNumberToObject(obj, "target_level", out->cfg.stepper_28byj.target_level);
+        cJSON_AddNumberToObject(obj, "level", out->cfg.stepper_28byj->axis.current_level);
+        cJSON_AddNumberToObject(obj, "target_level", out->cfg.stepper_28byj->axis.target_level);
         if (output_is_cover(out)) {
-            cJSON_AddNumberToObject(obj, "position", out->cfg.stepper_28byj.current_level);
-            cJSON_AddNumberToObject(obj, "target_position", out->cfg.stepper_28byj.target_level);
+            cJSON_AddNumberToObject(obj, "position", out->cfg.stepper_28byj->axis.current_level);
+            cJSON_AddNumberToObject(obj, "target_position", out->cfg.stepper_28byj->axis.target_level);
             cJSON_AddStringToObject(obj, "state", cover_state_text_locked(out));
         }
-        cJSON_AddNumberToObject(obj, "gpio_b", out->cfg.stepper_28byj.gpio_b);
-        cJSON_AddNumberToObject(obj, "gpio_c", out->cfg.stepper_28byj.gpio_c);
-        cJSON_AddNumberToObject(obj, "gpio_d", out->cfg.stepper_28byj.gpio_d);
-        if (out->cfg.stepper_28byj.home_gpio >= 0) {
-            cJSON_AddNumberToObject(obj, "home_gpio", out->cfg.stepper_28byj.home_gpio);
-            cJSON_AddStringToObject(obj, "home_pull", pull_mode_to_text(out->cfg.stepper_28byj.home_pull_mode));
-        }
-        cJSON_AddNumberToObject(obj, "steps_range", out->cfg.stepper_28byj.steps_range);
-        cJSON_AddNumberToObject(obj, "speed_steps_per_sec", out->cfg.stepper_28byj.speed_steps_per_sec);
-        cJSON_AddNumberToObject(obj, "position_steps", out->cfg.stepper_28byj.current_position_steps);
-        cJSON_AddNumberToObject(obj, "target_position_steps", out->cfg.stepper_28byj.target_position_steps);
-        cJSON_AddBoolToObject(obj, "reverse_direction", out->cfg.stepper_28byj.reverse_direction);
-        cJSON_AddBoolToObject(obj, "hold_enabled", out->cfg.stepper_28byj.hold_enabled);
-        cJSON_AddBoolToObject(obj, "home_inverted", out->cfg.stepper_28byj.home_inverted);
-        cJSON_AddBoolToObject(obj, "auto_home_on_boot", out->cfg.stepper_28byj.auto_home_on_boot);
-        cJSON_AddBoolToObject(obj, "home_active", out->cfg.stepper_28byj.home_active);
-        cJSON_AddBoolToObject(obj, "homing", out->cfg.stepper_28byj.homing);
-        cJSON_AddBoolToObject(obj, "homed", out->cfg.stepper_28byj.homed);
-        cJSON_AddBoolToObject(obj, "moving", out->cfg.stepper_28byj.moving);
+        cJSON_AddNumberToObject(obj, "gpio_b", out->cfg.stepper_28byj->gpio_b);
+        cJSON_AddNumberToObject(obj, "gpio_c", out->cfg.stepper_28byj->gpio_c);
+        cJSON_AddNumberToObject(obj, "gpio_d", out->cfg.stepper_28byj->gpio_d);
+        if (out->cfg.stepper_28byj->home_gpio >= 0) {
+            cJSON_AddNumberToObject(obj, "home_gpio", out->cfg.stepper_28byj->home_gpio);
+            cJSON_AddStringToObject(obj, "home_pull", pull_mode_to_text(out->cfg.stepper_28byj->home_pull_mode));
+        }
+        cJSON_AddNumberToObject(obj, "steps_range", out->cfg.stepper_28byj->axis.steps_range);
+        cJSON_AddNumberToObject(obj, "speed_steps_per_sec", out->cfg.stepper_28byj->axis.speed_steps_per_sec);
+        cJSON_AddNumberToObject(obj, "accel_steps_per_s2", out->cfg.stepper_28byj->axis.accel_steps_per_s2);
+        cJSON_AddNumberToObject(obj, "position_steps", out->cfg.stepper_28byj->axis.current_position_steps);
+        cJSON_AddNumberToObject(obj, "target_position_steps", out->cfg.stepper_28byj->axis.target_position_steps);
+        cJSON_AddBoolToObject(obj, "reverse_direction", out->cfg.stepper_28byj->reverse_direction);
+        cJSON_AddBoolToObject(obj, "hold_enabled", out->cfg.stepper_28byj->hold_enabled);
+        cJSON_AddBoolToObject(obj, "home_inverted", out->cfg.stepper_28byj->home_inverted);
+        cJSON_AddBoolToObject(obj, "auto_home_on_boot", out->cfg.stepper_28byj->auto_home_on_boot);
+        cJSON_AddBoolToObject(obj, "home_active", out->cfg.stepper_28byj->home_active);
+        cJSON_AddBoolToObject(obj, "homing", out->cfg.stepper_28byj->homing);
+        cJSON_AddBoolToObject(obj, "homed", out->cfg.stepper_28byj->homed);
+        cJSON_AddBoolToObject(obj, "moving", out->cfg.stepper_28byj->moving);
     } else if (out->type == OUTPUT_TYPE_STEPPER_A4988) {
-        cJSON_AddNumberToObject(obj, "level", out->cfg.stepper_a4988.current_level);
-        cJSON_AddNumberToObject(obj, "target_level", out->cfg.stepper_a4988.target_level);
+        cJSON_AddNumberToObject(obj, "level", out->cfg.stepper_a4988->axis.current_level);
+        cJSON_AddNumberToObject(obj, "target_level", out->cfg.stepper_a4988->axis.target_level);
         if (output_is_cover(out)) {
-            cJSON_AddNumberToObject(obj, "position", out->cfg.stepper_a4988.current_level);
-            cJSON_AddNumberToObject(obj, "target_position", out->cfg.stepper_a4988.target_level);
+            cJSON_AddNumberToObject(obj, "position", out->cfg.stepper_a4988->axis.current_level);
+            cJSON_AddNumberToObject(obj, "target_position", out->cfg.stepper_a4988->axis.target_level);
             cJSON_AddStringToObject(obj, "state", cover_state_text_locked(out));
         }
-        cJSON_AddNumberToObject(obj, "gpio_b", out->cfg.stepper_a4988.gpio_b);
-        if (out->cfg.stepper_a4988.gpio_c >= 0) {
-            cJSON_AddNumberToObject(obj, "gpio_c", out->cfg.stepper_a4988.gpio_c);
-            cJSON_AddNumberToObject(obj, "enable_active_level", out->cfg.stepper_a4988.enable_active_level);
-        }
-        if (out->cfg.stepper_a4988.home_gpio >= 0) {
-            cJSON_AddNumberToObject(obj, "home_gpio", out->cfg.stepper_a4988.home_gpio);
-            cJSON_AddStringToObject(obj, "home_pull", pull_mode_to_text(out->cfg.stepper_a4988.home_pull_mode));
-        }
-        cJSON_AddNumberToObject(obj, "steps_range", out->cfg.stepper_a4988.steps_range);
-        cJSON_AddNumberToObject(obj, "speed_steps_per_sec", out->cfg.stepper_a4988.speed_steps_per_sec);
-        cJSON_AddNumberToObject(obj, "step_pulse_us", out->cfg.stepper_a4988.step_pulse_us);
-        cJSON_AddNumberToObject(obj, "position_steps", out->cfg.stepper_a4988.current_position_steps);
-        cJSON_AddNumberToObject(obj, "target_position_steps", out->cfg.stepper_a4988.target_position_steps);
-        cJSON_AddBoolToObject(obj, "reverse_direction", out->cfg.stepper_a4988.reverse_direction);
-        cJSON_AddBoolToObject(obj, "hold_enabled", out->cfg.stepper_a4988.hold_enabled);
-        cJSON_AddBoolToObject(obj, "home_inverted", out->cfg.stepper_a4988.home_inverted);
-        cJSON_AddBoolToObject(obj, "auto_home_on_boot", out->cfg.stepper_a4988.auto_home_on_boot);
-        cJSON_AddBoolToObject(obj, "home_active", out->cfg.stepper_a4988.home_active);
-        cJSON_AddBoolToObject(obj, "homing", out->cfg.stepper_a4988.homing);
-        cJSON_AddBoolToObject(obj, "homed", out->cfg.stepper_a4988.homed);
-        cJSON_AddBoolToObject(obj, "moving", out->cfg.stepper_a4988.moving);
+        cJSON_AddNumberToObject(obj, "gpio_b", out->cfg.stepper_a4988->gpio_b);
+        if (out->cfg.stepper_a4988->gpio_c >= 0) {
+            cJSON_AddNumberToObject(obj, "gpio_c", out->cfg.stepper_a4988->gpio_c);
+            cJSON_AddNumberToObject(obj, "enable_active_level", out->cfg.stepper_a4988->enable_active_level);
+        }
+        if (out->cfg.stepper_a4988->home_gpio >= 0) {
+            cJSON_AddNumberToObject(obj, "home_gpio", out->cfg.stepper_a4988->home_gpio);
+            cJSON_AddStringToObject(obj, "home_pull", pull_mode_to_text(out->cfg.stepper_a4988->home_pull_mode));
+        }
+        cJSON_AddNumberToObject(obj, "steps_range", out->cfg.stepper_a4988->axis.steps_range);
+        cJSON_AddNumberToObject(obj, "speed_steps_per_sec", out->cfg.stepper_a4988->axis.speed_steps_per_sec);
+        cJSON_AddNumberToObject(obj, "accel_steps_per_s2", out->cfg.stepper_a4988->axis.accel_steps_per_s2);
+        cJSON_AddNumberToObject(obj, "step_pulse_us", out->cfg.stepper_a4988->step_pulse_us);
+        cJSON_AddStringToObject(obj, "pulse_engine", out->cfg.stepper_a4988->rmt_chan ? "rmt" : "gpio");
+        cJSON_AddNumberToObject(obj, "position_steps", out->cfg.stepper_a4988->axis.current_position_steps);
+        cJSON_AddNumberToObject(obj, "target_position_steps", out->cfg.stepper_a4988->axis.target_position_steps);
+        cJSON_AddBoolToObject(obj, "reverse_direction", out->cfg.stepper_a4988->reverse_direction);
+        cJSON_AddBoolToObject(obj, "hold_enabled", out->cfg.stepper_a4988->hold_enabled);
+        cJSON_AddBoolToObject(obj, "home_inverted", out->cfg.stepper_a4988->home_inverted);
+        cJSON_AddBoolToObject(obj, "auto_home_on_boot", out->cfg.stepper_a4988->auto_home_on_boot);
+        cJSON_AddBoolToObject(obj, "home_active", out->cfg.stepper_a4988->home_active);
+        cJSON_AddBoolToObject(obj, "homing", out->cfg.stepper_a4988->homing);
+        cJSON_AddBoolToObject(obj, "homed", out->cfg.stepper_a4988->homed);
+        cJSON_AddBoolToObject(obj, "moving", out->cfg.stepper_a4988->moving);
     }
     return obj;
 }
@@ -3866,6 +5558,12 @@ static cJSON *build_input_status_json(const input_runtime_t *in)
     cJSON_AddBoolToObject(obj, "enabled", in->enabled);
     cJSON_AddNumberToObject(obj, "gpio", in->gpio);
     cJSON_AddBoolToObject(obj, "state", in->state);
+    cJSON_AddStringToObject(obj, "type", in->counter ? "counter" : "digital");
+    if (in->counter) {
+        cJSON_AddNumberToObject(obj, "total", (double)in->total);
+        cJSON_AddNumberToObject(obj, "rate_per_min", in->rate_per_min);
+        cJSON_AddNumberToObject(obj, "rate_window_sec", in->rate_window_sec);
+    }
     return obj;
 }
 
@@ -3877,14 +5575,16 @@ static cJSON *build_button_status_json(const button_runtime_t *btn)
     cJSON_AddBoolToObject(obj, "enabled", btn->enabled);
     cJSON_AddNumberToObject(obj, "gpio", btn->gpio);
     cJSON_AddNumberToObject(obj, "long_press_ms", btn->long_press_ms);
+    cJSON_AddNumberToObject(obj, "multi_click_ms", btn->multi_click_ms);
+    cJSON_AddNumberToObject(obj, "hold_repeat_ms", btn->hold_repeat_ms);
+    cJSON_AddNumberToObject(obj, "max_clicks", btn->max_clicks);
     cJSON_AddBoolToObject(obj, "pressed", btn->last_pressed);
     cJSON *actions = cJSON_AddObjectToObject(obj, "actions");
-    cJSON *short_a = cJSON_AddObjectToObject(actions, "short");
-    cJSON_AddStringToObject(short_a, "type", button_action_type_to_text(btn->short_action.type));
-    cJSON_AddStringToObject(short_a, "target", btn->short_action.target);
-    cJSON *long_a = cJSON_AddObjectToObject(actions, "long");
-    cJSON_AddStringToObject(long_a, "type", button_action_type_to_text(btn->long_action.type));
-    cJSON_AddStringToObject(long_a, "target", btn->long_action.target);
+    for (int g = 0; g < BUTTON_GESTURE_COUNT; ++g) {
+        cJSON *a = cJSON_AddObjectToObject(actions, s_button_gesture_keys[g]);
+        cJSON_AddStringToObject(a, "type", button_action_type_to_text(btn->actions[g].type));
+        cJSON_AddStringToObject(a, "target", btn->actions[g].target);
+    }
     return obj;
 }
 
@@ -3938,6 +5638,111 @@ static cJSON *build_sensor_status_json(const sensor_runtime_t *sensor)
     return obj;
 }
 
+static void fill_output_status(const output_runtime_t *out, modules_output_status_t *st)
+{
+    memset(st, 0, sizeof(*st));
+    snprintf(st->id, sizeof(st->id), "%s", out->id);
+    st->type = output_type_to_text(out->type);
+    st->enabled = out->enabled;
+    st->supported = out->supported;
+    st->power = out->power;
+    st->has_level = true;
+
+    if (out->type == OUTPUT_TYPE_PWM) {
+        st->level = out->cfg.pwm->level;
+    } else if (out->type == OUTPUT_TYPE_WS2812) {
+        st->level = ws2812_percent_from_brightness(out->cfg.ws2812->level);
+        st->brightness = out->cfg.ws2812->level;
+        if (out->cfg.ws2812->mode == WS2812_MODE_RGB) {
+            st->has_color = true;
+            st->red = out->cfg.ws2812->red;
+            st->green = out->cfg.ws2812->green;
+            st->blue = out->cfg.ws2812->blue;
+            st->effect = ws2812_effect_name(out->cfg.ws2812->fx.effect);
+        }
+    } else if (out->type == OUTPUT_TYPE_SERVO_3WIRE) {
+        st->level = out->cfg.servo_3wire->level;
+    } else if (out->type == OUTPUT_TYPE_SERVO_5WIRE) {
+        st->level = out->cfg.servo_5wire->current_level;
+        st->target_level = out->cfg.servo_5wire->target_level;
+        st->moving = out->cfg.servo_5wire->moving;
+    } else if (out->type == OUTPUT_TYPE_CLOCK_4X4094) {
+        st->level = out->cfg.clock_4x4094->level;
+        st->brightness = (out->cfg.clock_4x4094->level * 255) / 100;
+    } else if (out->type == OUTPUT_TYPE_STEPPER_28BYJ) {
+        st->level = out->cfg.stepper_28byj->axis.current_level;
+        st->target_level = out->cfg.stepper_28byj->axis.target_level;
+        st->moving = out->cfg.stepper_28byj->moving;
+    } else if (out->type == OUTPUT_TYPE_STEPPER_A4988) {
+        st->level = out->cfg.stepper_a4988->axis.current_level;
+        st->target_level = out->cfg.stepper_a4988->axis.target_level;
+        st->moving = out->cfg.stepper_a4988->moving;
+    } else {
+        st->has_level = false;
+    }
+
+    if (out->type != OUTPUT_TYPE_SERVO_5WIRE && out->type != OUTPUT_TYPE_STEPPER_28BYJ &&
+        out->type != OUTPUT_TYPE_STEPPER_A4988) {
+        st->target_level = st->level;
+    }
+    if (output_is_cover(out)) {
+        st->cover_state = cover_state_text_locked(out);
+    }
+}
+
+static bool append_sensor_status(const sensor_runtime_t *sensor, modules_status_snapshot_t *snap)
+{
+    modules_sensor_status_t *st;
+
+    if (snap->sensor_count >= snap->sensor_capacity) {
+        return false;
+    }
+
+    st = &snap->sensors[snap->sensor_count++];
+    memset(st, 0, sizeof(*st));
+    snprintf(st->id, sizeof(st->id), "%s", sensor->id);
+    snprintf(st->source_id, sizeof(st->source_id), "%s", sensor->id);
+    snprintf(st->name, sizeof(st->name), "%s", sensor->name);
+    snprintf(st->type, sizeof(st->type), "%s", sensor->type);
+    st->source_index = (uint8_t)(sensor - s_runtime.sensors);
+    st->enabled = sensor->enabled;
+    st->supported = sensor->supported;
+    if (sensor->data_valid) {
+        if (strcmp(sensor->type, "aht20") == 0 || strcmp(sensor->type, "sht3x") == 0 || strcmp(sensor->type, "bme280") == 0) {
+            st->metrics |= MODULES_METRIC_TEMPERATURE | MODULES_METRIC_HUMIDITY;
+            st->temperature_c = sensor->temperature_c;
+            st->humidity_pct = sensor->humidity_pct;
+        }
+        if (strcmp(sensor->type, "bme280") == 0) {
+            st->metrics |= MODULES_METRIC_PRESSURE;
+            st->pressure_hpa = sensor->pressure_hpa;
+        }
+    }
+
+    if (strcmp(sensor->type, "ds18b20_bus") != 0) {
+        return true;
+    }
+    for (int i = 0; i < s_runtime.ds18b20.device_count; ++i) {
+        if (snap->sensor_count >= snap->sensor_capacity) {
+            return false;
+        }
+        st = &snap->sensors[snap->sensor_count++];
+        memset(st, 0, sizeof(*st));
+        snprintf(st->id, sizeof(st->id), "%s_%016" PRIX64, sensor->id, (uint64_t)s_runtime.ds18b20.addresses[i]);
+        snprintf(st->source_id, sizeof(st->source_id), "%s", sensor->id);
+        snprintf(st->name, sizeof(st->name), "%s %d", sensor->name, i + 1);
+        snprintf(st->type, sizeof(st->type), "%s", "ds18b20");
+        st->source_index = (uint8_t)(sensor - s_runtime.sensors);
+        st->enabled = sensor->enabled;
+        st->supported = sensor->supported;
+        if (s_runtime.ds18b20.valid[i]) {
+            st->metrics = MODULES_METRIC_TEMPERATURE;
+            st->temperature_c = s_runtime.ds18b20.temperatures[i];
+        }
+    }
+    return true;
+}
+
 esp_err_t modules_init(void)
 {
     if (!s_lock) {
@@ -3946,11 +5751,37 @@ esp_err_t modules_init(void)
             return ESP_ERR_NO_MEM;
         }
     }
+    if (!s_bus_lock) {
+        s_bus_lock = xSemaphoreCreateMutex();
+        if (!s_bus_lock) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    if (!s_ws2812_tx_lock) {
+        s_ws2812_tx_lock = xSemaphoreCreateMutex();
+        if (!s_ws2812_tx_lock) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    if (!s_sched_timer) {
+        const esp_timer_create_args_t timer_args = {
+            .callback = sched_timer_cb,
+            .name = "modules_sched",
+        };
+        sched_reset_locked();
+        ESP_RETURN_ON_ERROR(esp_timer_create(&timer_args, &s_sched_timer), TAG, "scheduler timer create failed");
+    }
 
     if (!s_poll_task) {
         if (xTaskCreate(modules_poll_task, "modules_poll", 4096, NULL, 4, &s_poll_task) != pdPASS) {
             return ESP_FAIL;
         }
+        esp_err_t err = gpio_edge_start(s_poll_task);
+        if (err != ESP_OK) {
+            ESP_LOGW(TAG, "GPIO edge capture unavailable, inputs will be polled: %s", esp_err_to_name(err));
+        }
+        s_edge_capture_ready = err == ESP_OK;
     }
 
     if (!s_sensor_task) {
@@ -3959,12 +5790,21 @@ esp_err_t modules_init(void)
         }
     }
 
+    if (!s_ws2812_tx_task) {
+        if (xTaskCreate(modules_ws2812_tx_task, "modules_ws2812", 3072, NULL, 4, &s_ws2812_tx_task) != pdPASS) {
+            return ESP_FAIL;
+        }
+    }
+
     return ESP_OK;
 }
 
 esp_err_t modules_apply_config(const cJSON *cfg)
 {
     esp_err_t err = ESP_OK;
+    // Totals from the torn-down runtime, plus those of a failed apply, written after s_lock is released.
+    counter_save_t saves[2 * MODULES_MAX_INPUTS];
+    int save_count;
 
     if (!cfg) {
         set_last_error("Configuration is null");
@@ -3972,130 +5812,345 @@ esp_err_t modules_apply_config(const cJSON *cfg)
     }
 
     clear_last_error();
-    xSemaphoreTake(s_lock, portMAX_DELAY);
-    clear_runtime_locked();
+    xSemaphoreTake(s_bus_lock, portMAX_DELAY);
+    xSemaphoreTake(s_ws2812_tx_lock, portMAX_DELAY);
+    runtime_lock();
+    save_count = clear_runtime_locked(saves);
 
-    const cJSON *outputs = jobj(cfg, "outputs");
-    const cJSON *inputs = jobj(cfg, "inputs");
-    const cJSON *buttons = jobj(cfg, "buttons");
-    const cJSON *sensors = jobj(cfg, "sensors");
+    runtime_layout_t layout;
     ledc_allocator_t ledc_alloc = {0};
 
-    if (cJSON_IsArray((cJSON *)outputs)) {
-        s_runtime.output_count = cJSON_GetArraySize((cJSON *)outputs);
-        if (s_runtime.output_count > MODULES_MAX_OUTPUTS) {
-            s_runtime.output_count = MODULES_MAX_OUTPUTS;
-        }
-        for (int i = 0; i < s_runtime.output_count; ++i) {
-            err = configure_output(&s_runtime.outputs[i], cJSON_GetArrayItem((cJSON *)outputs, i), &ledc_alloc);
-            if (err != ESP_OK) {
-                ESP_LOGE(TAG, "Failed to configure output %d (%s): %s", i,
-                         s_runtime.outputs[i].id[0] ? s_runtime.outputs[i].id : "<unnamed>",
-                         esp_err_to_name(err));
-                set_last_error("output %s: %s",
-                               s_runtime.outputs[i].id[0] ? s_runtime.outputs[i].id : "<unnamed>",
-                               esp_err_to_name(err));
-                goto fail;
-            }
-        }
+    plan_runtime_layout(&layout, cfg);
+    err = alloc_runtime_arena_locked(&layout);
+    if (err != ESP_OK) {
+        set_last_error("runtime arena: %s", esp_err_to_name(err));
+        goto fail;
     }
 
-    if (cJSON_IsArray((cJSON *)inputs)) {
-        s_runtime.input_count = cJSON_GetArraySize((cJSON *)inputs);
-        if (s_runtime.input_count > MODULES_MAX_INPUTS) {
-            s_runtime.input_count = MODULES_MAX_INPUTS;
-        }
-        for (int i = 0; i < s_runtime.input_count; ++i) {
-            err = configure_input(&s_runtime.inputs[i], cJSON_GetArrayItem((cJSON *)inputs, i));
-            if (err != ESP_OK) {
-                ESP_LOGE(TAG, "Failed to configure input %d (%s): %s", i,
-                         s_runtime.inputs[i].id[0] ? s_runtime.inputs[i].id : "<unnamed>",
-                         esp_err_to_name(err));
-                set_last_error("input %s: %s",
-                               s_runtime.inputs[i].id[0] ? s_runtime.inputs[i].id : "<unnamed>",
-                               esp_err_to_name(err));
-                goto fail;
-            }
+    s_runtime.output_count = layout.output_count;
+    for (int i = 0; i < s_runtime.output_count; ++i) {
+        err = configure_output(&s_runtime.outputs[i], cJSON_GetArrayItem((cJSON *)layout.outputs, i),
+                               layout.output_states[i], &ledc_alloc);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to configure output %d (%s): %s", i,
+                     s_runtime.outputs[i].id[0] ? s_runtime.outputs[i].id : "<unnamed>",
+                     esp_err_to_name(err));
+            set_last_error("output %s: %s",
+                           s_runtime.outputs[i].id[0] ? s_runtime.outputs[i].id : "<unnamed>",
+                           esp_err_to_name(err));
+            goto fail;
         }
     }
 
-    if (cJSON_IsArray((cJSON *)buttons)) {
-        s_runtime.button_count = cJSON_GetArraySize((cJSON *)buttons);
-        if (s_runtime.button_count > MODULES_MAX_BUTTONS) {
-            s_runtime.button_count = MODULES_MAX_BUTTONS;
-        }
-        for (int i = 0; i < s_runtime.button_count; ++i) {
-            err = configure_button(&s_runtime.buttons[i], cJSON_GetArrayItem((cJSON *)buttons, i));
-            if (err != ESP_OK) {
-                ESP_LOGE(TAG, "Failed to configure button %d (%s): %s", i,
-                         s_runtime.buttons[i].id[0] ? s_runtime.buttons[i].id : "<unnamed>",
-                         esp_err_to_name(err));
-                set_last_error("button %s: %s",
-                               s_runtime.buttons[i].id[0] ? s_runtime.buttons[i].id : "<unnamed>",
-                               esp_err_to_name(err));
-                goto fail;
-            }
+    s_runtime.input_count = layout.input_count;
+    for (int i = 0; i < s_runtime.input_count; ++i) {
+        err = configure_input(&s_runtime.inputs[i], cJSON_GetArrayItem((cJSON *)layout.inputs, i));
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to configure input %d (%s): %s", i,
+                     s_runtime.inputs[i].id[0] ? s_runtime.inputs[i].id : "<unnamed>",
+                     esp_err_to_name(err));
+            set_last_error("input %s: %s",
+                           s_runtime.inputs[i].id[0] ? s_runtime.inputs[i].id : "<unnamed>",
+                           esp_err_to_name(err));
+            goto fail;
         }
     }
 
-    if (cJSON_IsArray((cJSON *)sensors)) {
-        s_runtime.sensor_count = cJSON_GetArraySize((cJSON *)sensors);
-        if (s_runtime.sensor_count > MODULES_MAX_SENSORS) {
-            s_runtime.sensor_count = MODULES_MAX_SENSORS;
-        }
-        for (int i = 0; i < s_runtime.sensor_count; ++i) {
-            err = configure_sensor(&s_runtime.sensors[i], cJSON_GetArrayItem((cJSON *)sensors, i));
-            if (err != ESP_OK) {
-                ESP_LOGE(TAG, "Failed to configure sensor %d (%s): %s", i,
-                         s_runtime.sensors[i].id[0] ? s_runtime.sensors[i].id : "<unnamed>",
-                         esp_err_to_name(err));
-                set_last_error("sensor %s: %s",
-                               s_runtime.sensors[i].id[0] ? s_runtime.sensors[i].id : "<unnamed>",
-                               esp_err_to_name(err));
-                goto fail;
-            }
+    s_runtime.button_count = layout.button_count;
+    for (int i = 0; i < s_runtime.button_count; ++i) {
+        err = configure_button(&s_runtime.buttons[i], cJSON_GetArrayItem((cJSON *)layout.buttons, i));
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to configure button %d (%s): %s", i,
+                     s_runtime.buttons[i].id[0] ? s_runtime.buttons[i].id : "<unnamed>",
+                     esp_err_to_name(err));
+            set_last_error("button %s: %s",
+                           s_runtime.buttons[i].id[0] ? s_runtime.buttons[i].id : "<unnamed>",
+                           esp_err_to_name(err));
+            goto fail;
         }
     }
 
-    xSemaphoreGive(s_lock);
+    s_runtime.sensor_count = layout.sensor_count;
+    for (int i = 0; i < s_runtime.sensor_count; ++i) {
+        err = configure_sensor(&s_runtime.sensors[i], cJSON_GetArrayItem((cJSON *)layout.sensors, i));
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to configure sensor %d (%s): %s", i,
+                     s_runtime.sensors[i].id[0] ? s_runtime.sensors[i].id : "<unnamed>",
+                     esp_err_to_name(err));
+            set_last_error("sensor %s: %s",
+                           s_runtime.sensors[i].id[0] ? s_runtime.sensors[i].id : "<unnamed>",
+                           esp_err_to_name(err));
+            goto fail;
+        }
+    }
+
+    rebuild_id_index_locked();
+    adopt_counter_saves_locked(saves, save_count);
+    reset_changes_locked();
+    s_sched.resync = true;
+    runtime_unlock();
+    xSemaphoreGive(s_ws2812_tx_lock);
+    xSemaphoreGive(s_bus_lock);
+    write_counter_saves(saves, save_count);
+    wake_poll_task();
     notify_runtime_changed();
-    ESP_LOGI(TAG, "Applied runtime config: outputs=%d inputs=%d buttons=%d sensors=%d",
-             s_runtime.output_count, s_runtime.input_count, s_runtime.button_count, s_runtime.sensor_count);
+    ESP_LOGI(TAG, "Applied runtime config: outputs=%d inputs=%d buttons=%d sensors=%d arena=%u bytes",
+             s_runtime.output_count, s_runtime.input_count, s_runtime.button_count, s_runtime.sensor_count,
+             (unsigned)s_runtime.arena_size);
     return ESP_OK;
 
 fail:
-    clear_runtime_locked();
-    xSemaphoreGive(s_lock);
+    save_count += clear_runtime_locked(saves + save_count);
+    reset_changes_locked();
+    s_sched.resync = true;
+    runtime_unlock();
+    xSemaphoreGive(s_ws2812_tx_lock);
+    xSemaphoreGive(s_bus_lock);
+    write_counter_saves(saves, save_count);
+    wake_poll_task();
     return err;
 }
 
-cJSON *modules_build_status_json(void)
+// With changes set only the entities it names are included; NULL builds the full status.
+static cJSON *build_status_json_locked(const modules_changes_t *changes)
 {
+    bool full = !changes || changes->resync;
     cJSON *root = cJSON_CreateObject();
+    if (!root) {
+        return NULL;
+    }
+
     cJSON *outputs = cJSON_AddArrayToObject(root, "outputs");
     cJSON *inputs = cJSON_AddArrayToObject(root, "inputs");
-    cJSON *buttons = cJSON_AddArrayToObject(root, "buttons");
     cJSON *sensors = cJSON_AddArrayToObject(root, "sensors");
-
-    xSemaphoreTake(s_lock, portMAX_DELAY);
     for (int i = 0; i < s_runtime.output_count; ++i) {
-        cJSON_AddItemToArray(outputs, build_output_status_json(&s_runtime.outputs[i]));
+        if (full || (changes->outputs & (1UL << i))) {
+            cJSON_AddItemToArray(outputs, build_output_status_json(&s_runtime.outputs[i]));
+        }
     }
     for (int i = 0; i < s_runtime.input_count; ++i) {
-        cJSON_AddItemToArray(inputs, build_input_status_json(&s_runtime.inputs[i]));
+        if (full || (changes->inputs & (1UL << i))) {
+            cJSON_AddItemToArray(inputs, build_input_status_json(&s_runtime.inputs[i]));
+        }
     }
+    cJSON *buttons = cJSON_AddArrayToObject(root, "buttons");
     for (int i = 0; i < s_runtime.button_count; ++i) {
-        cJSON_AddItemToArray(buttons, build_button_status_json(&s_runtime.buttons[i]));
+        if (full || (changes->buttons & (1UL << i))) {
+            cJSON_AddItemToArray(buttons, build_button_status_json(&s_runtime.buttons[i]));
+        }
     }
     for (int i = 0; i < s_runtime.sensor_count; ++i) {
-        cJSON_AddItemToArray(sensors, build_sensor_status_json(&s_runtime.sensors[i]));
+        if (full || (changes->sensors & (1UL << i))) {
+            cJSON_AddItemToArray(sensors, build_sensor_status_json(&s_runtime.sensors[i]));
+        }
     }
     cJSON_AddBoolToObject(root, "any_output_on", is_any_output_on_locked());
-    xSemaphoreGive(s_lock);
+    return root;
+}
+
+cJSON *modules_build_status_json(void)
+{
+    cJSON *root;
+
+    runtime_lock();
+    int64_t start_us = esp_timer_get_time();
+    root = build_status_json_locked(NULL);
+    perf_probe_record(PERF_PROBE_STATUS_JSON, start_us);
+    runtime_unlock();
 
     return root;
 }
 
+cJSON *modules_build_entity_status_json(modules_entity_kind_t kind, int index)
+{
+    cJSON *item = NULL;
+
+    runtime_lock();
+    switch (kind) {
+    case MODULES_ENTITY_OUTPUT:
+        if (index >= 0 && index < s_runtime.output_count) {
+            item = build_output_status_json(&s_runtime.outputs[index]);
+        }
+        break;
+    case MODULES_ENTITY_INPUT:
+        if (index >= 0 && index < s_runtime.input_count) {
+            item = build_input_status_json(&s_runtime.inputs[index]);
+        }
+        break;
+    case MODULES_ENTITY_SENSOR:
+        if (index >= 0 && index < s_runtime.sensor_count) {
+            item = build_sensor_status_json(&s_runtime.sensors[index]);
+        }
+        break;
+    case MODULES_ENTITY_BUTTON:
+        if (index >= 0 && index < s_runtime.button_count) {
+            item = build_button_status_json(&s_runtime.buttons[index]);
+        }
+        break;
+    }
+    runtime_unlock();
+
+    return item;
+}
+
+esp_err_t modules_get_status_snapshot(modules_status_snapshot_t *snapshot)
+{
+    bool truncated = false;
+
+    if (!snapshot) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (snapshot->version != MODULES_STATUS_VERSION) {
+        return ESP_ERR_INVALID_VERSION;
+    }
+
+    snapshot->output_count = 0;
+    snapshot->input_count = 0;
+    snapshot->sensor_count = 0;
+
+    runtime_lock();
+    if (snapshot->outputs) {
+        for (int i = 0; i < s_runtime.output_count; ++i) {
+            if (snapshot->output_count >= snapshot->output_capacity) {
+                truncated = true;
+                break;
+            }
+            fill_output_status(&s_runtime.outputs[i], &snapshot->outputs[snapshot->output_count++]);
+        }
+    }
+    if (snapshot->inputs) {
+        for (int i = 0; i < s_runtime.input_count; ++i) {
+            if (snapshot->input_count >= snapshot->input_capacity) {
+                truncated = true;
+                break;
+            }
+            modules_input_status_t *st = &snapshot->inputs[snapshot->input_count++];
+            snprintf(st->id, sizeof(st->id), "%s", s_runtime.inputs[i].id);
+            st->enabled = s_runtime.inputs[i].enabled;
+            st->state = s_runtime.inputs[i].state;
+            st->counter = s_runtime.inputs[i].counter;
+            st->total = s_runtime.inputs[i].total;
+            st->rate_per_min = s_runtime.inputs[i].rate_per_min;
+        }
+    }
+    if (snapshot->sensors) {
+        for (int i = 0; i < s_runtime.sensor_count; ++i) {
+            if (!append_sensor_status(&s_runtime.sensors[i], snapshot)) {
+                truncated = true;
+                break;
+            }
+        }
+    }
+    snapshot->any_output_on = is_any_output_on_locked();
+    snapshot->seq = s_changes.seq;
+    runtime_unlock();
+
+    return truncated ? ESP_ERR_INVALID_SIZE : ESP_OK;
+}
+
+esp_err_t modules_get_output_status(const char *id, modules_output_status_t *out)
+{
+    esp_err_t err = ESP_ERR_NOT_FOUND;
+
+    if (!id || !out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    runtime_lock();
+    output_runtime_t *rt = find_output_locked(id);
+    if (rt) {
+        fill_output_status(rt, out);
+        err = ESP_OK;
+    }
+    runtime_unlock();
+    return err;
+}
+
+static void collect_changes_locked(uint32_t since_seq, modules_changes_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    out->seq = s_changes.seq;
+    if (since_seq < s_changes.reset_seq || since_seq > s_changes.seq ||
+        s_changes.seq - since_seq > MODULES_CHANGE_JOURNAL_LEN) {
+        out->resync = true;
+    } else {
+        for (uint32_t seq = since_seq + 1; seq <= s_changes.seq; ++seq) {
+            const change_entry_t *entry = &s_changes.journal[seq % MODULES_CHANGE_JOURNAL_LEN];
+            uint32_t bit = 1UL << entry->index;
+            if (entry->kind == CHANGE_KIND_OUTPUT) {
+                out->outputs |= bit;
+            } else if (entry->kind == CHANGE_KIND_INPUT) {
+                out->inputs |= bit;
+            } else if (entry->kind == CHANGE_KIND_BUTTON) {
+                out->buttons |= bit;
+            } else {
+                out->sensors |= bit;
+            }
+        }
+    }
+}
+
+int modules_get_button_events_since(uint32_t since_seq, modules_button_event_t *out, int max, uint32_t *out_seq)
+{
+    int count = 0;
+
+    runtime_lock();
+    uint32_t seq = since_seq;
+    if (!out || max <= 0) {
+        seq = s_button_event_seq;
+    } else if (s_button_event_seq - seq > MODULES_BUTTON_EVENT_LEN) {
+        seq = s_button_event_seq - MODULES_BUTTON_EVENT_LEN;
+    }
+    while (seq != s_button_event_seq && count < max) {
+        seq++;
+        out[count++] = s_button_events[(seq - 1) % MODULES_BUTTON_EVENT_LEN];
+    }
+    if (out_seq) {
+        *out_seq = seq;
+    }
+    runtime_unlock();
+    return count;
+}
+
+void modules_get_changes_since(uint32_t since_seq, modules_changes_t *out)
+{
+    if (!out) {
+        return;
+    }
+
+    runtime_lock();
+    collect_changes_locked(since_seq, out);
+    runtime_unlock();
+}
+
+esp_err_t modules_build_status_delta_json(uint32_t since_seq, uint32_t *out_seq, cJSON **out)
+{
+    modules_changes_t changes;
+
+    if (!out_seq || !out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    *out = NULL;
+    runtime_lock();
+    collect_changes_locked(since_seq, &changes);
+    *out_seq = changes.seq;
+    if (!changes.resync && changes.outputs == 0 && changes.inputs == 0 && changes.buttons == 0 &&
+        changes.sensors == 0) {
+        runtime_unlock();
+        return ESP_OK;
+    }
+    *out = build_status_json_locked(&changes);
+    runtime_unlock();
+
+    if (!*out) {
+        return ESP_ERR_NO_MEM;
+    }
+    cJSON_AddNumberToObject(*out, "seq", changes.seq);
+    cJSON_AddBoolToObject(*out, "full", changes.resync);
+    return ESP_OK;
+}
+
 esp_err_t modules_action(const char *id, const cJSON *action, cJSON **out_response)
 {
     if (!id || !action || !out_response) {
@@ -4105,7 +6160,7 @@ esp_err_t modules_action(const char *id, const cJSON *action, cJSON **out_respon
     esp_err_t err = ESP_ERR_NOT_FOUND;
     cJSON *resp = NULL;
 
-    xSemaphoreTake(s_lock, portMAX_DELAY);
+    runtime_lock();
 
     if (strcmp(id, "master") == 0) {
         const char *cmd = jstr(action, "command", "");
@@ -4146,15 +6201,15 @@ esp_err_t modules_action(const char *id, const cJSON *action, cJSON **out_respon
                 } else if (out->type == OUTPUT_TYPE_STEPPER_A4988) {
                     err = stepper_a4988_stop_locked(out);
                 } else if (out->type == OUTPUT_TYPE_SERVO_3WIRE) {
-                    out->cfg.servo_3wire.release_at_us = 0;
+                    out->cfg.servo_3wire->release_at_us = 0;
                     err = set_output_power_locked(out, false);
                 } else if (out->type == OUTPUT_TYPE_SERVO_5WIRE) {
                     err = servo_5wire_set_drive_locked(out, 0);
                     if (err == ESP_OK) {
-                        out->cfg.servo_5wire.target_level = out->cfg.servo_5wire.current_level;
-                        out->cfg.servo_5wire.moving = false;
-                        out->cfg.servo_5wire.timed_out = false;
-                        out->cfg.servo_5wire.drive_started_us = 0;
+                        out->cfg.servo_5wire->target_level = out->cfg.servo_5wire->current_level;
+                        out->cfg.servo_5wire->moving = false;
+                        out->cfg.servo_5wire->timed_out = false;
+                        out->cfg.servo_5wire->drive_started_us = 0;
                         out->power = false;
                     }
                 } else {
@@ -4167,6 +6222,7 @@ esp_err_t modules_action(const char *id, const cJSON *action, cJSON **out_respon
                 const cJSON *set_level = jobj(action, "set_level");
                 const cJSON *set_brightness = jobj(action, "set_brightness");
                 const cJSON *color = jobj(action, "color");
+                const cJSON *effect = jobj(action, "effect");
                 bool handled = false;
                 err = ESP_OK;
 
@@ -4182,11 +6238,15 @@ esp_err_t modules_action(const char *id, const cJSON *action, cJSON **out_respon
                     err = set_output_brightness_locked(out, set_brightness->valueint);
                     handled = true;
                 }
+                if (err == ESP_OK && out->type == OUTPUT_TYPE_WS2812 && cJSON_IsString(effect)) {
+                    err = set_ws2812_effect_locked(out, effect->valuestring);
+                    handled = true;
+                }
                 if (err == ESP_OK && out->type == OUTPUT_TYPE_WS2812 && cJSON_IsObject((cJSON *)color)) {
-                    if (out->cfg.ws2812.mode == WS2812_MODE_RGB) {
-                        out->cfg.ws2812.red = (uint8_t)jint(color, "r", out->cfg.ws2812.red);
-                        out->cfg.ws2812.green = (uint8_t)jint(color, "g", out->cfg.ws2812.green);
-                        out->cfg.ws2812.blue = (uint8_t)jint(color, "b", out->cfg.ws2812.blue);
+                    if (out->cfg.ws2812->mode == WS2812_MODE_RGB) {
+                        out->cfg.ws2812->red = (uint8_t)jint(color, "r", out->cfg.ws2812->red);
+                        out->cfg.ws2812->green = (uint8_t)jint(color, "g", out->cfg.ws2812->green);
+                        out->cfg.ws2812->blue = (uint8_t)jint(color, "b", out->cfg.ws2812->blue);
                     }
                     err = output_apply_physical_state(out);
                     handled = true;
@@ -4197,6 +6257,7 @@ esp_err_t modules_action(const char *id, const cJSON *action, cJSON **out_respon
             }
 
             if (err == ESP_OK) {
+                mark_output_dirty_locked(out);
                 resp = build_output_status_json(out);
             }
         } else {
@@ -4208,7 +6269,10 @@ esp_err_t modules_action(const char *id, const cJSON *action, cJSON **out_respon
         }
     }
 
-    xSemaphoreGive(s_lock);
+    (void)commit_changes_locked();
+    s_sched.resync = true;
+    runtime_unlock();
+    wake_poll_task();
 
     if (err == ESP_OK) {
         *out_response = resp;
@@ -4225,9 +6289,12 @@ esp_err_t modules_action(const char *id, const cJSON *action, cJSON **out_respon
 esp_err_t modules_set_master_output(bool on)
 {
     esp_err_t err;
-    xSemaphoreTake(s_lock, portMAX_DELAY);
+    runtime_lock();
     err = set_master_output_locked(on);
-    xSemaphoreGive(s_lock);
+    (void)commit_changes_locked();
+    s_sched.resync = true;
+    runtime_unlock();
+    wake_poll_task();
     if (err == ESP_OK) {
         notify_runtime_changed();
     }
@@ -4237,14 +6304,57 @@ esp_err_t modules_set_master_output(bool on)
 bool modules_is_any_output_on(void)
 {
     bool on = false;
-    xSemaphoreTake(s_lock, portMAX_DELAY);
+    runtime_lock();
     on = is_any_output_on_locked();
-    xSemaphoreGive(s_lock);
+    runtime_unlock();
     return on;
 }
 
-void modules_set_runtime_callback(modules_runtime_callback_t cb, void *ctx)
+esp_err_t modules_add_runtime_callback(modules_runtime_callback_t cb, void *ctx)
+{
+    int free_slot = -1;
+
+    if (!cb) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int i = 0; i < MODULES_MAX_RUNTIME_CALLBACKS; ++i) {
+        if (s_runtime_listeners[i].cb == cb && s_runtime_listeners[i].ctx == ctx) {
+            return ESP_OK;
+        }
+        if (!s_runtime_listeners[i].cb && free_slot < 0) {
+            free_slot = i;
+        }
+    }
+    if (free_slot < 0) {
+        return ESP_ERR_NO_MEM;
+    }
+    s_runtime_listeners[free_slot].ctx = ctx;
+    s_runtime_listeners[free_slot].cb = cb;
+    return ESP_OK;
+}
+
+void modules_get_counts(modules_counts_t *out)
+{
+    if (!out) {
+        return;
+    }
+    runtime_lock();
+    out->outputs = (uint16_t)s_runtime.output_count;
+    out->inputs = (uint16_t)s_runtime.input_count;
+    out->buttons = (uint16_t)s_runtime.button_count;
+    out->sensors = (uint16_t)s_runtime.sensor_count;
+    runtime_unlock();
+}
+
+void modules_get_lock_stats(modules_lock_stats_t *out, bool reset)
 {
-    s_runtime_cb = cb;
-    s_runtime_cb_ctx = ctx;
+    if (!out) {
+        return;
+    }
+    runtime_lock();
+    *out = s_lock_stats;
+    if (reset) {
+        memset(&s_lock_stats, 0, sizeof(s_lock_stats));
+    }
+    runtime_unlock();
 }
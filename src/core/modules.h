@@ -1,7 +1,9 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
 
+#include "app_config.h"
 #include "cJSON.h"
 #include "esp_err.h"
 
@@ -11,17 +13,153 @@ extern "C" {
 
 typedef void (*modules_runtime_callback_t)(void *ctx);
 
+#define MODULES_LOCK_HIST_BUCKETS 20
+
+// Bucket 0 counts holds below 2 us, bucket i counts [2^i, 2^(i+1)) us, the last one is open ended.
+typedef struct {
+    uint32_t acquisitions;
+    uint32_t max_hold_us;
+    uint64_t total_hold_us;
+    uint32_t hold_hist[MODULES_LOCK_HIST_BUCKETS];
+} modules_lock_stats_t;
+
+// Entities in the applied runtime, which may be fewer than the config lists if applying it failed.
+typedef struct {
+    uint16_t outputs;
+    uint16_t inputs;
+    uint16_t buttons;
+    uint16_t sensors;
+} modules_counts_t;
+
+typedef enum {
+    MODULES_ENTITY_OUTPUT = 0,
+    MODULES_ENTITY_INPUT,
+    MODULES_ENTITY_SENSOR,
+    MODULES_ENTITY_BUTTON,
+} modules_entity_kind_t;
+
+// Bump when a field of the snapshot structs changes meaning or layout.
+#define MODULES_STATUS_VERSION 4
+
+#define MODULES_STATUS_MAX_OUTPUTS APP_MODULES_MAX_OUTPUTS
+#define MODULES_STATUS_MAX_INPUTS APP_MODULES_MAX_INPUTS
+// Configured sensors plus one entry per discovered DS18B20 device.
+#define MODULES_STATUS_MAX_SENSORS (APP_MODULES_MAX_SENSORS + APP_MODULES_MAX_DS18B20)
+
+#define MODULES_METRIC_TEMPERATURE (1U << 0)
+#define MODULES_METRIC_HUMIDITY (1U << 1)
+#define MODULES_METRIC_PRESSURE (1U << 2)
+
+typedef struct {
+    char id[24];
+    const char *type;
+    const char *cover_state; // NULL unless the output acts as a cover
+    bool enabled;
+    bool supported;
+    bool power;
+    bool has_level;
+    bool has_color;
+    bool moving;
+    int level;
+    int target_level;
+    int brightness;
+    uint8_t red;
+    uint8_t green;
+    uint8_t blue;
+    const char *effect; // RGB WS2812 only, otherwise NULL
+} modules_output_status_t;
+
+typedef struct {
+    char id[24];
+    bool enabled;
+    bool state;
+    bool counter;
+    uint64_t total; // counter inputs only
+    float rate_per_min;
+} modules_input_status_t;
+
+// DS18B20 devices are reported as their own entries with source_id set to the owning bus.
+typedef struct {
+    char id[48];
+    char source_id[24];
+    char name[64];
+    char type[24];
+    uint8_t source_index; // bit in modules_changes_t.sensors
+    bool enabled;
+    bool supported;
+    uint8_t metrics; // MODULES_METRIC_* with a valid reading
+    float temperature_c;
+    float humidity_pct;
+    float pressure_hpa;
+} modules_sensor_status_t;
+
+// The caller owns every array and sets version and the capacities; counts and seq are filled in.
+typedef struct {
+    uint32_t version;
+    uint32_t seq; // change journal position the snapshot is consistent with
+    modules_output_status_t *outputs;
+    uint16_t output_capacity;
+    uint16_t output_count;
+    modules_input_status_t *inputs;
+    uint16_t input_capacity;
+    uint16_t input_count;
+    modules_sensor_status_t *sensors;
+    uint16_t sensor_capacity;
+    uint16_t sensor_count;
+    bool any_output_on;
+} modules_status_snapshot_t;
+
+#define MODULES_CHANGE_JOURNAL_LEN 32
+
+// Entities touched after a given journal sequence. Output and input bits follow snapshot order, button
+// bits the configured button order.
+// resync means the history is gone (journal wrapped or config reapplied) and everything must be re-read.
+typedef struct {
+    uint32_t seq;
+    bool resync;
+    uint32_t outputs;
+    uint32_t inputs;
+    uint32_t buttons;
+    uint32_t sensors;
+} modules_changes_t;
+
+#define MODULES_BUTTON_EVENT_LEN 16
+
+// A recognized button gesture: "single", "double", "triple" or "long". Hold-repeat ticks are not journaled.
+typedef struct {
+    uint32_t seq;
+    char id[24];
+    const char *gesture;
+    int64_t time_us;
+} modules_button_event_t;
+
 esp_err_t modules_init(void);
 esp_err_t modules_apply_config(const cJSON *cfg);
 const char *modules_last_error(void);
 
 cJSON *modules_build_status_json(void);
+// One element of the matching modules_build_status_json array, NULL past the last one; lets a caller
+// stream the status entity by entity instead of holding the whole tree.
+cJSON *modules_build_entity_status_json(modules_entity_kind_t kind, int index);
+esp_err_t modules_get_status_snapshot(modules_status_snapshot_t *snapshot);
+esp_err_t modules_get_output_status(const char *id, modules_output_status_t *out);
+void modules_get_changes_since(uint32_t since_seq, modules_changes_t *out);
+// Copies up to max button events newer than since_seq, oldest first; events that fell out of the ring
+// are skipped. *out_seq is where the next call should continue from; max 0 just reports the current position.
+int modules_get_button_events_since(uint32_t since_seq, modules_button_event_t *out, int max, uint32_t *out_seq);
+// Status JSON limited to what changed after since_seq, plus "seq" and "full". *out stays NULL when
+// nothing changed.
+esp_err_t modules_build_status_delta_json(uint32_t since_seq, uint32_t *out_seq, cJSON **out);
 esp_err_t modules_action(const char *id, const cJSON *action, cJSON **out_response);
 
 esp_err_t modules_set_master_output(bool on);
+// WS2812 effect names in Home Assistant effect_list order; NULL past the end.
+const char *modules_ws2812_effect_name(int index);
 bool modules_is_any_output_on(void);
 
-void modules_set_runtime_callback(modules_runtime_callback_t cb, void *ctx);
+esp_err_t modules_add_runtime_callback(modules_runtime_callback_t cb, void *ctx);
+void modules_get_lock_stats(modules_lock_stats_t *out, bool reset);
+void modules_get_counts(modules_counts_t *out);
 
 #ifdef __cplusplus
 }
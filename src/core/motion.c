@@ -0,0 +1,92 @@
+#include "core/motion.h"
+
+static uint32_t isqrt_u32(uint32_t value)
+{
+    uint32_t root = 0;
+    uint32_t bit = 1UL << 30;
+
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+void motion_profile_init(motion_profile_t *profile, int max_steps_per_sec, int accel_steps_per_s2)
+{
+    if (max_steps_per_sec < 1) {
+        max_steps_per_sec = 1;
+    }
+    if (accel_steps_per_s2 < 0) {
+        accel_steps_per_s2 = 0;
+    }
+
+    profile->vmax_sq = (uint32_t)max_steps_per_sec * (uint32_t)max_steps_per_sec;
+    profile->accel2 = 2U * (uint32_t)accel_steps_per_s2;
+    // With no acceleration limit the first step already runs at full speed.
+    profile->vstart_sq = (profile->accel2 == 0 || profile->accel2 > profile->vmax_sq) ? profile->vmax_sq : profile->accel2;
+    profile->v_sq = 0;
+    profile->dir = 0;
+}
+
+void motion_profile_start(motion_profile_t *profile, int direction)
+{
+    if (direction == 0) {
+        return;
+    }
+    profile->dir = direction > 0 ? 1 : -1;
+    if (profile->v_sq == 0) {
+        profile->v_sq = profile->vstart_sq;
+    }
+}
+
+void motion_profile_halt(motion_profile_t *profile)
+{
+    profile->v_sq = 0;
+}
+
+bool motion_profile_running(const motion_profile_t *profile)
+{
+    return profile->v_sq != 0;
+}
+
+uint32_t motion_profile_interval_us(const motion_profile_t *profile)
+{
+    uint32_t v = isqrt_u32(profile->v_sq);
+    return v ? 1000000U / v : 0;
+}
+
+void motion_profile_advance(motion_profile_t *profile, int steps_left)
+{
+    uint32_t v_sq = profile->v_sq;
+
+    if (v_sq == 0) {
+        return;
+    }
+
+    if (steps_left <= 0) {
+        // Arrived, or the target is now behind us: brake and come to rest so the caller can reverse.
+        v_sq = (steps_left == 0 || v_sq <= profile->vstart_sq + profile->accel2) ? 0 : v_sq - profile->accel2;
+    } else if ((uint64_t)v_sq >= (uint64_t)profile->accel2 * (uint64_t)steps_left) {
+        v_sq = v_sq > profile->vstart_sq + profile->accel2 ? v_sq - profile->accel2 : profile->vstart_sq;
+    } else {
+        v_sq = v_sq + profile->accel2 < profile->vmax_sq ? v_sq + profile->accel2 : profile->vmax_sq;
+    }
+    profile->v_sq = v_sq;
+}
+
+int motion_profile_stop_distance(const motion_profile_t *profile)
+{
+    if (profile->v_sq == 0 || profile->accel2 == 0) {
+        return 0;
+    }
+    return (int)(profile->v_sq / profile->accel2);
+}
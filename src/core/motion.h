@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Per-step trapezoidal velocity profile. Velocity is kept squared so that each step changes it by exactly
+// 2a (v^2 = v0^2 + 2as), which needs no floating point and no notion of elapsed time.
+typedef struct {
+    uint32_t vmax_sq;
+    uint32_t accel2;
+    uint32_t vstart_sq;
+    uint32_t v_sq;
+    int dir;
+} motion_profile_t;
+
+void motion_profile_init(motion_profile_t *profile, int max_steps_per_sec, int accel_steps_per_s2);
+void motion_profile_start(motion_profile_t *profile, int direction);
+void motion_profile_halt(motion_profile_t *profile);
+bool motion_profile_running(const motion_profile_t *profile);
+uint32_t motion_profile_interval_us(const motion_profile_t *profile);
+void motion_profile_advance(motion_profile_t *profile, int steps_left);
+int motion_profile_stop_distance(const motion_profile_t *profile);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,68 @@
+#include "core/perf_probe.h"
+
+#include <string.h>
+
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+
+#include "core/hist_util.h"
+
+static const char *const s_probe_names[PERF_PROBE_COUNT] = {
+    [PERF_PROBE_MODULES_POLL] = "modules_poll",
+    [PERF_PROBE_STATUS_JSON] = "status_json",
+    [PERF_PROBE_MQTT_PUBLISH] = "mqtt_publish",
+    [PERF_PROBE_WS2812_RENDER] = "ws2812_render",
+    [PERF_PROBE_WS2812_TX] = "ws2812_tx",
+};
+
+static perf_probe_stats_t s_probes[PERF_PROBE_COUNT];
+static portMUX_TYPE s_probe_mux = portMUX_INITIALIZER_UNLOCKED;
+
+const char *perf_probe_name(perf_probe_id_t id)
+{
+    return id < PERF_PROBE_COUNT ? s_probe_names[id] : "";
+}
+
+void perf_probe_record(perf_probe_id_t id, int64_t start_us)
+{
+    perf_probe_record_units(id, start_us, 0);
+}
+
+void perf_probe_record_units(perf_probe_id_t id, int64_t start_us, uint32_t units)
+{
+    if (id >= PERF_PROBE_COUNT) {
+        return;
+    }
+
+    uint32_t us = hist_elapsed_us(esp_timer_get_time() - start_us);
+    int bucket = hist_log2_bucket(us, PERF_PROBE_HIST_BUCKETS);
+
+    portENTER_CRITICAL(&s_probe_mux);
+    perf_probe_stats_t *probe = &s_probes[id];
+    probe->count++;
+    probe->total_us += us;
+    probe->units += units;
+    probe->hist[bucket]++;
+    if (us > probe->max_us) {
+        probe->max_us = us;
+    }
+    portEXIT_CRITICAL(&s_probe_mux);
+}
+
+void perf_probe_get(perf_probe_id_t id, perf_probe_stats_t *out, bool reset)
+{
+    if (!out) {
+        return;
+    }
+    if (id >= PERF_PROBE_COUNT) {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+
+    portENTER_CRITICAL(&s_probe_mux);
+    *out = s_probes[id];
+    if (reset) {
+        memset(&s_probes[id], 0, sizeof(s_probes[id]));
+    }
+    portEXIT_CRITICAL(&s_probe_mux);
+}
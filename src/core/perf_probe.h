@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PERF_PROBE_HIST_BUCKETS 20
+
+typedef enum {
+    PERF_PROBE_MODULES_POLL = 0,
+    PERF_PROBE_STATUS_JSON,
+    PERF_PROBE_MQTT_PUBLISH,
+    PERF_PROBE_WS2812_RENDER,
+    PERF_PROBE_WS2812_TX,
+    PERF_PROBE_COUNT,
+} perf_probe_id_t;
+
+// Same bucketing as modules_lock_stats_t: bucket 0 is below 2 us, bucket i is [2^i, 2^(i+1)) us.
+typedef struct {
+    uint32_t count;
+    uint32_t max_us;
+    uint64_t total_us;
+    uint64_t units; // work items (e.g. pixels) reported with perf_probe_record_units
+    uint32_t hist[PERF_PROBE_HIST_BUCKETS];
+} perf_probe_stats_t;
+
+const char *perf_probe_name(perf_probe_id_t id);
+// Records the time elapsed since start_us (an esp_timer_get_time() value). Safe from any task.
+void perf_probe_record(perf_probe_id_t id, int64_t start_us);
+// Same, also counting units of work so per-unit cost can be reported.
+void perf_probe_record_units(perf_probe_id_t id, int64_t start_us, uint32_t units);
+void perf_probe_get(perf_probe_id_t id, perf_probe_stats_t *out, bool reset);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,384 @@
+#include "core/ws2812_render.h"
+
+#include <string.h>
+
+#define WS2812_TWINKLE_SEED 0x9E3779B9U
+#define WS2812_EASING_TABLE_BITS 6
+#define WS2812_EASING_TABLE_LEN ((1 << WS2812_EASING_TABLE_BITS) + 1)
+
+static uint8_t ws2812_apply_gamma(uint8_t value)
+{
+    static const uint8_t k_gamma_lut[256] = {
+          0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,
+          1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
+          3,   3,   3,   3,   3,   4,   4,   4,   4,   5,   5,   5,   5,   6,   6,   6,
+          6,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,  10,  11,  11,  11,  12,
+         12,  13,  13,  13,  14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,
+         20,  20,  21,  22,  22,  23,  23,  24,  25,  25,  26,  26,  27,  28,  28,  29,
+         30,  30,  31,  32,  33,  33,  34,  35,  35,  36,  37,  38,  39,  39,  40,  41,
+         42,  43,  43,  44,  45,  46,  47,  48,  49,  49,  50,  51,  52,  53,  54,  55,
+         56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,  68,  69,  70,  71,
+         73,  74,  75,  76,  77,  78,  79,  81,  82,  83,  84,  85,  87,  88,  89,  90,
+         91,  93,  94,  95,  97,  98,  99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
+        113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
+        137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
+        163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
+        192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
+        223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255,
+    };
+
+    return k_gamma_lut[value];
+}
+
+const char *ws2812_effect_name(ws2812_effect_t effect)
+{
+    static const char *const k_names[WS2812_EFFECT_COUNT] = {
+        "none", "rainbow", "chase", "twinkle", "gradient", "breathe", "segments",
+    };
+
+    return (unsigned)effect < WS2812_EFFECT_COUNT ? k_names[effect] : k_names[WS2812_EFFECT_NONE];
+}
+
+void ws2812_palette_init(ws2812_palette_t *palette, const char *color_order, bool gamma_correction)
+{
+    static const char *const k_valid_orders[] = {
+        "RGB", "RBG", "GRB", "GBR", "BRG", "BGR",
+    };
+    const char *order = "GRB";
+
+    for (size_t i = 0; color_order && i < sizeof(k_valid_orders) / sizeof(k_valid_orders[0]); ++i) {
+        if (strcmp(color_order, k_valid_orders[i]) == 0) {
+            order = color_order;
+            break;
+        }
+    }
+    for (int k = 0; k < WS2812_BYTES_PER_PIXEL; ++k) {
+        palette->wire_perm[k] = order[k] == 'R' ? 0 : (order[k] == 'G' ? 1 : 2);
+    }
+    palette->gamma_correction = gamma_correction;
+    palette->lut_level = -1;
+}
+
+// Scaling by level and gamma collapse into one table, rebuilt only when the level changes.
+static void ws2812_prepare_lut(ws2812_palette_t *palette, int level)
+{
+    if (level < 0) {
+        level = 0;
+    }
+    if (level > WS2812_BRIGHTNESS_MAX) {
+        level = WS2812_BRIGHTNESS_MAX;
+    }
+    if (palette->lut_level == level) {
+        return;
+    }
+    for (int v = 0; v < 256; ++v) {
+        uint8_t scaled = (uint8_t)(((uint32_t)v * (uint32_t)level) / WS2812_BRIGHTNESS_MAX);
+        palette->level_lut[v] = palette->gamma_correction ? ws2812_apply_gamma(scaled) : scaled;
+    }
+    palette->lut_level = level;
+}
+
+static void ws2812_put_pixel(const ws2812_palette_t *palette, uint8_t *px, const uint8_t rgb[3])
+{
+    for (int k = 0; k < WS2812_BYTES_PER_PIXEL; ++k) {
+        px[k] = palette->level_lut[rgb[palette->wire_perm[k]]];
+    }
+}
+
+// Writes one pixel, then doubles the filled prefix with memcpy until the frame is full.
+static void ws2812_fill_frame(uint8_t *frame, size_t len, const uint8_t *pixel)
+{
+    size_t filled = len < WS2812_BYTES_PER_PIXEL ? len : WS2812_BYTES_PER_PIXEL;
+
+    memcpy(frame, pixel, filled);
+    while (filled < len) {
+        size_t chunk = filled < len - filled ? filled : len - filled;
+        memcpy(frame + filled, frame, chunk);
+        filled += chunk;
+    }
+}
+
+void ws2812_render_solid(ws2812_palette_t *palette, uint8_t *frame, int pixel_count, int level, const uint8_t rgb[3])
+{
+    size_t frame_len = (size_t)pixel_count * WS2812_BYTES_PER_PIXEL;
+    uint8_t pixel[WS2812_BYTES_PER_PIXEL];
+
+    if (level <= 0) {
+        memset(frame, 0, frame_len);
+        return;
+    }
+    ws2812_prepare_lut(palette, level);
+    ws2812_put_pixel(palette, pixel, rgb);
+    ws2812_fill_frame(frame, frame_len, pixel);
+}
+
+void ws2812_render_mono(ws2812_palette_t *palette, uint8_t *frame, int pixel_count, int level, int lit_bytes)
+{
+    size_t frame_len = (size_t)pixel_count * WS2812_BYTES_PER_PIXEL;
+    size_t active = (lit_bytes < 0 || (size_t)lit_bytes > frame_len) ? frame_len : (size_t)lit_bytes;
+
+    if (level <= 0) {
+        memset(frame, 0, frame_len);
+        return;
+    }
+    ws2812_prepare_lut(palette, level);
+    memset(frame, palette->level_lut[WS2812_BRIGHTNESS_MAX], active);
+    memset(frame + active, 0, frame_len - active);
+}
+
+static uint8_t ws2812_scale8(uint8_t value, uint8_t scale)
+{
+    return (uint8_t)(((uint32_t)value * ((uint32_t)scale + 1U)) >> 8);
+}
+
+static uint32_t ws2812_hash32(uint32_t x)
+{
+    x ^= x >> 16;
+    x *= 0x7FEB352DU;
+    x ^= x >> 15;
+    x *= 0x846CA68BU;
+    x ^= x >> 16;
+    return x;
+}
+
+// Three-segment hue wheel: hue 0 is red, 85 green, 170 blue.
+static void ws2812_wheel(uint8_t hue, uint8_t rgb[3])
+{
+    uint8_t ramp;
+
+    if (hue < 85) {
+        ramp = (uint8_t)(hue * 3);
+        rgb[0] = (uint8_t)(255 - ramp);
+        rgb[1] = ramp;
+        rgb[2] = 0;
+    } else if (hue < 170) {
+        ramp = (uint8_t)((hue - 85) * 3);
+        rgb[0] = 0;
+        rgb[1] = (uint8_t)(255 - ramp);
+        rgb[2] = ramp;
+    } else {
+        ramp = (uint8_t)((hue - 170) * 3);
+        rgb[0] = ramp;
+        rgb[1] = 0;
+        rgb[2] = (uint8_t)(255 - ramp);
+    }
+}
+
+// phase advances by fx->speed per frame (Q8), so speed 256 would be one step per frame.
+bool ws2812_render_effect(ws2812_palette_t *palette, uint8_t *frame, int pixel_count, const ws2812_effect_cfg_t *fx,
+                          int level, const uint8_t base[3], uint32_t effect_frame)
+{
+    const int count = pixel_count;
+    const uint32_t phase = effect_frame * (uint32_t)fx->speed;
+    size_t frame_len = (size_t)count * WS2812_BYTES_PER_PIXEL;
+    uint8_t *px = frame;
+    uint8_t rgb[3];
+
+    if (fx->effect == WS2812_EFFECT_NONE || fx->effect >= WS2812_EFFECT_COUNT) {
+        return false;
+    }
+    ws2812_prepare_lut(palette, level);
+
+    switch (fx->effect) {
+        case WS2812_EFFECT_RAINBOW: {
+            // One full wheel across the strip, hue positions in Q8 to stay smooth on short strips.
+            uint32_t step_q8 = (256U << 8) / (uint32_t)count;
+            uint32_t hue_q8 = (phase >> 6) << 8;
+            for (int i = 0; i < count; ++i, px += WS2812_BYTES_PER_PIXEL, hue_q8 += step_q8) {
+                ws2812_wheel((uint8_t)(hue_q8 >> 8), rgb);
+                ws2812_put_pixel(palette, px, rgb);
+            }
+            break;
+        }
+        case WS2812_EFFECT_CHASE: {
+            // Theater chase: every third pixel lit, marching forward.
+            uint8_t on[WS2812_BYTES_PER_PIXEL];
+            int lit = 2 - (int)((phase >> 9) % 3U);
+            ws2812_put_pixel(palette, on, base);
+            memset(frame, 0, frame_len);
+            for (int i = lit; i < count; i += 3) {
+                memcpy(frame + (size_t)i * WS2812_BYTES_PER_PIXEL, on, WS2812_BYTES_PER_PIXEL);
+            }
+            break;
+        }
+        case WS2812_EFFECT_TWINKLE: {
+            // Each pixel gets its own offset and rate from a hash of its index; squaring the triangle
+            // keeps most pixels dim with short peaks.
+            uint32_t t = phase >> 7;
+            for (int i = 0; i < count; ++i, px += WS2812_BYTES_PER_PIXEL) {
+                uint32_t h = ws2812_hash32((uint32_t)i ^ WS2812_TWINKLE_SEED);
+                uint8_t pos = (uint8_t)(t * (1U + ((h >> 8) & 3U)) + h);
+                uint32_t tri = pos < 128 ? (uint32_t)pos * 2U : (255U - pos) * 2U;
+                uint8_t scale = (uint8_t)((tri * tri) >> 8);
+                for (int k = 0; k < 3; ++k) {
+                    rgb[k] = ws2812_scale8(base[k], scale);
+                }
+                ws2812_put_pixel(palette, px, rgb);
+            }
+            break;
+        }
+        case WS2812_EFFECT_GRADIENT: {
+            uint32_t step_q16 = count > 1 ? (65536U / (uint32_t)(count - 1)) : 0;
+            uint32_t w_q16 = 0;
+            for (int i = 0; i < count; ++i, px += WS2812_BYTES_PER_PIXEL, w_q16 += step_q16) {
+                int32_t w = (int32_t)(w_q16 > 65536U ? 256U : (w_q16 >> 8));
+                for (int k = 0; k < 3; ++k) {
+                    rgb[k] = (uint8_t)(base[k] + (((int32_t)fx->gradient_rgb[k] - (int32_t)base[k]) * w) / 256);
+                }
+                ws2812_put_pixel(palette, px, rgb);
+            }
+            break;
+        }
+        case WS2812_EFFECT_BREATHE: {
+            // Squared triangle over 512 steps, floored so the strip never goes fully dark.
+            uint32_t tri = (phase >> 5) & 511U;
+            uint8_t pixel[WS2812_BYTES_PER_PIXEL];
+            if (tri > 255U) {
+                tri = 511U - tri;
+            }
+            uint8_t scale = (uint8_t)(24U + ((((tri * tri) >> 8) * 231U) >> 8));
+            for (int k = 0; k < 3; ++k) {
+                rgb[k] = ws2812_scale8(base[k], scale);
+            }
+            ws2812_put_pixel(palette, pixel, rgb);
+            ws2812_fill_frame(frame, frame_len, pixel);
+            break;
+        }
+        case WS2812_EFFECT_SEGMENTS:
+            memset(frame, 0, frame_len);
+            for (int seg_idx = 0; seg_idx < fx->segment_count; ++seg_idx) {
+                const ws2812_segment_t *seg = &fx->segments[seg_idx];
+                uint8_t pixel[WS2812_BYTES_PER_PIXEL];
+                int len;
+                if (seg->start >= count) {
+                    continue;
+                }
+                len = seg->count > count - seg->start ? count - seg->start : seg->count;
+                ws2812_put_pixel(palette, pixel, seg->rgb);
+                ws2812_fill_frame(frame + (size_t)seg->start * WS2812_BYTES_PER_PIXEL,
+                                  (size_t)len * WS2812_BYTES_PER_PIXEL, pixel);
+            }
+            break;
+        case WS2812_EFFECT_NONE:
+        case WS2812_EFFECT_COUNT:
+        default:
+            break;
+    }
+    return true;
+}
+
+// Easing curves sampled at 64 intervals in Q16 and interpolated between samples: smoothstep for
+// ease_in_out, and CIE 1976 lightness to luminance for cie, which makes a fade look even to the eye.
+uint32_t ws2812_ease(ws2812_easing_t easing, uint32_t phase_q16)
+{
+    static const uint16_t k_ease_in_out[WS2812_EASING_TABLE_LEN] = {
+            0,    47,   188,   418,   736,  1137,  1620,  2180,
+         2816,  3523,  4300,  5142,  6048,  7013,  8036,  9112,
+        10240, 11415, 12636, 13898, 15200, 16537, 17908, 19308,
+        20736, 22187, 23660, 25150, 26656, 28173, 29700, 31232,
+        32768, 34303, 35835, 37362, 38879, 40385, 41875, 43348,
+        44799, 46227, 47627, 48998, 50335, 51637, 52899, 54120,
+        55295, 56423, 57499, 58522, 59487, 60393, 61235, 62012,
+        62719, 63355, 63915, 64398, 64799, 65117, 65347, 65488,
+        65535,
+    };
+    static const uint16_t k_cie_lightness[WS2812_EASING_TABLE_LEN] = {
+            0,   113,   227,   340,   453,   567,   686,   821,
+          972,  1141,  1328,  1535,  1762,  2010,  2281,  2575,
+         2894,  3237,  3607,  4004,  4429,  4883,  5367,  5882,
+         6429,  7009,  7623,  8272,  8956,  9677, 10436, 11234,
+        12071, 12948, 13868, 14830, 15835, 16885, 17980, 19121,
+        20310, 21547, 22833, 24170, 25558, 26997, 28490, 30037,
+        31639, 33297, 35012, 36785, 38616, 40507, 42460, 44473,
+        46550, 48690, 50895, 53166, 55503, 57907, 60380, 62922,
+        65535,
+    };
+    const int frac_bits = 16 - WS2812_EASING_TABLE_BITS;
+    const uint16_t *table;
+    uint32_t idx;
+    uint32_t frac;
+
+    if (phase_q16 > 0xFFFFU) {
+        phase_q16 = 0xFFFFU;
+    }
+    switch (easing) {
+        case WS2812_EASING_EASE_IN_OUT: table = k_ease_in_out; break;
+        case WS2812_EASING_CIE: table = k_cie_lightness; break;
+        case WS2812_EASING_LINEAR:
+        default: return phase_q16;
+    }
+    idx = phase_q16 >> frac_bits;
+    frac = phase_q16 & ((1U << frac_bits) - 1U);
+    return table[idx] + ((((uint32_t)table[idx + 1] - table[idx]) * frac) >> frac_bits);
+}
+
+int ws2812_lerp(int from, int to, uint32_t weight_q16)
+{
+    return (int)(((uint32_t)from * (65536U - weight_q16) + (uint32_t)to * weight_q16 + 32768U) >> 16);
+}
+
+void ws2812_transition_start(ws2812_transition_t *transition, int duration_ms, ws2812_easing_t easing, bool use_wipe,
+                             int start_level, const uint8_t start_rgb[3], int target_level, const uint8_t target_rgb[3])
+{
+    transition->active = true;
+    transition->use_wipe = use_wipe;
+    transition->easing = easing;
+    transition->duration_us = (int64_t)duration_ms * 1000LL;
+    transition->phase_per_us = (uint32_t)((1ULL << 32) / (uint64_t)transition->duration_us);
+    transition->start_level = start_level;
+    transition->target_level = target_level;
+    memcpy(transition->start_rgb, start_rgb, sizeof(transition->start_rgb));
+    memcpy(transition->target_rgb, target_rgb, sizeof(transition->target_rgb));
+}
+
+void ws2812_transition_step(ws2812_transition_t *transition, int64_t elapsed_us, int pixel_count,
+                            ws2812_transition_frame_t *out)
+{
+    out->segments = -1;
+    if (elapsed_us < 0) {
+        elapsed_us = 0;
+    }
+    if (elapsed_us >= transition->duration_us) {
+        transition->active = false;
+        transition->use_wipe = false;
+        out->level = transition->target_level;
+        memcpy(out->rgb, transition->target_rgb, sizeof(out->rgb));
+        return;
+    }
+
+    uint32_t phase_q16 = (uint32_t)(((uint64_t)elapsed_us * transition->phase_per_us) >> 16);
+    uint32_t eased = ws2812_ease(transition->easing, phase_q16);
+
+    if (transition->use_wipe) {
+        int total_segments = pixel_count * WS2812_BYTES_PER_PIXEL;
+        int lit = (int)(((uint32_t)total_segments * eased + 0xFFFFU) >> 16);
+        bool turning_on = (transition->start_level == 0 && transition->target_level > 0);
+
+        out->segments = turning_on ? lit : total_segments - lit;
+        if (out->segments >= total_segments) {
+            out->segments = -1;
+        }
+        out->level = turning_on ? transition->target_level : transition->start_level;
+        memcpy(out->rgb, transition->target_rgb, sizeof(out->rgb));
+    } else {
+        out->level = ws2812_lerp(transition->start_level, transition->target_level, eased);
+        for (int k = 0; k < 3; ++k) {
+            out->rgb[k] = (uint8_t)ws2812_lerp(transition->start_rgb[k], transition->target_rgb[k], eased);
+        }
+    }
+}
+
+// led_strip keeps its own GRB buffer and does not expose it, so the frame is copied across with the
+// argument order that makes its wire bytes equal ours.
+esp_err_t ws2812_transmit(led_strip_handle_t strip, const uint8_t *frame, int pixel_count)
+{
+    const uint8_t *px = frame;
+
+    for (int i = 0; i < pixel_count; ++i, px += WS2812_BYTES_PER_PIXEL) {
+        esp_err_t err = led_strip_set_pixel(strip, (uint32_t)i, px[1], px[0], px[2]);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+    return led_strip_refresh(strip);
+}
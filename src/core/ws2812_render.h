@@ -0,0 +1,106 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "led_strip.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define WS2812_BYTES_PER_PIXEL 3
+#define WS2812_BRIGHTNESS_MAX 255
+#define WS2812_MAX_SEGMENTS 8
+
+typedef enum {
+    WS2812_EASING_LINEAR = 0,
+    WS2812_EASING_EASE_IN_OUT,
+    WS2812_EASING_CIE,
+} ws2812_easing_t;
+
+typedef enum {
+    WS2812_EFFECT_NONE = 0,
+    WS2812_EFFECT_RAINBOW,
+    WS2812_EFFECT_CHASE,
+    WS2812_EFFECT_TWINKLE,
+    WS2812_EFFECT_GRADIENT,
+    WS2812_EFFECT_BREATHE,
+    WS2812_EFFECT_SEGMENTS,
+    WS2812_EFFECT_COUNT,
+} ws2812_effect_t;
+
+typedef struct {
+    uint16_t start;
+    uint16_t count;
+    uint8_t rgb[3];
+} ws2812_segment_t;
+
+// Channel order and gamma are resolved ahead of rendering: wire byte k of a pixel is
+// level_lut[rgb[wire_perm[k]]], with level_lut rebuilt only when the level changes.
+typedef struct {
+    bool gamma_correction;
+    uint8_t wire_perm[WS2812_BYTES_PER_PIXEL];
+    int lut_level;
+    uint8_t level_lut[256];
+} ws2812_palette_t;
+
+// Every effect frame is a pure function of these settings, the base color and level, and the frame
+// index, so a given frame index always renders the same bytes.
+typedef struct {
+    ws2812_effect_t effect;
+    int speed;
+    uint8_t gradient_rgb[3];
+    ws2812_segment_t segments[WS2812_MAX_SEGMENTS];
+    int segment_count;
+} ws2812_effect_cfg_t;
+
+// A fade or wipe between two level/color states, stepped from the elapsed time alone.
+typedef struct {
+    bool active;
+    bool use_wipe;
+    ws2812_easing_t easing;
+    int64_t duration_us;
+    // Progress per microsecond as a Q32 fraction; progress is kept in Q16.
+    uint32_t phase_per_us;
+    int start_level;
+    int target_level;
+    uint8_t start_rgb[3];
+    uint8_t target_rgb[3];
+} ws2812_transition_t;
+
+// One transition frame; segments is the lit wipe prefix in wire bytes, -1 for a full frame.
+typedef struct {
+    int level;
+    uint8_t rgb[3];
+    int segments;
+} ws2812_transition_frame_t;
+
+// Config and Home Assistant effect_list name; "none" for out-of-range values.
+const char *ws2812_effect_name(ws2812_effect_t effect);
+// color_order is one of the six permutations of "RGB"; anything else falls back to GRB.
+void ws2812_palette_init(ws2812_palette_t *palette, const char *color_order, bool gamma_correction);
+// Frames are pixel_count * WS2812_BYTES_PER_PIXEL bytes in wire order.
+void ws2812_render_solid(ws2812_palette_t *palette, uint8_t *frame, int pixel_count, int level, const uint8_t rgb[3]);
+// Mono-triplet strips treat every wire byte as its own segment; lit_bytes < 0 lights them all.
+void ws2812_render_mono(ws2812_palette_t *palette, uint8_t *frame, int pixel_count, int level, int lit_bytes);
+// Returns false for WS2812_EFFECT_NONE, leaving the frame untouched.
+bool ws2812_render_effect(ws2812_palette_t *palette, uint8_t *frame, int pixel_count, const ws2812_effect_cfg_t *fx,
+                          int level, const uint8_t base[3], uint32_t effect_frame);
+// duration_ms must be positive. A wipe only makes sense between off and on on a mono-triplet strip.
+void ws2812_transition_start(ws2812_transition_t *transition, int duration_ms, ws2812_easing_t easing, bool use_wipe,
+                             int start_level, const uint8_t start_rgb[3], int target_level, const uint8_t target_rgb[3]);
+// Computes the frame elapsed_us into the transition; from the duration on it returns the target and
+// clears transition->active.
+void ws2812_transition_step(ws2812_transition_t *transition, int64_t elapsed_us, int pixel_count,
+                            ws2812_transition_frame_t *out);
+// Copies a wire-order frame into the strip and refreshes it.
+esp_err_t ws2812_transmit(led_strip_handle_t strip, const uint8_t *frame, int pixel_count);
+// Maps a Q16 transition phase through the easing curve, also in Q16.
+uint32_t ws2812_ease(ws2812_easing_t easing, uint32_t phase_q16);
+int ws2812_lerp(int from, int to, uint32_t weight_q16);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,162 @@
+#include "drivers/gpio_edge.h"
+
+#include "driver/gpio.h"
+#include "esp_timer.h"
+
+#define GPIO_EDGE_RING_LEN 64
+
+_Static_assert((GPIO_EDGE_RING_LEN & (GPIO_EDGE_RING_LEN - 1)) == 0, "GPIO_EDGE_RING_LEN must be a power of two");
+
+// All GPIO handlers run one after another from the same interrupt, so the ISR side is a single producer
+// and the indices only need ordering, not locking.
+static gpio_edge_event_t s_ring[GPIO_EDGE_RING_LEN];
+static uint32_t s_head = 0;
+static uint32_t s_tail = 0;
+static uint32_t s_dropped = 0;
+static TaskHandle_t s_notify_task = NULL;
+
+typedef struct {
+    uint32_t pending;
+    uint32_t min_interval_us;
+    int64_t last_us;
+} edge_counter_t;
+
+static edge_counter_t s_counters[GPIO_EDGE_MAX_COUNTERS];
+static portMUX_TYPE s_counter_mux = portMUX_INITIALIZER_UNLOCKED;
+static bool s_service_installed = false;
+
+static void gpio_edge_isr(void *arg)
+{
+    uint32_t packed = (uint32_t)(uintptr_t)arg;
+    int gpio = (int)(packed & 0xFF);
+    uint32_t head = s_head;
+    BaseType_t woken = pdFALSE;
+
+    if (head - __atomic_load_n(&s_tail, __ATOMIC_ACQUIRE) >= GPIO_EDGE_RING_LEN) {
+        s_dropped++;
+    } else {
+        gpio_edge_event_t *ev = &s_ring[head & (GPIO_EDGE_RING_LEN - 1)];
+        ev->time_us = esp_timer_get_time();
+        ev->source = (uint8_t)(packed >> 8);
+        ev->level = (uint8_t)(gpio_get_level((gpio_num_t)gpio) != 0);
+        __atomic_store_n(&s_head, head + 1, __ATOMIC_RELEASE);
+    }
+
+    if (s_notify_task) {
+        vTaskNotifyGiveFromISR(s_notify_task, &woken);
+    }
+    portYIELD_FROM_ISR(woken);
+}
+
+static void gpio_edge_counter_isr(void *arg)
+{
+    edge_counter_t *counter = &s_counters[(uint32_t)(uintptr_t)arg];
+    int64_t now_us = esp_timer_get_time();
+
+    portENTER_CRITICAL_ISR(&s_counter_mux);
+    if (counter->last_us == 0 || now_us - counter->last_us >= (int64_t)counter->min_interval_us) {
+        counter->pending++;
+        counter->last_us = now_us;
+    }
+    portEXIT_CRITICAL_ISR(&s_counter_mux);
+}
+
+esp_err_t gpio_edge_start(TaskHandle_t notify_task)
+{
+    s_notify_task = notify_task;
+    if (s_service_installed) {
+        return ESP_OK;
+    }
+
+    esp_err_t err = gpio_install_isr_service(0);
+    // Someone else (another driver) may own the service already; handlers can still be added.
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        return err;
+    }
+    s_service_installed = true;
+    return ESP_OK;
+}
+
+esp_err_t gpio_edge_add(int gpio, uint8_t source)
+{
+    if (!s_service_installed || gpio < 0 || gpio > 0xFF) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t err = gpio_set_intr_type((gpio_num_t)gpio, GPIO_INTR_ANYEDGE);
+    if (err != ESP_OK) {
+        return err;
+    }
+    err = gpio_isr_handler_add((gpio_num_t)gpio, gpio_edge_isr,
+                               (void *)(uintptr_t)(((uint32_t)source << 8) | (uint32_t)gpio));
+    if (err != ESP_OK) {
+        (void)gpio_set_intr_type((gpio_num_t)gpio, GPIO_INTR_DISABLE);
+        return err;
+    }
+    return gpio_intr_enable((gpio_num_t)gpio);
+}
+
+esp_err_t gpio_edge_add_counter(int gpio, uint8_t channel, bool rising, uint32_t min_interval_us)
+{
+    if (!s_service_installed || gpio < 0 || channel >= GPIO_EDGE_MAX_COUNTERS) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    portENTER_CRITICAL(&s_counter_mux);
+    s_counters[channel].pending = 0;
+    s_counters[channel].last_us = 0;
+    s_counters[channel].min_interval_us = min_interval_us;
+    portEXIT_CRITICAL(&s_counter_mux);
+
+    esp_err_t err = gpio_set_intr_type((gpio_num_t)gpio, rising ? GPIO_INTR_POSEDGE : GPIO_INTR_NEGEDGE);
+    if (err != ESP_OK) {
+        return err;
+    }
+    err = gpio_isr_handler_add((gpio_num_t)gpio, gpio_edge_counter_isr, (void *)(uintptr_t)channel);
+    if (err != ESP_OK) {
+        (void)gpio_set_intr_type((gpio_num_t)gpio, GPIO_INTR_DISABLE);
+        return err;
+    }
+    return gpio_intr_enable((gpio_num_t)gpio);
+}
+
+uint32_t gpio_edge_take_count(uint8_t channel)
+{
+    uint32_t pending;
+
+    if (channel >= GPIO_EDGE_MAX_COUNTERS) {
+        return 0;
+    }
+    portENTER_CRITICAL(&s_counter_mux);
+    pending = s_counters[channel].pending;
+    s_counters[channel].pending = 0;
+    portEXIT_CRITICAL(&s_counter_mux);
+    return pending;
+}
+
+void gpio_edge_remove(int gpio)
+{
+    if (!s_service_installed || gpio < 0) {
+        return;
+    }
+    (void)gpio_intr_disable((gpio_num_t)gpio);
+    (void)gpio_isr_handler_remove((gpio_num_t)gpio);
+    (void)gpio_set_intr_type((gpio_num_t)gpio, GPIO_INTR_DISABLE);
+}
+
+bool gpio_edge_pop(gpio_edge_event_t *out)
+{
+    uint32_t tail = s_tail;
+
+    if (tail == __atomic_load_n(&s_head, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+    *out = s_ring[tail & (GPIO_EDGE_RING_LEN - 1)];
+    __atomic_store_n(&s_tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+uint32_t gpio_edge_dropped(void)
+{
+    return __atomic_load_n(&s_dropped, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "app_config.h"
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Edge capture for GPIO inputs. The ISR timestamps every edge into a single-producer ring and wakes the
+// consumer task; the consumer drains the ring with gpio_edge_pop and does all filtering itself.
+
+// One counter channel per possible input.
+#define GPIO_EDGE_MAX_COUNTERS APP_MODULES_MAX_INPUTS
+
+typedef struct {
+    int64_t time_us;
+    uint8_t source;
+    uint8_t level;
+} gpio_edge_event_t;
+
+// Installs the GPIO ISR service on first use. notify_task is woken (task notification) on every edge.
+esp_err_t gpio_edge_start(TaskHandle_t notify_task);
+// Routes both edges of gpio to the ring, tagged with source. The pin must already be configured as input.
+esp_err_t gpio_edge_add(int gpio, uint8_t source);
+// Counts active edges (rising or falling) of gpio on channel inside the ISR, without queueing events.
+// Edges closer than min_interval_us to the previous counted one are treated as contact bounce.
+esp_err_t gpio_edge_add_counter(int gpio, uint8_t channel, bool rising, uint32_t min_interval_us);
+// Returns the pulses counted on channel since the previous call.
+uint32_t gpio_edge_take_count(uint8_t channel);
+void gpio_edge_remove(int gpio);
+bool gpio_edge_pop(gpio_edge_event_t *out);
+// Number of edges dropped because the ring was full; the consumer should resample levels when it grows.
+uint32_t gpio_edge_dropped(void);
+
+#ifdef __cplusplus
+}
+#endif
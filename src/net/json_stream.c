@@ -0,0 +1,234 @@
+#include "net/json_stream.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static void flush_buf(json_stream_t *js)
+{
+    if (js->err == ESP_OK && js->len > 0) {
+        js->err = httpd_resp_send_chunk(js->req, js->buf, (ssize_t)js->len);
+    }
+    js->len = 0;
+}
+
+static void put_raw(json_stream_t *js, const char *data, size_t len)
+{
+    while (len > 0 && js->err == ESP_OK) {
+        size_t room = sizeof(js->buf) - js->len;
+        size_t n = len < room ? len : room;
+        memcpy(js->buf + js->len, data, n);
+        js->len += n;
+        data += n;
+        len -= n;
+        if (js->len == sizeof(js->buf)) {
+            flush_buf(js);
+        }
+    }
+}
+
+static void put_str(json_stream_t *js, const char *text)
+{
+    put_raw(js, text, strlen(text));
+}
+
+static void put_escaped(json_stream_t *js, const char *text)
+{
+    const char *run = text;
+
+    put_raw(js, "\"", 1);
+    for (const char *p = text; *p; ++p) {
+        unsigned char c = (unsigned char)*p;
+        char esc[8];
+
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        put_raw(js, run, (size_t)(p - run));
+        run = p + 1;
+        switch (c) {
+            case '"': put_raw(js, "\\\"", 2); break;
+            case '\\': put_raw(js, "\\\\", 2); break;
+            case '\b': put_raw(js, "\\b", 2); break;
+            case '\f': put_raw(js, "\\f", 2); break;
+            case '\n': put_raw(js, "\\n", 2); break;
+            case '\r': put_raw(js, "\\r", 2); break;
+            case '\t': put_raw(js, "\\t", 2); break;
+            default:
+                snprintf(esc, sizeof(esc), "\\u%04x", c);
+                put_raw(js, esc, 6);
+                break;
+        }
+    }
+    put_str(js, run);
+    put_raw(js, "\"", 1);
+}
+
+// Writes the separator and, inside an object, the key. Returns false once the stream has failed.
+static bool begin_value(json_stream_t *js, const char *key)
+{
+    if (js->err != ESP_OK) {
+        return false;
+    }
+    if (js->depth > 0) {
+        if (js->has_items[js->depth - 1]) {
+            put_raw(js, ",", 1);
+        }
+        js->has_items[js->depth - 1] = true;
+        if (js->is_object[js->depth - 1]) {
+            put_escaped(js, key ? key : "");
+            put_raw(js, ":", 1);
+        }
+    }
+    return js->err == ESP_OK;
+}
+
+static void begin_container(json_stream_t *js, const char *key, bool is_object)
+{
+    if (!begin_value(js, key)) {
+        return;
+    }
+    if (js->depth >= JSON_STREAM_MAX_DEPTH) {
+        js->err = ESP_ERR_INVALID_SIZE;
+        return;
+    }
+    js->has_items[js->depth] = false;
+    js->is_object[js->depth] = is_object;
+    js->depth++;
+    put_raw(js, is_object ? "{" : "[", 1);
+}
+
+static void end_container(json_stream_t *js, bool is_object)
+{
+    if (js->err != ESP_OK) {
+        return;
+    }
+    if (js->depth == 0 || js->is_object[js->depth - 1] != is_object) {
+        js->err = ESP_ERR_INVALID_STATE;
+        return;
+    }
+    js->depth--;
+    put_raw(js, is_object ? "}" : "]", 1);
+}
+
+void json_stream_init(json_stream_t *js, httpd_req_t *req)
+{
+    memset(js, 0, sizeof(*js));
+    js->req = req;
+    js->err = ESP_OK;
+}
+
+void json_stream_begin_object(json_stream_t *js, const char *key)
+{
+    begin_container(js, key, true);
+}
+
+void json_stream_end_object(json_stream_t *js)
+{
+    end_container(js, true);
+}
+
+void json_stream_begin_array(json_stream_t *js, const char *key)
+{
+    begin_container(js, key, false);
+}
+
+void json_stream_end_array(json_stream_t *js)
+{
+    end_container(js, false);
+}
+
+void json_stream_string(json_stream_t *js, const char *key, const char *value)
+{
+    if (begin_value(js, key)) {
+        put_escaped(js, value ? value : "");
+    }
+}
+
+void json_stream_int(json_stream_t *js, const char *key, int value)
+{
+    char tmp[16];
+
+    if (begin_value(js, key)) {
+        put_raw(js, tmp, (size_t)snprintf(tmp, sizeof(tmp), "%d", value));
+    }
+}
+
+void json_stream_number(json_stream_t *js, const char *key, double value)
+{
+    char tmp[32];
+    double check = 0.0;
+
+    if (!begin_value(js, key)) {
+        return;
+    }
+    // Same formatting rules as cJSON_PrintUnformatted so streamed and printed output match.
+    if (isnan(value) || isinf(value)) {
+        put_str(js, "null");
+    } else if (fabs(value) < 2147483648.0 && value == (double)(int)value) {
+        put_raw(js, tmp, (size_t)snprintf(tmp, sizeof(tmp), "%d", (int)value));
+    } else {
+        snprintf(tmp, sizeof(tmp), "%1.15g", value);
+        if (sscanf(tmp, "%lg", &check) != 1 || check != value) {
+            snprintf(tmp, sizeof(tmp), "%1.17g", value);
+        }
+        put_str(js, tmp);
+    }
+}
+
+void json_stream_bool(json_stream_t *js, const char *key, bool value)
+{
+    if (begin_value(js, key)) {
+        put_str(js, value ? "true" : "false");
+    }
+}
+
+void json_stream_null(json_stream_t *js, const char *key)
+{
+    if (begin_value(js, key)) {
+        put_str(js, "null");
+    }
+}
+
+void json_stream_item(json_stream_t *js, const char *key, const cJSON *item)
+{
+    const cJSON *child;
+
+    if (!item || cJSON_IsNull(item)) {
+        json_stream_null(js, key);
+    } else if (cJSON_IsObject(item)) {
+        json_stream_begin_object(js, key);
+        for (child = item->child; child && js->err == ESP_OK; child = child->next) {
+            json_stream_item(js, child->string, child);
+        }
+        json_stream_end_object(js);
+    } else if (cJSON_IsArray(item)) {
+        json_stream_begin_array(js, key);
+        for (child = item->child; child && js->err == ESP_OK; child = child->next) {
+            json_stream_item(js, NULL, child);
+        }
+        json_stream_end_array(js);
+    } else if (cJSON_IsString(item)) {
+        json_stream_string(js, key, item->valuestring);
+    } else if (cJSON_IsNumber(item)) {
+        json_stream_number(js, key, item->valuedouble);
+    } else if (cJSON_IsBool(item)) {
+        json_stream_bool(js, key, cJSON_IsTrue(item));
+    } else if (cJSON_IsRaw(item) && item->valuestring) {
+        if (begin_value(js, key)) {
+            put_str(js, item->valuestring);
+        }
+    } else {
+        json_stream_null(js, key);
+    }
+}
+
+esp_err_t json_stream_finish(json_stream_t *js)
+{
+    if (js->err == ESP_OK && js->depth != 0) {
+        js->err = ESP_ERR_INVALID_STATE;
+    }
+    flush_buf(js);
+    esp_err_t end_err = httpd_resp_send_chunk(js->req, NULL, 0);
+    return js->err != ESP_OK ? js->err : end_err;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "cJSON.h"
+#include "esp_err.h"
+#include "esp_http_server.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define JSON_STREAM_BUF_SIZE 512
+#define JSON_STREAM_MAX_DEPTH 16
+
+// Emits JSON straight into a chunked HTTP response through a fixed buffer. Keys are ignored inside
+// arrays and at the top level. The first failure sticks and is returned by json_stream_finish().
+typedef struct {
+    httpd_req_t *req;
+    esp_err_t err;
+    size_t len;
+    int depth;
+    bool has_items[JSON_STREAM_MAX_DEPTH];
+    bool is_object[JSON_STREAM_MAX_DEPTH];
+    char buf[JSON_STREAM_BUF_SIZE];
+} json_stream_t;
+
+void json_stream_init(json_stream_t *js, httpd_req_t *req);
+void json_stream_begin_object(json_stream_t *js, const char *key);
+void json_stream_end_object(json_stream_t *js);
+void json_stream_begin_array(json_stream_t *js, const char *key);
+void json_stream_end_array(json_stream_t *js);
+void json_stream_string(json_stream_t *js, const char *key, const char *value);
+void json_stream_int(json_stream_t *js, const char *key, int value);
+void json_stream_number(json_stream_t *js, const char *key, double value);
+void json_stream_bool(json_stream_t *js, const char *key, bool value);
+void json_stream_null(json_stream_t *js, const char *key);
+void json_stream_item(json_stream_t *js, const char *key, const cJSON *item);
+esp_err_t json_stream_finish(json_stream_t *js);
+
+#ifdef __cplusplus
+}
+#endif
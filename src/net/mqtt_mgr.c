@@ -1,6 +1,8 @@
 #include "net/mqtt_mgr.h"
 
 #include <ctype.h>
+#include <inttypes.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -12,28 +14,53 @@
 #include "freertos/task.h"
 #include "mqtt_client.h"
 
+#include "app_config.h"
+#include "core/hash_util.h"
 #include "core/modules.h"
+#include "core/perf_probe.h"
 #include "core/system_log.h"
 
 static const char *TAG = "mqtt_mgr";
 
-#define MQTT_MAX_ENTITIES 24
+#define MQTT_MAX_ENTITIES APP_MQTT_MAX_ENTITIES
+// Open-addressing index of command entities by id, kept at most half full.
+#define MQTT_COMMAND_INDEX_SLOTS (2 * MQTT_MAX_ENTITIES)
 #define MQTT_STATE_PAYLOAD_MAX 256
+// Per-entity share of the aggregated device state document ("id":value).
+#define MQTT_DEVICE_STATE_ENTRY_MAX 128
+#define MQTT_STATE_WINDOW_MS_DEFAULT 200
+#define MQTT_TOPIC_MAX 192
+// Room for a full discovery config in one frame; the outbox cap keeps a stalled broker from draining heap.
+#define MQTT_BUFFER_SIZE 2048
+#define MQTT_OUTBOX_LIMIT (16 * 1024)
 #define MQTT_OUTPUT_THROTTLE_MS 250
-#define MQTT_FLUSH_TASK_PERIOD_MS 100
+#define MQTT_SENSOR_HEARTBEAT_MS (300 * 1000)
+#define MQTT_WORKER_PERIOD_MS 100
+// Publish deadlines live on a wheel ticking with the worker; one lap covers 3.2 s, longer timers wrap.
+#define MQTT_WHEEL_SLOTS 32
+// Connect-time sync sends at most this many messages per worker tick and waits while the outbox is deep.
+#define MQTT_SYNC_BATCH 4
+#define MQTT_SYNC_OUTBOX_HIGH_WATER 4096
 #define MQTT_UNIT_CELSIUS "\xC2\xB0" "C"
+#define MQTT_BUTTON_EVENT_BATCH 8
+// Gestures older than this (e.g. queued while the broker was down) are dropped instead of replayed.
+#define MQTT_BUTTON_EVENT_MAX_AGE_US 5000000LL
 
 typedef enum {
     ENTITY_KIND_NONE = 0,
     ENTITY_KIND_OUTPUT,
     ENTITY_KIND_INPUT,
     ENTITY_KIND_SENSOR,
+    ENTITY_KIND_BUTTON,
 } entity_kind_t;
 
 typedef struct {
     bool enabled;
     bool discovery;
     bool retain;
+    // Publish switch/cover/number/input/sensor states as one JSON document on <prefix>/state.
+    bool json_state;
+    int state_window_ms;
     int port;
     char host[96];
     char uri[128];
@@ -46,11 +73,67 @@ typedef struct {
     char node_id[40];
 } mqtt_cfg_t;
 
+typedef enum {
+    SENSOR_METRIC_TEMPERATURE = 0,
+    SENSOR_METRIC_HUMIDITY,
+    SENSOR_METRIC_PRESSURE,
+    SENSOR_METRIC_COUNT,
+} sensor_metric_t;
+
+static const char *const s_sensor_metric_names[SENSOR_METRIC_COUNT] = {
+    [SENSOR_METRIC_TEMPERATURE] = "temperature_c",
+    [SENSOR_METRIC_HUMIDITY] = "humidity_pct",
+    [SENSOR_METRIC_PRESSURE] = "pressure_hpa",
+};
+
+// Roughly the resolution of the supported sensors, so readout noise does not produce retained publishes.
+static const float s_sensor_default_deadband[SENSOR_METRIC_COUNT] = {
+    [SENSOR_METRIC_TEMPERATURE] = 0.1f,
+    [SENSOR_METRIC_HUMIDITY] = 0.5f,
+    [SENSOR_METRIC_PRESSURE] = 0.2f,
+};
+
+// mqtt_publish block of one config item; negative fields keep the built-in default.
+typedef struct {
+    char id[24];
+    bool ds18b20_bus;
+    int throttle_ms;
+    int heartbeat_ms;
+    float deadband[SENSOR_METRIC_COUNT];
+    float deadband_pct;
+} publish_override_t;
+
+typedef enum {
+    ENTITY_TOPIC_STATE = 0,
+    ENTITY_TOPIC_COMMAND,
+    ENTITY_TOPIC_SET_POSITION,
+    ENTITY_TOPIC_CONFIG,
+} entity_topic_t;
+
+// Topics are not stored per entity; they are assembled from the shared prefix, the entity id and
+// one of these suffixes when needed.
+static const char *const s_entity_topic_suffix[] = {
+    [ENTITY_TOPIC_STATE] = "state",
+    [ENTITY_TOPIC_COMMAND] = "set",
+    [ENTITY_TOPIC_SET_POSITION] = "set_position",
+    [ENTITY_TOPIC_CONFIG] = "config",
+};
+
+// Subscriptions and discovery run from the worker task in paced batches, not in the event handler.
+typedef enum {
+    MQTT_SYNC_IDLE = 0,
+    MQTT_SYNC_ANNOUNCE,
+    MQTT_SYNC_SUBSCRIBE,
+    MQTT_SYNC_DISCOVERY,
+    MQTT_SYNC_STATES,
+} mqtt_sync_phase_t;
+
 typedef struct {
     bool used;
     entity_kind_t kind;
     bool supports_command;
-    char id[24];
+    // Config ids are at most 23 characters; derived ids add a suffix of up to 12 ("_temperature").
+    char id[40];
     char name[48];
     char type[16];
     char role[24];
@@ -58,26 +141,73 @@ typedef struct {
     char output_mode[24];
     char source_id[40];
     char metric[24];
-    char unique_id[64];
-    char command_topic[160];
-    char set_position_topic[160];
-    char state_topic[160];
-    char config_topic[192];
+    bool has_position_topic;
     bool has_last_published_payload;
+    // Throttled publish waiting for the flush task, which rebuilds the payload from fresh status.
     bool pending_publish;
     int64_t last_publish_us;
-    char last_published_payload[MQTT_STATE_PAYLOAD_MAX];
-    char pending_payload[MQTT_STATE_PAYLOAD_MAX];
+    uint32_t last_payload_hash;
+    // Publish policy resolved in add_entity; deadbands apply to sensors only.
+    int throttle_ms;
+    int heartbeat_ms;
+    float deadband;
+    float deadband_pct;
+    bool has_last_value;
+    float last_value;
+    // One wheel deadline per entity: the end of the throttle window while a publish is pending,
+    // otherwise the heartbeat.
+    bool wheel_armed;
+    uint32_t wheel_due_tick;
+    int16_t wheel_next;
+    // Discovery config hash the broker acknowledged, and the one in flight under discovery_msg_id.
+    // Guarded by s_sync_mux.
+    uint32_t discovery_hash;
+    uint32_t discovery_pending_hash;
+    int discovery_msg_id;
+    int status_index; // bit in modules_changes_t, -1 until resolved against a snapshot
 } mqtt_entity_t;
 
 static mqtt_cfg_t s_cfg = {0};
 static mqtt_entity_t s_entities[MQTT_MAX_ENTITIES] = {0};
 static int s_entity_count = 0;
+// Slot holds entity index + 1, 0 when empty.
+static uint16_t s_command_index[MQTT_COMMAND_INDEX_SLOTS] = {0};
+static publish_override_t s_publish_overrides[MQTT_MAX_ENTITIES];
+static int s_publish_override_count = 0;
+// Slot heads are entity indexes, -1 when empty; guarded by s_state_lock.
+static int16_t s_wheel_head[MQTT_WHEEL_SLOTS];
+static uint32_t s_wheel_tick = 0;
 static esp_mqtt_client_handle_t s_client = NULL;
 static bool s_connected = false;
 static char s_availability_topic[160] = {0};
+static char s_device_state_topic[160] = {0};
+// Aggregated state document waiting for its coalescing window; guarded by s_state_lock.
+static bool s_device_state_dirty = false;
+static int64_t s_device_state_due_us = 0;
+static bool s_device_state_published = false;
+static uint32_t s_device_state_hash = 0;
 static SemaphoreHandle_t s_state_lock = NULL;
-static TaskHandle_t s_flush_task = NULL;
+static TaskHandle_t s_worker_task = NULL;
+static portMUX_TYPE s_sync_mux = portMUX_INITIALIZER_UNLOCKED;
+static mqtt_sync_phase_t s_sync_request = MQTT_SYNC_IDLE;
+// Worker-owned progress of the current sync.
+static mqtt_sync_phase_t s_sync_phase = MQTT_SYNC_IDLE;
+static int s_sync_next = 0;
+// Reused for every state publish; guarded by s_state_lock.
+static modules_output_status_t s_status_outputs[MODULES_STATUS_MAX_OUTPUTS];
+static modules_input_status_t s_status_inputs[MODULES_STATUS_MAX_INPUTS];
+static modules_sensor_status_t s_status_sensors[MODULES_STATUS_MAX_SENSORS];
+static modules_status_snapshot_t s_status = {
+    .version = MODULES_STATUS_VERSION,
+    .outputs = s_status_outputs,
+    .output_capacity = MODULES_STATUS_MAX_OUTPUTS,
+    .inputs = s_status_inputs,
+    .input_capacity = MODULES_STATUS_MAX_INPUTS,
+    .sensors = s_status_sensors,
+    .sensor_capacity = MODULES_STATUS_MAX_SENSORS,
+};
+static uint32_t s_change_seq = 0;
+static uint32_t s_button_event_seq = 0;
 
 static const cJSON *jobj(const cJSON *obj, const char *key);
 static const char *jstr(const cJSON *obj, const char *key, const char *def);
@@ -86,14 +216,14 @@ static int jint(const cJSON *obj, const char *key, int def);
 static void modules_runtime_changed_cb(void *ctx);
 static esp_err_t publish_all_states(void);
 static esp_err_t publish_state_snapshot(bool force_all, bool allow_throttle);
-static esp_err_t build_entity_state_payload(const mqtt_entity_t *entity, const cJSON *status,
-                                            char *payload, size_t payload_len);
-static int entity_publish_throttle_ms(const mqtt_entity_t *entity);
+static esp_err_t publish_states_locked(const modules_changes_t *changes, bool force_all, bool allow_throttle);
+static esp_err_t load_status_snapshot_locked(void);
+static esp_err_t build_entity_state_payload(const mqtt_entity_t *entity, char *payload, size_t payload_len);
 static esp_err_t flush_pending_entity_updates(void);
-static esp_err_t ensure_flush_task(void);
+static esp_err_t publish_device_state_locked(bool force);
+static esp_err_t ensure_worker_task(void);
+static esp_err_t publish_discovery_entity(mqtt_entity_t *entity, bool *published);
 static esp_err_t apply_number_command(const mqtt_entity_t *entity, const char *data, int len);
-static bool topic_matches(const char *expected, const char *topic, int topic_len);
-static bool entity_uses_position_topic(const mqtt_entity_t *entity, const char *topic, int topic_len);
 static esp_err_t apply_cover_command(const mqtt_entity_t *entity, const char *data, int len,
                                      bool position_topic);
 static const char *normalize_output_component_override(const char *value);
@@ -102,7 +232,7 @@ static const char *resolve_output_component(const cJSON *item);
 static bool output_type_supports_cover(const char *type);
 static esp_err_t clear_discovery_topic(const char *component, const char *id);
 static bool entity_exists(entity_kind_t kind, const char *id);
-static bool sync_entities_from_status(const cJSON *status);
+static bool sync_entities_from_status_locked(void);
 
 static const cJSON *jobj(const cJSON *obj, const char *key)
 {
@@ -217,19 +347,6 @@ static void copy_str(char *dst, size_t len, const char *src)
     snprintf(dst, len, "%s", src ? src : "");
 }
 
-static bool topic_matches(const char *expected, const char *topic, int topic_len)
-{
-    if (!expected || !expected[0] || !topic || topic_len <= 0) {
-        return false;
-    }
-    return (int)strlen(expected) == topic_len && strncmp(expected, topic, (size_t)topic_len) == 0;
-}
-
-static bool entity_uses_position_topic(const mqtt_entity_t *entity, const char *topic, int topic_len)
-{
-    return entity && topic_matches(entity->set_position_topic, topic, topic_len);
-}
-
 static bool str_ieq(const char *a, const char *b)
 {
     if (!a || !b) {
@@ -254,41 +371,308 @@ static esp_err_t publish_raw(const char *topic, const char *payload, int qos, bo
     return (msg_id >= 0) ? ESP_OK : ESP_FAIL;
 }
 
+static const char *format_discovery_topic(char *topic, size_t topic_len, const char *component, const char *id)
+{
+    snprintf(topic, topic_len, "%s/%s/%s/%s/%s", s_cfg.discovery_prefix, component, s_cfg.node_id, id,
+             s_entity_topic_suffix[ENTITY_TOPIC_CONFIG]);
+    return topic;
+}
+
+// Lights use Home Assistant's JSON schema, which parses its own state topic and has no value_template,
+// so they keep per-entity state topics in aggregated mode.
+static bool entity_in_device_state(const mqtt_entity_t *entity)
+{
+    if (!s_cfg.json_state || entity->kind == ENTITY_KIND_BUTTON) {
+        return false;
+    }
+    if (entity->kind != ENTITY_KIND_OUTPUT) {
+        return true;
+    }
+    return strcmp(entity->component, "switch") == 0 || strcmp(entity->component, "cover") == 0 ||
+           strcmp(entity->component, "number") == 0;
+}
+
+static const char *entity_topic(const mqtt_entity_t *entity, entity_topic_t which, char *topic, size_t topic_len)
+{
+    if (which == ENTITY_TOPIC_CONFIG) {
+        return format_discovery_topic(topic, topic_len, entity->component, entity->id);
+    }
+    if (which == ENTITY_TOPIC_STATE && entity_in_device_state(entity)) {
+        snprintf(topic, topic_len, "%s", s_device_state_topic);
+        return topic;
+    }
+    snprintf(topic, topic_len, "%s/%s/%s", s_cfg.topic_prefix, entity->id, s_entity_topic_suffix[which]);
+    return topic;
+}
+
 static esp_err_t clear_discovery_topic(const char *component, const char *id)
 {
-    char topic[192];
+    char topic[MQTT_TOPIC_MAX];
 
     if (!component || !component[0] || !id || !id[0]) {
         return ESP_ERR_INVALID_ARG;
     }
 
-    snprintf(topic, sizeof(topic), "%s/%s/%s/%s/config",
-             s_cfg.discovery_prefix, component, s_cfg.node_id, id);
-    return publish_raw(topic, "", 1, true);
+    return publish_raw(format_discovery_topic(topic, sizeof(topic), component, id), "", 1, true);
 }
 
-static int entity_publish_throttle_ms(const mqtt_entity_t *entity)
+static void subscribe_entity_commands(const mqtt_entity_t *entity)
 {
-    if (!entity) {
-        return 0;
+    char topic[MQTT_TOPIC_MAX];
+
+    if (!entity->used || !entity->supports_command) {
+        return;
     }
-    if (strcmp(entity->component, "light") == 0 || strcmp(entity->component, "number") == 0) {
-        return MQTT_OUTPUT_THROTTLE_MS;
+    (void)esp_mqtt_client_subscribe(s_client, entity_topic(entity, ENTITY_TOPIC_COMMAND, topic, sizeof(topic)), 1);
+    if (entity->has_position_topic) {
+        (void)esp_mqtt_client_subscribe(s_client,
+                                        entity_topic(entity, ENTITY_TOPIC_SET_POSITION, topic, sizeof(topic)), 1);
+    }
+}
+
+static uint32_t payload_hash(const char *payload)
+{
+    return hash_fnv1a(HASH_FNV1A_SEED, payload, strlen(payload));
+}
+
+// field selects a member of an object-valued state (cover), NULL for the whole value.
+static const char *entity_value_template(const mqtt_entity_t *entity, const char *field, char *buf, size_t len)
+{
+    if (field && !entity_in_device_state(entity)) {
+        snprintf(buf, len, "{{ value_json.%s }}", field);
+    } else if (field) {
+        snprintf(buf, len, "{{ value_json['%s'].%s }}", entity->id, field);
+    } else {
+        snprintf(buf, len, "{{ value_json['%s'] }}", entity->id);
+    }
+    return buf;
+}
+
+// The first change opens the window; later ones ride along, so latency stays bounded by the window.
+static void schedule_device_state_locked(void)
+{
+    if (!s_device_state_dirty) {
+        s_device_state_due_us = esp_timer_get_time() + (int64_t)s_cfg.state_window_ms * 1000LL;
+        s_device_state_dirty = true;
+    }
+}
+
+static TickType_t worker_wait_ticks(void)
+{
+    TickType_t wait = pdMS_TO_TICKS(MQTT_WORKER_PERIOD_MS);
+
+    xSemaphoreTake(s_state_lock, portMAX_DELAY);
+    if (s_device_state_dirty && s_connected) {
+        int64_t left_ms = (s_device_state_due_us - esp_timer_get_time()) / 1000LL;
+        if (left_ms < 0) {
+            left_ms = 0;
+        }
+        if (pdMS_TO_TICKS(left_ms) < wait) {
+            wait = pdMS_TO_TICKS(left_ms);
+        }
+    }
+    xSemaphoreGive(s_state_lock);
+    return wait;
+}
+
+static uint32_t wheel_tick_at(int64_t us)
+{
+    return (uint32_t)(us / ((int64_t)MQTT_WORKER_PERIOD_MS * 1000LL));
+}
+
+static void wheel_reset_locked(void)
+{
+    memset(s_wheel_head, 0xFF, sizeof(s_wheel_head));
+    s_wheel_tick = wheel_tick_at(esp_timer_get_time());
+}
+
+static void wheel_unlink_locked(int index)
+{
+    mqtt_entity_t *entity = &s_entities[index];
+
+    if (!entity->wheel_armed) {
+        return;
+    }
+    int16_t *link = &s_wheel_head[entity->wheel_due_tick % MQTT_WHEEL_SLOTS];
+    while (*link >= 0 && *link != index) {
+        link = &s_entities[*link].wheel_next;
+    }
+    if (*link == index) {
+        *link = entity->wheel_next;
+    }
+    entity->wheel_armed = false;
+}
+
+static void wheel_rearm_locked(int index)
+{
+    mqtt_entity_t *entity = &s_entities[index];
+    int64_t due_us;
+
+    wheel_unlink_locked(index);
+    if (!entity->used) {
+        return;
+    }
+    if (entity->pending_publish) {
+        due_us = entity->last_publish_us + (int64_t)entity->throttle_ms * 1000LL;
+    } else if (entity->heartbeat_ms > 0 && entity->has_last_published_payload) {
+        due_us = entity->last_publish_us + (int64_t)entity->heartbeat_ms * 1000LL;
+    } else {
+        return;
+    }
+
+    // Round up so an entity never fires before its deadline, and never into an already swept tick.
+    uint32_t tick = wheel_tick_at(due_us + (int64_t)MQTT_WORKER_PERIOD_MS * 1000LL - 1);
+    if ((int32_t)(tick - s_wheel_tick) <= 0) {
+        tick = s_wheel_tick + 1;
     }
-    return 0;
+    entity->wheel_due_tick = tick;
+    entity->wheel_next = s_wheel_head[tick % MQTT_WHEEL_SLOTS];
+    s_wheel_head[tick % MQTT_WHEEL_SLOTS] = (int16_t)index;
+    entity->wheel_armed = true;
 }
 
-static void mqtt_flush_task(void *arg)
+// Sweeps the slots passed since the last call and unlinks entities whose deadline is due. Entries in a
+// swept slot that belong to a later lap stay put.
+static int wheel_expire_locked(int64_t now_us, int *expired, int capacity)
+{
+    uint32_t now_tick = wheel_tick_at(now_us);
+    uint32_t steps = now_tick - s_wheel_tick;
+    int count = 0;
+
+    if (steps > MQTT_WHEEL_SLOTS) {
+        steps = MQTT_WHEEL_SLOTS;
+    }
+    for (uint32_t k = 0; k < steps; ++k) {
+        int16_t *link = &s_wheel_head[(now_tick - k) % MQTT_WHEEL_SLOTS];
+        while (*link >= 0) {
+            mqtt_entity_t *entity = &s_entities[*link];
+            if ((int32_t)(entity->wheel_due_tick - now_tick) <= 0 && count < capacity) {
+                expired[count++] = *link;
+                *link = entity->wheel_next;
+                entity->wheel_armed = false;
+            } else {
+                link = &entity->wheel_next;
+            }
+        }
+    }
+    s_wheel_tick = now_tick;
+    return count;
+}
+
+// A reconnect restarts from ANNOUNCE; discovery configs the broker already acknowledged are skipped by
+// hash, so an interrupted sync effectively resumes where it stopped.
+static void request_sync(mqtt_sync_phase_t phase)
+{
+    portENTER_CRITICAL(&s_sync_mux);
+    if (s_sync_request == MQTT_SYNC_IDLE || phase < s_sync_request) {
+        s_sync_request = phase;
+    }
+    if (phase == MQTT_SYNC_ANNOUNCE) {
+        // Unacknowledged configs may have been dropped with the old session; send them again.
+        for (int i = 0; i < s_entity_count; ++i) {
+            s_entities[i].discovery_msg_id = 0;
+        }
+    }
+    portEXIT_CRITICAL(&s_sync_mux);
+    if (s_worker_task) {
+        xTaskNotifyGive(s_worker_task);
+    }
+}
+
+static void ack_discovery_publish(int msg_id)
+{
+    if (msg_id <= 0) {
+        return;
+    }
+    portENTER_CRITICAL(&s_sync_mux);
+    for (int i = 0; i < s_entity_count; ++i) {
+        if (s_entities[i].discovery_msg_id == msg_id) {
+            s_entities[i].discovery_hash = s_entities[i].discovery_pending_hash;
+            s_entities[i].discovery_msg_id = 0;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&s_sync_mux);
+}
+
+static bool sync_outbox_full(void)
+{
+    return s_client && esp_mqtt_client_get_outbox_size(s_client) > MQTT_SYNC_OUTBOX_HIGH_WATER;
+}
+
+static void service_sync(void)
+{
+    int budget = MQTT_SYNC_BATCH;
+    bool publish_states = false;
+
+    portENTER_CRITICAL(&s_sync_mux);
+    if (s_sync_request != MQTT_SYNC_IDLE) {
+        s_sync_phase = s_sync_request;
+        s_sync_next = 0;
+        s_sync_request = MQTT_SYNC_IDLE;
+    }
+    portEXIT_CRITICAL(&s_sync_mux);
+
+    if (s_sync_phase == MQTT_SYNC_IDLE || !s_connected) {
+        return;
+    }
+
+    xSemaphoreTake(s_state_lock, portMAX_DELAY);
+    while (budget > 0 && s_sync_phase != MQTT_SYNC_IDLE && s_connected && !sync_outbox_full()) {
+        if (s_sync_phase == MQTT_SYNC_ANNOUNCE) {
+            (void)publish_raw(s_availability_topic, "online", 1, true);
+            budget--;
+            s_sync_phase = MQTT_SYNC_SUBSCRIBE;
+            s_sync_next = 0;
+        } else if (s_sync_phase == MQTT_SYNC_SUBSCRIBE) {
+            if (s_sync_next >= s_entity_count) {
+                s_sync_phase = MQTT_SYNC_DISCOVERY;
+                s_sync_next = 0;
+                continue;
+            }
+            if (s_entities[s_sync_next].supports_command) {
+                subscribe_entity_commands(&s_entities[s_sync_next]);
+                budget--;
+            }
+            s_sync_next++;
+        } else if (s_sync_phase == MQTT_SYNC_DISCOVERY) {
+            bool published = false;
+            if (s_sync_next >= s_entity_count) {
+                s_sync_phase = MQTT_SYNC_STATES;
+                continue;
+            }
+            if (publish_discovery_entity(&s_entities[s_sync_next], &published) != ESP_OK) {
+                break;
+            }
+            if (published) {
+                budget--;
+            }
+            s_sync_next++;
+        } else {
+            s_sync_phase = MQTT_SYNC_IDLE;
+            publish_states = true;
+        }
+    }
+    xSemaphoreGive(s_state_lock);
+
+    if (publish_states) {
+        ESP_LOGI(TAG, "broker sync complete for %d entities", s_entity_count);
+        (void)publish_all_states();
+    }
+}
+
+static void mqtt_worker_task(void *arg)
 {
     (void)arg;
 
     while (1) {
-        (void)ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(MQTT_FLUSH_TASK_PERIOD_MS));
+        (void)ulTaskNotifyTake(pdTRUE, worker_wait_ticks());
+        service_sync();
         (void)flush_pending_entity_updates();
     }
 }
 
-static esp_err_t ensure_flush_task(void)
+static esp_err_t ensure_worker_task(void)
 {
     if (!s_state_lock) {
         s_state_lock = xSemaphoreCreateMutex();
@@ -297,8 +681,8 @@ static esp_err_t ensure_flush_task(void)
         }
     }
 
-    if (!s_flush_task) {
-        if (xTaskCreate(mqtt_flush_task, "mqtt_flush", 4096, NULL, 4, &s_flush_task) != pdPASS) {
+    if (!s_worker_task) {
+        if (xTaskCreate(mqtt_worker_task, "mqtt_worker", 4096, NULL, 4, &s_worker_task) != pdPASS) {
             return ESP_FAIL;
         }
     }
@@ -306,15 +690,56 @@ static esp_err_t ensure_flush_task(void)
     return ESP_OK;
 }
 
-static mqtt_entity_t *find_entity_by_topic(const char *topic, int topic_len)
+static uint32_t command_index_slot(const char *id, size_t id_len)
 {
-    for (int i = 0; i < s_entity_count; ++i) {
-        mqtt_entity_t *entity = &s_entities[i];
-        if (!entity->used || !entity->supports_command) {
-            continue;
+    return hash_fnv1a(HASH_FNV1A_SEED, id, id_len) % MQTT_COMMAND_INDEX_SLOTS;
+}
+
+// Duplicate ids keep the first entity, matching the old linear scan.
+static void command_index_insert(int entity)
+{
+    const char *id = s_entities[entity].id;
+    for (uint32_t slot = command_index_slot(id, strlen(id));; slot = (slot + 1) % MQTT_COMMAND_INDEX_SLOTS) {
+        if (s_command_index[slot] == 0) {
+            s_command_index[slot] = (uint16_t)(entity + 1);
+            return;
         }
-        if (topic_matches(entity->command_topic, topic, topic_len) ||
-            topic_matches(entity->set_position_topic, topic, topic_len)) {
+    }
+}
+
+// Command topics are <topic_prefix>/<id>/set and, for covers, <topic_prefix>/<id>/set_position. The id
+// is cut out of the topic and resolved through s_command_index instead of comparing every entity.
+static mqtt_entity_t *find_entity_by_topic(const char *topic, int topic_len, bool *position_topic)
+{
+    size_t prefix_len = strlen(s_cfg.topic_prefix);
+    size_t len = topic_len > 0 ? (size_t)topic_len : 0;
+
+    *position_topic = false;
+    if (!topic || len <= prefix_len + 1 || strncmp(topic, s_cfg.topic_prefix, prefix_len) != 0 ||
+        topic[prefix_len] != '/') {
+        return NULL;
+    }
+    const char *id = topic + prefix_len + 1;
+    const char *end = topic + len;
+    const char *slash = memchr(id, '/', (size_t)(end - id));
+    if (!slash || slash == id) {
+        return NULL;
+    }
+    size_t id_len = (size_t)(slash - id);
+    size_t suffix_len = (size_t)(end - slash);
+    if (suffix_len == strlen("/set_position") && memcmp(slash, "/set_position", suffix_len) == 0) {
+        *position_topic = true;
+    } else if (suffix_len != strlen("/set") || memcmp(slash, "/set", suffix_len) != 0) {
+        return NULL;
+    }
+
+    for (uint32_t slot = command_index_slot(id, id_len); s_command_index[slot] != 0;
+         slot = (slot + 1) % MQTT_COMMAND_INDEX_SLOTS) {
+        mqtt_entity_t *entity = &s_entities[s_command_index[slot] - 1];
+        if (strlen(entity->id) == id_len && memcmp(entity->id, id, id_len) == 0) {
+            if (*position_topic && !entity->has_position_topic) {
+                return NULL;
+            }
             return entity;
         }
     }
@@ -324,7 +749,62 @@ static mqtt_entity_t *find_entity_by_topic(const char *topic, int topic_len)
 static void reset_entities(void)
 {
     memset(s_entities, 0, sizeof(s_entities));
+    memset(s_command_index, 0, sizeof(s_command_index));
+    wheel_reset_locked();
     s_entity_count = 0;
+    s_change_seq = 0;
+}
+
+static const publish_override_t *find_publish_override(const mqtt_entity_t *entity)
+{
+    bool ds18b20 = entity->kind == ENTITY_KIND_SENSOR && strcmp(entity->type, "ds18b20") == 0;
+    const char *id = entity->kind == ENTITY_KIND_SENSOR ? entity->source_id : entity->id;
+
+    for (int i = 0; i < s_publish_override_count; ++i) {
+        const publish_override_t *ovr = &s_publish_overrides[i];
+        if (ds18b20 ? ovr->ds18b20_bus : strcmp(ovr->id, id) == 0) {
+            return ovr;
+        }
+    }
+    return NULL;
+}
+
+static void apply_publish_policy(mqtt_entity_t *entity)
+{
+    int metric = -1;
+
+    if (entity->kind == ENTITY_KIND_SENSOR) {
+        for (int i = 0; i < SENSOR_METRIC_COUNT; ++i) {
+            if (strcmp(entity->metric, s_sensor_metric_names[i]) == 0) {
+                metric = i;
+            }
+        }
+    }
+
+    entity->throttle_ms = 0;
+    if (strcmp(entity->component, "light") == 0 || strcmp(entity->component, "number") == 0) {
+        entity->throttle_ms = MQTT_OUTPUT_THROTTLE_MS;
+    }
+    entity->heartbeat_ms = entity->kind == ENTITY_KIND_SENSOR ? MQTT_SENSOR_HEARTBEAT_MS : 0;
+    entity->deadband = metric >= 0 ? s_sensor_default_deadband[metric] : 0.0f;
+    entity->deadband_pct = 0.0f;
+
+    const publish_override_t *ovr = find_publish_override(entity);
+    if (!ovr) {
+        return;
+    }
+    if (ovr->throttle_ms >= 0) {
+        entity->throttle_ms = ovr->throttle_ms;
+    }
+    if (ovr->heartbeat_ms >= 0) {
+        entity->heartbeat_ms = ovr->heartbeat_ms;
+    }
+    if (metric >= 0 && ovr->deadband[metric] >= 0.0f) {
+        entity->deadband = ovr->deadband[metric];
+    }
+    if (metric >= 0 && ovr->deadband_pct >= 0.0f) {
+        entity->deadband_pct = ovr->deadband_pct;
+    }
 }
 
 static bool add_entity(entity_kind_t kind, const char *component, const char *id,
@@ -333,11 +813,14 @@ static bool add_entity(entity_kind_t kind, const char *component, const char *id
                        const char *output_mode)
 {
     if (s_entity_count >= MQTT_MAX_ENTITIES) {
+        // Only reachable when APP_MQTT_MAX_ENTITIES is overridden below the module limits.
+        ESP_LOGW(TAG, "MQTT entity limit (%d) reached, %s not published", MQTT_MAX_ENTITIES, id ? id : "");
         return false;
     }
 
     mqtt_entity_t *entity = &s_entities[s_entity_count++];
     entity->used = true;
+    entity->status_index = -1;
     entity->kind = kind;
     entity->supports_command = supports_command;
     copy_str(entity->id, sizeof(entity->id), id);
@@ -349,17 +832,11 @@ static bool add_entity(entity_kind_t kind, const char *component, const char *id
     copy_str(entity->source_id, sizeof(entity->source_id), source_id ? source_id : id);
     copy_str(entity->metric, sizeof(entity->metric), metric);
 
-    snprintf(entity->unique_id, sizeof(entity->unique_id), "%s_%s", s_cfg.node_id, id);
-    snprintf(entity->state_topic, sizeof(entity->state_topic), "%s/%s/state", s_cfg.topic_prefix, id);
-    if (supports_command) {
-        snprintf(entity->command_topic, sizeof(entity->command_topic), "%s/%s/set", s_cfg.topic_prefix, id);
-        if (strcmp(component, "cover") == 0) {
-            snprintf(entity->set_position_topic, sizeof(entity->set_position_topic),
-                     "%s/%s/set_position", s_cfg.topic_prefix, id);
-        }
+    entity->has_position_topic = supports_command && strcmp(component, "cover") == 0;
+    apply_publish_policy(entity);
+    if (supports_command && entity->id[0]) {
+        command_index_insert(s_entity_count - 1);
     }
-    snprintf(entity->config_topic, sizeof(entity->config_topic), "%s/%s/%s/%s/config",
-             s_cfg.discovery_prefix, component, s_cfg.node_id, id);
     return true;
 }
 
@@ -397,6 +874,11 @@ static esp_err_t parse_cfg(const cJSON *cfg, mqtt_cfg_t *out)
     out->enabled = jbool(mqtt, "enable", false);
     out->discovery = jbool(mqtt, "discovery", true);
     out->retain = jbool(mqtt, "retain", true);
+    out->json_state = strcmp(jstr(mqtt, "state_mode", "entity"), "json") == 0;
+    out->state_window_ms = jint(mqtt, "state_window_ms", MQTT_STATE_WINDOW_MS_DEFAULT);
+    if (out->state_window_ms < 0 || out->state_window_ms > 5000) {
+        out->state_window_ms = MQTT_STATE_WINDOW_MS_DEFAULT;
+    }
     out->port = jint(mqtt, "port", 1883);
     if (out->port <= 0 || out->port > 65535) {
         out->port = 1883;
@@ -416,9 +898,55 @@ static esp_err_t parse_cfg(const cJSON *cfg, mqtt_cfg_t *out)
     }
 
     snprintf(s_availability_topic, sizeof(s_availability_topic), "%s/status", out->topic_prefix);
+    snprintf(s_device_state_topic, sizeof(s_device_state_topic), "%s/state", out->topic_prefix);
     return ESP_OK;
 }
 
+static float jfloat(const cJSON *obj, const char *key, float def)
+{
+    const cJSON *it = jobj(obj, key);
+    return cJSON_IsNumber(it) ? (float)it->valuedouble : def;
+}
+
+static void add_publish_override(const cJSON *item, bool ds18b20_bus)
+{
+    const cJSON *publish = jobj(item, "mqtt_publish");
+
+    if (!cJSON_IsObject((cJSON *)publish) || s_publish_override_count >= MQTT_MAX_ENTITIES) {
+        return;
+    }
+
+    publish_override_t *ovr = &s_publish_overrides[s_publish_override_count++];
+    const cJSON *deadband = jobj(publish, "deadband");
+    int heartbeat_sec = jint(publish, "heartbeat_sec", -1);
+    copy_str(ovr->id, sizeof(ovr->id), jstr(item, "id", ""));
+    ovr->ds18b20_bus = ds18b20_bus;
+    ovr->throttle_ms = jint(publish, "throttle_ms", -1);
+    ovr->heartbeat_ms = heartbeat_sec >= 0 ? heartbeat_sec * 1000 : -1;
+    for (int i = 0; i < SENSOR_METRIC_COUNT; ++i) {
+        ovr->deadband[i] = jfloat(deadband, s_sensor_metric_names[i], -1.0f);
+    }
+    ovr->deadband_pct = jfloat(publish, "deadband_pct", -1.0f);
+}
+
+static void parse_publish_overrides(const cJSON *cfg)
+{
+    static const char *const sections[] = {"outputs", "inputs", "sensors"};
+
+    memset(s_publish_overrides, 0, sizeof(s_publish_overrides));
+    s_publish_override_count = 0;
+    for (size_t s = 0; s < sizeof(sections) / sizeof(sections[0]); ++s) {
+        const cJSON *items = jobj(cfg, sections[s]);
+        const cJSON *item = NULL;
+        if (!cJSON_IsArray((cJSON *)items)) {
+            continue;
+        }
+        cJSON_ArrayForEach(item, (cJSON *)items) {
+            add_publish_override(item, strcmp(jstr(item, "type", ""), "ds18b20_bus") == 0);
+        }
+    }
+}
+
 static void build_entities_from_status(const cJSON *status)
 {
     reset_entities();
@@ -426,6 +954,7 @@ static void build_entities_from_status(const cJSON *status)
     const cJSON *outputs = jobj(status, "outputs");
     const cJSON *inputs = jobj(status, "inputs");
     const cJSON *sensors = jobj(status, "sensors");
+    const cJSON *buttons = jobj(status, "buttons");
 
     if (cJSON_IsArray((cJSON *)outputs)) {
         int count = cJSON_GetArraySize((cJSON *)outputs);
@@ -456,9 +985,38 @@ static void build_entities_from_status(const cJSON *status)
             if (!jbool(item, "enabled", true)) {
                 continue;
             }
-            add_entity(ENTITY_KIND_INPUT, "binary_sensor", jstr(item, "id", ""),
+            const char *iid = jstr(item, "id", "");
+            const char *name = jstr(item, "name", iid);
+            if (strcmp(jstr(item, "type", "digital"), "counter") == 0) {
+                char id_total[40] = {0};
+                char id_rate[40] = {0};
+                char name_total[64] = {0};
+                char name_rate[64] = {0};
+                snprintf(id_total, sizeof(id_total), "%s_total", iid);
+                snprintf(id_rate, sizeof(id_rate), "%s_rate", iid);
+                snprintf(name_total, sizeof(name_total), "%s Total", name);
+                snprintf(name_rate, sizeof(name_rate), "%s Rate", name);
+                add_entity(ENTITY_KIND_INPUT, "sensor", id_total, name_total, "counter", "total",
+                           iid, "total", false, "");
+                add_entity(ENTITY_KIND_INPUT, "sensor", id_rate, name_rate, "counter", "rate",
+                           iid, "rate_per_min", false, "");
+                continue;
+            }
+            add_entity(ENTITY_KIND_INPUT, "binary_sensor", iid,
                        jstr(item, "name", ""), "digital", jstr(item, "role", ""),
-                       jstr(item, "id", ""), "", false, "");
+                       iid, "", false, "");
+        }
+    }
+
+    if (cJSON_IsArray((cJSON *)buttons)) {
+        int count = cJSON_GetArraySize((cJSON *)buttons);
+        for (int i = 0; i < count; ++i) {
+            const cJSON *item = cJSON_GetArrayItem((cJSON *)buttons, i);
+            if (!jbool(item, "enabled", true)) {
+                continue;
+            }
+            add_entity(ENTITY_KIND_BUTTON, "event", jstr(item, "id", ""), jstr(item, "name", ""), "button",
+                       "", jstr(item, "id", ""), "", false, "");
         }
     }
 
@@ -513,24 +1071,19 @@ static void build_entities_from_status(const cJSON *status)
     }
 }
 
-static bool sync_entities_from_status(const cJSON *status)
+static bool sync_entities_from_status_locked(void)
 {
     bool added = false;
-    const cJSON *sensors = jobj(status, "sensors");
-
-    if (!cJSON_IsArray((cJSON *)sensors)) {
-        return false;
-    }
 
-    cJSON *item = NULL;
-    cJSON_ArrayForEach(item, (cJSON *)sensors) {
-        if (!jbool(item, "enabled", true) || !jbool(item, "supported", false)) {
+    for (int i = 0; i < s_status.sensor_count; ++i) {
+        const modules_sensor_status_t *st = &s_status.sensors[i];
+        if (!st->enabled || !st->supported) {
             continue;
         }
 
-        const char *type = jstr(item, "type", "");
-        const char *sid = jstr(item, "id", "");
-        const char *name = jstr(item, "name", sid);
+        const char *type = st->type;
+        const char *sid = st->id;
+        const char *name = st->name[0] ? st->name : sid;
 
         if (strcmp(type, "aht20") == 0 || strcmp(type, "sht3x") == 0 || strcmp(type, "bme280") == 0) {
             char id_temp[40] = {0};
@@ -562,21 +1115,13 @@ static bool sync_entities_from_status(const cJSON *status)
                     added = true;
                 }
             }
-        } else if (strcmp(type, "ds18b20_bus") == 0) {
-            const cJSON *devices = jobj(item, "devices");
-            if (!cJSON_IsArray((cJSON *)devices)) {
-                continue;
-            }
-            cJSON *dev = NULL;
-            cJSON_ArrayForEach(dev, (cJSON *)devices) {
-                const char *dev_id = jstr(dev, "id", "");
-                char entity_name[72] = {0};
-                snprintf(entity_name, sizeof(entity_name), "%s Temperature", jstr(dev, "name", "DS18B20"));
-                if (!entity_exists(ENTITY_KIND_SENSOR, dev_id) &&
-                    add_entity(ENTITY_KIND_SENSOR, "sensor", dev_id, entity_name, "ds18b20", "temperature",
-                               dev_id, "temperature_c", false, "")) {
-                    added = true;
-                }
+        } else if (strcmp(type, "ds18b20") == 0) {
+            char entity_name[72] = {0};
+            snprintf(entity_name, sizeof(entity_name), "%s Temperature", name);
+            if (!entity_exists(ENTITY_KIND_SENSOR, sid) &&
+                add_entity(ENTITY_KIND_SENSOR, "sensor", sid, entity_name, "ds18b20", "temperature",
+                           sid, "temperature_c", false, "")) {
+                added = true;
             }
         }
     }
@@ -596,41 +1141,49 @@ static cJSON *build_device_obj(void)
     return dev;
 }
 
-static esp_err_t publish_discovery_entity(const mqtt_entity_t *entity)
+// Sets *published only when a config actually went out; unchanged ones the broker has seen are skipped.
+static esp_err_t publish_discovery_entity(mqtt_entity_t *entity, bool *published)
 {
+    *published = false;
     if (!s_cfg.discovery || !entity || !entity->used) {
         return ESP_OK;
     }
 
+    char topic[MQTT_TOPIC_MAX];
+    char tmpl[96];
+    char unique_id[80];
+    snprintf(unique_id, sizeof(unique_id), "%s_%s", s_cfg.node_id, entity->id);
+
     cJSON *root = cJSON_CreateObject();
     cJSON_AddStringToObject(root, "name", entity->name);
     cJSON_AddStringToObject(root, "object_id", entity->id);
-    cJSON_AddStringToObject(root, "unique_id", entity->unique_id);
+    cJSON_AddStringToObject(root, "unique_id", unique_id);
     cJSON_AddStringToObject(root, "availability_topic", s_availability_topic);
     cJSON_AddStringToObject(root, "payload_available", "online");
     cJSON_AddStringToObject(root, "payload_not_available", "offline");
     cJSON_AddItemToObject(root, "device", build_device_obj());
 
     if (entity->kind == ENTITY_KIND_OUTPUT && strcmp(entity->component, "switch") == 0) {
-        cJSON_AddStringToObject(root, "command_topic", entity->command_topic);
-        cJSON_AddStringToObject(root, "state_topic", entity->state_topic);
+        cJSON_AddStringToObject(root, "command_topic", entity_topic(entity, ENTITY_TOPIC_COMMAND, topic, sizeof(topic)));
+        cJSON_AddStringToObject(root, "state_topic", entity_topic(entity, ENTITY_TOPIC_STATE, topic, sizeof(topic)));
         cJSON_AddStringToObject(root, "payload_on", "ON");
         cJSON_AddStringToObject(root, "payload_off", "OFF");
         cJSON_AddBoolToObject(root, "retain", s_cfg.retain);
     } else if (entity->kind == ENTITY_KIND_OUTPUT && strcmp(entity->component, "cover") == 0) {
-        cJSON_AddStringToObject(root, "command_topic", entity->command_topic);
-        cJSON_AddStringToObject(root, "set_position_topic", entity->set_position_topic);
-        cJSON_AddStringToObject(root, "state_topic", entity->state_topic);
-        cJSON_AddStringToObject(root, "position_topic", entity->state_topic);
-        cJSON_AddStringToObject(root, "value_template", "{{ value_json.state }}");
-        cJSON_AddStringToObject(root, "position_template", "{{ value_json.position }}");
+        cJSON_AddStringToObject(root, "command_topic", entity_topic(entity, ENTITY_TOPIC_COMMAND, topic, sizeof(topic)));
+        cJSON_AddStringToObject(root, "set_position_topic", entity_topic(entity, ENTITY_TOPIC_SET_POSITION, topic, sizeof(topic)));
+        cJSON_AddStringToObject(root, "state_topic", entity_topic(entity, ENTITY_TOPIC_STATE, topic, sizeof(topic)));
+        cJSON_AddStringToObject(root, "position_topic", entity_topic(entity, ENTITY_TOPIC_STATE, topic, sizeof(topic)));
+        cJSON_AddStringToObject(root, "value_template", entity_value_template(entity, "state", tmpl, sizeof(tmpl)));
+        cJSON_AddStringToObject(root, "position_template",
+                                entity_value_template(entity, "position", tmpl, sizeof(tmpl)));
         cJSON_AddStringToObject(root, "payload_open", "OPEN");
         cJSON_AddStringToObject(root, "payload_close", "CLOSE");
         cJSON_AddStringToObject(root, "payload_stop", "STOP");
         cJSON_AddBoolToObject(root, "retain", s_cfg.retain);
     } else if (entity->kind == ENTITY_KIND_OUTPUT && strcmp(entity->component, "number") == 0) {
-        cJSON_AddStringToObject(root, "command_topic", entity->command_topic);
-        cJSON_AddStringToObject(root, "state_topic", entity->state_topic);
+        cJSON_AddStringToObject(root, "command_topic", entity_topic(entity, ENTITY_TOPIC_COMMAND, topic, sizeof(topic)));
+        cJSON_AddStringToObject(root, "state_topic", entity_topic(entity, ENTITY_TOPIC_STATE, topic, sizeof(topic)));
         cJSON_AddNumberToObject(root, "min", 0);
         cJSON_AddNumberToObject(root, "max", 100);
         cJSON_AddNumberToObject(root, "step", 1);
@@ -641,19 +1194,32 @@ static esp_err_t publish_discovery_entity(const mqtt_entity_t *entity)
         cJSON_AddStringToObject(root, "unit_of_measurement", "%");
     } else if (entity->kind == ENTITY_KIND_OUTPUT) {
         cJSON_AddStringToObject(root, "schema", "json");
-        cJSON_AddStringToObject(root, "command_topic", entity->command_topic);
-        cJSON_AddStringToObject(root, "state_topic", entity->state_topic);
+        cJSON_AddStringToObject(root, "command_topic", entity_topic(entity, ENTITY_TOPIC_COMMAND, topic, sizeof(topic)));
+        cJSON_AddStringToObject(root, "state_topic", entity_topic(entity, ENTITY_TOPIC_STATE, topic, sizeof(topic)));
         cJSON_AddBoolToObject(root, "brightness", true);
         cJSON_AddNumberToObject(root, "brightness_scale", 255);
         if (strcmp(entity->type, "ws2812") == 0 && strcmp(entity->output_mode, "mono_triplet") != 0) {
             cJSON *modes = cJSON_AddArrayToObject(root, "supported_color_modes");
             cJSON_AddItemToArray(modes, cJSON_CreateString("rgb"));
+            cJSON_AddBoolToObject(root, "effect", true);
+            cJSON *effects = cJSON_AddArrayToObject(root, "effect_list");
+            for (int i = 0; modules_ws2812_effect_name(i); ++i) {
+                cJSON_AddItemToArray(effects, cJSON_CreateString(modules_ws2812_effect_name(i)));
+            }
         } else {
             cJSON *modes = cJSON_AddArrayToObject(root, "supported_color_modes");
             cJSON_AddItemToArray(modes, cJSON_CreateString("brightness"));
         }
+    } else if (entity->kind == ENTITY_KIND_INPUT && strcmp(entity->type, "counter") == 0) {
+        cJSON_AddStringToObject(root, "state_topic", entity_topic(entity, ENTITY_TOPIC_STATE, topic, sizeof(topic)));
+        if (strcmp(entity->role, "total") == 0) {
+            cJSON_AddStringToObject(root, "state_class", "total_increasing");
+        } else {
+            cJSON_AddStringToObject(root, "state_class", "measurement");
+            cJSON_AddStringToObject(root, "unit_of_measurement", "1/min");
+        }
     } else if (entity->kind == ENTITY_KIND_INPUT) {
-        cJSON_AddStringToObject(root, "state_topic", entity->state_topic);
+        cJSON_AddStringToObject(root, "state_topic", entity_topic(entity, ENTITY_TOPIC_STATE, topic, sizeof(topic)));
         cJSON_AddStringToObject(root, "payload_on", "ON");
         cJSON_AddStringToObject(root, "payload_off", "OFF");
         if (strcmp(entity->role, "motion") == 0) {
@@ -663,8 +1229,16 @@ static esp_err_t publish_discovery_entity(const mqtt_entity_t *entity)
         } else if (strcmp(entity->role, "contact") == 0 || strcmp(entity->role, "limit") == 0) {
             cJSON_AddStringToObject(root, "device_class", "door");
         }
+    } else if (entity->kind == ENTITY_KIND_BUTTON) {
+        cJSON_AddStringToObject(root, "state_topic", entity_topic(entity, ENTITY_TOPIC_STATE, topic, sizeof(topic)));
+        cJSON_AddStringToObject(root, "device_class", "button");
+        cJSON *types = cJSON_AddArrayToObject(root, "event_types");
+        cJSON_AddItemToArray(types, cJSON_CreateString("single"));
+        cJSON_AddItemToArray(types, cJSON_CreateString("double"));
+        cJSON_AddItemToArray(types, cJSON_CreateString("triple"));
+        cJSON_AddItemToArray(types, cJSON_CreateString("long"));
     } else if (entity->kind == ENTITY_KIND_SENSOR) {
-        cJSON_AddStringToObject(root, "state_topic", entity->state_topic);
+        cJSON_AddStringToObject(root, "state_topic", entity_topic(entity, ENTITY_TOPIC_STATE, topic, sizeof(topic)));
         cJSON_AddStringToObject(root, "state_class", "measurement");
         if (strcmp(entity->role, "temperature") == 0) {
             cJSON_AddStringToObject(root, "device_class", "temperature");
@@ -678,13 +1252,39 @@ static esp_err_t publish_discovery_entity(const mqtt_entity_t *entity)
         }
     }
 
+    if (entity_in_device_state(entity) && strcmp(entity->component, "cover") != 0) {
+        cJSON_AddStringToObject(root, "value_template", entity_value_template(entity, NULL, tmpl, sizeof(tmpl)));
+    }
+
     char *payload = cJSON_PrintUnformatted(root);
     cJSON_Delete(root);
     if (!payload) {
         return ESP_ERR_NO_MEM;
     }
 
-    esp_err_t err = publish_raw(entity->config_topic, payload, 1, true);
+    entity_topic(entity, ENTITY_TOPIC_CONFIG, topic, sizeof(topic));
+    uint32_t hash = hash_fnv1a(hash_fnv1a(HASH_FNV1A_SEED, topic, strlen(topic)), payload, strlen(payload));
+    bool seen;
+    portENTER_CRITICAL(&s_sync_mux);
+    seen = entity->discovery_hash == hash || (entity->discovery_msg_id > 0 && entity->discovery_pending_hash == hash);
+    portEXIT_CRITICAL(&s_sync_mux);
+    if (seen) {
+        free(payload);
+        return ESP_OK;
+    }
+
+    esp_err_t err = ESP_ERR_INVALID_STATE;
+    if (s_client && s_connected) {
+        int msg_id = esp_mqtt_client_publish(s_client, topic, payload, 0, 1, 1);
+        err = msg_id >= 0 ? ESP_OK : ESP_FAIL;
+        if (err == ESP_OK) {
+            portENTER_CRITICAL(&s_sync_mux);
+            entity->discovery_pending_hash = hash;
+            entity->discovery_msg_id = msg_id;
+            portEXIT_CRITICAL(&s_sync_mux);
+            *published = true;
+        }
+    }
     free(payload);
     if (err == ESP_OK && entity->kind == ENTITY_KIND_OUTPUT) {
         if (strcmp(entity->component, "number") != 0) {
@@ -700,146 +1300,418 @@ static esp_err_t publish_discovery_entity(const mqtt_entity_t *entity)
     return err;
 }
 
-static const cJSON *find_status_item(const cJSON *arr, const char *id)
+static esp_err_t load_status_snapshot_locked(void)
 {
-    if (!cJSON_IsArray((cJSON *)arr)) {
-        return NULL;
+    esp_err_t err = modules_get_status_snapshot(&s_status);
+    if (err == ESP_ERR_INVALID_SIZE) {
+        ESP_LOGW(TAG, "Status snapshot truncated");
+        return ESP_OK;
     }
-    cJSON *item = NULL;
-    cJSON_ArrayForEach(item, (cJSON *)arr) {
-        const cJSON *it_id = cJSON_GetObjectItemCaseSensitive(item, "id");
-        if (cJSON_IsString(it_id) && it_id->valuestring && strcmp(it_id->valuestring, id) == 0) {
-            return item;
+    return err;
+}
+
+static const modules_output_status_t *find_output_status(const char *id)
+{
+    for (int i = 0; i < s_status.output_count; ++i) {
+        if (strcmp(s_status.outputs[i].id, id) == 0) {
+            return &s_status.outputs[i];
         }
     }
     return NULL;
 }
 
-static const cJSON *find_sensor_status_item(const cJSON *arr, const mqtt_entity_t *entity)
+static const modules_input_status_t *find_input_status(const char *id)
 {
-    if (!cJSON_IsArray((cJSON *)arr) || !entity) {
-        return NULL;
-    }
-
-    cJSON *item = NULL;
-    cJSON_ArrayForEach(item, (cJSON *)arr) {
-        const cJSON *it_id = cJSON_GetObjectItemCaseSensitive(item, "id");
-        if (cJSON_IsString(it_id) && it_id->valuestring &&
-            strcmp(it_id->valuestring, entity->source_id) == 0) {
-            return item;
+    for (int i = 0; i < s_status.input_count; ++i) {
+        if (strcmp(s_status.inputs[i].id, id) == 0) {
+            return &s_status.inputs[i];
         }
+    }
+    return NULL;
+}
 
-        const cJSON *devices = cJSON_GetObjectItemCaseSensitive(item, "devices");
-        if (cJSON_IsArray((cJSON *)devices)) {
-            cJSON *dev = NULL;
-            cJSON_ArrayForEach(dev, (cJSON *)devices) {
-                const cJSON *dev_id = cJSON_GetObjectItemCaseSensitive(dev, "id");
-                if (cJSON_IsString(dev_id) && dev_id->valuestring &&
-                    strcmp(dev_id->valuestring, entity->source_id) == 0) {
-                    return dev;
-                }
-            }
+static const modules_sensor_status_t *find_sensor_status(const char *id)
+{
+    for (int i = 0; i < s_status.sensor_count; ++i) {
+        if (strcmp(s_status.sensors[i].id, id) == 0) {
+            return &s_status.sensors[i];
         }
     }
-
     return NULL;
 }
 
-static esp_err_t build_entity_state_payload(const mqtt_entity_t *entity, const cJSON *status,
-                                            char *payload, size_t payload_len)
+static bool sensor_metric_value(const modules_sensor_status_t *st, const char *metric, float *out)
 {
-    if (!entity || !status || !payload || payload_len < 2) {
-        return ESP_ERR_INVALID_ARG;
+    if (strcmp(metric, "temperature_c") == 0 && (st->metrics & MODULES_METRIC_TEMPERATURE)) {
+        *out = st->temperature_c;
+    } else if (strcmp(metric, "humidity_pct") == 0 && (st->metrics & MODULES_METRIC_HUMIDITY)) {
+        *out = st->humidity_pct;
+    } else if (strcmp(metric, "pressure_hpa") == 0 && (st->metrics & MODULES_METRIC_PRESSURE)) {
+        *out = st->pressure_hpa;
+    } else {
+        return false;
     }
+    return true;
+}
 
-    payload[0] = 0;
-    if (entity->kind == ENTITY_KIND_OUTPUT && strcmp(entity->component, "switch") == 0) {
-        bool power = jbool(status, "power", false);
-        snprintf(payload, payload_len, "%s", power ? "ON" : "OFF");
-    } else if (entity->kind == ENTITY_KIND_OUTPUT && strcmp(entity->component, "cover") == 0) {
-        int position = jint(status, "position", jint(status, "level", 0));
-        const char *cover_state = jstr(status, "state", "stopped");
+static bool entity_changed(mqtt_entity_t *entity, const modules_changes_t *changes)
+{
+    uint32_t mask = 0;
+
+    // Buttons have no state; their gestures go out through publish_button_events_locked.
+    if (entity->kind == ENTITY_KIND_BUTTON) {
+        return false;
+    }
+    if (entity->status_index < 0) {
+        if (entity->kind == ENTITY_KIND_OUTPUT) {
+            const modules_output_status_t *st = find_output_status(entity->id);
+            entity->status_index = st ? (int)(st - s_status.outputs) : -1;
+        } else if (entity->kind == ENTITY_KIND_INPUT) {
+            const modules_input_status_t *st = find_input_status(entity->source_id);
+            entity->status_index = st ? (int)(st - s_status.inputs) : -1;
+        } else if (entity->kind == ENTITY_KIND_SENSOR) {
+            const modules_sensor_status_t *st = find_sensor_status(entity->source_id);
+            entity->status_index = st ? st->source_index : -1;
+        }
+        if (entity->status_index < 0) {
+            return true;
+        }
+    }
+
+    if (entity->kind == ENTITY_KIND_OUTPUT) {
+        mask = changes->outputs;
+    } else if (entity->kind == ENTITY_KIND_INPUT) {
+        mask = changes->inputs;
+    } else if (entity->kind == ENTITY_KIND_SENSOR) {
+        mask = changes->sensors;
+    }
+    return (mask & (1UL << entity->status_index)) != 0;
+}
+
+static void build_output_state_payload(const mqtt_entity_t *entity, const modules_output_status_t *st,
+                                       char *payload, size_t payload_len)
+{
+    if (strcmp(entity->component, "switch") == 0) {
+        snprintf(payload, payload_len, "%s", st->power ? "ON" : "OFF");
+    } else if (strcmp(entity->component, "cover") == 0) {
+        const char *cover_state = st->cover_state ? st->cover_state : "stopped";
         const char *mqtt_state = cover_state;
         if (strcmp(cover_state, "not_homed") == 0 || strcmp(cover_state, "homing") == 0) {
             mqtt_state = "stopped";
         }
         snprintf(payload, payload_len, "{\"state\":\"%s\",\"position\":%d,\"cover_state\":\"%s\"}",
-                 mqtt_state, position, cover_state);
-    } else if (entity->kind == ENTITY_KIND_OUTPUT && strcmp(entity->component, "number") == 0) {
-        int level = jint(status, "level", 0);
-        snprintf(payload, payload_len, "%d", level);
-    } else if (entity->kind == ENTITY_KIND_OUTPUT && strcmp(entity->component, "light") == 0 &&
+                 mqtt_state, st->level, cover_state);
+    } else if (strcmp(entity->component, "number") == 0) {
+        snprintf(payload, payload_len, "%d", st->level);
+    } else if (strcmp(entity->component, "light") == 0 &&
                (strcmp(entity->type, "servo_3wire") == 0 || strcmp(entity->type, "servo_5wire") == 0)) {
-        int level = jint(status, "level", 0);
-        int brightness = (level * 255) / 100;
+        int brightness = (st->level * 255) / 100;
         snprintf(payload, payload_len, "{\"state\":\"%s\",\"brightness\":%d}",
-                 level > 0 ? "ON" : "OFF", brightness);
-    } else if (entity->kind == ENTITY_KIND_OUTPUT &&
-               (strcmp(entity->type, "pwm") == 0 || strcmp(entity->type, "clock_4x4094") == 0)) {
-        bool power = jbool(status, "power", false);
-        int level = jint(status, "level", strcmp(entity->type, "clock_4x4094") == 0 ? 100 : 0);
-        int brightness = (level * 255) / 100;
+                 st->level > 0 ? "ON" : "OFF", brightness);
+    } else if (strcmp(entity->type, "pwm") == 0 || strcmp(entity->type, "clock_4x4094") == 0) {
+        int brightness = (st->level * 255) / 100;
         snprintf(payload, payload_len, "{\"state\":\"%s\",\"brightness\":%d}",
-                 power ? "ON" : "OFF", brightness);
-    } else if (entity->kind == ENTITY_KIND_OUTPUT && strcmp(entity->type, "ws2812") == 0) {
-        bool power = jbool(status, "power", false);
-        int brightness = jint(status, "brightness", 0);
+                 st->power ? "ON" : "OFF", brightness);
+    } else if (strcmp(entity->type, "ws2812") == 0) {
         if (strcmp(entity->output_mode, "mono_triplet") == 0) {
             snprintf(payload, payload_len, "{\"state\":\"%s\",\"brightness\":%d}",
-                     power ? "ON" : "OFF", brightness);
+                     st->power ? "ON" : "OFF", st->brightness);
         } else {
-            const cJSON *color = jobj(status, "color");
             snprintf(payload, payload_len,
-                     "{\"state\":\"%s\",\"brightness\":%d,\"color\":{\"r\":%d,\"g\":%d,\"b\":%d}}",
-                     power ? "ON" : "OFF", brightness,
-                     jint(color, "r", 255), jint(color, "g", 255), jint(color, "b", 255));
+                     "{\"state\":\"%s\",\"brightness\":%d,\"color\":{\"r\":%d,\"g\":%d,\"b\":%d},"
+                     "\"effect\":\"%s\"}",
+                     st->power ? "ON" : "OFF", st->brightness,
+                     st->has_color ? st->red : 255, st->has_color ? st->green : 255,
+                     st->has_color ? st->blue : 255, st->effect ? st->effect : "none");
+        }
+    }
+}
+
+static esp_err_t build_entity_state_payload(const mqtt_entity_t *entity, char *payload, size_t payload_len)
+{
+    if (!entity || !payload || payload_len < 2) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    payload[0] = 0;
+    if (entity->kind == ENTITY_KIND_OUTPUT) {
+        const modules_output_status_t *st = find_output_status(entity->id);
+        if (!st) {
+            return ESP_ERR_NOT_FOUND;
         }
+        build_output_state_payload(entity, st, payload, payload_len);
     } else if (entity->kind == ENTITY_KIND_INPUT) {
-        bool state = jbool(status, "state", false);
-        snprintf(payload, payload_len, "%s", state ? "ON" : "OFF");
+        const modules_input_status_t *st = find_input_status(entity->source_id);
+        if (!st) {
+            return ESP_ERR_NOT_FOUND;
+        }
+        if (!st->counter) {
+            snprintf(payload, payload_len, "%s", st->state ? "ON" : "OFF");
+        } else if (strcmp(entity->metric, "total") == 0) {
+            snprintf(payload, payload_len, "%" PRIu64, st->total);
+        } else {
+            snprintf(payload, payload_len, "%.2f", (double)st->rate_per_min);
+        }
     } else if (entity->kind == ENTITY_KIND_SENSOR) {
-        const cJSON *metric = cJSON_GetObjectItemCaseSensitive((cJSON *)status, entity->metric);
-        if (!cJSON_IsNumber(metric)) {
+        const modules_sensor_status_t *st = find_sensor_status(entity->source_id);
+        float value = 0.0f;
+        if (!st || !sensor_metric_value(st, entity->metric, &value)) {
             return ESP_ERR_NOT_FOUND;
         }
-        snprintf(payload, payload_len, "%.2f", metric->valuedouble);
+        snprintf(payload, payload_len, "%.2f", (double)value);
     } else {
-        return ESP_OK;
+        return ESP_ERR_NOT_FOUND;
     }
 
     return ESP_OK;
 }
 
+static mqtt_entity_t *find_button_entity(const char *id)
+{
+    for (int i = 0; i < s_entity_count; ++i) {
+        if (s_entities[i].used && s_entities[i].kind == ENTITY_KIND_BUTTON && strcmp(s_entities[i].id, id) == 0) {
+            return &s_entities[i];
+        }
+    }
+    return NULL;
+}
+
+// Gestures are events, not state: never retained, and skipped once stale.
+static void publish_button_events_locked(void)
+{
+    modules_button_event_t events[MQTT_BUTTON_EVENT_BATCH];
+    int count;
+
+    do {
+        count = modules_get_button_events_since(s_button_event_seq, events, MQTT_BUTTON_EVENT_BATCH,
+                                                &s_button_event_seq);
+        int64_t now_us = esp_timer_get_time();
+        for (int i = 0; i < count; ++i) {
+            mqtt_entity_t *entity = find_button_entity(events[i].id);
+            char topic[MQTT_TOPIC_MAX];
+            char payload[48];
+
+            if (!entity || now_us - events[i].time_us > MQTT_BUTTON_EVENT_MAX_AGE_US) {
+                continue;
+            }
+            snprintf(payload, sizeof(payload), "{\"event_type\":\"%s\"}", events[i].gesture);
+            (void)publish_raw(entity_topic(entity, ENTITY_TOPIC_STATE, topic, sizeof(topic)), payload, 1, false);
+        }
+    } while (count == MQTT_BUTTON_EVENT_BATCH);
+}
+
+static bool entity_sensor_value(const mqtt_entity_t *entity, float *value)
+{
+    const modules_sensor_status_t *st;
+
+    if (entity->kind != ENTITY_KIND_SENSOR) {
+        return false;
+    }
+    st = find_sensor_status(entity->source_id);
+    return st && sensor_metric_value(st, entity->metric, value);
+}
+
+// The effective deadband is the larger of the absolute one and deadband_pct of the last published value.
+static bool entity_within_deadband(const mqtt_entity_t *entity)
+{
+    float value = 0.0f;
+
+    if (!entity->has_last_value || !entity_sensor_value(entity, &value)) {
+        return false;
+    }
+    float delta = fabsf(value - entity->last_value);
+    float relative = fabsf(entity->last_value) * entity->deadband_pct / 100.0f;
+    return delta < (entity->deadband > relative ? entity->deadband : relative);
+}
+
+static void record_entity_state_locked(mqtt_entity_t *entity, uint32_t hash)
+{
+    entity->last_payload_hash = hash;
+    entity->has_last_published_payload = true;
+    entity->has_last_value = entity_sensor_value(entity, &entity->last_value);
+}
+
+static void mark_entity_published_locked(mqtt_entity_t *entity, int64_t now_us)
+{
+    entity->last_publish_us = now_us;
+    entity->pending_publish = false;
+    wheel_rearm_locked((int)(entity - s_entities));
+}
+
+// ON/OFF states are strings; numbers and cover objects are already valid JSON values.
+// Ids are sanitized by cfg_json, but the document must stay valid JSON whatever a caller registers.
+static void json_escape_copy(char *dst, size_t dst_len, const char *src)
+{
+    size_t wr = 0;
+
+    for (; *src && wr + 7 < dst_len; ++src) {
+        unsigned char ch = (unsigned char)*src;
+        if (ch == '"' || ch == '\\') {
+            dst[wr++] = '\\';
+            dst[wr++] = (char)ch;
+        } else if (ch < 0x20) {
+            wr += (size_t)snprintf(dst + wr, dst_len - wr, "\\u%04x", ch);
+        } else {
+            dst[wr++] = (char)ch;
+        }
+    }
+    dst[wr] = 0;
+}
+
+static esp_err_t build_device_state_payload(char *payload, size_t payload_len)
+{
+    size_t used = 0;
+    int n = snprintf(payload, payload_len, "{");
+
+    used = (size_t)n;
+    for (int i = 0; i < s_entity_count; ++i) {
+        const mqtt_entity_t *entity = &s_entities[i];
+        char value[MQTT_STATE_PAYLOAD_MAX];
+        char key[sizeof(entity->id) * 6 + 8];
+
+        if (!entity->used || !entity_in_device_state(entity) ||
+            build_entity_state_payload(entity, value, sizeof(value)) != ESP_OK || !value[0]) {
+            continue;
+        }
+        json_escape_copy(key, sizeof(key), entity->id);
+        bool quote = strcmp(entity->component, "binary_sensor") == 0 || strcmp(entity->component, "switch") == 0;
+        n = snprintf(payload + used, payload_len - used, quote ? "%s\"%s\":\"%s\"" : "%s\"%s\":%s",
+                     used > 1 ? "," : "", key, value);
+        if (n < 0 || (size_t)n >= payload_len - used) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        used += (size_t)n;
+    }
+    if (used + 2 > payload_len) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(payload + used, "}", 2);
+    return ESP_OK;
+}
+
+// Caller holds s_state_lock with a fresh snapshot loaded. force republishes an unchanged document.
+static esp_err_t publish_device_state_locked(bool force)
+{
+    size_t len = (size_t)MQTT_MAX_ENTITIES * MQTT_DEVICE_STATE_ENTRY_MAX;
+    char *payload = malloc(len);
+    if (!payload) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t err = build_device_state_payload(payload, len);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "device state document too large");
+        s_device_state_dirty = false;
+        free(payload);
+        return err;
+    }
+
+    uint32_t hash = payload_hash(payload);
+    if (!force && s_device_state_published && hash == s_device_state_hash) {
+        s_device_state_dirty = false;
+        free(payload);
+        return ESP_OK;
+    }
+
+    err = publish_raw(s_device_state_topic, payload, 1, s_cfg.retain);
+    free(payload);
+    if (err == ESP_OK) {
+        int64_t now_us = esp_timer_get_time();
+        s_device_state_hash = hash;
+        s_device_state_published = true;
+        s_device_state_dirty = false;
+        for (int i = 0; i < s_entity_count; ++i) {
+            if (s_entities[i].used && entity_in_device_state(&s_entities[i])) {
+                mark_entity_published_locked(&s_entities[i], now_us);
+            }
+        }
+    } else {
+        s_device_state_due_us = esp_timer_get_time() + (int64_t)MQTT_WORKER_PERIOD_MS * 1000LL;
+    }
+    return err;
+}
+
+// Only entities whose wheel deadline passed are visited: throttled publishes that are now allowed, and
+// heartbeats that republish an unchanged state.
 static esp_err_t flush_pending_entity_updates(void)
 {
     esp_err_t result = ESP_OK;
     int64_t now_us = esp_timer_get_time();
+    int expired[MQTT_MAX_ENTITIES];
+    int device_heartbeats[MQTT_MAX_ENTITIES];
+    int device_heartbeat_count = 0;
 
     if (!s_connected || !s_state_lock) {
         return ESP_OK;
     }
 
+    bool snapshot_loaded = false;
+
     xSemaphoreTake(s_state_lock, portMAX_DELAY);
-    for (int i = 0; i < s_entity_count; ++i) {
-        mqtt_entity_t *entity = &s_entities[i];
-        int throttle_ms = entity_publish_throttle_ms(entity);
+    int expired_count = wheel_expire_locked(now_us, expired, MQTT_MAX_ENTITIES);
+    for (int n = 0; n < expired_count; ++n) {
+        mqtt_entity_t *entity = &s_entities[expired[n]];
+        bool heartbeat = !entity->pending_publish;
+        char payload[MQTT_STATE_PAYLOAD_MAX];
+        char topic[MQTT_TOPIC_MAX];
 
-        if (!entity->used || !entity->pending_publish) {
+        if (!entity->used) {
             continue;
         }
-        if (throttle_ms > 0 && entity->last_publish_us > 0 &&
-            now_us < entity->last_publish_us + ((int64_t)throttle_ms * 1000LL)) {
+        if (heartbeat && entity_in_device_state(entity)) {
+            device_heartbeats[device_heartbeat_count++] = expired[n];
             continue;
         }
 
-        if (publish_raw(entity->state_topic, entity->pending_payload, 1, s_cfg.retain) == ESP_OK) {
-            copy_str(entity->last_published_payload, sizeof(entity->last_published_payload), entity->pending_payload);
-            entity->has_last_published_payload = true;
-            entity->last_publish_us = now_us;
+        if (!snapshot_loaded) {
+            if (load_status_snapshot_locked() != ESP_OK) {
+                result = ESP_FAIL;
+                wheel_rearm_locked(expired[n]);
+                continue;
+            }
+            snapshot_loaded = true;
+        }
+        if (build_entity_state_payload(entity, payload, sizeof(payload)) != ESP_OK) {
             entity->pending_publish = false;
-            entity->pending_payload[0] = 0;
+            wheel_rearm_locked(expired[n]);
+            continue;
+        }
+        uint32_t hash = payload_hash(payload);
+        if (!heartbeat && entity->has_last_published_payload && entity->last_payload_hash == hash) {
+            entity->pending_publish = false;
+            wheel_rearm_locked(expired[n]);
+            continue;
+        }
+
+        if (publish_raw(entity_topic(entity, ENTITY_TOPIC_STATE, topic, sizeof(topic)), payload, 1, s_cfg.retain) ==
+            ESP_OK) {
+            record_entity_state_locked(entity, hash);
+            mark_entity_published_locked(entity, now_us);
         } else {
             result = ESP_FAIL;
+            wheel_rearm_locked(expired[n]);
+        }
+    }
+    // Independent of the per-entity result: these entities are off the wheel and only a successful
+    // document publish (which rearms them) or an explicit rearm puts them back.
+    if (device_heartbeat_count > 0) {
+        esp_err_t err = snapshot_loaded ? ESP_OK : load_status_snapshot_locked();
+        if (err == ESP_OK) {
+            snapshot_loaded = true;
+            err = publish_device_state_locked(true);
+        }
+        if (err != ESP_OK) {
+            result = ESP_FAIL;
+            for (int n = 0; n < device_heartbeat_count; ++n) {
+                wheel_rearm_locked(device_heartbeats[n]);
+            }
+        }
+    }
+    if (result == ESP_OK && s_device_state_dirty && now_us >= s_device_state_due_us) {
+        if (!snapshot_loaded && load_status_snapshot_locked() != ESP_OK) {
+            result = ESP_FAIL;
+        } else if (publish_device_state_locked(false) != ESP_OK) {
+            result = ESP_FAIL;
         }
     }
     xSemaphoreGive(s_state_lock);
@@ -849,92 +1721,101 @@ static esp_err_t flush_pending_entity_updates(void)
 
 static esp_err_t publish_state_snapshot(bool force_all, bool allow_throttle)
 {
-    cJSON *status;
-    const cJSON *outputs;
-    const cJSON *inputs;
-    const cJSON *sensors;
-    bool wake_flush_task = false;
+    modules_changes_t changes;
+    esp_err_t err;
 
     if (!s_connected) {
         return ESP_ERR_INVALID_STATE;
     }
 
-    status = modules_build_status_json();
-    if (!status) {
-        return ESP_ERR_NO_MEM;
-    }
+    xSemaphoreTake(s_state_lock, portMAX_DELAY);
+    int64_t start_us = esp_timer_get_time();
+    modules_get_changes_since(s_change_seq, &changes);
+    err = load_status_snapshot_locked();
+    if (err == ESP_OK) {
+        s_change_seq = changes.seq;
+        err = publish_states_locked(&changes, force_all, allow_throttle);
+    }
+    perf_probe_record(PERF_PROBE_MQTT_PUBLISH, start_us);
+    xSemaphoreGive(s_state_lock);
+    return err;
+}
 
-    outputs = jobj(status, "outputs");
-    inputs = jobj(status, "inputs");
-    sensors = jobj(status, "sensors");
+// Only entities named in changes are rebuilt unless force_all is set or the journal asks for a resync.
+static esp_err_t publish_states_locked(const modules_changes_t *changes, bool force_all, bool allow_throttle)
+{
+    bool wake_worker = false;
 
-    xSemaphoreTake(s_state_lock, portMAX_DELAY);
     for (int i = 0; i < s_entity_count; ++i) {
         mqtt_entity_t *entity = &s_entities[i];
-        const cJSON *item = NULL;
         char payload[MQTT_STATE_PAYLOAD_MAX] = {0};
-        bool changed = false;
+        char topic[MQTT_TOPIC_MAX];
+        uint32_t hash;
         int throttle_ms;
         int64_t now_us;
 
         if (!entity->used) {
             continue;
         }
-
-        if (entity->kind == ENTITY_KIND_OUTPUT) {
-            item = find_status_item(outputs, entity->id);
-        } else if (entity->kind == ENTITY_KIND_INPUT) {
-            item = find_status_item(inputs, entity->id);
-        } else if (entity->kind == ENTITY_KIND_SENSOR) {
-            item = find_sensor_status_item(sensors, entity);
+        if (changes->resync) {
+            entity->status_index = -1;
         }
-        if (!item || build_entity_state_payload(entity, item, payload, sizeof(payload)) != ESP_OK) {
+        if (!force_all && !changes->resync && !entity_changed(entity, changes)) {
             continue;
         }
 
-        if (entity->pending_publish && entity->has_last_published_payload &&
-            strcmp(entity->last_published_payload, payload) == 0) {
-            entity->pending_publish = false;
-            entity->pending_payload[0] = 0;
+        if (build_entity_state_payload(entity, payload, sizeof(payload)) != ESP_OK) {
             continue;
         }
 
-        if (entity->pending_publish) {
-            changed = strcmp(entity->pending_payload, payload) != 0;
-        } else if (entity->has_last_published_payload) {
-            changed = strcmp(entity->last_published_payload, payload) != 0;
-        } else {
-            changed = true;
+        if (!force_all && entity_within_deadband(entity)) {
+            continue;
         }
 
-        if (!force_all && !changed) {
+        hash = payload_hash(payload);
+        if (entity_in_device_state(entity)) {
+            if (!entity->has_last_published_payload || entity->last_payload_hash != hash || force_all) {
+                record_entity_state_locked(entity, hash);
+                schedule_device_state_locked();
+            }
             continue;
         }
 
-        throttle_ms = allow_throttle ? entity_publish_throttle_ms(entity) : 0;
+        // A pending publish is dropped once the state is back to what was last published.
+        if (entity->has_last_published_payload && entity->last_payload_hash == hash &&
+            (entity->pending_publish || !force_all)) {
+            entity->pending_publish = false;
+            continue;
+        }
+
+        throttle_ms = allow_throttle ? entity->throttle_ms : 0;
         now_us = esp_timer_get_time();
         if (!force_all && throttle_ms > 0 && entity->last_publish_us > 0 &&
             now_us < entity->last_publish_us + ((int64_t)throttle_ms * 1000LL)) {
-            copy_str(entity->pending_payload, sizeof(entity->pending_payload), payload);
-            entity->pending_publish = true;
-            wake_flush_task = true;
+            if (!entity->pending_publish) {
+                entity->pending_publish = true;
+                wheel_rearm_locked(i);
+            }
             continue;
         }
 
-        if (publish_raw(entity->state_topic, payload, 1, s_cfg.retain) == ESP_OK) {
-            copy_str(entity->last_published_payload, sizeof(entity->last_published_payload), payload);
-            entity->has_last_published_payload = true;
-            entity->last_publish_us = now_us;
-            entity->pending_publish = false;
-            entity->pending_payload[0] = 0;
+        if (publish_raw(entity_topic(entity, ENTITY_TOPIC_STATE, topic, sizeof(topic)), payload, 1, s_cfg.retain) ==
+            ESP_OK) {
+            record_entity_state_locked(entity, hash);
+            mark_entity_published_locked(entity, now_us);
         }
     }
-    xSemaphoreGive(s_state_lock);
 
-    cJSON_Delete(status);
+    if (s_device_state_dirty) {
+        if (force_all || s_cfg.state_window_ms == 0) {
+            (void)publish_device_state_locked(force_all);
+        } else {
+            wake_worker = true;
+        }
+    }
 
-    if (wake_flush_task && s_flush_task) {
-        xTaskNotifyGive(s_flush_task);
+    if (wake_worker && s_worker_task) {
+        xTaskNotifyGive(s_worker_task);
     }
 
     return ESP_OK;
@@ -947,27 +1828,15 @@ static esp_err_t publish_all_states(void)
 
 static int current_output_level(const mqtt_entity_t *entity)
 {
-    cJSON *status = NULL;
-    const cJSON *outputs = NULL;
-    const cJSON *item = NULL;
-    int level = -1;
+    modules_output_status_t st;
 
     if (!entity || !entity->id[0]) {
         return -1;
     }
-
-    status = modules_build_status_json();
-    if (!status) {
+    if (modules_get_output_status(entity->id, &st) != ESP_OK || !st.has_level) {
         return -1;
     }
-
-    outputs = jobj(status, "outputs");
-    item = find_status_item(outputs, entity->id);
-    if (item) {
-        level = jint(item, "level", -1);
-    }
-    cJSON_Delete(status);
-    return level;
+    return st.level;
 }
 
 static esp_err_t apply_light_command(const mqtt_entity_t *entity, const char *data, int len)
@@ -1025,6 +1894,11 @@ static esp_err_t apply_light_command(const mqtt_entity_t *entity, const char *da
         if (cJSON_IsObject(color)) {
             cJSON_AddItemReferenceToObject(action, "color", (cJSON *)color);
         }
+
+        const cJSON *effect = cJSON_GetObjectItemCaseSensitive(root, "effect");
+        if (cJSON_IsString(effect) && strcmp(entity->type, "ws2812") == 0) {
+            cJSON_AddStringToObject(action, "effect", effect->valuestring);
+        }
     } else {
         if (str_ieq(buf, "ON")) {
             if (servo_light) {
@@ -1189,17 +2063,10 @@ static void mqtt_event_handler(void *arg, esp_event_base_t base, int32_t event_i
             s_connected = true;
             ESP_LOGI(TAG, "connected to broker");
             system_log_write("mqtt", "info", "Connected to broker");
-            for (int i = 0; i < s_entity_count; ++i) {
-                if (s_entities[i].supports_command) {
-                    (void)esp_mqtt_client_subscribe(s_client, s_entities[i].command_topic, 1);
-                    if (s_entities[i].set_position_topic[0] != 0) {
-                        (void)esp_mqtt_client_subscribe(s_client, s_entities[i].set_position_topic, 1);
-                    }
-                }
-                (void)publish_discovery_entity(&s_entities[i]);
-            }
-            (void)publish_raw(s_availability_topic, "online", 1, true);
-            (void)publish_all_states();
+            request_sync(MQTT_SYNC_ANNOUNCE);
+            break;
+        case MQTT_EVENT_PUBLISHED:
+            ack_discovery_publish(event->msg_id);
             break;
         case MQTT_EVENT_DISCONNECTED:
             s_connected = false;
@@ -1210,7 +2077,8 @@ static void mqtt_event_handler(void *arg, esp_event_base_t base, int32_t event_i
             if (event->current_data_offset != 0) {
                 break;
             }
-            mqtt_entity_t *entity = find_entity_by_topic(event->topic, event->topic_len);
+            bool position_topic = false;
+            mqtt_entity_t *entity = find_entity_by_topic(event->topic, event->topic_len, &position_topic);
             if (!entity) {
                 break;
             }
@@ -1218,8 +2086,7 @@ static void mqtt_event_handler(void *arg, esp_event_base_t base, int32_t event_i
             if (strcmp(entity->component, "switch") == 0) {
                 err = apply_relay_command(entity, event->data, event->data_len);
             } else if (strcmp(entity->component, "cover") == 0) {
-                err = apply_cover_command(entity, event->data, event->data_len,
-                                          entity_uses_position_topic(entity, event->topic, event->topic_len));
+                err = apply_cover_command(entity, event->data, event->data_len, position_topic);
             } else if (strcmp(entity->component, "number") == 0) {
                 err = apply_number_command(entity, event->data, event->data_len);
             } else {
@@ -1275,28 +2142,30 @@ static void modules_runtime_changed_cb(void *ctx)
 
 esp_err_t mqtt_mgr_notify_runtime_changed(void)
 {
+    modules_changes_t changes;
+    esp_err_t err;
+    bool added = false;
+
     if (!s_cfg.enabled || !s_connected) {
         return ESP_OK;
     }
-    cJSON *status = modules_build_status_json();
-    if (!status) {
-        return ESP_ERR_NO_MEM;
-    }
-    bool added = sync_entities_from_status(status);
-    cJSON_Delete(status);
-    if (added) {
-        for (int i = 0; i < s_entity_count; ++i) {
-            if (s_entities[i].supports_command) {
-                (void)esp_mqtt_client_subscribe(s_client, s_entities[i].command_topic, 1);
-                if (s_entities[i].set_position_topic[0] != 0) {
-                    (void)esp_mqtt_client_subscribe(s_client, s_entities[i].set_position_topic, 1);
-                }
-            }
-            (void)publish_discovery_entity(&s_entities[i]);
+
+    xSemaphoreTake(s_state_lock, portMAX_DELAY);
+    modules_get_changes_since(s_change_seq, &changes);
+    err = load_status_snapshot_locked();
+    if (err == ESP_OK) {
+        added = sync_entities_from_status_locked();
+        if (!added) {
+            s_change_seq = changes.seq;
+            err = publish_states_locked(&changes, false, true);
         }
-        return publish_all_states();
     }
-    return publish_state_snapshot(false, true);
+    publish_button_events_locked();
+    xSemaphoreGive(s_state_lock);
+    if (err == ESP_OK && added) {
+        request_sync(MQTT_SYNC_SUBSCRIBE);
+    }
+    return err;
 }
 
 esp_err_t mqtt_mgr_start_from_cfg(const cJSON *cfg)
@@ -1307,19 +2176,21 @@ esp_err_t mqtt_mgr_start_from_cfg(const cJSON *cfg)
         return err;
     }
 
-    err = ensure_flush_task();
+    err = ensure_worker_task();
     if (err != ESP_OK) {
         return err;
     }
 
     s_cfg = next_cfg;
+    parse_publish_overrides(cfg);
     cJSON *status = modules_build_status_json();
     if (!status) {
         return ESP_ERR_NO_MEM;
     }
     build_entities_from_status(status);
     cJSON_Delete(status);
-    modules_set_runtime_callback(modules_runtime_changed_cb, NULL);
+    (void)modules_get_button_events_since(0, NULL, 0, &s_button_event_seq);
+    (void)modules_add_runtime_callback(modules_runtime_changed_cb, NULL);
 
     if (!s_cfg.enabled) {
         ESP_LOGI(TAG, "MQTT disabled in config");
@@ -1342,6 +2213,8 @@ esp_err_t mqtt_mgr_start_from_cfg(const cJSON *cfg)
         .session.last_will.qos = 1,
         .session.last_will.retain = 1,
         .network.reconnect_timeout_ms = 5000,
+        .buffer.size = MQTT_BUFFER_SIZE,
+        .outbox.limit = MQTT_OUTBOX_LIMIT,
     };
 
     s_client = esp_mqtt_client_init(&mqtt_cfg);
@@ -3,6 +3,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
+#include <unistd.h>
 
 #include "cJSON.h"
 #include "esp_app_desc.h"
@@ -18,16 +20,32 @@
 #include "app_config.h"
 #include "core/cfg_json.h"
 #include "core/modules.h"
+#include "core/perf_probe.h"
 #include "core/system_log.h"
 #include "net/dns_server.h"
+#include "net/json_stream.h"
 #include "net/mqtt_mgr.h"
-#include "net/web_ui.h"
+#include "web_ui_gz.h"
 #include "net/wifi_mgr.h"
 
 static const char *TAG = "web";
 static httpd_handle_t s_server = NULL;
 static const size_t OTA_RECV_CHUNK = 4096;
 
+#define WEB_STREAM_MAX_CLIENTS 4
+#define WEB_STREAM_SUBPROTOCOL "esp32-stream"
+#define WEB_STREAM_AUTH_PREFIX "auth."
+
+#if !CONFIG_HTTPD_WS_PRE_HANDSHAKE_CB_SUPPORT
+#error "/api/stream authenticates in the pre-handshake callback; enable CONFIG_HTTPD_WS_PRE_HANDSHAKE_CB_SUPPORT"
+#endif
+
+// Live status WebSocket clients. Only touched from the httpd task (handlers and queued work).
+static int s_stream_fds[WEB_STREAM_MAX_CLIENTS] = {-1, -1, -1, -1};
+static int s_stream_clients = 0;
+static uint32_t s_stream_seq = 0;
+static volatile bool s_stream_push_queued = false;
+
 typedef struct {
     cJSON *cfg_dup;
 } apply_ctx_t;
@@ -82,11 +100,15 @@ static bool is_auth_enabled(void)
     return jbool(auth, "enable", false) && password[0] != 0;
 }
 
+static bool auth_token_valid(const char *provided)
+{
+    const char *expected = jstr(get_web_auth_cfg(), "password", "");
+    return provided && strcmp(provided, expected) == 0;
+}
+
 static esp_err_t require_auth(httpd_req_t *req)
 {
     char provided[96] = {0};
-    const cJSON *auth = get_web_auth_cfg();
-    const char *expected = jstr(auth, "password", "");
 
     if (!is_auth_enabled()) {
         return ESP_OK;
@@ -100,7 +122,7 @@ static esp_err_t require_auth(httpd_req_t *req)
     }
 
     if (httpd_req_get_hdr_value_str(req, "X-Auth-Token", provided, sizeof(provided)) != ESP_OK ||
-        strcmp(provided, expected) != 0) {
+        !auth_token_valid(provided)) {
         system_log_write("web", "warn", "Rejected API request with invalid auth token");
         httpd_resp_set_status(req, "401 Unauthorized");
         httpd_resp_set_hdr(req, "Cache-Control", "no-store");
@@ -133,7 +155,7 @@ static esp_err_t schedule_apply_from_current_cfg(void)
         return ESP_ERR_NO_MEM;
     }
 
-    ctx->cfg_dup = cJSON_Duplicate((cJSON *)cfg_json_get(), 1);
+    ctx->cfg_dup = cfg_json_get_copy();
     if (!ctx->cfg_dup) {
         free(ctx);
         return ESP_ERR_NO_MEM;
@@ -148,22 +170,29 @@ static esp_err_t schedule_apply_from_current_cfg(void)
     return ESP_OK;
 }
 
-static esp_err_t json_send(httpd_req_t *req, cJSON *obj, int status_code)
+static esp_err_t json_stream_send(httpd_req_t *req, const cJSON *obj)
 {
-    char *out = cJSON_PrintUnformatted(obj);
-    if (!out) {
-        return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "oom");
+    json_stream_t js;
+
+    httpd_resp_set_type(req, "application/json");
+    json_stream_init(&js, req);
+    json_stream_item(&js, NULL, obj);
+    esp_err_t err = json_stream_finish(&js);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Streaming %s failed: %s", req->uri, esp_err_to_name(err));
     }
+    return err;
+}
 
+static esp_err_t json_send(httpd_req_t *req, const cJSON *obj, int status_code)
+{
     if (status_code != 200) {
         char st[32];
         snprintf(st, sizeof(st), "%d", status_code);
         httpd_resp_set_status(req, st);
     }
 
-    httpd_resp_set_type(req, "application/json");
-    httpd_resp_send(req, out, HTTPD_RESP_USE_STRLEN);
-    free(out);
+    (void)json_stream_send(req, obj);
     return ESP_OK;
 }
 
@@ -267,10 +296,83 @@ static void ota_restart_task(void *arg)
     esp_restart();
 }
 
+// Only the gzip blob is linked, so the page can be served to clients that accept gzip. No header means
+// any coding is acceptable; otherwise gzip (or *) must be listed without q=0.
+static bool accepts_gzip(httpd_req_t *req)
+{
+    char accept[128];
+    size_t len = httpd_req_get_hdr_value_len(req, "Accept-Encoding");
+
+    if (len == 0) {
+        return true;
+    }
+    if (len >= sizeof(accept) || httpd_req_get_hdr_value_str(req, "Accept-Encoding", accept, sizeof(accept)) != ESP_OK) {
+        // Browsers send short lists; read an oversized one as accepting rather than locking it out.
+        return true;
+    }
+
+    // An explicit gzip entry wins over the * wildcard.
+    bool wildcard = false;
+    char *save = NULL;
+    for (char *tok = strtok_r(accept, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+        char *params = strchr(tok, ';');
+        if (params) {
+            *params++ = 0;
+        }
+        tok += strspn(tok, " \t");
+        tok[strcspn(tok, " \t")] = 0;
+        const char *q = params ? strstr(params, "q=") : NULL;
+        bool allowed = !q || strtod(q + 2, NULL) > 0.0;
+        if (strcasecmp(tok, "gzip") == 0) {
+            return allowed;
+        }
+        if (strcmp(tok, "*") == 0) {
+            wildcard = allowed;
+        }
+    }
+    return wildcard;
+}
+
 static esp_err_t handle_root(httpd_req_t *req)
 {
+    char if_none_match[96];
+
+    // The response depends on Accept-Encoding, so caches must key on it.
+    httpd_resp_set_hdr(req, "Vary", "Accept-Encoding");
+    if (!accepts_gzip(req)) {
+        httpd_resp_set_status(req, "406 Not Acceptable");
+        httpd_resp_set_type(req, "text/plain");
+        return httpd_resp_send(req, "gzip encoding required", HTTPD_RESP_USE_STRLEN);
+    }
+
+    // no-cache still lets the browser keep the page; it just revalidates, which costs a 304 here.
+    httpd_resp_set_hdr(req, "ETag", WEB_INDEX_HTML_GZ_ETAG);
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+    if (httpd_req_get_hdr_value_str(req, "If-None-Match", if_none_match, sizeof(if_none_match)) == ESP_OK &&
+        strstr(if_none_match, WEB_INDEX_HTML_GZ_ETAG)) {
+        httpd_resp_set_status(req, "304 Not Modified");
+        return httpd_resp_send(req, NULL, 0);
+    }
+
     httpd_resp_set_type(req, "text/html; charset=utf-8");
-    return httpd_resp_send(req, WEB_INDEX_HTML, HTTPD_RESP_USE_STRLEN);
+    httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
+    return httpd_resp_send(req, (const char *)WEB_INDEX_HTML_GZ, sizeof(WEB_INDEX_HTML_GZ));
+}
+
+static esp_err_t send_cfg_visitor(const cJSON *cfg, void *ctx)
+{
+    return json_stream_send((httpd_req_t *)ctx, cfg);
+}
+
+// Streams the live tree under the config lock instead of a copy, so peak heap stays at one chunk.
+// An apply or the reset button waits for the send; the socket send timeout bounds a slow client.
+static esp_err_t send_cfg(httpd_req_t *req)
+{
+    esp_err_t err = cfg_json_visit(send_cfg_visitor, req);
+    if (err == ESP_ERR_INVALID_STATE) {
+        return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "config unavailable");
+    }
+    return err;
 }
 
 static esp_err_t handle_get_config(httpd_req_t *req)
@@ -280,14 +382,7 @@ static esp_err_t handle_get_config(httpd_req_t *req)
         return auth_err;
     }
 
-    const cJSON *cfg = cfg_json_get();
-    cJSON *dup = cJSON_Duplicate((cJSON *)cfg, 1);
-    if (!dup) {
-        return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "oom");
-    }
-    esp_err_t r = json_send(req, dup, 200);
-    cJSON_Delete(dup);
-    return r;
+    return send_cfg(req);
 }
 
 static esp_err_t handle_post_config(httpd_req_t *req)
@@ -475,13 +570,233 @@ static esp_err_t handle_get_modules(httpd_req_t *req)
         return auth_err;
     }
 
-    cJSON *st = modules_build_status_json();
-    if (!st) {
-        return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "oom");
+    // Same document as modules_build_status_json, built and sent one entity at a time so heap use does
+    // not grow with the entity count. Each entity is read under its own lock hold.
+    static const struct {
+        const char *key;
+        modules_entity_kind_t kind;
+    } k_sections[] = {
+        {"outputs", MODULES_ENTITY_OUTPUT},
+        {"inputs", MODULES_ENTITY_INPUT},
+        {"sensors", MODULES_ENTITY_SENSOR},
+        {"buttons", MODULES_ENTITY_BUTTON},
+    };
+    json_stream_t js;
+
+    httpd_resp_set_type(req, "application/json");
+    json_stream_init(&js, req);
+    json_stream_begin_object(&js, NULL);
+    for (size_t s = 0; s < sizeof(k_sections) / sizeof(k_sections[0]); ++s) {
+        json_stream_begin_array(&js, k_sections[s].key);
+        for (int i = 0;; ++i) {
+            cJSON *item = modules_build_entity_status_json(k_sections[s].kind, i);
+            if (!item) {
+                break;
+            }
+            json_stream_item(&js, NULL, item);
+            cJSON_Delete(item);
+        }
+        json_stream_end_array(&js);
     }
-    esp_err_t r = json_send(req, st, 200);
-    cJSON_Delete(st);
-    return r;
+    json_stream_bool(&js, "any_output_on", modules_is_any_output_on());
+    json_stream_end_object(&js);
+    esp_err_t err = json_stream_finish(&js);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Streaming %s failed: %s", req->uri, esp_err_to_name(err));
+    }
+    return err;
+}
+
+static int hex_value(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+// Decodes the hex text into out as a string; false if it is malformed or does not fit.
+static bool hex_decode_str(const char *hex, char *out, size_t out_size)
+{
+    size_t len = strlen(hex);
+
+    if (len % 2 != 0 || len / 2 >= out_size) {
+        return false;
+    }
+    for (size_t i = 0; i < len / 2; ++i) {
+        int hi = hex_value(hex[2 * i]);
+        int lo = hex_value(hex[2 * i + 1]);
+        if (hi < 0 || lo < 0 || (hi | lo) == 0) {
+            return false;
+        }
+        out[i] = (char)((hi << 4) | lo);
+    }
+    out[len / 2] = 0;
+    return true;
+}
+
+// Browsers cannot set headers on a WebSocket upgrade, and a ?token= would end up in logs and history,
+// so the UI offers the token hex-encoded as a second subprotocol, "auth.<hex>". Other clients may
+// send X-Auth-Token instead.
+static bool stream_auth_ok(httpd_req_t *req)
+{
+    char protocols[256] = {0};
+    char token[96] = {0};
+    char *save = NULL;
+
+    if (!is_auth_enabled()) {
+        return true;
+    }
+    if (httpd_req_get_hdr_value_str(req, "X-Auth-Token", token, sizeof(token)) == ESP_OK) {
+        return auth_token_valid(token);
+    }
+    if (httpd_req_get_hdr_value_str(req, "Sec-WebSocket-Protocol", protocols, sizeof(protocols)) != ESP_OK) {
+        return false;
+    }
+    for (char *p = strtok_r(protocols, ", ", &save); p; p = strtok_r(NULL, ", ", &save)) {
+        if (strncmp(p, WEB_STREAM_AUTH_PREFIX, strlen(WEB_STREAM_AUTH_PREFIX)) == 0) {
+            return hex_decode_str(p + strlen(WEB_STREAM_AUTH_PREFIX), token, sizeof(token)) &&
+                   auth_token_valid(token);
+        }
+    }
+    return false;
+}
+
+// Runs before the server answers the upgrade, so a bad token gets a plain 401 and no socket.
+static esp_err_t stream_pre_handshake(httpd_req_t *req)
+{
+    if (stream_auth_ok(req)) {
+        return ESP_OK;
+    }
+    system_log_write("web", "warn", "Rejected live stream with invalid auth token");
+    httpd_resp_set_status(req, "401 Unauthorized");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    httpd_resp_send(req, "auth required", HTTPD_RESP_USE_STRLEN);
+    return ESP_FAIL;
+}
+
+static void stream_remove_fd(int fd)
+{
+    for (int i = 0; i < WEB_STREAM_MAX_CLIENTS; ++i) {
+        if (s_stream_fds[i] == fd) {
+            s_stream_fds[i] = -1;
+            s_stream_clients--;
+        }
+    }
+}
+
+static esp_err_t stream_send_json(int fd, httpd_req_t *req, const cJSON *obj)
+{
+    char *payload = cJSON_PrintUnformatted(obj);
+    if (!payload) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    httpd_ws_frame_t frame = {
+        .final = true,
+        .type = HTTPD_WS_TYPE_TEXT,
+        .payload = (uint8_t *)payload,
+        .len = strlen(payload),
+    };
+    esp_err_t err = req ? httpd_ws_send_frame(req, &frame) : httpd_ws_send_frame_async(s_server, fd, &frame);
+    free(payload);
+    return err;
+}
+
+static void stream_push_work(void *arg)
+{
+    (void)arg;
+    s_stream_push_queued = false;
+    if (s_stream_clients == 0) {
+        return;
+    }
+
+    cJSON *delta = NULL;
+    if (modules_build_status_delta_json(s_stream_seq, &s_stream_seq, &delta) != ESP_OK || !delta) {
+        return;
+    }
+    for (int i = 0; i < WEB_STREAM_MAX_CLIENTS; ++i) {
+        int fd = s_stream_fds[i];
+        if (fd < 0) {
+            continue;
+        }
+        if (httpd_ws_get_fd_info(s_server, fd) != HTTPD_WS_CLIENT_WEBSOCKET ||
+            stream_send_json(fd, NULL, delta) != ESP_OK) {
+            stream_remove_fd(fd);
+        }
+    }
+    cJSON_Delete(delta);
+}
+
+static void stream_runtime_changed_cb(void *ctx)
+{
+    (void)ctx;
+    if (!s_server || s_stream_clients == 0 || s_stream_push_queued) {
+        return;
+    }
+    s_stream_push_queued = true;
+    if (httpd_queue_work(s_server, stream_push_work, NULL) != ESP_OK) {
+        s_stream_push_queued = false;
+    }
+}
+
+static void web_close_socket(httpd_handle_t hd, int sockfd)
+{
+    (void)hd;
+    stream_remove_fd(sockfd);
+    close(sockfd);
+}
+
+static esp_err_t handle_stream(httpd_req_t *req)
+{
+    if (req->method == HTTP_GET) {
+        int fd = httpd_req_to_sockfd(req);
+        int slot = -1;
+
+        for (int i = 0; i < WEB_STREAM_MAX_CLIENTS && slot < 0; ++i) {
+            if (s_stream_fds[i] < 0) {
+                slot = i;
+            }
+        }
+        if (slot < 0) {
+            ESP_LOGW(TAG, "Live stream client limit reached");
+            return ESP_FAIL;
+        }
+
+        // The full status goes out before the client is registered so deltas can only follow it.
+        cJSON *st = modules_build_status_json();
+        if (!st) {
+            return ESP_ERR_NO_MEM;
+        }
+        cJSON_AddBoolToObject(st, "full", true);
+        esp_err_t err = stream_send_json(fd, req, st);
+        cJSON_Delete(st);
+        if (err != ESP_OK) {
+            return err;
+        }
+        s_stream_fds[slot] = fd;
+        s_stream_clients++;
+        return ESP_OK;
+    }
+
+    // Clients have nothing to say; drain and drop whatever they send.
+    uint8_t buf[64];
+    httpd_ws_frame_t frame = {0};
+    esp_err_t err = httpd_ws_recv_frame(req, &frame, 0);
+    if (err != ESP_OK) {
+        return err;
+    }
+    if (frame.len > sizeof(buf)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    frame.payload = buf;
+    return frame.len > 0 ? httpd_ws_recv_frame(req, &frame, frame.len) : ESP_OK;
 }
 
 static esp_err_t handle_get_runtime(httpd_req_t *req)
@@ -554,23 +869,8 @@ static esp_err_t handle_get_backup(httpd_req_t *req)
         return auth_err;
     }
 
-    cJSON *dup = cJSON_Duplicate((cJSON *)cfg_json_get(), 1);
-    char *payload;
-    if (!dup) {
-        return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "oom");
-    }
-
-    payload = cJSON_PrintUnformatted(dup);
-    cJSON_Delete(dup);
-    if (!payload) {
-        return httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "oom");
-    }
-
-    httpd_resp_set_type(req, "application/json");
     httpd_resp_set_hdr(req, "Content-Disposition", "attachment; filename=\"esp32-config-backup.json\"");
-    esp_err_t err = httpd_resp_send(req, payload, HTTPD_RESP_USE_STRLEN);
-    free(payload);
-    return err;
+    return send_cfg(req);
 }
 
 static esp_err_t handle_post_restore(httpd_req_t *req)
@@ -636,11 +936,71 @@ static esp_err_t handle_get_system(httpd_req_t *req)
     cJSON_AddNumberToObject(root, "sta_rssi", wifi_mgr_get_sta_rssi());
     cJSON_AddStringToObject(root, "fw_build_date", app_desc ? app_desc->date : "");
     cJSON_AddStringToObject(root, "fw_build_time", app_desc ? app_desc->time : "");
+
+    modules_lock_stats_t lock_stats = {0};
+    modules_get_lock_stats(&lock_stats, false);
+    cJSON *lock = cJSON_AddObjectToObject(root, "modules_lock");
+    cJSON_AddNumberToObject(lock, "acquisitions", lock_stats.acquisitions);
+    cJSON_AddNumberToObject(lock, "max_hold_us", lock_stats.max_hold_us);
+    cJSON_AddNumberToObject(lock, "avg_hold_us",
+                            lock_stats.acquisitions ? (double)(lock_stats.total_hold_us / lock_stats.acquisitions) : 0);
+    cJSON *hist = cJSON_AddArrayToObject(lock, "hold_hist_log2_us");
+    for (int i = 0; i < MODULES_LOCK_HIST_BUCKETS; ++i) {
+        cJSON_AddItemToArray(hist, cJSON_CreateNumber(lock_stats.hold_hist[i]));
+    }
     esp_err_t err = json_send(req, root, 200);
     cJSON_Delete(root);
     return err;
 }
 
+// Hot-path timings for before/after comparisons; ?reset=1 clears the probes after reading them.
+static esp_err_t handle_get_perf(httpd_req_t *req)
+{
+    esp_err_t auth_err = require_auth(req);
+    if (auth_err != ESP_OK) {
+        return auth_err;
+    }
+
+    char query[32] = {0};
+    char reset_value[8] = {0};
+    bool reset = httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK &&
+                 httpd_query_key_value(query, "reset", reset_value, sizeof(reset_value)) == ESP_OK &&
+                 strcmp(reset_value, "1") == 0;
+
+    modules_counts_t counts;
+    modules_get_counts(&counts);
+
+    json_stream_t js;
+    httpd_resp_set_type(req, "application/json");
+    json_stream_init(&js, req);
+    json_stream_begin_object(&js, NULL);
+    json_stream_begin_object(&js, "entities");
+    json_stream_int(&js, "outputs", counts.outputs);
+    json_stream_int(&js, "inputs", counts.inputs);
+    json_stream_int(&js, "buttons", counts.buttons);
+    json_stream_int(&js, "sensors", counts.sensors);
+    json_stream_end_object(&js);
+    for (int id = 0; id < PERF_PROBE_COUNT; ++id) {
+        perf_probe_stats_t stats;
+        perf_probe_get((perf_probe_id_t)id, &stats, reset);
+        json_stream_begin_object(&js, perf_probe_name((perf_probe_id_t)id));
+        json_stream_number(&js, "count", stats.count);
+        json_stream_number(&js, "avg_us", stats.count ? (double)(stats.total_us / stats.count) : 0);
+        json_stream_number(&js, "max_us", stats.max_us);
+        if (stats.units) {
+            json_stream_number(&js, "ns_per_unit", (double)((stats.total_us * 1000ULL) / stats.units));
+        }
+        json_stream_begin_array(&js, "hist_log2_us");
+        for (int i = 0; i < PERF_PROBE_HIST_BUCKETS; ++i) {
+            json_stream_number(&js, NULL, stats.hist[i]);
+        }
+        json_stream_end_array(&js);
+        json_stream_end_object(&js);
+    }
+    json_stream_end_object(&js);
+    return json_stream_finish(&js);
+}
+
 static esp_err_t handle_get_events(httpd_req_t *req)
 {
     esp_err_t auth_err = require_auth(req);
@@ -728,7 +1088,8 @@ esp_err_t web_server_start(void)
 
     httpd_config_t conf = HTTPD_DEFAULT_CONFIG();
     conf.uri_match_fn = httpd_uri_match_wildcard;
-    conf.max_uri_handlers = 20;
+    conf.max_uri_handlers = 24;
+    conf.close_fn = web_close_socket;
 
     esp_err_t err = httpd_start(&s_server, &conf);
     if (err != ESP_OK) {
@@ -742,12 +1103,19 @@ esp_err_t web_server_start(void)
     httpd_uri_t factory_reset = {.uri = "/api/factory-reset", .method = HTTP_POST, .handler = handle_factory_reset};
     httpd_uri_t ota = {.uri = "/api/ota", .method = HTTP_POST, .handler = handle_ota_upload};
     httpd_uri_t mods = {.uri = "/api/modules", .method = HTTP_GET, .handler = handle_get_modules};
+    httpd_uri_t stream = {.uri = "/api/stream",
+                          .method = HTTP_GET,
+                          .handler = handle_stream,
+                          .is_websocket = true,
+                          .supported_subprotocol = WEB_STREAM_SUBPROTOCOL,
+                          .ws_pre_handshake_cb = stream_pre_handshake};
     httpd_uri_t runtime = {.uri = "/api/runtime", .method = HTTP_GET, .handler = handle_get_runtime};
     httpd_uri_t wifi_scan = {.uri = "/api/wifi/scan", .method = HTTP_GET, .handler = handle_wifi_scan};
     httpd_uri_t backup = {.uri = "/api/backup", .method = HTTP_GET, .handler = handle_get_backup};
     httpd_uri_t restore = {.uri = "/api/restore", .method = HTTP_POST, .handler = handle_post_restore};
     httpd_uri_t system = {.uri = "/api/system", .method = HTTP_GET, .handler = handle_get_system};
     httpd_uri_t events = {.uri = "/api/events", .method = HTTP_GET, .handler = handle_get_events};
+    httpd_uri_t perf = {.uri = "/api/perf", .method = HTTP_GET, .handler = handle_get_perf};
     httpd_uri_t act = {.uri = "/api/modules/*", .method = HTTP_POST, .handler = handle_module_action};
     httpd_uri_t u204 = {.uri = "/generate_204", .method = HTTP_GET, .handler = handle_generate_204};
     httpd_uri_t uios = {.uri = "/hotspot-detect.html", .method = HTTP_GET, .handler = captive_redirect_to_root};
@@ -762,12 +1130,14 @@ esp_err_t web_server_start(void)
     httpd_register_uri_handler(s_server, &factory_reset);
     httpd_register_uri_handler(s_server, &ota);
     httpd_register_uri_handler(s_server, &mods);
+    httpd_register_uri_handler(s_server, &stream);
     httpd_register_uri_handler(s_server, &runtime);
     httpd_register_uri_handler(s_server, &wifi_scan);
     httpd_register_uri_handler(s_server, &backup);
     httpd_register_uri_handler(s_server, &restore);
     httpd_register_uri_handler(s_server, &system);
     httpd_register_uri_handler(s_server, &events);
+    httpd_register_uri_handler(s_server, &perf);
     httpd_register_uri_handler(s_server, &act);
     httpd_register_uri_handler(s_server, &u204);
     httpd_register_uri_handler(s_server, &uios);
@@ -775,5 +1145,6 @@ esp_err_t web_server_start(void)
     httpd_register_uri_handler(s_server, &uncsi);
     httpd_register_uri_handler(s_server, &any);
 
+    (void)modules_add_runtime_callback(stream_runtime_changed_cb, NULL);
     return ESP_OK;
 }
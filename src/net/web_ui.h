@@ -48,6 +48,10 @@ static const char *WEB_INDEX_HTML =
 "<div class='row'>"
 "<div><label id='lbl_discovery_prefix' for='mqtt_discovery_prefix'></label><input id='mqtt_discovery_prefix'/></div>"
 "</div>"
+"<div class='row'>"
+"<div><label id='lbl_mqtt_state_mode' for='mqtt_state_mode'></label><select id='mqtt_state_mode'><option value='entity'>entity</option><option value='json'>json</option></select></div>"
+"<div><label id='lbl_mqtt_state_window_ms' for='mqtt_state_window_ms'></label><input id='mqtt_state_window_ms' type='number' min='0' max='5000'/></div>"
+"</div>"
 "<div class='row3'>"
 "<div><label><input id='mqtt_enable' type='checkbox' style='width:auto'/> <span id='lbl_mqtt_enable'></span></label></div>"
 "<div><label><input id='mqtt_discovery' type='checkbox' style='width:auto'/> <span id='lbl_mqtt_discovery'></span></label></div>"
@@ -98,7 +102,7 @@ static const char *WEB_INDEX_HTML =
 "const SENSOR_TYPES=['ds18b20_bus','aht20','sht3x','bme280'];"
 "const BUTTON_ACTIONS=['none','master_toggle','master_on','master_off','toggle_output','set_output','dim_step_up','dim_step_down'];"
 "const BOARD_PROFILES=['esp32-c3-supermini','esp32-c3-luatos'];"
-"const I18N={ru:{title:'ESP32-C3 MQTT',subtitle:'',scan_wifi:'\\u0421\\u043A\\u0430\\u043D\\u0438\\u0440\\u043E\\u0432\\u0430\\u0442\\u044C Wi-Fi',save_apply:'\\u0421\\u043E\\u0445\\u0440\\u0430\\u043D\\u0438\\u0442\\u044C \\u0438 \\u043F\\u0440\\u0438\\u043C\\u0435\\u043D\\u0438\\u0442\\u044C',apply_only:'\\u041F\\u0440\\u0438\\u043C\\u0435\\u043D\\u0438\\u0442\\u044C \\u0431\\u0435\\u0437 \\u0441\\u043E\\u0445\\u0440\\u0430\\u043D\\u0435\\u043D\\u0438\\u044F',factory_reset:'\\u0421\\u0431\\u0440\\u043E\\u0441 \\u043A \\u0437\\u0430\\u0432\\u043E\\u0434\\u0441\\u043A\\u0438\\u043C',connectivity:'\\u041F\\u043E\\u0434\\u043A\\u043B\\u044E\\u0447\\u0435\\u043D\\u0438\\u0435',device_name:'\\u0418\\u043C\\u044F \\u0443\\u0441\\u0442\\u0440\\u043E\\u0439\\u0441\\u0442\\u0432\\u0430',hostname:'Hostname',ap_ssid:'SSID \\u0442\\u043E\\u0447\\u043A\\u0438 \\u0434\\u043E\\u0441\\u0442\\u0443\\u043F\\u0430',ap_pass:'\\u041F\\u0430\\u0440\\u043E\\u043B\\u044C \\u0442\\u043E\\u0447\\u043A\\u0438 \\u0434\\u043E\\u0441\\u0442\\u0443\\u043F\\u0430',wifi_scan:'\\u0421\\u043F\\u0438\\u0441\\u043E\\u043A Wi-Fi',sta_ssid:'Wi\\u2011Fi \\u0441\\u0435\\u0442\\u044C / SSID \\u043A\\u043B\\u0438\\u0435\\u043D\\u0442\\u0430',sta_pass:'\\u041F\\u0430\\u0440\\u043E\\u043B\\u044C \\u043A\\u043B\\u0438\\u0435\\u043D\\u0442\\u0430',mqtt_host:'MQTT \\u0445\\u043E\\u0441\\u0442',mqtt_port:'MQTT \\u043F\\u043E\\u0440\\u0442',mqtt_user:'MQTT \\u043F\\u043E\\u043B\\u044C\\u0437\\u043E\\u0432\\u0430\\u0442\\u0435\\u043B\\u044C',mqtt_pass:'MQTT \\u043F\\u0430\\u0440\\u043E\\u043B\\u044C',topic_prefix:'\\u041F\\u0440\\u0435\\u0444\\u0438\\u043A\\u0441 \\u0442\\u043E\\u043F\\u0438\\u043A\\u043E\\u0432',client_id:'Client ID',discovery_prefix:'\\u041F\\u0440\\u0435\\u0444\\u0438\\u043A\\u0441 discovery',board_profile:'\\u041F\\u0440\\u043E\\u0444\\u0438\\u043B\\u044C \\u043F\\u043B\\u0430\\u0442\\u044B',mqtt_enabled:'\\u041F\\u043E\\u0434\\u043A\\u043B\\u044E\\u0447\\u0430\\u0442\\u044C\\u0441\\u044F \\u043A MQTT',ha_discovery:'HA discovery',retain:'Retain',gpio_policy:'\\u041F\\u043E\\u043B\\u0438\\u0442\\u0438\\u043A\\u0430 GPIO',runtime_status:'\\u0421\\u043E\\u0441\\u0442\\u043E\\u044F\\u043D\\u0438\\u0435 runtime',outputs:'\\u0412\\u044B\\u0445\\u043E\\u0434\\u044B',add_output:'\\u0414\\u043E\\u0431\\u0430\\u0432\\u0438\\u0442\\u044C \\u0432\\u044B\\u0445\\u043E\\u0434',io_title:'\\u0412\\u0445\\u043E\\u0434\\u044B \\u0438 \\u043A\\u043D\\u043E\\u043F\\u043A\\u0438',add_io:'\\u0414\\u043E\\u0431\\u0430\\u0432\\u0438\\u0442\\u044C I/O',sensors:'\\u0414\\u0430\\u0442\\u0447\\u0438\\u043A\\u0438',add_sensor:'\\u0414\\u043E\\u0431\\u0430\\u0432\\u0438\\u0442\\u044C \\u0434\\u0430\\u0442\\u0447\\u0438\\u043A',ota_title:'\\u041E\\u0431\\u043D\\u043E\\u0432\\u043B\\u0435\\u043D\\u0438\\u0435 \\u043F\\u0440\\u043E\\u0448\\u0438\\u0432\\u043A\\u0438',ota_file:'\\u0424\\u0430\\u0439\\u043B \\u043F\\u0440\\u043E\\u0448\\u0438\\u0432\\u043A\\u0438 (.bin)',ota_upload:'\\u0417\\u0430\\u0433\\u0440\\u0443\\u0437\\u0438\\u0442\\u044C \\u0438 \\u043E\\u0431\\u043D\\u043E\\u0432\\u0438\\u0442\\u044C',ota_hint:'\\u0412\\u044B\\u0431\\u0435\\u0440\\u0438\\u0442\\u0435 .bin \\u0438\\u0437 build \\u0438 \\u0434\\u043E\\u0436\\u0434\\u0438\\u0442\\u0435\\u0441\\u044C \\u043F\\u0435\\u0440\\u0435\\u0437\\u0430\\u043F\\u0443\\u0441\\u043A\\u0430 \\u0443\\u0441\\u0442\\u0440\\u043E\\u0439\\u0441\\u0442\\u0432\\u0430. \\u0412\\u043E \\u0432\\u0440\\u0435\\u043C\\u044F OTA \\u043F\\u0438\\u0442\\u0430\\u043D\\u0438\\u0435 \\u043D\\u0435 \\u043E\\u0442\\u043A\\u043B\\u044E\\u0447\\u0430\\u0442\\u044C.',ota_choose_file:'\\u0412\\u044B\\u0431\\u0435\\u0440\\u0438\\u0442\\u0435 .bin \\u0444\\u0430\\u0439\\u043B \\u043F\\u0440\\u043E\\u0448\\u0438\\u0432\\u043A\\u0438',ota_confirm:'\\u0417\\u0430\\u043B\\u0438\\u0442\\u044C \\u043F\\u0440\\u043E\\u0448\\u0438\\u0432\\u043A\\u0443 {name}? \\u0423\\u0441\\u0442\\u0440\\u043E\\u0439\\u0441\\u0442\\u0432\\u043E \\u043F\\u0435\\u0440\\u0435\\u0437\\u0430\\u0433\\u0440\\u0443\\u0437\\u0438\\u0442\\u0441\\u044F.',ota_uploading:'\\u0417\\u0430\\u0433\\u0440\\u0443\\u0437\\u043A\\u0430 \\u043F\\u0440\\u043E\\u0448\\u0438\\u0432\\u043A\\u0438...',ota_done:'\\u041F\\u0440\\u043E\\u0448\\u0438\\u0432\\u043A\\u0430 \\u0437\\u0430\\u043B\\u0438\\u0442\\u0430, \\u043F\\u0435\\u0440\\u0435\\u0437\\u0430\\u043F\\u0443\\u0441\\u043A \\u0437\\u0430\\u043F\\u043B\\u0430\\u043D\\u0438\\u0440\\u043E\\u0432\\u0430\\u043D',raw_title:'\\u0421\\u044B\\u0440\\u044B\\u0435 \\u043D\\u0430\\u0441\\u0442\\u0440\\u043E\\u0439\\u043A\\u0438',raw_subtitle:'\\u041D\\u043E\\u0440\\u043C\\u0430\\u043B\\u0438\\u0437\\u043E\\u0432\\u0430\\u043D\\u043D\\u044B\\u0439 JSON, \\u043A\\u043E\\u0442\\u043E\\u0440\\u044B\\u0439 \\u0431\\u0443\\u0434\\u0435\\u0442 \\u0441\\u043E\\u0445\\u0440\\u0430\\u043D\\u0451\\u043D \\u0432 \\u0443\\u0441\\u0442\\u0440\\u043E\\u0439\\u0441\\u0442\\u0432\\u0435.',remove:'\\u0423\\u0434\\u0430\\u043B\\u0438\\u0442\\u044C',id:'ID',name:'\\u0418\\u043C\\u044F',kind:'\\u0422\\u0438\\u043F I/O',kind_input:'\\u0412\\u0445\\u043E\\u0434',kind_button:'\\u041A\\u043D\\u043E\\u043F\\u043A\\u0430',type:'\\u0422\\u0438\\u043F',gpio:'GPIO',enabled:'\\u0412\\u043A\\u043B\\u044E\\u0447\\u0435\\u043D\\u043E',active_level:'\\u0410\\u043A\\u0442\\u0438\\u0432\\u043D\\u044B\\u0439 \\u0443\\u0440\\u043E\\u0432\\u0435\\u043D\\u044C',default_on:'\\u0412\\u043A\\u043B\\u044E\\u0447\\u0430\\u0442\\u044C \\u043F\\u043E \\u0443\\u043C\\u043E\\u043B\\u0447\\u0430\\u043D\\u0438\\u044E',freq_hz:'\\u0427\\u0430\\u0441\\u0442\\u043E\\u0442\\u0430, \\u0413\\u0446',default_level:'\\u0423\\u0440\\u043E\\u0432\\u0435\\u043D\\u044C \\u043F\\u043E \\u0443\\u043C\\u043E\\u043B\\u0447\\u0430\\u043D\\u0438\\u044E',inverted:'\\u0418\\u043D\\u0432\\u0435\\u0440\\u0441\\u0438\\u044F',pixels:'\\u041A\\u043E\\u043B\\u0438\\u0447\\u0435\\u0441\\u0442\\u0432\\u043E \\u043F\\u0438\\u043A\\u0441\\u0435\\u043B\\u0435\\u0439',color_order:'\\u041F\\u043E\\u0440\\u044F\\u0434\\u043E\\u043A \\u0446\\u0432\\u0435\\u0442\\u043E\\u0432',role:'\\u041D\\u0430\\u0437\\u043D\\u0430\\u0447\\u0435\\u043D\\u0438\\u0435',pull:'\\u041F\\u043E\\u0434\\u0442\\u044F\\u0436\\u043A\\u0430',long_press_ms:'\\u0414\\u043E\\u043B\\u0433\\u043E\\u0435 \\u043D\\u0430\\u0436\\u0430\\u0442\\u0438\\u0435, \\u043C\\u0441',short_action:'\\u041A\\u043E\\u0440\\u043E\\u0442\\u043A\\u043E\\u0435 \\u0434\\u0435\\u0439\\u0441\\u0442\\u0432\\u0438\\u0435',short_target:'\\u0426\\u0435\\u043B\\u044C \\u043A\\u043E\\u0440\\u043E\\u0442\\u043A\\u043E\\u0433\\u043E',short_value:'\\u0428\\u0430\\u0433/\\u0437\\u043D\\u0430\\u0447\\u0435\\u043D\\u0438\\u0435',long_action:'\\u0414\\u043E\\u043B\\u0433\\u043E\\u0435 \\u0434\\u0435\\u0439\\u0441\\u0442\\u0432\\u0438\\u0435',long_target:'\\u0426\\u0435\\u043B\\u044C \\u0434\\u043E\\u043B\\u0433\\u043E\\u0433\\u043E',long_value:'\\u0428\\u0430\\u0433/\\u0437\\u043D\\u0430\\u0447\\u0435\\u043D\\u0438\\u0435',poll_sec:'\\u041F\\u0435\\u0440\\u0438\\u043E\\u0434 \\u043E\\u043F\\u0440\\u043E\\u0441\\u0430, \\u0441\\u0435\\u043A',sda:'SDA',scl:'SCL',address:'\\u0410\\u0434\\u0440\\u0435\\u0441',select_network:'\\u0412\\u044B\\u0431\\u0435\\u0440\\u0438\\u0442\\u0435 \\u0441\\u0435\\u0442\\u044C \\u0438\\u043B\\u0438 \\u0432\\u0432\\u0435\\u0434\\u0438\\u0442\\u0435 \\u0432\\u0440\\u0443\\u0447\\u043D\\u0443\\u044E',found_networks:'\\u041D\\u0430\\u0439\\u0434\\u0435\\u043D\\u043E \\u0441\\u0435\\u0442\\u0435\\u0439: {count}',found_networks_cached:'\\u041F\\u043E\\u043A\\u0430\\u0437\\u0430\\u043D \\u043A\\u044D\\u0448 \\u0441\\u043A\\u0430\\u043D\\u0438\\u0440\\u043E\\u0432\\u0430\\u043D\\u0438\\u044F: {count}',msg_saved:'\\u041A\\u043E\\u043D\\u0444\\u0438\\u0433\\u0443\\u0440\\u0430\\u0446\\u0438\\u044F \\u0441\\u043E\\u0445\\u0440\\u0430\\u043D\\u0435\\u043D\\u0430',msg_apply:'\\u041F\\u0440\\u0438\\u043C\\u0435\\u043D\\u0435\\u043D\\u0438\\u0435 \\u0437\\u0430\\u043F\\u043B\\u0430\\u043D\\u0438\\u0440\\u043E\\u0432\\u0430\\u043D\\u043E',msg_saved_apply:'\\u0421\\u043E\\u0445\\u0440\\u0430\\u043D\\u0435\\u043D\\u0438\\u0435 \\u0438 \\u043F\\u0440\\u0438\\u043C\\u0435\\u043D\\u0435\\u043D\\u0438\\u0435 \\u0437\\u0430\\u043F\\u043B\\u0430\\u043D\\u0438\\u0440\\u043E\\u0432\\u0430\\u043D\\u044B',msg_reset:'\\u0421\\u0431\\u0440\\u043E\\u0441 \\u043A \\u0437\\u0430\\u0432\\u043E\\u0434\\u0441\\u043A\\u0438\\u043C \\u0437\\u0430\\u043F\\u043B\\u0430\\u043D\\u0438\\u0440\\u043E\\u0432\\u0430\\u043D',confirm_reset:'\\u0421\\u0442\\u0435\\u0440\\u0435\\u0442\\u044C \\u0432\\u0441\\u044E \\u043A\\u043E\\u043D\\u0444\\u0438\\u0433\\u0443\\u0440\\u0430\\u0446\\u0438\\u044E \\u0443\\u0441\\u0442\\u0440\\u043E\\u0439\\u0441\\u0442\\u0432\\u0430 \\u0438 \\u043F\\u0435\\u0440\\u0435\\u0437\\u0430\\u0433\\u0440\\u0443\\u0437\\u0438\\u0442\\u044C?',no_gpio_conflicts:'\\u041A\\u043E\\u043D\\u0444\\u043B\\u0438\\u043A\\u0442\\u043E\\u0432 GPIO \\u043D\\u0435 \\u043D\\u0430\\u0439\\u0434\\u0435\\u043D\\u043E.',conflicts:'\\u041A\\u043E\\u043D\\u0444\\u043B\\u0438\\u043A\\u0442\\u044B',empty_io:'\\u041F\\u043E\\u043A\\u0430 \\u043D\\u0435\\u0442 \\u0432\\u0445\\u043E\\u0434\\u043E\\u0432 \\u0438\\u043B\\u0438 \\u043A\\u043D\\u043E\\u043F\\u043E\\u043A.',mode:'\\u0440\\u0435\\u0436\\u0438\\u043C',mqtt_state:'mqtt',ap_state:'ap',connected:'\\u043F\\u043E\\u0434\\u043A\\u043B\\u044E\\u0447\\u0451\\u043D',offline:'\\u043E\\u0444\\u043B\\u0430\\u0439\\u043D',output_name:'\\u0412\\u044B\\u0445\\u043E\\u0434',io_name:'\\u0412\\u0445\\u043E\\u0434',button_name:'\\u041A\\u043D\\u043E\\u043F\\u043A\\u0430',sensor_name:'\\u0414\\u0430\\u0442\\u0447\\u0438\\u043A'},en:{title:'ESP32-C3 MQTT',subtitle:'',scan_wifi:'Scan Wi-Fi',save_apply:'Save and apply',apply_only:'Apply only',factory_reset:'Factory reset',connectivity:'Connectivity',device_name:'Device name',hostname:'Hostname',ap_ssid:'AP SSID',ap_pass:'AP password',wifi_scan:'Wi-Fi scan',sta_ssid:'Wi\\u2011Fi network / STA SSID',sta_pass:'STA password',mqtt_host:'MQTT host',mqtt_port:'MQTT port',mqtt_user:'MQTT user',mqtt_pass:'MQTT password',topic_prefix:'Topic prefix',client_id:'Client ID',discovery_prefix:'Discovery prefix',board_profile:'Board profile',mqtt_enabled:'Connect to MQTT',ha_discovery:'HA discovery',retain:'Retain',gpio_policy:'GPIO policy',runtime_status:'Runtime status',outputs:'Outputs',add_output:'Add output',io_title:'Inputs and buttons',add_io:'Add I/O',sensors:'Sensors',add_sensor:'Add sensor',ota_title:'Firmware update',ota_file:'Firmware file (.bin)',ota_upload:'Upload and update',ota_hint:'Select the compiled .bin from build and keep power connected until the device reboots. The web page may briefly disconnect during OTA.',ota_choose_file:'Select a firmware .bin file first',ota_confirm:'Upload firmware {name}? The device will reboot after the update.',ota_uploading:'Uploading firmware...',ota_done:'Firmware uploaded, reboot scheduled',raw_title:'Raw config',raw_subtitle:'Normalized JSON that will be saved into the device.',remove:'Remove',id:'ID',name:'Name',kind:'I/O kind',kind_input:'Input',kind_button:'Button',type:'Type',gpio:'GPIO',enabled:'Enabled',active_level:'Active level',default_on:'Default ON',freq_hz:'Freq Hz',default_level:'Default level',inverted:'Inverted',pixels:'Pixels',color_order:'Color order',role:'Role',pull:'Pull',long_press_ms:'Long press ms',short_action:'Short action',short_target:'Short target',short_value:'Step/value',long_action:'Long action',long_target:'Long target',long_value:'Step/value',poll_sec:'Poll sec',sda:'SDA',scl:'SCL',address:'Address',select_network:'Select a network or type manually',found_networks:'Networks found: {count}',found_networks_cached:'Cached scan results: {count}',msg_saved:'Config saved',msg_apply:'Apply scheduled',msg_saved_apply:'Save + apply scheduled',msg_reset:'Factory reset scheduled',confirm_reset:'Erase full device configuration and reboot?',no_gpio_conflicts:'No GPIO conflicts detected.',conflicts:'Conflicts',empty_io:'No inputs or buttons yet.',mode:'mode',mqtt_state:'mqtt',ap_state:'ap',connected:'connected',offline:'offline',output_name:'Output',io_name:'Input',button_name:'Button',sensor_name:'Sensor'}};"
+"const I18N={ru:{title:'ESP32-C3 MQTT',subtitle:'',scan_wifi:'\\u0421\\u043A\\u0430\\u043D\\u0438\\u0440\\u043E\\u0432\\u0430\\u0442\\u044C Wi-Fi',save_apply:'\\u0421\\u043E\\u0445\\u0440\\u0430\\u043D\\u0438\\u0442\\u044C \\u0438 \\u043F\\u0440\\u0438\\u043C\\u0435\\u043D\\u0438\\u0442\\u044C',apply_only:'\\u041F\\u0440\\u0438\\u043C\\u0435\\u043D\\u0438\\u0442\\u044C \\u0431\\u0435\\u0437 \\u0441\\u043E\\u0445\\u0440\\u0430\\u043D\\u0435\\u043D\\u0438\\u044F',factory_reset:'\\u0421\\u0431\\u0440\\u043E\\u0441 \\u043A \\u0437\\u0430\\u0432\\u043E\\u0434\\u0441\\u043A\\u0438\\u043C',connectivity:'\\u041F\\u043E\\u0434\\u043A\\u043B\\u044E\\u0447\\u0435\\u043D\\u0438\\u0435',device_name:'\\u0418\\u043C\\u044F \\u0443\\u0441\\u0442\\u0440\\u043E\\u0439\\u0441\\u0442\\u0432\\u0430',hostname:'Hostname',ap_ssid:'SSID \\u0442\\u043E\\u0447\\u043A\\u0438 \\u0434\\u043E\\u0441\\u0442\\u0443\\u043F\\u0430',ap_pass:'\\u041F\\u0430\\u0440\\u043E\\u043B\\u044C \\u0442\\u043E\\u0447\\u043A\\u0438 \\u0434\\u043E\\u0441\\u0442\\u0443\\u043F\\u0430',wifi_scan:'\\u0421\\u043F\\u0438\\u0441\\u043E\\u043A Wi-Fi',sta_ssid:'Wi\\u2011Fi \\u0441\\u0435\\u0442\\u044C / SSID \\u043A\\u043B\\u0438\\u0435\\u043D\\u0442\\u0430',sta_pass:'\\u041F\\u0430\\u0440\\u043E\\u043B\\u044C \\u043A\\u043B\\u0438\\u0435\\u043D\\u0442\\u0430',mqtt_host:'MQTT \\u0445\\u043E\\u0441\\u0442',mqtt_port:'MQTT \\u043F\\u043E\\u0440\\u0442',mqtt_user:'MQTT \\u043F\\u043E\\u043B\\u044C\\u0437\\u043E\\u0432\\u0430\\u0442\\u0435\\u043B\\u044C',mqtt_pass:'MQTT \\u043F\\u0430\\u0440\\u043E\\u043B\\u044C',topic_prefix:'\\u041F\\u0440\\u0435\\u0444\\u0438\\u043A\\u0441 \\u0442\\u043E\\u043F\\u0438\\u043A\\u043E\\u0432',client_id:'Client ID',discovery_prefix:'\\u041F\\u0440\\u0435\\u0444\\u0438\\u043A\\u0441 discovery',board_profile:'\\u041F\\u0440\\u043E\\u0444\\u0438\\u043B\\u044C \\u043F\\u043B\\u0430\\u0442\\u044B',mqtt_enabled:'\\u041F\\u043E\\u0434\\u043A\\u043B\\u044E\\u0447\\u0430\\u0442\\u044C\\u0441\\u044F \\u043A MQTT',ha_discovery:'HA discovery',retain:'Retain',state_mode:'\\u0421\\u043E\\u0441\\u0442\\u043E\\u044F\\u043D\\u0438\\u044F MQTT',state_window_ms:'\\u041E\\u043A\\u043D\\u043E \\u043E\\u0431\\u044A\\u0435\\u0434\\u0438\\u043D\\u0435\\u043D\\u0438\\u044F, \\u043C\\u0441',gpio_policy:'\\u041F\\u043E\\u043B\\u0438\\u0442\\u0438\\u043A\\u0430 GPIO',runtime_status:'\\u0421\\u043E\\u0441\\u0442\\u043E\\u044F\\u043D\\u0438\\u0435 runtime',outputs:'\\u0412\\u044B\\u0445\\u043E\\u0434\\u044B',add_output:'\\u0414\\u043E\\u0431\\u0430\\u0432\\u0438\\u0442\\u044C \\u0432\\u044B\\u0445\\u043E\\u0434',io_title:'\\u0412\\u0445\\u043E\\u0434\\u044B \\u0438 \\u043A\\u043D\\u043E\\u043F\\u043A\\u0438',add_io:'\\u0414\\u043E\\u0431\\u0430\\u0432\\u0438\\u0442\\u044C I/O',sensors:'\\u0414\\u0430\\u0442\\u0447\\u0438\\u043A\\u0438',add_sensor:'\\u0414\\u043E\\u0431\\u0430\\u0432\\u0438\\u0442\\u044C \\u0434\\u0430\\u0442\\u0447\\u0438\\u043A',ota_title:'\\u041E\\u0431\\u043D\\u043E\\u0432\\u043B\\u0435\\u043D\\u0438\\u0435 \\u043F\\u0440\\u043E\\u0448\\u0438\\u0432\\u043A\\u0438',ota_file:'\\u0424\\u0430\\u0439\\u043B \\u043F\\u0440\\u043E\\u0448\\u0438\\u0432\\u043A\\u0438 (.bin)',ota_upload:'\\u0417\\u0430\\u0433\\u0440\\u0443\\u0437\\u0438\\u0442\\u044C \\u0438 \\u043E\\u0431\\u043D\\u043E\\u0432\\u0438\\u0442\\u044C',ota_hint:'\\u0412\\u044B\\u0431\\u0435\\u0440\\u0438\\u0442\\u0435 .bin \\u0438\\u0437 build \\u0438 \\u0434\\u043E\\u0436\\u0434\\u0438\\u0442\\u0435\\u0441\\u044C \\u043F\\u0435\\u0440\\u0435\\u0437\\u0430\\u043F\\u0443\\u0441\\u043A\\u0430 \\u0443\\u0441\\u0442\\u0440\\u043E\\u0439\\u0441\\u0442\\u0432\\u0430. \\u0412\\u043E \\u0432\\u0440\\u0435\\u043C\\u044F OTA \\u043F\\u0438\\u0442\\u0430\\u043D\\u0438\\u0435 \\u043D\\u0435 \\u043E\\u0442\\u043A\\u043B\\u044E\\u0447\\u0430\\u0442\\u044C.',ota_choose_file:'\\u0412\\u044B\\u0431\\u0435\\u0440\\u0438\\u0442\\u0435 .bin \\u0444\\u0430\\u0439\\u043B \\u043F\\u0440\\u043E\\u0448\\u0438\\u0432\\u043A\\u0438',ota_confirm:'\\u0417\\u0430\\u043B\\u0438\\u0442\\u044C \\u043F\\u0440\\u043E\\u0448\\u0438\\u0432\\u043A\\u0443 {name}? \\u0423\\u0441\\u0442\\u0440\\u043E\\u0439\\u0441\\u0442\\u0432\\u043E \\u043F\\u0435\\u0440\\u0435\\u0437\\u0430\\u0433\\u0440\\u0443\\u0437\\u0438\\u0442\\u0441\\u044F.',ota_uploading:'\\u0417\\u0430\\u0433\\u0440\\u0443\\u0437\\u043A\\u0430 \\u043F\\u0440\\u043E\\u0448\\u0438\\u0432\\u043A\\u0438...',ota_done:'\\u041F\\u0440\\u043E\\u0448\\u0438\\u0432\\u043A\\u0430 \\u0437\\u0430\\u043B\\u0438\\u0442\\u0430, \\u043F\\u0435\\u0440\\u0435\\u0437\\u0430\\u043F\\u0443\\u0441\\u043A \\u0437\\u0430\\u043F\\u043B\\u0430\\u043D\\u0438\\u0440\\u043E\\u0432\\u0430\\u043D',raw_title:'\\u0421\\u044B\\u0440\\u044B\\u0435 \\u043D\\u0430\\u0441\\u0442\\u0440\\u043E\\u0439\\u043A\\u0438',raw_subtitle:'\\u041D\\u043E\\u0440\\u043C\\u0430\\u043B\\u0438\\u0437\\u043E\\u0432\\u0430\\u043D\\u043D\\u044B\\u0439 JSON, \\u043A\\u043E\\u0442\\u043E\\u0440\\u044B\\u0439 \\u0431\\u0443\\u0434\\u0435\\u0442 \\u0441\\u043E\\u0445\\u0440\\u0430\\u043D\\u0451\\u043D \\u0432 \\u0443\\u0441\\u0442\\u0440\\u043E\\u0439\\u0441\\u0442\\u0432\\u0435.',remove:'\\u0423\\u0434\\u0430\\u043B\\u0438\\u0442\\u044C',id:'ID',name:'\\u0418\\u043C\\u044F',kind:'\\u0422\\u0438\\u043F I/O',kind_input:'\\u0412\\u0445\\u043E\\u0434',kind_button:'\\u041A\\u043D\\u043E\\u043F\\u043A\\u0430',type:'\\u0422\\u0438\\u043F',gpio:'GPIO',enabled:'\\u0412\\u043A\\u043B\\u044E\\u0447\\u0435\\u043D\\u043E',active_level:'\\u0410\\u043A\\u0442\\u0438\\u0432\\u043D\\u044B\\u0439 \\u0443\\u0440\\u043E\\u0432\\u0435\\u043D\\u044C',default_on:'\\u0412\\u043A\\u043B\\u044E\\u0447\\u0430\\u0442\\u044C \\u043F\\u043E \\u0443\\u043C\\u043E\\u043B\\u0447\\u0430\\u043D\\u0438\\u044E',freq_hz:'\\u0427\\u0430\\u0441\\u0442\\u043E\\u0442\\u0430, \\u0413\\u0446',default_level:'\\u0423\\u0440\\u043E\\u0432\\u0435\\u043D\\u044C \\u043F\\u043E \\u0443\\u043C\\u043E\\u043B\\u0447\\u0430\\u043D\\u0438\\u044E',inverted:'\\u0418\\u043D\\u0432\\u0435\\u0440\\u0441\\u0438\\u044F',pixels:'\\u041A\\u043E\\u043B\\u0438\\u0447\\u0435\\u0441\\u0442\\u0432\\u043E \\u043F\\u0438\\u043A\\u0441\\u0435\\u043B\\u0435\\u0439',color_order:'\\u041F\\u043E\\u0440\\u044F\\u0434\\u043E\\u043A \\u0446\\u0432\\u0435\\u0442\\u043E\\u0432',role:'\\u041D\\u0430\\u0437\\u043D\\u0430\\u0447\\u0435\\u043D\\u0438\\u0435',pull:'\\u041F\\u043E\\u0434\\u0442\\u044F\\u0436\\u043A\\u0430',long_press_ms:'\\u0414\\u043E\\u043B\\u0433\\u043E\\u0435 \\u043D\\u0430\\u0436\\u0430\\u0442\\u0438\\u0435, \\u043C\\u0441',short_action:'\\u041A\\u043E\\u0440\\u043E\\u0442\\u043A\\u043E\\u0435 \\u0434\\u0435\\u0439\\u0441\\u0442\\u0432\\u0438\\u0435',short_target:'\\u0426\\u0435\\u043B\\u044C \\u043A\\u043E\\u0440\\u043E\\u0442\\u043A\\u043E\\u0433\\u043E',short_value:'\\u0428\\u0430\\u0433/\\u0437\\u043D\\u0430\\u0447\\u0435\\u043D\\u0438\\u0435',long_action:'\\u0414\\u043E\\u043B\\u0433\\u043E\\u0435 \\u0434\\u0435\\u0439\\u0441\\u0442\\u0432\\u0438\\u0435',long_target:'\\u0426\\u0435\\u043B\\u044C \\u0434\\u043E\\u043B\\u0433\\u043E\\u0433\\u043E',long_value:'\\u0428\\u0430\\u0433/\\u0437\\u043D\\u0430\\u0447\\u0435\\u043D\\u0438\\u0435',double_action:'\\u0414\\u0432\\u043E\\u0439\\u043D\\u043E\\u0435 \\u043D\\u0430\\u0436\\u0430\\u0442\\u0438\\u0435',double_target:'\\u0426\\u0435\\u043B\\u044C \\u0434\\u0432\\u043E\\u0439\\u043D\\u043E\\u0433\\u043E',double_value:'\\u0428\\u0430\\u0433/\\u0437\\u043D\\u0430\\u0447\\u0435\\u043D\\u0438\\u0435',triple_action:'\\u0422\\u0440\\u043E\\u0439\\u043D\\u043E\\u0435 \\u043D\\u0430\\u0436\\u0430\\u0442\\u0438\\u0435',triple_target:'\\u0426\\u0435\\u043B\\u044C \\u0442\\u0440\\u043E\\u0439\\u043D\\u043E\\u0433\\u043E',triple_value:'\\u0428\\u0430\\u0433/\\u0437\\u043D\\u0430\\u0447\\u0435\\u043D\\u0438\\u0435',hold_action:'\\u041F\\u043E\\u0432\\u0442\\u043E\\u0440 \\u043F\\u0440\\u0438 \\u0443\\u0434\\u0435\\u0440\\u0436\\u0430\\u043D\\u0438\\u0438',hold_target:'\\u0426\\u0435\\u043B\\u044C \\u043F\\u043E\\u0432\\u0442\\u043E\\u0440\\u0430',hold_value:'\\u0428\\u0430\\u0433/\\u0437\\u043D\\u0430\\u0447\\u0435\\u043D\\u0438\\u0435',multi_click_ms:'\\u041F\\u0430\\u0443\\u0437\\u0430 \\u043C\\u0435\\u0436\\u0434\\u0443 \\u043D\\u0430\\u0436\\u0430\\u0442\\u0438\\u044F\\u043C\\u0438, \\u043C\\u0441',hold_repeat_ms:'\\u041F\\u0435\\u0440\\u0438\\u043E\\u0434 \\u043F\\u043E\\u0432\\u0442\\u043E\\u0440\\u0430, \\u043C\\u0441',poll_sec:'\\u041F\\u0435\\u0440\\u0438\\u043E\\u0434 \\u043E\\u043F\\u0440\\u043E\\u0441\\u0430, \\u0441\\u0435\\u043A',sda:'SDA',scl:'SCL',address:'\\u0410\\u0434\\u0440\\u0435\\u0441',select_network:'\\u0412\\u044B\\u0431\\u0435\\u0440\\u0438\\u0442\\u0435 \\u0441\\u0435\\u0442\\u044C \\u0438\\u043B\\u0438 \\u0432\\u0432\\u0435\\u0434\\u0438\\u0442\\u0435 \\u0432\\u0440\\u0443\\u0447\\u043D\\u0443\\u044E',found_networks:'\\u041D\\u0430\\u0439\\u0434\\u0435\\u043D\\u043E \\u0441\\u0435\\u0442\\u0435\\u0439: {count}',found_networks_cached:'\\u041F\\u043E\\u043A\\u0430\\u0437\\u0430\\u043D \\u043A\\u044D\\u0448 \\u0441\\u043A\\u0430\\u043D\\u0438\\u0440\\u043E\\u0432\\u0430\\u043D\\u0438\\u044F: {count}',msg_saved:'\\u041A\\u043E\\u043D\\u0444\\u0438\\u0433\\u0443\\u0440\\u0430\\u0446\\u0438\\u044F \\u0441\\u043E\\u0445\\u0440\\u0430\\u043D\\u0435\\u043D\\u0430',msg_apply:'\\u041F\\u0440\\u0438\\u043C\\u0435\\u043D\\u0435\\u043D\\u0438\\u0435 \\u0437\\u0430\\u043F\\u043B\\u0430\\u043D\\u0438\\u0440\\u043E\\u0432\\u0430\\u043D\\u043E',msg_saved_apply:'\\u0421\\u043E\\u0445\\u0440\\u0430\\u043D\\u0435\\u043D\\u0438\\u0435 \\u0438 \\u043F\\u0440\\u0438\\u043C\\u0435\\u043D\\u0435\\u043D\\u0438\\u0435 \\u0437\\u0430\\u043F\\u043B\\u0430\\u043D\\u0438\\u0440\\u043E\\u0432\\u0430\\u043D\\u044B',msg_reset:'\\u0421\\u0431\\u0440\\u043E\\u0441 \\u043A \\u0437\\u0430\\u0432\\u043E\\u0434\\u0441\\u043A\\u0438\\u043C \\u0437\\u0430\\u043F\\u043B\\u0430\\u043D\\u0438\\u0440\\u043E\\u0432\\u0430\\u043D',confirm_reset:'\\u0421\\u0442\\u0435\\u0440\\u0435\\u0442\\u044C \\u0432\\u0441\\u044E \\u043A\\u043E\\u043D\\u0444\\u0438\\u0433\\u0443\\u0440\\u0430\\u0446\\u0438\\u044E \\u0443\\u0441\\u0442\\u0440\\u043E\\u0439\\u0441\\u0442\\u0432\\u0430 \\u0438 \\u043F\\u0435\\u0440\\u0435\\u0437\\u0430\\u0433\\u0440\\u0443\\u0437\\u0438\\u0442\\u044C?',no_gpio_conflicts:'\\u041A\\u043E\\u043D\\u0444\\u043B\\u0438\\u043A\\u0442\\u043E\\u0432 GPIO \\u043D\\u0435 \\u043D\\u0430\\u0439\\u0434\\u0435\\u043D\\u043E.',conflicts:'\\u041A\\u043E\\u043D\\u0444\\u043B\\u0438\\u043A\\u0442\\u044B',empty_io:'\\u041F\\u043E\\u043A\\u0430 \\u043D\\u0435\\u0442 \\u0432\\u0445\\u043E\\u0434\\u043E\\u0432 \\u0438\\u043B\\u0438 \\u043A\\u043D\\u043E\\u043F\\u043E\\u043A.',mode:'\\u0440\\u0435\\u0436\\u0438\\u043C',mqtt_state:'mqtt',ap_state:'ap',connected:'\\u043F\\u043E\\u0434\\u043A\\u043B\\u044E\\u0447\\u0451\\u043D',offline:'\\u043E\\u0444\\u043B\\u0430\\u0439\\u043D',output_name:'\\u0412\\u044B\\u0445\\u043E\\u0434',io_name:'\\u0412\\u0445\\u043E\\u0434',button_name:'\\u041A\\u043D\\u043E\\u043F\\u043A\\u0430',sensor_name:'\\u0414\\u0430\\u0442\\u0447\\u0438\\u043A'},en:{title:'ESP32-C3 MQTT',subtitle:'',scan_wifi:'Scan Wi-Fi',save_apply:'Save and apply',apply_only:'Apply only',factory_reset:'Factory reset',connectivity:'Connectivity',device_name:'Device name',hostname:'Hostname',ap_ssid:'AP SSID',ap_pass:'AP password',wifi_scan:'Wi-Fi scan',sta_ssid:'Wi\\u2011Fi network / STA SSID',sta_pass:'STA password',mqtt_host:'MQTT host',mqtt_port:'MQTT port',mqtt_user:'MQTT user',mqtt_pass:'MQTT password',topic_prefix:'Topic prefix',client_id:'Client ID',discovery_prefix:'Discovery prefix',board_profile:'Board profile',mqtt_enabled:'Connect to MQTT',ha_discovery:'HA discovery',retain:'Retain',state_mode:'MQTT state mode',state_window_ms:'Coalescing window ms',gpio_policy:'GPIO policy',runtime_status:'Runtime status',outputs:'Outputs',add_output:'Add output',io_title:'Inputs and buttons',add_io:'Add I/O',sensors:'Sensors',add_sensor:'Add sensor',ota_title:'Firmware update',ota_file:'Firmware file (.bin)',ota_upload:'Upload and update',ota_hint:'Select the compiled .bin from build and keep power connected until the device reboots. The web page may briefly disconnect during OTA.',ota_choose_file:'Select a firmware .bin file first',ota_confirm:'Upload firmware {name}? The device will reboot after the update.',ota_uploading:'Uploading firmware...',ota_done:'Firmware uploaded, reboot scheduled',raw_title:'Raw config',raw_subtitle:'Normalized JSON that will be saved into the device.',remove:'Remove',id:'ID',name:'Name',kind:'I/O kind',kind_input:'Input',kind_button:'Button',type:'Type',gpio:'GPIO',enabled:'Enabled',active_level:'Active level',default_on:'Default ON',freq_hz:'Freq Hz',default_level:'Default level',inverted:'Inverted',pixels:'Pixels',color_order:'Color order',role:'Role',pull:'Pull',long_press_ms:'Long press ms',short_action:'Short action',short_target:'Short target',short_value:'Step/value',long_action:'Long action',long_target:'Long target',long_value:'Step/value',double_action:'Double action',double_target:'Double target',double_value:'Step/value',triple_action:'Triple action',triple_target:'Triple target',triple_value:'Step/value',hold_action:'Hold repeat action',hold_target:'Hold target',hold_value:'Step/value',multi_click_ms:'Multi-click gap ms',hold_repeat_ms:'Hold repeat ms',poll_sec:'Poll sec',sda:'SDA',scl:'SCL',address:'Address',select_network:'Select a network or type manually',found_networks:'Networks found: {count}',found_networks_cached:'Cached scan results: {count}',msg_saved:'Config saved',msg_apply:'Apply scheduled',msg_saved_apply:'Save + apply scheduled',msg_reset:'Factory reset scheduled',confirm_reset:'Erase full device configuration and reboot?',no_gpio_conflicts:'No GPIO conflicts detected.',conflicts:'Conflicts',empty_io:'No inputs or buttons yet.',mode:'mode',mqtt_state:'mqtt',ap_state:'ap',connected:'connected',offline:'offline',output_name:'Output',io_name:'Input',button_name:'Button',sensor_name:'Sensor'}};"
 "const OUTPUT_TYPE_LABELS={relay:{ru:'\\u0420\\u0435\\u043B\\u0435',en:'Relay'},pwm:{ru:'PWM',en:'PWM'},ws2812:{ru:'WS2812',en:'WS2812'},servo_3wire:{ru:'\\u0421\\u0435\\u0440\\u0432\\u043E 3-\\u043F\\u0440\\u043E\\u0432\\u043E\\u0434\\u043D\\u044B\\u0439',en:'Servo 3-wire'},servo_5wire:{ru:'\\u0421\\u0435\\u0440\\u0432\\u043E 5-\\u043F\\u0440\\u043E\\u0432\\u043E\\u0434\\u043D\\u044B\\u0439',en:'Servo 5-wire'},clock_4x4094:{ru:'\\u0427\\u0430\\u0441\\u044B 4x4094',en:'Clock 4x4094'},stepper_28byj:{ru:'\\u0428\\u0430\\u0433\\u043E\\u0432\\u044B\\u0439 28BYJ-48',en:'Stepper 28BYJ-48'},stepper_a4988:{ru:'\\u0428\\u0430\\u0433\\u043E\\u0432\\u044B\\u0439 A4988',en:'Stepper A4988'}};"
 "const INPUT_ROLE_LABELS={generic_binary:{ru:'\\u041E\\u0431\\u0449\\u0438\\u0439 \\u0432\\u0445\\u043E\\u0434',en:'Generic binary'},motion:{ru:'\\u0414\\u0432\\u0438\\u0436\\u0435\\u043D\\u0438\\u0435',en:'Motion'},presence:{ru:'\\u041F\\u0440\\u0438\\u0441\\u0443\\u0442\\u0441\\u0442\\u0432\\u0438\\u0435',en:'Presence'},contact:{ru:'\\u041A\\u043E\\u043D\\u0442\\u0430\\u043A\\u0442',en:'Contact'},limit:{ru:'\\u041A\\u043E\\u043D\\u0446\\u0435\\u0432\\u0438\\u043A',en:'Limit'}};"
 "const SENSOR_TYPE_LABELS={ds18b20_bus:{ru:'DS18B20 \\u0448\\u0438\\u043D\\u0430',en:'DS18B20 bus'},aht20:{ru:'AHT20',en:'AHT20'},sht3x:{ru:'SHT3X',en:'SHT3X'},bme280:{ru:'BME280',en:'BME280'}};"
@@ -108,7 +112,7 @@ static const char *WEB_INDEX_HTML =
 "const BOARD_HINTS={'esp32-c3-supermini':{ru:'',en:''},'esp32-c3-luatos':{ru:'',en:''}};"
 "const BOARD_PINOUTS={'esp32-c3-supermini':{title:'Super Mini',subtitle:'reference pinout',left:[{label:'GPIO5',gpio:5,tags:['A5','MISO']},{label:'GPIO6',gpio:6,tags:['MOSI']},{label:'GPIO7',gpio:7,tags:['SS']},{label:'GPIO8',gpio:8,tags:['SDA']},{label:'GPIO9',gpio:9,tags:['SCL']},{label:'GPIO10',gpio:10,tags:[]},{label:'GPIO20',gpio:20,tags:['RX']},{label:'GPIO21',gpio:21,tags:['TX']}],right:[{label:'5V',type:'power'},{label:'GND',type:'ground'},{label:'3V3',type:'power'},{label:'GPIO4',gpio:4,tags:['A4','SCK']},{label:'GPIO3',gpio:3,tags:['A3']},{label:'GPIO2',gpio:2,tags:['A2']},{label:'GPIO1',gpio:1,tags:['A1']},{label:'GPIO0',gpio:0,tags:['A0']}]} ,'esp32-c3-luatos':{title:'LuatOS',subtitle:'reference pinout',left:[{label:'GND',type:'ground'},{label:'5V',type:'power'},{label:'BOOT',gpio:9,tags:['BOOT']},{label:'GPIO8',gpio:8,tags:['PWM4']},{label:'GPIO4',gpio:4,tags:['A4','SDA']},{label:'GPIO5',gpio:5,tags:['A5','SCL']},{label:'3V3',type:'power'},{label:'GND',type:'ground'},{label:'GPIO11',gpio:11,tags:['VDDSPI']},{label:'GPIO7',gpio:7,tags:['SS']},{label:'GPIO6',gpio:6,tags:['PWM1']},{label:'GPIO10',gpio:10,tags:['MISO']},{label:'GPIO3',gpio:3,tags:['A3','MOSI']},{label:'GPIO2',gpio:2,tags:['A2','SCK']},{label:'3V3',type:'power'},{label:'GND',type:'ground'}],right:[{label:'5V',type:'power'},{label:'PWB',type:'special'},{label:'GND',type:'ground'},{label:'3V3',type:'power'},{label:'RESET',type:'special'},{label:'NC',type:'special'},{label:'GPIO13',gpio:13,tags:['SPIWP']},{label:'U0_TX',gpio:21,tags:['U0TX']},{label:'U0_RX',gpio:20,tags:['U0RX']},{label:'GND',type:'ground'},{label:'GPIO19',gpio:19,tags:['USB+']},{label:'GPIO18',gpio:18,tags:['USB-']},{label:'GPIO12',gpio:12,tags:['SPIHD']},{label:'GPIO1',gpio:1,tags:['A1','U1RX']},{label:'GPIO0',gpio:0,tags:['A0','U1TX']},{label:'GND',type:'ground'}]}};"
 "const SERVICE_PIN_REASONS={2:{ru:'strap pin, \\u043B\\u0443\\u0447\\u0448\\u0435 \\u0438\\u0437\\u0431\\u0435\\u0433\\u0430\\u0442\\u044C',en:'strap pin, best avoided'},8:{ru:'\\u0432\\u0441\\u0442\\u0440\\u043E\\u0435\\u043D\\u043D\\u044B\\u0439 LED + strap pin',en:'onboard LED + strap pin'},9:{ru:'\\u043A\\u043D\\u043E\\u043F\\u043A\\u0430 BOOT + strap pin',en:'BOOT button + strap pin'},11:{ru:'VDD_SPI, \\u043D\\u0443\\u0436\\u0435\\u043D unlock \\u0434\\u043B\\u044F \\u0438\\u0441\\u043F\\u043E\\u043B\\u044C\\u0437\\u043E\\u0432\\u0430\\u043D\\u0438\\u044F \\u043A\\u0430\\u043A GPIO',en:'VDD_SPI, requires unlock before GPIO use'},12:{ru:'\\u043D\\u0430 LuatOS \\u0434\\u043E\\u0441\\u0442\\u0443\\u043F\\u0435\\u043D \\u043A\\u0430\\u043A GPIO/LED, \\u043D\\u0430 \\u0434\\u0440\\u0443\\u0433\\u0438\\u0445 \\u043F\\u043B\\u0430\\u0442\\u0430\\u0445 \\u0437\\u0430\\u0432\\u0438\\u0441\\u0438\\u0442 \\u043E\\u0442 \\u0440\\u0435\\u0436\\u0438\\u043C\\u0430 flash',en:'available as GPIO/LED on LuatOS, flash-mode dependent on other boards'},13:{ru:'\\u043D\\u0430 LuatOS \\u0434\\u043E\\u0441\\u0442\\u0443\\u043F\\u0435\\u043D \\u043A\\u0430\\u043A GPIO/LED, \\u043D\\u0430 \\u0434\\u0440\\u0443\\u0433\\u0438\\u0445 \\u043F\\u043B\\u0430\\u0442\\u0430\\u0445 \\u0437\\u0430\\u0432\\u0438\\u0441\\u0438\\u0442 \\u043E\\u0442 \\u0440\\u0435\\u0436\\u0438\\u043C\\u0430 flash',en:'available as GPIO/LED on LuatOS, flash-mode dependent on other boards'},18:{ru:'USB D-',en:'USB D-'},19:{ru:'USB D+',en:'USB D+'},20:{ru:'UART RX',en:'UART RX'},21:{ru:'UART TX',en:'UART TX'}};"
-"let cfg=null;let runtimeInfo={};let systemInfo={};let lang=localStorage.getItem('ui_lang')||'ru';let authToken=localStorage.getItem('ui_auth_token')||'';let wifiScanLoaded=false;let wifiScanInFlight=null;let liveModules={outputs:[],inputs:[],buttons:[],sensors:[]};let livePollTimer=null;let livePollInFlight=null;let deferredRenderPending=false;"
+"let cfg=null;let runtimeInfo={};let systemInfo={};let lang=localStorage.getItem('ui_lang')||'ru';let authToken=localStorage.getItem('ui_auth_token')||'';let wifiScanLoaded=false;let wifiScanInFlight=null;let liveModules={outputs:[],inputs:[],buttons:[],sensors:[]};let livePollTimer=null;let livePollInFlight=null;let liveSocket=null;let liveSocketRetry=null;let deferredRenderPending=false;"
 "function esc(v){return String(v==null?'':v).replace(/[&<>\\\"']/g,m=>{if(m==='&')return '&amp;';if(m==='<')return '&lt;';if(m==='>')return '&gt;';if(m==='\\\"')return '&quot;';return '&#39;';});}"
 "function pick(v,d){return v===undefined||v===null?d:v;}"
 "function t(k){return(I18N[lang]&&I18N[lang][k])||(I18N.en&&I18N.en[k])||k;}"
@@ -145,7 +149,7 @@ static const char *WEB_INDEX_HTML =
 "function gpioOptionsAdc(selected,profile){const boardProfile=normalizeBoardProfile(profile);const options=adcFeedbackGpios(boardProfile);const numeric=Number(selected);if(selected!==undefined&&selected!==null&&selected!==''&&!Number.isNaN(numeric)&&!options.includes(numeric))options.push(numeric);options.sort((a,b)=>a-b);return options.map(g=>{const invalid=!adcFeedbackGpios(boardProfile).includes(Number(g));const label=invalid?invalidCurrentGpioLabel(boardProfile,g):`GPIO${g}`;return `<option value='${g}' ${Number(selected)===g?'selected':''}>${esc(label)}</option>`;}).join('');}"
 "const setOutputTypeBase=setOutputType;"
 "setOutputType=function(idx,value){const o=cfg.outputs[idx]||{};if((value==='servo_3wire'||value==='servo_5wire')&&o.mqtt_component===undefined)o.mqtt_component='auto';if((value==='servo_3wire'||value==='servo_5wire')&&o.mqtt_number_mode===undefined)o.mqtt_number_mode='slider';if(value==='servo_3wire'&&o.hold_power_ms===undefined)o.hold_power_ms=1200;return setOutputTypeBase(idx,value);};"
-"function setOutputType(idx,value){const o=cfg.outputs[idx]||{};const boardProfile=normalizeBoardProfile(pick(cfg.device.board_profile,'esp32-c3-supermini'));let fallback=pick(o.gpio,0);o.type=value;if(value==='servo_3wire'){if(o.default_level===undefined)o.default_level=0;if(o.min_us===undefined)o.min_us=500;if(o.max_us===undefined)o.max_us=2500;if(o.reverse_direction===undefined)o.reverse_direction=false;}else if(value==='servo_5wire'){if(o.default_level===undefined)o.default_level=0;if(o.gpio_b===undefined){const alt=allowedGpios(boardProfile).find(g=>Number(g)!==Number(pick(o.gpio,0)));o.gpio_b=(alt!==undefined?alt:fallback);}if(o.feedback_gpio===undefined){const adc=adcFeedbackGpios(boardProfile).find(g=>Number(g)!==Number(pick(o.gpio,0))&&Number(g)!==Number(pick(o.gpio_b,-1)));o.feedback_gpio=(adc!==undefined?adc:0);}if(o.feedback_min_raw===undefined)o.feedback_min_raw=300;if(o.feedback_max_raw===undefined)o.feedback_max_raw=3700;if(o.deadband_pct===undefined)o.deadband_pct=2;if(o.move_timeout_ms===undefined)o.move_timeout_ms=15000;if(o.reverse_direction===undefined)o.reverse_direction=false;}else if(value==='clock_4x4094'){const extra=allowedGpios(boardProfile).filter(g=>Number(g)!==Number(pick(o.gpio,0)));if(o.gpio_b===undefined)o.gpio_b=(extra[0]!==undefined?extra[0]:fallback);if(o.gpio_c===undefined)o.gpio_c=(extra[1]!==undefined?extra[1]:fallback);if(o.default_on===undefined)o.default_on=true;if(o.default_level===undefined)o.default_level=100;if(o.blink_period_ms===undefined)o.blink_period_ms=2000;if(o.timezone_offset_min===undefined)o.timezone_offset_min=180;if(o.common_anode===undefined)o.common_anode=false;if(o.mirror_segments===undefined)o.mirror_segments=true;if(o.reverse_digits===undefined)o.reverse_digits=false;if(o.leading_zero===undefined)o.leading_zero=true;if(o.blink_separator===undefined)o.blink_separator=true;ensureClockSegmentMap(o);}else if(value==='stepper_28byj'){if(o.default_level===undefined)o.default_level=0;const extra=allowedGpios(boardProfile).filter(g=>![Number(pick(o.gpio,0))].includes(Number(g)));if(o.gpio_b===undefined)o.gpio_b=(extra[0]!==undefined?extra[0]:fallback);if(o.gpio_c===undefined)o.gpio_c=(extra[1]!==undefined?extra[1]:fallback);if(o.gpio_d===undefined)o.gpio_d=(extra[2]!==undefined?extra[2]:fallback);if(o.steps_range===undefined)o.steps_range=2048;if(o.speed_steps_per_sec===undefined)o.speed_steps_per_sec=400;if(o.reverse_direction===undefined)o.reverse_direction=false;if(o.hold_enabled===undefined)o.hold_enabled=false;if(o.home_pull===undefined)o.home_pull='up';if(o.home_inverted===undefined)o.home_inverted=false;if(o.auto_home_on_boot===undefined)o.auto_home_on_boot=false;}else if(value==='stepper_a4988'){if(o.default_level===undefined)o.default_level=0;const extra=allowedGpios(boardProfile).filter(g=>Number(g)!==Number(pick(o.gpio,0)));if(o.gpio_b===undefined)o.gpio_b=(extra[0]!==undefined?extra[0]:fallback);if(o.steps_range===undefined)o.steps_range=200;if(o.speed_steps_per_sec===undefined)o.speed_steps_per_sec=800;if(o.step_pulse_us===undefined)o.step_pulse_us=4;if(o.enable_active_level===undefined)o.enable_active_level=0;if(o.reverse_direction===undefined)o.reverse_direction=false;if(o.hold_enabled===undefined)o.hold_enabled=false;if(o.home_pull===undefined)o.home_pull='up';if(o.home_inverted===undefined)o.home_inverted=false;if(o.auto_home_on_boot===undefined)o.auto_home_on_boot=false;}cfg.outputs[idx]=o;render();}"
+"function setOutputType(idx,value){const o=cfg.outputs[idx]||{};const boardProfile=normalizeBoardProfile(pick(cfg.device.board_profile,'esp32-c3-supermini'));let fallback=pick(o.gpio,0);o.type=value;if(value==='servo_3wire'){if(o.default_level===undefined)o.default_level=0;if(o.min_us===undefined)o.min_us=500;if(o.max_us===undefined)o.max_us=2500;if(o.reverse_direction===undefined)o.reverse_direction=false;}else if(value==='servo_5wire'){if(o.default_level===undefined)o.default_level=0;if(o.gpio_b===undefined){const alt=allowedGpios(boardProfile).find(g=>Number(g)!==Number(pick(o.gpio,0)));o.gpio_b=(alt!==undefined?alt:fallback);}if(o.feedback_gpio===undefined){const adc=adcFeedbackGpios(boardProfile).find(g=>Number(g)!==Number(pick(o.gpio,0))&&Number(g)!==Number(pick(o.gpio_b,-1)));o.feedback_gpio=(adc!==undefined?adc:0);}if(o.feedback_min_raw===undefined)o.feedback_min_raw=300;if(o.feedback_max_raw===undefined)o.feedback_max_raw=3700;if(o.deadband_pct===undefined)o.deadband_pct=2;if(o.move_timeout_ms===undefined)o.move_timeout_ms=15000;if(o.reverse_direction===undefined)o.reverse_direction=false;}else if(value==='clock_4x4094'){const extra=allowedGpios(boardProfile).filter(g=>Number(g)!==Number(pick(o.gpio,0)));if(o.gpio_b===undefined)o.gpio_b=(extra[0]!==undefined?extra[0]:fallback);if(o.gpio_c===undefined)o.gpio_c=(extra[1]!==undefined?extra[1]:fallback);if(o.default_on===undefined)o.default_on=true;if(o.default_level===undefined)o.default_level=100;if(o.blink_period_ms===undefined)o.blink_period_ms=2000;if(o.timezone_offset_min===undefined)o.timezone_offset_min=180;if(o.common_anode===undefined)o.common_anode=false;if(o.mirror_segments===undefined)o.mirror_segments=true;if(o.reverse_digits===undefined)o.reverse_digits=false;if(o.leading_zero===undefined)o.leading_zero=true;if(o.blink_separator===undefined)o.blink_separator=true;ensureClockSegmentMap(o);}else if(value==='stepper_28byj'){if(o.default_level===undefined)o.default_level=0;const extra=allowedGpios(boardProfile).filter(g=>![Number(pick(o.gpio,0))].includes(Number(g)));if(o.gpio_b===undefined)o.gpio_b=(extra[0]!==undefined?extra[0]:fallback);if(o.gpio_c===undefined)o.gpio_c=(extra[1]!==undefined?extra[1]:fallback);if(o.gpio_d===undefined)o.gpio_d=(extra[2]!==undefined?extra[2]:fallback);if(o.steps_range===undefined)o.steps_range=2048;if(o.speed_steps_per_sec===undefined)o.speed_steps_per_sec=400;if(o.accel_steps_per_s2===undefined)o.accel_steps_per_s2=2000;if(o.reverse_direction===undefined)o.reverse_direction=false;if(o.hold_enabled===undefined)o.hold_enabled=false;if(o.home_pull===undefined)o.home_pull='up';if(o.home_inverted===undefined)o.home_inverted=false;if(o.auto_home_on_boot===undefined)o.auto_home_on_boot=false;}else if(value==='stepper_a4988'){if(o.default_level===undefined)o.default_level=0;const extra=allowedGpios(boardProfile).filter(g=>Number(g)!==Number(pick(o.gpio,0)));if(o.gpio_b===undefined)o.gpio_b=(extra[0]!==undefined?extra[0]:fallback);if(o.steps_range===undefined)o.steps_range=200;if(o.speed_steps_per_sec===undefined)o.speed_steps_per_sec=800;if(o.accel_steps_per_s2===undefined)o.accel_steps_per_s2=4000;if(o.step_pulse_us===undefined)o.step_pulse_us=4;if(o.pulse_engine===undefined)o.pulse_engine='gpio';if(o.enable_active_level===undefined)o.enable_active_level=0;if(o.reverse_direction===undefined)o.reverse_direction=false;if(o.hold_enabled===undefined)o.hold_enabled=false;if(o.home_pull===undefined)o.home_pull='up';if(o.home_inverted===undefined)o.home_inverted=false;if(o.auto_home_on_boot===undefined)o.auto_home_on_boot=false;}cfg.outputs[idx]=o;render();}"
 "function ws2812ModeOptions(selected){return [['rgb',uiText('ws_mode_rgb')],['mono_triplet',uiText('ws_mode_mono')]].map(([v,label])=>`<option value='${v}' ${String(selected)===v?'selected':''}>${esc(label)}</option>`).join('');}"
 "function ws2812TransitionOptions(selected,mode){const items=(mode==='mono_triplet')?[['none',uiText('ws_transition_none')],['fade',uiText('ws_transition_fade')],['wipe',uiText('ws_transition_wipe')]]:[['none',uiText('ws_transition_none')],['fade',uiText('ws_transition_fade')]];return items.map(([v,label])=>`<option value='${v}' ${String(selected)===v?'selected':''}>${esc(label)}</option>`).join('');}"
 "function ws2812ColorOrderOptions(selected){return ['RGB','RBG','GRB','GBR','BRG','BGR'].map(v=>`<option value='${v}' ${String(selected)===v?'selected':''}>${v}</option>`).join('');}"
@@ -183,7 +187,11 @@ static const char *WEB_INDEX_HTML =
 "function renderIoLiveCard(entry){const live=entry.kind==='button'?findLiveById(liveModules.buttons,entry.data.id):findLiveById(liveModules.inputs,entry.data.id);let state='neutral';let label=liveText('live_unavailable');if(live){const active=entry.kind==='button'?!!live.pressed:!!live.state;state=active?'active':'released';label=active?(entry.kind==='button'?liveText('button_pressed'):liveText('input_on')):(entry.kind==='button'?liveText('button_released'):liveText('input_off'));}const hint=live?`GPIO ${pick(live.gpio,entry.data.gpio)}`:liveText('live_unavailable');return `<div id='io_live_${entry.section}_${entry.idx}'><div class='livebox'><div class='livehead'><div><div class='livetitle'>${esc(liveText('runtime_title'))}</div><div class='livehint'>${esc(hint)}</div></div></div><div class='livebadges'><span class='badge badge-${state}'>${esc(label)}</span></div></div></div>`;}"
 "function refreshLiveWidgets(){if(!cfg)return;cfg.outputs.forEach((output,index)=>{const el=document.getElementById(`output_live_${index}`);if(el)el.outerHTML=renderOutputLiveCard(index,output);});ioEntries().forEach(entry=>{const el=document.getElementById(`io_live_${entry.section}_${entry.idx}`);if(el)el.outerHTML=renderIoLiveCard(entry);});}"
 "function pollLiveModules(silent){if(livePollInFlight)return livePollInFlight;livePollInFlight=apiFetch('/api/modules').then(r=>{if(r.status===401)throw new Error(uxText('auth_required'));if(!r.ok)throw new Error(`HTTP ${r.status}`);return r.json();}).then(j=>{liveModules={outputs:Array.isArray(j.outputs)?j.outputs:[],inputs:Array.isArray(j.inputs)?j.inputs:[],buttons:Array.isArray(j.buttons)?j.buttons:[],sensors:Array.isArray(j.sensors)?j.sensors:[]};refreshLiveWidgets();}).catch(e=>{if(!silent)setMsg(String(e),false);}).finally(()=>{livePollInFlight=null;});return livePollInFlight;}"
-"function startLivePolling(){if(livePollTimer)return;livePollTimer=window.setInterval(()=>{pollLiveModules(true);},1000);}"
+"function startLivePolling(){if(startLiveStream()||livePollTimer)return;livePollTimer=window.setInterval(()=>{pollLiveModules(true);},1000);}"
+"function stopLivePolling(){if(livePollTimer){window.clearInterval(livePollTimer);livePollTimer=null;}}"
+"function mergeLiveList(list,items){const out=Array.isArray(list)?list.slice():[];(Array.isArray(items)?items:[]).forEach(item=>{const i=out.findIndex(x=>x.id===item.id);if(i>=0)out[i]=item;else out.push(item);});return out;}"
+"function applyLiveDelta(j){if(!j||typeof j!=='object')return;if(j.full){liveModules={outputs:Array.isArray(j.outputs)?j.outputs:[],inputs:Array.isArray(j.inputs)?j.inputs:[],buttons:Array.isArray(j.buttons)?j.buttons:[],sensors:Array.isArray(j.sensors)?j.sensors:[]};}else{liveModules.outputs=mergeLiveList(liveModules.outputs,j.outputs);liveModules.inputs=mergeLiveList(liveModules.inputs,j.inputs);liveModules.buttons=mergeLiveList(liveModules.buttons,j.buttons);liveModules.sensors=mergeLiveList(liveModules.sensors,j.sensors);}refreshLiveWidgets();}"
+"function startLiveStream(){if(liveSocket)return true;if(!('WebSocket' in window))return false;let ws;try{const protocols=['esp32-stream'];if(authToken)protocols.push('auth.'+Array.from(new TextEncoder().encode(authToken),b=>b.toString(16).padStart(2,'0')).join(''));ws=new WebSocket(`${location.protocol==='https:'?'wss':'ws'}://${location.host}/api/stream`,protocols);}catch(e){return false;}liveSocket=ws;ws.onopen=()=>{stopLivePolling();};ws.onmessage=ev=>{try{applyLiveDelta(JSON.parse(ev.data));}catch(e){}};ws.onclose=()=>{if(liveSocket!==ws)return;liveSocket=null;if(!livePollTimer)livePollTimer=window.setInterval(()=>{pollLiveModules(true);},1000);if(!liveSocketRetry)liveSocketRetry=window.setTimeout(()=>{liveSocketRetry=null;startLiveStream();},5000);};return true;}"
 "async function testOutput(index){try{const output=cfg.outputs[index];if(!output)throw new Error('Output not found');if(!String(output.id||'').trim())throw new Error(liveText('missing_output_id'));await saveOnly();const applyResp=await apiFetch('/api/apply',{method:'POST'});if(!applyResp.ok)throw new Error(await applyResp.text()||(`HTTP ${applyResp.status}`));const resp=await apiFetch(`/api/modules/${encodeURIComponent(String(output.id).trim())}/action`,{method:'POST',headers:{'Content-Type':'application/json'},body:JSON.stringify({test:true,duration_ms:1200})});const text=await resp.text();if(!resp.ok)throw new Error(text||(`HTTP ${resp.status}`));setMsg(liveText('test_started'),true);await pollLiveModules(true);window.setTimeout(()=>{pollLiveModules(true);},1400);}catch(e){setMsg(String(e),false);}}"
 "async function homeOutput(index){try{const output=cfg.outputs[index];if(!output)throw new Error('Output not found');if(!isStepperOutput(output))throw new Error(stepperText('home_only'));if(!String(output.id||'').trim())throw new Error(liveText('missing_output_id'));if(optionalGpioValue(output.home_gpio)==='')throw new Error(stepperText('home_missing'));await saveOnly();const applyResp=await apiFetch('/api/apply',{method:'POST'});if(!applyResp.ok)throw new Error(await applyResp.text()||(`HTTP ${applyResp.status}`));const resp=await apiFetch(`/api/modules/${encodeURIComponent(String(output.id).trim())}/action`,{method:'POST',headers:{'Content-Type':'application/json'},body:JSON.stringify({home:true})});const text=await resp.text();if(!resp.ok)throw new Error(text||(`HTTP ${resp.status}`));setMsg(stepperText('home_started'),true);await pollLiveModules(true);window.setTimeout(()=>{pollLiveModules(true);},1200);}catch(e){setMsg(String(e),false);}}"
 "function servoHaDisplayOptions(selected){return [['auto',uiText('ha_display_auto')],['number',uiText('ha_display_number')],['light',uiText('ha_display_light')],['cover',uiText('ha_display_cover')]].map(([v,label])=>`<option value='${esc(v)}' ${String(selected)===String(v)?'selected':''}>${esc(label)}</option>`).join('');}"
@@ -193,18 +201,18 @@ static const char *WEB_INDEX_HTML =
 "const renderOutputsBase=renderOutputs;"
 "renderOutputs=function(){renderOutputsBase();renderServo3WireHoldOptions();renderServoHaOptions();};"
 "function renderOutputs(){const boardProfile=normalizeBoardProfile(pick(cfg.device.board_profile,'esp32-c3-supermini'));document.getElementById('outputs').innerHTML=cfg.outputs.map((o,i)=>{const type=pick(o.type,'relay');const relayEnabled=pwmPowerRelayEnabled(o);const wsMode=pick(o.mode,'rgb');const wsTransition=normalizeWs2812Transition(pick(o.transition_style,'none'),wsMode);return `<div class='item'><div class='itemhead'><strong>${esc(o.name||o.id||(`${t('output_name')} ${i+1}`))}</strong><button class='danger' onclick='removeItem(\\\"outputs\\\",${i})'>${t('remove')}</button></div><div class='row'><div><label>${t('id')}</label><input value='${esc(o.id||'')}' oninput='setField(\\\"outputs\\\",${i},\\\"id\\\",this.value)'/></div><div><label>${t('name')}</label><input value='${esc(o.name||'')}' oninput='setField(\\\"outputs\\\",${i},\\\"name\\\",this.value)'/></div></div><div class='row3'><div><label>${t('type')}</label><select onchange='setOutputType(${i},this.value)'>${enumOptions(OUTPUT_TYPES,type,OUTPUT_TYPE_LABELS)}</select></div><div><label>${t('gpio')}</label><select onchange='setField(\\\"outputs\\\",${i},\\\"gpio\\\",Number(this.value))'>${gpioOptions(pick(o.gpio,0),boardProfile)}</select></div><div><label><input type='checkbox' ${o.enabled!==false?'checked':''} onchange='setField(\\\"outputs\\\",${i},\\\"enabled\\\",this.checked)' style='width:auto'/> ${t('enabled')}</label></div></div>${type==='relay'?`<div class='row'><div><label>${t('active_level')}</label><select onchange='setField(\\\"outputs\\\",${i},\\\"active_level\\\",Number(this.value))'><option value='1' ${Number(pick(o.active_level,1))===1?'selected':''}>1</option><option value='0' ${Number(pick(o.active_level,1))===0?'selected':''}>0</option></select></div><div><label><input type='checkbox' ${o.default_on?'checked':''} onchange='setField(\\\"outputs\\\",${i},\\\"default_on\\\",this.checked)' style='width:auto'/> ${t('default_on')}</label></div></div>`:''}${type==='pwm'?`<div class='row3'><div><label>${t('freq_hz')}</label><input type='number' value='${esc(pick(o.freq_hz,1000))}' oninput='setField(\\\"outputs\\\",${i},\\\"freq_hz\\\",Number(this.value||0))'/></div><div><label>${t('default_level')}</label><input type='number' min='0' max='100' value='${esc(pick(o.default_level,0))}' oninput='setField(\\\"outputs\\\",${i},\\\"default_level\\\",Number(this.value||0))'/></div><div><label>${uiText('pwm_max_level')}</label><input type='number' min='1' max='100' value='${esc(pick(o.max_level_pct,100))}' oninput='setField(\\\"outputs\\\",${i},\\\"max_level_pct\\\",Number(this.value||100))'/></div></div><div class='row'><div><label><input type='checkbox' ${relayEnabled?'checked':''} onchange='togglePwmPowerRelay(${i},this.checked)' style='width:auto'/> ${uiText('power_relay_enable')}</label></div><div><label><input type='checkbox' ${o.inverted?'checked':''} onchange='setField(\\\"outputs\\\",${i},\\\"inverted\\\",this.checked)' style='width:auto'/> ${t('inverted')}</label></div></div>${relayEnabled?`<div class='row3'><div><label>${uiText('power_relay_gpio')}</label><select onchange='setOptionalPwmPowerRelayGpio(${i},this.value)'>${gpioOptionsOptional(optionalGpioValue(o.power_relay_gpio),boardProfile)}</select></div><div><label>${uiText('power_relay_active_level')}</label><select onchange='setField(\\\"outputs\\\",${i},\\\"power_relay_active_level\\\",Number(this.value))'><option value='1' ${Number(pick(o.power_relay_active_level,1))===1?'selected':''}>1</option><option value='0' ${Number(pick(o.power_relay_active_level,1))===0?'selected':''}>0</option></select></div></div>`:''}`:''}${type==='ws2812'?`<div class='row3'><div><label>${uiText('ws_mode')}</label><select onchange='setWs2812Mode(${i},this.value)'>${ws2812ModeOptions(wsMode)}</select></div><div><label>${t('pixels')}</label><input type='number' value='${esc(pick(o.pixel_count,1))}' oninput='setField(\\\"outputs\\\",${i},\\\"pixel_count\\\",Number(this.value||1))'/></div><div><label>${t('color_order')}</label><select onchange='setField(\\\"outputs\\\",${i},\\\"color_order\\\",this.value)'>${ws2812ColorOrderOptions(pick(o.color_order,'GRB'))}</select></div></div><div class='row3'><div><label>${uiText('ws_transition')}</label><select onchange='setField(\\\"outputs\\\",${i},\\\"transition_style\\\",this.value)'>${ws2812TransitionOptions(wsTransition,wsMode)}</select></div><div><label>${uiText('ws_transition_ms')}</label><input type='number' min='0' max='5000' value='${esc(pick(o.transition_ms,300))}' oninput='setField(\\\"outputs\\\",${i},\\\"transition_ms\\\",Number(this.value||0))'/></div><div><label><input type='checkbox' ${o.default_power_on?'checked':''} onchange='setField(\\\"outputs\\\",${i},\\\"default_power_on\\\",this.checked)' style='width:auto'/> ${t('default_on')}</label></div></div>${wsMode==='mono_triplet'?`<div class='hint muted'>${uiText('ws_mono_order_hint')}</div>`:''}`:''}${type==='servo_3wire'?`<div class='row3'><div><label>${uiText('servo_default_position')}</label><input type='number' min='0' max='100' value='${esc(pick(o.default_level,0))}' oninput='setField(\\\"outputs\\\",${i},\\\"default_level\\\",Number(this.value||0))'/></div><div><label>${uiText('servo_min_us')}</label><input type='number' min='400' max='2600' value='${esc(pick(o.min_us,500))}' oninput='setField(\\\"outputs\\\",${i},\\\"min_us\\\",Number(this.value||500))'/></div><div><label>${uiText('servo_max_us')}</label><input type='number' min='400' max='2600' value='${esc(pick(o.max_us,2500))}' oninput='setField(\\\"outputs\\\",${i},\\\"max_us\\\",Number(this.value||2500))'/></div></div><div class='row'><div><label><input type='checkbox' ${o.reverse_direction?'checked':''} onchange='setField(\\\"outputs\\\",${i},\\\"reverse_direction\\\",this.checked)' style='width:auto'/> ${uiText('servo_reverse')}</label></div></div>`:''}${type==='servo_5wire'?`<div class='row3'><div><label>${uiText('servo_gpio_b')}</label><select onchange='setField(\\\"outputs\\\",${i},\\\"gpio_b\\\",Number(this.value))'>${gpioOptions(pick(o.gpio_b,1),boardProfile)}</select></div><div><label>${uiText('servo_feedback_gpio')}</label><select onchange='setField(\\\"outputs\\\",${i},\\\"feedback_gpio\\\",Number(this.value))'>${gpioOptionsAdc(pick(o.feedback_gpio,0),boardProfile)}</select></div><div><label>${uiText('servo_default_position')}</label><input type='number' min='0' max='100' value='${esc(pick(o.default_level,0))}' oninput='setField(\\\"outputs\\\",${i},\\\"default_level\\\",Number(this.value||0))'/></div></div><div class='row3'><div><label>${uiText('servo_feedback_min')}</label><input type='number' min='0' max='4095' value='${esc(pick(o.feedback_min_raw,300))}' oninput='setField(\\\"outputs\\\",${i},\\\"feedback_min_raw\\\",Number(this.value||0))'/></div><div><label>${uiText('servo_feedback_max')}</label><input type='number' min='0' max='4095' value='${esc(pick(o.feedback_max_raw,3700))}' oninput='setField(\\\"outputs\\\",${i},\\\"feedback_max_raw\\\",Number(this.value||0))'/></div><div><label>${uiText('servo_deadband')}</label><input type='number' min='1' max='20' value='${esc(pick(o.deadband_pct,2))}' oninput='setField(\\\"outputs\\\",${i},\\\"deadband_pct\\\",Number(this.value||2))'/></div></div><div class='row'><div><label>${uiText('servo_timeout')}</label><input type='number' min='1000' max='60000' value='${esc(pick(o.move_timeout_ms,15000))}' oninput='setField(\\\"outputs\\\",${i},\\\"move_timeout_ms\\\",Number(this.value||15000))'/></div><div><label><input type='checkbox' ${o.reverse_direction?'checked':''} onchange='setField(\\\"outputs\\\",${i},\\\"reverse_direction\\\",this.checked)' style='width:auto'/> ${uiText('servo_reverse')}</label></div></div>`:''}${renderOutputLiveCard(i,o)}</div>`;}).join('');}"
-"function wsGammaText(key){const ru={label:'\\u0413\\u0430\\u043C\\u043C\\u0430-\\u043A\\u043E\\u0440\\u0440\\u0435\\u043A\\u0446\\u0438\\u044F',hint:'\\u0414\\u0435\\u043B\\u0430\\u0435\\u0442 \\u043D\\u0438\\u0437\\u043A\\u0443\\u044E \\u044F\\u0440\\u043A\\u043E\\u0441\\u0442\\u044C \\u0432\\u0438\\u0437\\u0443\\u0430\\u043B\\u044C\\u043D\\u043E \\u043F\\u043B\\u0430\\u0432\\u043D\\u0435\\u0435, \\u043D\\u043E \\u043E\\u0442\\u043A\\u043B\\u0438\\u043A \\u043F\\u043E \\u0448\\u043A\\u0430\\u043B\\u0435 \\u0441\\u0442\\u0430\\u043D\\u043E\\u0432\\u0438\\u0442\\u0441\\u044F \\u043D\\u0435\\u043B\\u0438\\u043D\\u0435\\u0439\\u043D\\u044B\\u043C.'};const en={label:'Gamma correction',hint:'Makes low brightness look smoother, but the response becomes less linear.'};const dict=lang==='ru'?ru:en;return dict[key]||key;}"
-"function renderWs2812GammaOptions(){document.querySelectorAll('#outputs .item').forEach((card,i)=>{const output=cfg.outputs[i]||{};if(String(pick(output.type,'relay'))!=='ws2812')return;const block=document.createElement('div');block.setAttribute('data-ws-gamma',String(i));block.innerHTML=`<div class='row'><div><label><input type='checkbox' ${output.gamma_correction?'checked':''} onchange='setField(\\\"outputs\\\",${i},\\\"gamma_correction\\\",this.checked)' style='width:auto'/> ${esc(wsGammaText('label'))}</label></div></div><div class='hint muted'>${esc(wsGammaText('hint'))}</div>`;const live=document.getElementById(`output_live_${i}`);if(live&&live.parentNode===card)card.insertBefore(block,live);else card.appendChild(block);});}"
+"function wsGammaText(key){const ru={label:'\\u0413\\u0430\\u043C\\u043C\\u0430-\\u043A\\u043E\\u0440\\u0440\\u0435\\u043A\\u0446\\u0438\\u044F',hint:'\\u0414\\u0435\\u043B\\u0430\\u0435\\u0442 \\u043D\\u0438\\u0437\\u043A\\u0443\\u044E \\u044F\\u0440\\u043A\\u043E\\u0441\\u0442\\u044C \\u0432\\u0438\\u0437\\u0443\\u0430\\u043B\\u044C\\u043D\\u043E \\u043F\\u043B\\u0430\\u0432\\u043D\\u0435\\u0435, \\u043D\\u043E \\u043E\\u0442\\u043A\\u043B\\u0438\\u043A \\u043F\\u043E \\u0448\\u043A\\u0430\\u043B\\u0435 \\u0441\\u0442\\u0430\\u043D\\u043E\\u0432\\u0438\\u0442\\u0441\\u044F \\u043D\\u0435\\u043B\\u0438\\u043D\\u0435\\u0439\\u043D\\u044B\\u043C.',driver:'\\u0414\\u0440\\u0430\\u0439\\u0432\\u0435\\u0440',driver_hint:'SPI \\u043F\\u0435\\u0440\\u0435\\u0434\\u0430\\u0451\\u0442 \\u043A\\u0430\\u0434\\u0440 \\u0447\\u0435\\u0440\\u0435\\u0437 DMA \\u0438 \\u043F\\u043E\\u0434\\u0445\\u043E\\u0434\\u0438\\u0442 \\u0434\\u043B\\u044F \\u0434\\u043B\\u0438\\u043D\\u043D\\u044B\\u0445 \\u043B\\u0435\\u043D\\u0442; \\u0435\\u0433\\u043E \\u043C\\u043E\\u0436\\u0435\\u0442 \\u0438\\u0441\\u043F\\u043E\\u043B\\u044C\\u0437\\u043E\\u0432\\u0430\\u0442\\u044C \\u0442\\u043E\\u043B\\u044C\\u043A\\u043E \\u043E\\u0434\\u043D\\u0430 \\u043B\\u0435\\u043D\\u0442\\u0430.',effect:'\\u042D\\u0444\\u0444\\u0435\\u043A\\u0442',effect_fps:'\\u041A\\u0430\\u0434\\u0440\\u043E\\u0432 \\u0432 \\u0441\\u0435\\u043A\\u0443\\u043D\\u0434\\u0443',effect_speed:'\\u0421\\u043A\\u043E\\u0440\\u043E\\u0441\\u0442\\u044C \\u044D\\u0444\\u0444\\u0435\\u043A\\u0442\\u0430 (1-255)',easing:'\\u041A\\u0440\\u0438\\u0432\\u0430\\u044F \\u043F\\u0435\\u0440\\u0435\\u0445\\u043E\\u0434\\u0430',easing_linear:'\\u041B\\u0438\\u043D\\u0435\\u0439\\u043D\\u0430\\u044F',easing_ease_in_out:'\\u041F\\u043B\\u0430\\u0432\\u043D\\u044B\\u0439 \\u0441\\u0442\\u0430\\u0440\\u0442 \\u0438 \\u0444\\u0438\\u043D\\u0438\\u0448',easing_cie:'\\u041F\\u0435\\u0440\\u0446\\u0435\\u043F\\u0442\\u0438\\u0432\\u043D\\u0430\\u044F (CIE L*)'};const en={label:'Gamma correction',hint:'Makes low brightness look smoother, but the response becomes less linear.',driver:'Driver',driver_hint:'SPI sends the frame by DMA and suits long strips; only one strip can use it.',effect:'Effect',effect_fps:'Effect FPS',effect_speed:'Effect speed (1-255)',easing:'Transition curve',easing_linear:'Linear',easing_ease_in_out:'Ease in/out',easing_cie:'Perceptual (CIE L*)'};const dict=lang==='ru'?ru:en;return dict[key]||key;}"
+"function renderWs2812GammaOptions(){document.querySelectorAll('#outputs .item').forEach((card,i)=>{const output=cfg.outputs[i]||{};if(String(pick(output.type,'relay'))!=='ws2812')return;const block=document.createElement('div');block.setAttribute('data-ws-gamma',String(i));block.innerHTML=`<div class='row3'><div><label><input type='checkbox' ${output.gamma_correction?'checked':''} onchange='setField(\\\"outputs\\\",${i},\\\"gamma_correction\\\",this.checked)' style='width:auto'/> ${esc(wsGammaText('label'))}</label></div><div><label>${esc(wsGammaText('driver'))}</label><select onchange='setField(\\\"outputs\\\",${i},\\\"driver\\\",this.value)'><option value='rmt' ${pick(output.driver,'rmt')==='rmt'?'selected':''}>RMT</option><option value='spi' ${output.driver==='spi'?'selected':''}>SPI + DMA</option></select></div><div><label>${esc(wsGammaText('easing'))}</label><select onchange='setField(\\\"outputs\\\",${i},\\\"transition_easing\\\",this.value)'>${['linear','ease_in_out','cie'].map(e=>`<option value='${e}' ${pick(output.transition_easing,'linear')===e?'selected':''}>${esc(wsGammaText('easing_'+e))}</option>`).join('')}</select></div></div><div class='hint muted'>${esc(wsGammaText('hint'))}</div><div class='hint muted'>${esc(wsGammaText('driver_hint'))}</div>${pick(output.mode,'rgb')!=='mono_triplet'?`<div class='row3'><div><label>${esc(wsGammaText('effect'))}</label><select onchange='setField(\\\"outputs\\\",${i},\\\"effect\\\",this.value)'>${['none','rainbow','chase','twinkle','gradient','breathe','segments'].map(e=>`<option value='${e}' ${pick(output.effect,'none')===e?'selected':''}>${e}</option>`).join('')}</select></div><div><label>${esc(wsGammaText('effect_fps'))}</label><input type='number' min='1' max='60' value='${esc(pick(output.effect_fps,30))}' oninput='setField(\\\"outputs\\\",${i},\\\"effect_fps\\\",Number(this.value||30))'/></div><div><label>${esc(wsGammaText('effect_speed'))}</label><input type='number' min='1' max='255' value='${esc(pick(output.effect_speed,64))}' oninput='setField(\\\"outputs\\\",${i},\\\"effect_speed\\\",Number(this.value||64))'/></div></div>`:''}`;const live=document.getElementById(`output_live_${i}`);if(live&&live.parentNode===card)card.insertBefore(block,live);else card.appendChild(block);});}"
 "function setOptionalNumericField(section,idx,key,value){if(value===''){delete cfg[section][idx][key];}else{cfg[section][idx][key]=Number(value);}requestRender();}"
-"function stepperText(key){const ru={gpio_b:'GPIO B',gpio_c:'GPIO C',gpio_d:'GPIO D',dir_gpio:'GPIO DIR',enable_gpio:'GPIO ENABLE',enable_level:'ENABLE active level',home_gpio:'GPIO HOME',home_pull:'HOME pull',home_inverted:'Invert HOME',auto_home:'Auto home on boot',home_button:'Home',home_active:'HOME active',home_inactive:'HOME inactive',homing:'Homing',homed:'Home fixed',home_started:'Homing started',home_hint:'Optional endstop for 0% position. When triggered, the stepper resets its position to zero.',home_missing:'Set HOME GPIO first.',home_only:'Home action is available only for stepper outputs.',steps_range:'\\u0425\\u043E\\u0434, \\u0448\\u0430\\u0433\\u043E\\u0432',speed:'\\u0421\\u043A\\u043E\\u0440\\u043E\\u0441\\u0442\\u044C, \\u0448\\u0430\\u0433/\\u0441',pulse:'\\u0418\\u043C\\u043F\\u0443\\u043B\\u044C\\u0441 STEP, \\u043C\\u043A\\u0441',hold:'\\u0423\\u0434\\u0435\\u0440\\u0436\\u0438\\u0432\\u0430\\u0442\\u044C \\u043C\\u043E\\u0442\\u043E\\u0440',reverse:'\\u0420\\u0435\\u0432\\u0435\\u0440\\u0441 \\u043D\\u0430\\u043F\\u0440\\u0430\\u0432\\u043B\\u0435\\u043D\\u0438\\u044F',default_pos:'\\u041F\\u043E\\u0437\\u0438\\u0446\\u0438\\u044F \\u043F\\u043E \\u0443\\u043C\\u043E\\u043B\\u0447\\u0430\\u043D\\u0438\\u044E, %',hint_28byj:'\\u0414\\u0438\\u0430\\u043F\\u0430\\u0437\\u043E\\u043D 0..100% \\u043E\\u0442\\u043E\\u0431\\u0440\\u0430\\u0436\\u0430\\u0435\\u0442\\u0441\\u044F \\u0432 0..steps_range \\u0448\\u0430\\u0433\\u043E\\u0432 ULN2003.',hint_a4988:'\\u0414\\u0438\\u0430\\u043F\\u0430\\u0437\\u043E\\u043D 0..100% \\u043E\\u0442\\u043E\\u0431\\u0440\\u0430\\u0436\\u0430\\u0435\\u0442\\u0441\\u044F \\u0432 0..steps_range \\u0448\\u0430\\u0433\\u043E\\u0432 A4988.'};const en={gpio_b:'GPIO B',gpio_c:'GPIO C',gpio_d:'GPIO D',dir_gpio:'DIR GPIO',enable_gpio:'ENABLE GPIO',enable_level:'ENABLE active level',home_gpio:'HOME GPIO',home_pull:'HOME pull',home_inverted:'Invert HOME',auto_home:'Auto home on boot',home_button:'Home',home_active:'HOME active',home_inactive:'HOME inactive',homing:'Homing',homed:'Home fixed',home_started:'Homing started',home_hint:'Optional endstop for 0% position. When triggered, the stepper resets its position to zero.',home_missing:'Set HOME GPIO first.',home_only:'Home action is available only for stepper outputs.',steps_range:'Travel, steps',speed:'Speed, steps/s',pulse:'STEP pulse, us',hold:'Hold motor',reverse:'Reverse direction',default_pos:'Default position, %',hint_28byj:'Maps 0..100% to 0..steps_range steps for ULN2003.',hint_a4988:'Maps 0..100% to 0..steps_range steps for A4988.'};const dict=lang==='ru'?ru:en;return dict[key]||key;}"
+"function stepperText(key){const ru={gpio_b:'GPIO B',gpio_c:'GPIO C',gpio_d:'GPIO D',dir_gpio:'GPIO DIR',enable_gpio:'GPIO ENABLE',enable_level:'ENABLE active level',home_gpio:'GPIO HOME',home_pull:'HOME pull',home_inverted:'Invert HOME',auto_home:'Auto home on boot',home_button:'Home',home_active:'HOME active',home_inactive:'HOME inactive',homing:'Homing',homed:'Home fixed',home_started:'Homing started',home_hint:'Optional endstop for 0% position. When triggered, the stepper resets its position to zero.',home_missing:'Set HOME GPIO first.',home_only:'Home action is available only for stepper outputs.',steps_range:'\\u0425\\u043E\\u0434, \\u0448\\u0430\\u0433\\u043E\\u0432',speed:'\\u0421\\u043A\\u043E\\u0440\\u043E\\u0441\\u0442\\u044C, \\u0448\\u0430\\u0433/\\u0441',accel:'\\u0423\\u0441\\u043A\\u043E\\u0440\\u0435\\u043D\\u0438\\u0435, \\u0448\\u0430\\u0433/\\u0441\\u00B2 (0 = \\u0432\\u044B\\u043A\\u043B)',pulse:'\\u0418\\u043C\\u043F\\u0443\\u043B\\u044C\\u0441 STEP, \\u043C\\u043A\\u0441',pulse_engine:'\\u0413\\u0435\\u043D\\u0435\\u0440\\u0430\\u0442\\u043E\\u0440 STEP',hold:'\\u0423\\u0434\\u0435\\u0440\\u0436\\u0438\\u0432\\u0430\\u0442\\u044C \\u043C\\u043E\\u0442\\u043E\\u0440',reverse:'\\u0420\\u0435\\u0432\\u0435\\u0440\\u0441 \\u043D\\u0430\\u043F\\u0440\\u0430\\u0432\\u043B\\u0435\\u043D\\u0438\\u044F',default_pos:'\\u041F\\u043E\\u0437\\u0438\\u0446\\u0438\\u044F \\u043F\\u043E \\u0443\\u043C\\u043E\\u043B\\u0447\\u0430\\u043D\\u0438\\u044E, %',hint_28byj:'\\u0414\\u0438\\u0430\\u043F\\u0430\\u0437\\u043E\\u043D 0..100% \\u043E\\u0442\\u043E\\u0431\\u0440\\u0430\\u0436\\u0430\\u0435\\u0442\\u0441\\u044F \\u0432 0..steps_range \\u0448\\u0430\\u0433\\u043E\\u0432 ULN2003.',hint_a4988:'\\u0414\\u0438\\u0430\\u043F\\u0430\\u0437\\u043E\\u043D 0..100% \\u043E\\u0442\\u043E\\u0431\\u0440\\u0430\\u0436\\u0430\\u0435\\u0442\\u0441\\u044F \\u0432 0..steps_range \\u0448\\u0430\\u0433\\u043E\\u0432 A4988.'};const en={gpio_b:'GPIO B',gpio_c:'GPIO C',gpio_d:'GPIO D',dir_gpio:'DIR GPIO',enable_gpio:'ENABLE GPIO',enable_level:'ENABLE active level',home_gpio:'HOME GPIO',home_pull:'HOME pull',home_inverted:'Invert HOME',auto_home:'Auto home on boot',home_button:'Home',home_active:'HOME active',home_inactive:'HOME inactive',homing:'Homing',homed:'Home fixed',home_started:'Homing started',home_hint:'Optional endstop for 0% position. When triggered, the stepper resets its position to zero.',home_missing:'Set HOME GPIO first.',home_only:'Home action is available only for stepper outputs.',steps_range:'Travel, steps',speed:'Speed, steps/s',accel:'Acceleration, steps/s\\u00B2 (0 = off)',pulse:'STEP pulse, us',pulse_engine:'STEP generator',hold:'Hold motor',reverse:'Reverse direction',default_pos:'Default position, %',hint_28byj:'Maps 0..100% to 0..steps_range steps for ULN2003.',hint_a4988:'Maps 0..100% to 0..steps_range steps for A4988.'};const dict=lang==='ru'?ru:en;return dict[key]||key;}"
 "function clockText(key){const ru={data_gpio:'GPIO DATA',clock_gpio:'GPIO CLOCK',latch_gpio:'GPIO LATCH',brightness_gpio:'GPIO BRIGHTNESS',brightness_level:'\\u042F\\u0440\\u043A\\u043E\\u0441\\u0442\\u044C \\u043F\\u043E \\u0443\\u043C\\u043E\\u043B\\u0447\\u0430\\u043D\\u0438\\u044E, %',blink_period:'\\u041F\\u0435\\u0440\\u0438\\u043E\\u0434 \\u043C\\u0438\\u0433\\u0430\\u043D\\u0438\\u044F, \\u043C\\u0441',timezone:'\\u0427\\u0430\\u0441\\u043E\\u0432\\u043E\\u0439 \\u043F\\u043E\\u044F\\u0441, \\u043C\\u0438\\u043D',common_anode:'Common anode',mirror_segments:'\\u0417\\u0435\\u0440\\u043A\\u0430\\u043B\\u0438\\u0442\\u044C \\u0441\\u0435\\u0433\\u043C\\u0435\\u043D\\u0442\\u044B',reverse_digits:'\\u0420\\u0430\\u0437\\u0432\\u043E\\u0440\\u043E\\u0442 \\u0446\\u0438\\u0444\\u0440',leading_zero:'\\u0412\\u0435\\u0434\\u0443\\u0449\\u0438\\u0439 \\u043D\\u043E\\u043B\\u044C \\u0447\\u0430\\u0441\\u0430',blink_separator:'\\u041C\\u0438\\u0433\\u0430\\u044E\\u0449\\u0430\\u044F \\u0442\\u043E\\u0447\\u043A\\u0430 \\u0440\\u0430\\u0437\\u0434\\u0435\\u043B\\u0438\\u0442\\u0435\\u043B\\u044F',segment_map:'\\u041A\\u0430\\u0440\\u0442\\u0430 \\u0441\\u0435\\u0433\\u043C\\u0435\\u043D\\u0442\\u043E\\u0432',segment_a:'\\u0421\\u0435\\u0433\\u043C\\u0435\\u043D\\u0442 A',segment_b:'\\u0421\\u0435\\u0433\\u043C\\u0435\\u043D\\u0442 B',segment_c:'\\u0421\\u0435\\u0433\\u043C\\u0435\\u043D\\u0442 C',segment_d:'\\u0421\\u0435\\u0433\\u043C\\u0435\\u043D\\u0442 D',segment_e:'\\u0421\\u0435\\u0433\\u043C\\u0435\\u043D\\u0442 E',segment_f:'\\u0421\\u0435\\u0433\\u043C\\u0435\\u043D\\u0442 F',segment_g:'\\u0421\\u0435\\u0433\\u043C\\u0435\\u043D\\u0442 G',segment_dp:'\\u0422\\u043E\\u0447\\u043A\\u0430 / DP',segment_hint:'\\u0423\\u043A\\u0430\\u0436\\u0438\\u0442\\u0435, \\u043D\\u0430 \\u043A\\u0430\\u043A\\u043E\\u0439 \\u043D\\u043E\\u043C\\u0435\\u0440 \\u043B\\u0438\\u043D\\u0438\\u0438 4094 \\u043F\\u043E\\u0441\\u0430\\u0436\\u0435\\u043D \\u043A\\u0430\\u0436\\u0434\\u044B\\u0439 \\u043B\\u043E\\u0433\\u0438\\u0447\\u0435\\u0441\\u043A\\u0438\\u0439 \\u0441\\u0435\\u0433\\u043C\\u0435\\u043D\\u0442. \\u041D\\u043E\\u043C\\u0435\\u0440\\u0430 1..8 \\u0434\\u043E\\u043B\\u0436\\u043D\\u044B \\u0431\\u044B\\u0442\\u044C \\u0443\\u043D\\u0438\\u043A\\u0430\\u043B\\u044C\\u043D\\u044B\\u043C\\u0438.',hint:'4 \\u043A\\u0430\\u0441\\u043A\\u0430\\u0434\\u043D\\u044B\\u0445 HEF4094: DATA, CLOCK, LATCH. \\u041E\\u043F\\u0446\\u0438\\u043E\\u043D\\u0430\\u043B\\u044C\\u043D\\u044B\\u0439 BRIGHTNESS GPIO \\u043F\\u043E\\u0434\\u0430\\u0451\\u0442 PWM \\u043D\\u0430 \\u0442\\u0440\\u0430\\u043D\\u0437\\u0438\\u0441\\u0442\\u043E\\u0440 \\u0438\\u043B\\u0438 EN \\u0434\\u0440\\u0430\\u0439\\u0432\\u0435\\u0440. \\u0417\\u0435\\u0440\\u043A\\u0430\\u043B\\u0438\\u0442\\u044C \\u0441\\u0435\\u0433\\u043C\\u0435\\u043D\\u0442\\u044B \\u043F\\u043E\\u043C\\u043E\\u0433\\u0430\\u0435\\u0442, \\u043A\\u043E\\u0433\\u0434\\u0430 2/5 \\u0438\\u043B\\u0438 6/9 \\u0432\\u044B\\u0433\\u043B\\u044F\\u0434\\u044F\\u0442 \\u0437\\u0435\\u0440\\u043A\\u0430\\u043B\\u044C\\u043D\\u043E.',display:'\\u0418\\u043D\\u0434\\u0438\\u043A\\u0430\\u0446\\u0438\\u044F',time_ok:'\\u0412\\u0440\\u0435\\u043C\\u044F \\u0441\\u0438\\u043D\\u0445\\u0440.',time_wait:'\\u0416\\u0434\\u0451\\u043C NTP'};const en={data_gpio:'DATA GPIO',clock_gpio:'CLOCK GPIO',latch_gpio:'LATCH GPIO',brightness_gpio:'BRIGHTNESS GPIO',brightness_level:'Default brightness, %',blink_period:'Blink period, ms',timezone:'Timezone offset, min',common_anode:'Common anode',mirror_segments:'Mirror segments',reverse_digits:'Reverse digit order',leading_zero:'Leading hour zero',blink_separator:'Blink separator dot',segment_map:'Segment map',segment_a:'Segment A',segment_b:'Segment B',segment_c:'Segment C',segment_d:'Segment D',segment_e:'Segment E',segment_f:'Segment F',segment_g:'Segment G',segment_dp:'Dot / DP',segment_hint:'Choose which 4094 output number drives each logical segment. Numbers 1..8 should stay unique.',hint:'Four cascaded HEF4094 registers: DATA, CLOCK, LATCH. Optional BRIGHTNESS GPIO outputs PWM to a transistor or driver enable pin. Mirroring helps when 2/5 or 6/9 look horizontally flipped.',display:'Display',time_ok:'Time synced',time_wait:'Waiting for NTP'};const dict=lang==='ru'?ru:en;return dict[key]||key;}"
-"function renderStepperOptions(){document.querySelectorAll('#outputs .item').forEach((card,i)=>{const output=cfg.outputs[i]||{};const type=String(pick(output.type,'relay'));if(type!=='stepper_28byj'&&type!=='stepper_a4988')return;const boardProfile=normalizeBoardProfile(pick(cfg.device.board_profile,'esp32-c3-supermini'));const block=document.createElement('div');const live=document.getElementById(`output_live_${i}`);const coverRow=`<div class='row'><div><label><input type='checkbox' ${String(pick(output.role,'generic'))==='cover'?'checked':''} onchange='setField(\\\"outputs\\\",${i},\\\"role\\\",this.checked?\\\"cover\\\":\\\"generic\\\")' style='width:auto'/> ${esc(uxText('cover_mode'))}</label></div></div><div class='hint muted'>${esc(uxText('cover_mode_hint'))}</div>`;const homeRow=`<div class='row3'><div><label>${esc(stepperText('home_gpio'))}</label><select onchange='setOptionalNumericField(\\\"outputs\\\",${i},\\\"home_gpio\\\",this.value)'>${gpioOptionsOptional(optionalGpioValue(output.home_gpio),boardProfile)}</select></div><div><label>${esc(stepperText('home_pull'))}</label><select onchange='setField(\\\"outputs\\\",${i},\\\"home_pull\\\",this.value)'>${enumOptions(PULLS,pick(output.home_pull,'up'),PULL_LABELS)}</select></div><div><label><input type='checkbox' ${output.home_inverted?'checked':''} onchange='setField(\\\"outputs\\\",${i},\\\"home_inverted\\\",this.checked)' style='width:auto'/> ${esc(stepperText('home_inverted'))}</label></div></div><div class='row'><div><label><input type='checkbox' ${output.auto_home_on_boot?'checked':''} onchange='setField(\\\"outputs\\\",${i},\\\"auto_home_on_boot\\\",this.checked)' style='width:auto'/> ${esc(stepperText('auto_home'))}</label></div></div><div class='hint muted'>${esc(stepperText('home_hint'))}</div>`;if(type==='stepper_28byj'){block.innerHTML=`<div class='row3'><div><label>${esc(stepperText('gpio_b'))}</label><select onchange='setField(\\\"outputs\\\",${i},\\\"gpio_b\\\",Number(this.value))'>${gpioOptions(pick(output.gpio_b,1),boardProfile)}</select></div><div><label>${esc(stepperText('gpio_c'))}</label><select onchange='setField(\\\"outputs\\\",${i},\\\"gpio_c\\\",Number(this.value))'>${gpioOptions(pick(output.gpio_c,3),boardProfile)}</select></div><div><label>${esc(stepperText('gpio_d'))}</label><select onchange='setField(\\\"outputs\\\",${i},\\\"gpio_d\\\",Number(this.value))'>${gpioOptions(pick(output.gpio_d,4),boardProfile)}</select></div></div><div class='row3'><div><label>${esc(stepperText('default_pos'))}</label><input type='number' min='0' max='100' value='${esc(pick(output.default_level,0))}' oninput='setField(\\\"outputs\\\",${i},\\\"default_level\\\",Number(this.value||0))'/></div><div><label>${esc(stepperText('steps_range'))}</label><input type='number' min='32' max='200000' value='${esc(pick(output.steps_range,2048))}' oninput='setField(\\\"outputs\\\",${i},\\\"steps_range\\\",Number(this.value||2048))'/></div><div><label>${esc(stepperText('speed'))}</label><input type='number' min='10' max='1500' value='${esc(pick(output.speed_steps_per_sec,400))}' oninput='setField(\\\"outputs\\\",${i},\\\"speed_steps_per_sec\\\",Number(this.value||400))'/></div></div><div class='row'><div><label><input type='checkbox' ${output.reverse_direction?'checked':''} onchange='setField(\\\"outputs\\\",${i},\\\"reverse_direction\\\",this.checked)' style='width:auto'/> ${esc(stepperText('reverse'))}</label></div><div><label><input type='checkbox' ${output.hold_enabled?'checked':''} onchange='setField(\\\"outputs\\\",${i},\\\"hold_enabled\\\",this.checked)' style='width:auto'/> ${esc(stepperText('hold'))}</label></div></div>${coverRow}${homeRow}<div class='hint muted'>${esc(stepperText('hint_28byj'))}</div>`;}else{block.innerHTML=`<div class='row3'><div><label>${esc(stepperText('dir_gpio'))}</label><select onchange='setField(\\\"outputs\\\",${i},\\\"gpio_b\\\",Number(this.value))'>${gpioOptions(pick(output.gpio_b,1),boardProfile)}</select></div><div><label>${esc(stepperText('enable_gpio'))}</label><select onchange='setOptionalNumericField(\\\"outputs\\\",${i},\\\"gpio_c\\\",this.value)'>${gpioOptionsOptional(optionalGpioValue(output.gpio_c),boardProfile)}</select></div><div><label>${esc(stepperText('enable_level'))}</label><select onchange='setField(\\\"outputs\\\",${i},\\\"enable_active_level\\\",Number(this.value))'><option value='0' ${Number(pick(output.enable_active_level,0))===0?'selected':''}>0</option><option value='1' ${Number(pick(output.enable_active_level,0))===1?'selected':''}>1</option></select></div></div><div class='row3'><div><label>${esc(stepperText('default_pos'))}</label><input type='number' min='0' max='100' value='${esc(pick(output.default_level,0))}' oninput='setField(\\\"outputs\\\",${i},\\\"default_level\\\",Number(this.value||0))'/></div><div><label>${esc(stepperText('steps_range'))}</label><input type='number' min='32' max='200000' value='${esc(pick(output.steps_range,200))}' oninput='setField(\\\"outputs\\\",${i},\\\"steps_range\\\",Number(this.value||200))'/></div><div><label>${esc(stepperText('speed'))}</label><input type='number' min='10' max='20000' value='${esc(pick(output.speed_steps_per_sec,800))}' oninput='setField(\\\"outputs\\\",${i},\\\"speed_steps_per_sec\\\",Number(this.value||800))'/></div></div><div class='row3'><div><label>${esc(stepperText('pulse'))}</label><input type='number' min='2' max='20' value='${esc(pick(output.step_pulse_us,4))}' oninput='setField(\\\"outputs\\\",${i},\\\"step_pulse_us\\\",Number(this.value||4))'/></div><div><label><input type='checkbox' ${output.reverse_direction?'checked':''} onchange='setField(\\\"outputs\\\",${i},\\\"reverse_direction\\\",this.checked)' style='width:auto'/> ${esc(stepperText('reverse'))}</label></div><div><label><input type='checkbox' ${output.hold_enabled?'checked':''} onchange='setField(\\\"outputs\\\",${i},\\\"hold_enabled\\\",this.checked)' style='width:auto'/> ${esc(stepperText('hold'))}</label></div></div>${coverRow}${homeRow}<div class='hint muted'>${esc(stepperText('hint_a4988'))}</div>`;}if(live&&live.parentNode===card)card.insertBefore(block,live);else card.appendChild(block);});}"
+"function renderStepperOptions(){document.querySelectorAll('#outputs .item').forEach((card,i)=>{const output=cfg.outputs[i]||{};const type=String(pick(output.type,'relay'));if(type!=='stepper_28byj'&&type!=='stepper_a4988')return;const boardProfile=normalizeBoardProfile(pick(cfg.device.board_profile,'esp32-c3-supermini'));const block=document.createElement('div');const live=document.getElementById(`output_live_${i}`);const coverRow=`<div class='row'><div><label><input type='checkbox' ${String(pick(output.role,'generic'))==='cover'?'checked':''} onchange='setField(\\\"outputs\\\",${i},\\\"role\\\",this.checked?\\\"cover\\\":\\\"generic\\\")' style='width:auto'/> ${esc(uxText('cover_mode'))}</label></div></div><div class='hint muted'>${esc(uxText('cover_mode_hint'))}</div>`;const homeRow=`<div class='row3'><div><label>${esc(stepperText('home_gpio'))}</label><select onchange='setOptionalNumericField(\\\"outputs\\\",${i},\\\"home_gpio\\\",this.value)'>${gpioOptionsOptional(optionalGpioValue(output.home_gpio),boardProfile)}</select></div><div><label>${esc(stepperText('home_pull'))}</label><select onchange='setField(\\\"outputs\\\",${i},\\\"home_pull\\\",this.value)'>${enumOptions(PULLS,pick(output.home_pull,'up'),PULL_LABELS)}</select></div><div><label><input type='checkbox' ${output.home_inverted?'checked':''} onchange='setField(\\\"outputs\\\",${i},\\\"home_inverted\\\",this.checked)' style='width:auto'/> ${esc(stepperText('home_inverted'))}</label></div></div><div class='row'><div><label><input type='checkbox' ${output.auto_home_on_boot?'checked':''} onchange='setField(\\\"outputs\\\",${i},\\\"auto_home_on_boot\\\",this.checked)' style='width:auto'/> ${esc(stepperText('auto_home'))}</label></div></div><div class='hint muted'>${esc(stepperText('home_hint'))}</div>`;if(type==='stepper_28byj'){block.innerHTML=`<div class='row3'><div><label>${esc(stepperText('gpio_b'))}</label><select onchange='setField(\\\"outputs\\\",${i},\\\"gpio_b\\\",Number(this.value))'>${gpioOptions(pick(output.gpio_b,1),boardProfile)}</select></div><div><label>${esc(stepperText('gpio_c'))}</label><select onchange='setField(\\\"outputs\\\",${i},\\\"gpio_c\\\",Number(this.value))'>${gpioOptions(pick(output.gpio_c,3),boardProfile)}</select></div><div><label>${esc(stepperText('gpio_d'))}</label><select onchange='setField(\\\"outputs\\\",${i},\\\"gpio_d\\\",Number(this.value))'>${gpioOptions(pick(output.gpio_d,4),boardProfile)}</select></div></div><div class='row3'><div><label>${esc(stepperText('default_pos'))}</label><input type='number' min='0' max='100' value='${esc(pick(output.default_level,0))}' oninput='setField(\\\"outputs\\\",${i},\\\"default_level\\\",Number(this.value||0))'/></div><div><label>${esc(stepperText('steps_range'))}</label><input type='number' min='32' max='200000' value='${esc(pick(output.steps_range,2048))}' oninput='setField(\\\"outputs\\\",${i},\\\"steps_range\\\",Number(this.value||2048))'/></div><div><label>${esc(stepperText('speed'))}</label><input type='number' min='10' max='1500' value='${esc(pick(output.speed_steps_per_sec,400))}' oninput='setField(\\\"outputs\\\",${i},\\\"speed_steps_per_sec\\\",Number(this.value||400))'/></div></div><div class='row'><div><label>${esc(stepperText('accel'))}</label><input type='number' min='0' max='100000' value='${esc(pick(output.accel_steps_per_s2,2000))}' oninput='setField(\\\"outputs\\\",${i},\\\"accel_steps_per_s2\\\",Number(this.value||0))'/></div></div><div class='row'><div><label><input type='checkbox' ${output.reverse_direction?'checked':''} onchange='setField(\\\"outputs\\\",${i},\\\"reverse_direction\\\",this.checked)' style='width:auto'/> ${esc(stepperText('reverse'))}</label></div><div><label><input type='checkbox' ${output.hold_enabled?'checked':''} onchange='setField(\\\"outputs\\\",${i},\\\"hold_enabled\\\",this.checked)' style='width:auto'/> ${esc(stepperText('hold'))}</label></div></div>${coverRow}${homeRow}<div class='hint muted'>${esc(stepperText('hint_28byj'))}</div>`;}else{block.innerHTML=`<div class='row3'><div><label>${esc(stepperText('dir_gpio'))}</label><select onchange='setField(\\\"outputs\\\",${i},\\\"gpio_b\\\",Number(this.value))'>${gpioOptions(pick(output.gpio_b,1),boardProfile)}</select></div><div><label>${esc(stepperText('enable_gpio'))}</label><select onchange='setOptionalNumericField(\\\"outputs\\\",${i},\\\"gpio_c\\\",this.value)'>${gpioOptionsOptional(optionalGpioValue(output.gpio_c),boardProfile)}</select></div><div><label>${esc(stepperText('enable_level'))}</label><select onchange='setField(\\\"outputs\\\",${i},\\\"enable_active_level\\\",Number(this.value))'><option value='0' ${Number(pick(output.enable_active_level,0))===0?'selected':''}>0</option><option value='1' ${Number(pick(output.enable_active_level,0))===1?'selected':''}>1</option></select></div></div><div class='row3'><div><label>${esc(stepperText('default_pos'))}</label><input type='number' min='0' max='100' value='${esc(pick(output.default_level,0))}' oninput='setField(\\\"outputs\\\",${i},\\\"default_level\\\",Number(this.value||0))'/></div><div><label>${esc(stepperText('steps_range'))}</label><input type='number' min='32' max='200000' value='${esc(pick(output.steps_range,200))}' oninput='setField(\\\"outputs\\\",${i},\\\"steps_range\\\",Number(this.value||200))'/></div><div><label>${esc(stepperText('speed'))}</label><input type='number' min='10' max='20000' value='${esc(pick(output.speed_steps_per_sec,800))}' oninput='setField(\\\"outputs\\\",${i},\\\"speed_steps_per_sec\\\",Number(this.value||800))'/></div></div><div class='row'><div><label>${esc(stepperText('accel'))}</label><input type='number' min='0' max='100000' value='${esc(pick(output.accel_steps_per_s2,4000))}' oninput='setField(\\\"outputs\\\",${i},\\\"accel_steps_per_s2\\\",Number(this.value||0))'/></div></div><div class='row3'><div><label>${esc(stepperText('pulse'))}</label><input type='number' min='2' max='20' value='${esc(pick(output.step_pulse_us,4))}' oninput='setField(\\\"outputs\\\",${i},\\\"step_pulse_us\\\",Number(this.value||4))'/></div><div><label><input type='checkbox' ${output.reverse_direction?'checked':''} onchange='setField(\\\"outputs\\\",${i},\\\"reverse_direction\\\",this.checked)' style='width:auto'/> ${esc(stepperText('reverse'))}</label></div><div><label><input type='checkbox' ${output.hold_enabled?'checked':''} onchange='setField(\\\"outputs\\\",${i},\\\"hold_enabled\\\",this.checked)' style='width:auto'/> ${esc(stepperText('hold'))}</label></div></div><div class='row'><div><label>${esc(stepperText('pulse_engine'))}</label><select onchange='setField(\\\"outputs\\\",${i},\\\"pulse_engine\\\",this.value)'><option value='gpio' ${String(pick(output.pulse_engine,'gpio'))==='gpio'?'selected':''}>GPIO</option><option value='rmt' ${String(pick(output.pulse_engine,'gpio'))==='rmt'?'selected':''}>RMT</option></select></div></div>${coverRow}${homeRow}<div class='hint muted'>${esc(stepperText('hint_a4988'))}</div>`;}if(live&&live.parentNode===card)card.insertBefore(block,live);else card.appendChild(block);});}"
 "function renderClock4094Options(){document.querySelectorAll('#outputs .item').forEach((card,i)=>{const output=ensureClockSegmentMap(cfg.outputs[i]||{});if(String(pick(output.type,'relay'))!=='clock_4x4094')return;const boardProfile=normalizeBoardProfile(pick(cfg.device.board_profile,'esp32-c3-supermini'));const block=document.createElement('div');const live=document.getElementById(`output_live_${i}`);block.innerHTML=`<div class='row3'><div><label>${esc(clockText('clock_gpio'))}</label><select onchange='setField(\\\"outputs\\\",${i},\\\"gpio_b\\\",Number(this.value))'>${gpioOptions(pick(output.gpio_b,1),boardProfile)}</select></div><div><label>${esc(clockText('latch_gpio'))}</label><select onchange='setField(\\\"outputs\\\",${i},\\\"gpio_c\\\",Number(this.value))'>${gpioOptions(pick(output.gpio_c,3),boardProfile)}</select></div><div><label>${esc(clockText('brightness_gpio'))}</label><select onchange='setOptionalNumericField(\\\"outputs\\\",${i},\\\"brightness_gpio\\\",this.value)'>${gpioOptionsOptional(optionalGpioValue(output.brightness_gpio),boardProfile)}</select></div></div><div class='row3'><div><label>${esc(clockText('brightness_level'))}</label><input type='number' min='0' max='100' value='${esc(pick(output.default_level,100))}' oninput='setField(\\\"outputs\\\",${i},\\\"default_level\\\",Number(this.value||0))'/></div><div><label>${esc(clockText('blink_period'))}</label><input type='number' min='200' max='10000' step='100' value='${esc(pick(output.blink_period_ms,2000))}' oninput='setField(\\\"outputs\\\",${i},\\\"blink_period_ms\\\",Number(this.value||2000))'/></div><div><label>${esc(clockText('timezone'))}</label><input type='number' min='-720' max='840' value='${esc(pick(output.timezone_offset_min,180))}' oninput='setField(\\\"outputs\\\",${i},\\\"timezone_offset_min\\\",Number(this.value||0))'/></div></div><div class='row'><div><label><input type='checkbox' ${pick(output.default_on,true)?'checked':''} onchange='setField(\\\"outputs\\\",${i},\\\"default_on\\\",this.checked)' style='width:auto'/> ${t('default_on')}</label></div><div><label><input type='checkbox' ${output.common_anode?'checked':''} onchange='setField(\\\"outputs\\\",${i},\\\"common_anode\\\",this.checked)' style='width:auto'/> ${esc(clockText('common_anode'))}</label></div><div><label><input type='checkbox' ${pick(output.mirror_segments,true)?'checked':''} onchange='setField(\\\"outputs\\\",${i},\\\"mirror_segments\\\",this.checked)' style='width:auto'/> ${esc(clockText('mirror_segments'))}</label></div></div><div class='row'><div><label><input type='checkbox' ${pick(output.leading_zero,true)?'checked':''} onchange='setField(\\\"outputs\\\",${i},\\\"leading_zero\\\",this.checked)' style='width:auto'/> ${esc(clockText('leading_zero'))}</label></div><div><label><input type='checkbox' ${output.reverse_digits?'checked':''} onchange='setField(\\\"outputs\\\",${i},\\\"reverse_digits\\\",this.checked)' style='width:auto'/> ${esc(clockText('reverse_digits'))}</label></div></div><div class='row'><div><label><input type='checkbox' ${pick(output.blink_separator,true)?'checked':''} onchange='setField(\\\"outputs\\\",${i},\\\"blink_separator\\\",this.checked)' style='width:auto'/> ${esc(clockText('blink_separator'))}</label></div></div><div><label>${esc(clockText('segment_map'))}</label><div class='row3'><div><label>${esc(clockText('segment_a'))}</label><select onchange='setField(\\\"outputs\\\",${i},\\\"segment_a\\\",Number(this.value))'>${clockSegmentOptions(pick(output.segment_a,1))}</select></div><div><label>${esc(clockText('segment_b'))}</label><select onchange='setField(\\\"outputs\\\",${i},\\\"segment_b\\\",Number(this.value))'>${clockSegmentOptions(pick(output.segment_b,2))}</select></div><div><label>${esc(clockText('segment_c'))}</label><select onchange='setField(\\\"outputs\\\",${i},\\\"segment_c\\\",Number(this.value))'>${clockSegmentOptions(pick(output.segment_c,3))}</select></div></div><div class='row3'><div><label>${esc(clockText('segment_d'))}</label><select onchange='setField(\\\"outputs\\\",${i},\\\"segment_d\\\",Number(this.value))'>${clockSegmentOptions(pick(output.segment_d,4))}</select></div><div><label>${esc(clockText('segment_e'))}</label><select onchange='setField(\\\"outputs\\\",${i},\\\"segment_e\\\",Number(this.value))'>${clockSegmentOptions(pick(output.segment_e,5))}</select></div><div><label>${esc(clockText('segment_f'))}</label><select onchange='setField(\\\"outputs\\\",${i},\\\"segment_f\\\",Number(this.value))'>${clockSegmentOptions(pick(output.segment_f,6))}</select></div></div><div class='row3'><div><label>${esc(clockText('segment_g'))}</label><select onchange='setField(\\\"outputs\\\",${i},\\\"segment_g\\\",Number(this.value))'>${clockSegmentOptions(pick(output.segment_g,7))}</select></div><div><label>${esc(clockText('segment_dp'))}</label><select onchange='setField(\\\"outputs\\\",${i},\\\"segment_dp\\\",Number(this.value))'>${clockSegmentOptions(pick(output.segment_dp,8))}</select></div></div><div class='hint muted'>${esc(clockText('segment_hint'))}</div></div><div class='hint muted'>${esc(clockText('hint'))}</div>`;if(live&&live.parentNode===card)card.insertBefore(block,live);else card.appendChild(block);});}"
-"function renderIo(){const boardProfile=normalizeBoardProfile(pick(cfg.device.board_profile,'esp32-c3-supermini'));const items=ioEntries();document.getElementById('io').innerHTML=items.length?items.map((entry,row)=>{const o=entry.data;const sec=entry.section;const idx=entry.idx;const isButton=entry.kind==='button';return `<div class='item'><div class='itemhead'><strong>${esc(o.name||o.id||(`${isButton?t('button_name'):t('io_name')} ${row+1}`))}</strong><button class='danger' onclick='removeItem(\\\"${sec}\\\",${idx})'>${t('remove')}</button></div><div class='row3'><div><label>${t('kind')}</label><select onchange='changeIoKind(\\\"${sec}\\\",${idx},this.value)'><option value='input' ${!isButton?'selected':''}>${t('kind_input')}</option><option value='button' ${isButton?'selected':''}>${t('kind_button')}</option></select></div><div><label>${t('id')}</label><input value='${esc(o.id||'')}' oninput='setField(\\\"${sec}\\\",${idx},\\\"id\\\",this.value)'/></div><div><label>${t('name')}</label><input value='${esc(o.name||'')}' oninput='setField(\\\"${sec}\\\",${idx},\\\"name\\\",this.value)'/></div></div><div class='row3'><div><label>${t('gpio')}</label><select onchange='setField(\\\"${sec}\\\",${idx},\\\"gpio\\\",Number(this.value))'>${gpioOptions(pick(o.gpio,0),boardProfile)}</select></div><div><label>${t('pull')}</label><select onchange='setField(\\\"${sec}\\\",${idx},\\\"pull\\\",this.value)'>${enumOptions(PULLS,pick(o.pull,'up'),PULL_LABELS)}</select></div>${isButton?`<div><label>${t('long_press_ms')}</label><input type='number' value='${esc(pick(o.long_press_ms,1000))}' oninput='setField(\\\"${sec}\\\",${idx},\\\"long_press_ms\\\",Number(this.value||1000))'/></div>`:`<div><label>${t('role')}</label><select onchange='setField(\\\"${sec}\\\",${idx},\\\"role\\\",this.value)'>${enumOptions(INPUT_ROLES,pick(o.role,'generic_binary'),INPUT_ROLE_LABELS)}</select></div>`}</div><div class='row'><div><label><input type='checkbox' ${o.inverted?'checked':''} onchange='setField(\\\"${sec}\\\",${idx},\\\"inverted\\\",this.checked)' style='width:auto'/> ${t('inverted')}</label></div><div><label><input type='checkbox' ${o.enabled!==false?'checked':''} onchange='setField(\\\"${sec}\\\",${idx},\\\"enabled\\\",this.checked)' style='width:auto'/> ${t('enabled')}</label></div></div>${isButton?actionEditor(sec,idx,'short',(o.actions||{}).short)+actionEditor(sec,idx,'long',(o.actions||{}).long):''}${renderIoLiveCard(entry)}</div>`;}).join(''):`<div class='muted'>${t('empty_io')}</div>`;}"
+"function renderIo(){const boardProfile=normalizeBoardProfile(pick(cfg.device.board_profile,'esp32-c3-supermini'));const items=ioEntries();document.getElementById('io').innerHTML=items.length?items.map((entry,row)=>{const o=entry.data;const sec=entry.section;const idx=entry.idx;const isButton=entry.kind==='button';return `<div class='item'><div class='itemhead'><strong>${esc(o.name||o.id||(`${isButton?t('button_name'):t('io_name')} ${row+1}`))}</strong><button class='danger' onclick='removeItem(\\\"${sec}\\\",${idx})'>${t('remove')}</button></div><div class='row3'><div><label>${t('kind')}</label><select onchange='changeIoKind(\\\"${sec}\\\",${idx},this.value)'><option value='input' ${!isButton?'selected':''}>${t('kind_input')}</option><option value='button' ${isButton?'selected':''}>${t('kind_button')}</option></select></div><div><label>${t('id')}</label><input value='${esc(o.id||'')}' oninput='setField(\\\"${sec}\\\",${idx},\\\"id\\\",this.value)'/></div><div><label>${t('name')}</label><input value='${esc(o.name||'')}' oninput='setField(\\\"${sec}\\\",${idx},\\\"name\\\",this.value)'/></div></div><div class='row3'><div><label>${t('gpio')}</label><select onchange='setField(\\\"${sec}\\\",${idx},\\\"gpio\\\",Number(this.value))'>${gpioOptions(pick(o.gpio,0),boardProfile)}</select></div><div><label>${t('pull')}</label><select onchange='setField(\\\"${sec}\\\",${idx},\\\"pull\\\",this.value)'>${enumOptions(PULLS,pick(o.pull,'up'),PULL_LABELS)}</select></div>${isButton?`<div><label>${t('long_press_ms')}</label><input type='number' value='${esc(pick(o.long_press_ms,1000))}' oninput='setField(\\\"${sec}\\\",${idx},\\\"long_press_ms\\\",Number(this.value||1000))'/></div>`:`<div><label>${t('role')}</label><select onchange='setField(\\\"${sec}\\\",${idx},\\\"role\\\",this.value)'>${enumOptions(INPUT_ROLES,pick(o.role,'generic_binary'),INPUT_ROLE_LABELS)}</select></div>`}</div><div class='row'><div><label><input type='checkbox' ${o.inverted?'checked':''} onchange='setField(\\\"${sec}\\\",${idx},\\\"inverted\\\",this.checked)' style='width:auto'/> ${t('inverted')}</label></div><div><label><input type='checkbox' ${o.enabled!==false?'checked':''} onchange='setField(\\\"${sec}\\\",${idx},\\\"enabled\\\",this.checked)' style='width:auto'/> ${t('enabled')}</label></div></div>${isButton?`<div class='row'><div><label>${t('multi_click_ms')}</label><input type='number' value='${esc(pick(o.multi_click_ms,300))}' oninput='setField(\\\"${sec}\\\",${idx},\\\"multi_click_ms\\\",Number(this.value||300))'/></div><div><label>${t('hold_repeat_ms')}</label><input type='number' value='${esc(pick(o.hold_repeat_ms,200))}' oninput='setField(\\\"${sec}\\\",${idx},\\\"hold_repeat_ms\\\",Number(this.value||200))'/></div></div>`+['short','double','triple','long','hold'].map(w=>actionEditor(sec,idx,w,(o.actions||{})[w])).join(''):''}${renderIoLiveCard(entry)}</div>`;}).join(''):`<div class='muted'>${t('empty_io')}</div>`;}"
 "function renderSensors(){const boardProfile=normalizeBoardProfile(pick(cfg.device.board_profile,'esp32-c3-supermini'));document.getElementById('sensors').innerHTML=cfg.sensors.map((o,i)=>{const type=pick(o.type,'ds18b20_bus');return `<div class='item'><div class='itemhead'><strong>${esc(o.name||o.id||(`${t('sensor_name')} ${i+1}`))}</strong><button class='danger' onclick='removeItem(\\\"sensors\\\",${i})'>${t('remove')}</button></div><div class='row'><div><label>${t('id')}</label><input value='${esc(o.id||'')}' oninput='setField(\\\"sensors\\\",${i},\\\"id\\\",this.value)'/></div><div><label>${t('name')}</label><input value='${esc(o.name||'')}' oninput='setField(\\\"sensors\\\",${i},\\\"name\\\",this.value)'/></div></div><div class='row3'><div><label>${t('type')}</label><select onchange='setField(\\\"sensors\\\",${i},\\\"type\\\",this.value)'>${enumOptions(SENSOR_TYPES,type,SENSOR_TYPE_LABELS)}</select></div><div><label>${t('poll_sec')}</label><input type='number' value='${esc(pick(o.poll_interval_sec,30))}' oninput='setField(\\\"sensors\\\",${i},\\\"poll_interval_sec\\\",Number(this.value||30))'/></div><div><label><input type='checkbox' ${o.enabled!==false?'checked':''} onchange='setField(\\\"sensors\\\",${i},\\\"enabled\\\",this.checked)' style='width:auto'/> ${t('enabled')}</label></div></div>${type==='ds18b20_bus'?`<div><label>${t('gpio')}</label><select onchange='setField(\\\"sensors\\\",${i},\\\"gpio\\\",Number(this.value))'>${gpioOptions(pick(o.gpio,0),boardProfile)}</select></div>`:`<div class='row3'><div><label>${t('sda')}</label><select onchange='setField(\\\"sensors\\\",${i},\\\"sda_gpio\\\",Number(this.value))'>${gpioOptions(pick(o.sda_gpio,0),boardProfile)}</select></div><div><label>${t('scl')}</label><select onchange='setField(\\\"sensors\\\",${i},\\\"scl_gpio\\\",Number(this.value))'>${gpioOptions(pick(o.scl_gpio,1),boardProfile)}</select></div><div><label>${t('address')}</label><input value='${esc(pick(o.address,type==='aht20'?56:type==='sht3x'?68:118))}' oninput='setField(\\\"sensors\\\",${i},\\\"address\\\",Number(this.value||0))'/></div></div>`}</div>`;}).join('');}"
 "function boardHint(){const key=normalizeBoardProfile(pick(cfg.device.board_profile,'esp32-c3-supermini'));const hint=BOARD_HINTS[key]||BOARD_HINTS['esp32-c3-supermini'];return hint[lang]||hint.en||'';}"
-"function renderMeta(){const boardProfile=normalizeBoardProfile(pick(cfg.device.board_profile,'esp32-c3-supermini'));const boardHintText=boardHint();const boardHintEl=document.getElementById('board_hint');document.getElementById('device_name').value=pick(cfg.device.name,'');document.getElementById('sta_ssid').value=pick(cfg.connectivity.sta.ssid,'');document.getElementById('sta_ssid').placeholder=t('select_network');document.getElementById('sta_pass').value=pick(cfg.connectivity.sta.pass,'');document.getElementById('mqtt_host').value=pick(cfg.connectivity.mqtt.host,'');document.getElementById('mqtt_port').value=pick(cfg.connectivity.mqtt.port,1883);document.getElementById('mqtt_user').value=pick(cfg.connectivity.mqtt.user,'');document.getElementById('mqtt_pass').value=pick(cfg.connectivity.mqtt.pass,'');document.getElementById('mqtt_topic_prefix').value=pick(cfg.connectivity.mqtt.topic_prefix,'');document.getElementById('mqtt_client_id').value=pick(cfg.connectivity.mqtt.client_id,'');document.getElementById('mqtt_discovery_prefix').value=pick(cfg.connectivity.mqtt.discovery_prefix,'homeassistant');document.getElementById('mqtt_enable').checked=cfg.connectivity.mqtt.enable===true;document.getElementById('mqtt_discovery').checked=cfg.connectivity.mqtt.discovery!==false;document.getElementById('mqtt_retain').checked=cfg.connectivity.mqtt.retain!==false;document.getElementById('web_auth_enable').checked=cfg.web.auth.enable===true;document.getElementById('web_auth_pass').value=pick(cfg.web.auth.password,'');document.getElementById('auth_token').value=authToken;document.getElementById('board_profile').innerHTML=boardOptions(boardProfile);document.getElementById('board_profile').value=boardProfile;boardHintEl.textContent=boardHintText;boardHintEl.style.display=boardHintText?'block':'none';}"
-"function updateMetaFromInputs(){cfg.device.name=document.getElementById('device_name').value.trim();cfg.connectivity.ap={};cfg.connectivity.sta.ssid=document.getElementById('sta_ssid').value.trim();cfg.connectivity.sta.pass=document.getElementById('sta_pass').value;cfg.connectivity.mqtt.enable=document.getElementById('mqtt_enable').checked;cfg.connectivity.mqtt.host=document.getElementById('mqtt_host').value.trim();cfg.connectivity.mqtt.port=Number(document.getElementById('mqtt_port').value||1883);cfg.connectivity.mqtt.user=document.getElementById('mqtt_user').value.trim();cfg.connectivity.mqtt.pass=document.getElementById('mqtt_pass').value;cfg.connectivity.mqtt.topic_prefix=document.getElementById('mqtt_topic_prefix').value.trim();cfg.connectivity.mqtt.client_id=document.getElementById('mqtt_client_id').value.trim();cfg.connectivity.mqtt.discovery_prefix=document.getElementById('mqtt_discovery_prefix').value.trim();cfg.connectivity.mqtt.discovery=document.getElementById('mqtt_discovery').checked;cfg.connectivity.mqtt.retain=document.getElementById('mqtt_retain').checked;cfg.web.auth.enable=document.getElementById('web_auth_enable').checked;cfg.web.auth.password=document.getElementById('web_auth_pass').value;cfg.device.board_profile=normalizeBoardProfile(document.getElementById('board_profile').value);authToken=document.getElementById('auth_token').value;localStorage.setItem('ui_auth_token',authToken||'');}"
+"function renderMeta(){const boardProfile=normalizeBoardProfile(pick(cfg.device.board_profile,'esp32-c3-supermini'));const boardHintText=boardHint();const boardHintEl=document.getElementById('board_hint');document.getElementById('device_name').value=pick(cfg.device.name,'');document.getElementById('sta_ssid').value=pick(cfg.connectivity.sta.ssid,'');document.getElementById('sta_ssid').placeholder=t('select_network');document.getElementById('sta_pass').value=pick(cfg.connectivity.sta.pass,'');document.getElementById('mqtt_host').value=pick(cfg.connectivity.mqtt.host,'');document.getElementById('mqtt_port').value=pick(cfg.connectivity.mqtt.port,1883);document.getElementById('mqtt_user').value=pick(cfg.connectivity.mqtt.user,'');document.getElementById('mqtt_pass').value=pick(cfg.connectivity.mqtt.pass,'');document.getElementById('mqtt_topic_prefix').value=pick(cfg.connectivity.mqtt.topic_prefix,'');document.getElementById('mqtt_client_id').value=pick(cfg.connectivity.mqtt.client_id,'');document.getElementById('mqtt_discovery_prefix').value=pick(cfg.connectivity.mqtt.discovery_prefix,'homeassistant');document.getElementById('mqtt_enable').checked=cfg.connectivity.mqtt.enable===true;document.getElementById('mqtt_discovery').checked=cfg.connectivity.mqtt.discovery!==false;document.getElementById('mqtt_retain').checked=cfg.connectivity.mqtt.retain!==false;document.getElementById('mqtt_state_mode').value=pick(cfg.connectivity.mqtt.state_mode,'entity');document.getElementById('mqtt_state_window_ms').value=pick(cfg.connectivity.mqtt.state_window_ms,200);document.getElementById('web_auth_enable').checked=cfg.web.auth.enable===true;document.getElementById('web_auth_pass').value=pick(cfg.web.auth.password,'');document.getElementById('auth_token').value=authToken;document.getElementById('board_profile').innerHTML=boardOptions(boardProfile);document.getElementById('board_profile').value=boardProfile;boardHintEl.textContent=boardHintText;boardHintEl.style.display=boardHintText?'block':'none';}"
+"function updateMetaFromInputs(){cfg.device.name=document.getElementById('device_name').value.trim();cfg.connectivity.ap={};cfg.connectivity.sta.ssid=document.getElementById('sta_ssid').value.trim();cfg.connectivity.sta.pass=document.getElementById('sta_pass').value;cfg.connectivity.mqtt.enable=document.getElementById('mqtt_enable').checked;cfg.connectivity.mqtt.host=document.getElementById('mqtt_host').value.trim();cfg.connectivity.mqtt.port=Number(document.getElementById('mqtt_port').value||1883);cfg.connectivity.mqtt.user=document.getElementById('mqtt_user').value.trim();cfg.connectivity.mqtt.pass=document.getElementById('mqtt_pass').value;cfg.connectivity.mqtt.topic_prefix=document.getElementById('mqtt_topic_prefix').value.trim();cfg.connectivity.mqtt.client_id=document.getElementById('mqtt_client_id').value.trim();cfg.connectivity.mqtt.discovery_prefix=document.getElementById('mqtt_discovery_prefix').value.trim();cfg.connectivity.mqtt.discovery=document.getElementById('mqtt_discovery').checked;cfg.connectivity.mqtt.retain=document.getElementById('mqtt_retain').checked;cfg.connectivity.mqtt.state_mode=document.getElementById('mqtt_state_mode').value;cfg.connectivity.mqtt.state_window_ms=Number(document.getElementById('mqtt_state_window_ms').value||200);cfg.web.auth.enable=document.getElementById('web_auth_enable').checked;cfg.web.auth.password=document.getElementById('web_auth_pass').value;cfg.device.board_profile=normalizeBoardProfile(document.getElementById('board_profile').value);authToken=document.getElementById('auth_token').value;localStorage.setItem('ui_auth_token',authToken||'');}"
 "function setBoardProfile(value){updateMetaFromInputs();cfg.device.board_profile=normalizeBoardProfile(value);render();}"
 "function validateGpios(){const boardProfile=normalizeBoardProfile(pick(cfg.device.board_profile,'esp32-c3-supermini'));const used={};const errors=[];const touch=(label,g,opts)=>{if(g===undefined||g===null||g==='')return;const gpio=Number(g);const opt=opts||{};if(!Number.isInteger(gpio)){errors.push(`${label}: invalid GPIO`);return;}if(!gpioAllowed(boardProfile,gpio))errors.push(`${label}: ${gpioForbiddenText(boardProfile,gpio)}`);if(opt.adc&&!adcFeedbackGpios(boardProfile).includes(gpio))errors.push(`${label}: ${lang==='ru'?'\\u043D\\u0443\\u0436\\u0435\\u043D ADC-\\u0441\\u043E\\u0432\\u043C\\u0435\\u0441\\u0442\\u0438\\u043C\\u044B\\u0439 GPIO0..GPIO4':'requires ADC-capable GPIO0..GPIO4'}`);const key=String(gpio);used[key]=used[key]||[];used[key].push(label);};cfg.outputs.forEach(o=>{const name=`${t('output_name')} ${o.id||o.name||'?'}`;touch(name,o.gpio);if(o.type==='pwm')touch(`${name} (${uiText('power_relay')})`,o.power_relay_gpio);if(o.type==='servo_5wire'){touch(`${name} (B)`,o.gpio_b);touch(`${name} (${uiText('servo_feedback')})`,o.feedback_gpio,{adc:true});}if(o.type==='clock_4x4094'){touch(`${name} (CLOCK)`,o.gpio_b);touch(`${name} (LATCH)`,o.gpio_c);touch(`${name} (BRIGHT)`,o.brightness_gpio);}if(o.type==='stepper_28byj'){touch(`${name} (B)`,o.gpio_b);touch(`${name} (C)`,o.gpio_c);touch(`${name} (D)`,o.gpio_d);touch(`${name} (HOME)`,o.home_gpio);}if(o.type==='stepper_a4988'){touch(`${name} (DIR)`,o.gpio_b);touch(`${name} (ENABLE)`,o.gpio_c);touch(`${name} (HOME)`,o.home_gpio);}});cfg.inputs.forEach(o=>touch(`${t('io_name')} ${o.id||o.name||'?'}`,o.gpio));cfg.buttons.forEach(o=>touch(`${t('button_name')} ${o.id||o.name||'?'}`,o.gpio));cfg.sensors.forEach(o=>{if(o.type==='ds18b20_bus'){touch(`${t('sensor_name')} ${o.id||o.name||'?'}`,o.gpio);}else{touch('i2c_sda',o.sda_gpio);touch('i2c_scl',o.scl_gpio);}});Object.entries(used).forEach(([gpio,list])=>{if(list.length>1&&!(list.every(v=>v==='i2c_sda')||list.every(v=>v==='i2c_scl')))errors.push(`GPIO${gpio}: ${list.join(', ')}`);});document.getElementById('pinout_summary').innerHTML=errors.length?`<span class='err'>${t('conflicts')}:</span><br>${errors.map(esc).join('<br>')}`:`<span class='ok'>${t('no_gpio_conflicts')}</span>`;return errors.length===0;}"
 "function collectPinUsage(){const usage={};const add=(gpio,kind,label,share)=>{const num=Number(gpio);if(!Number.isInteger(num))return;const key=String(num);usage[key]=usage[key]||[];usage[key].push({kind,label,share:share||''});};cfg.outputs.forEach(o=>{const name=`${t('output_name')} ${o.id||o.name||'?'}`;add(o.gpio,'output',name,'');if(o.type==='pwm')add(o.power_relay_gpio,'output',`${name} (${uiText('power_relay')})`,'');if(o.type==='servo_5wire'){add(o.gpio_b,'output',`${name} (B)`,'');add(o.feedback_gpio,'sensor',`${name} (${uiText('servo_feedback')})`,'');}if(o.type==='clock_4x4094'){add(o.gpio_b,'output',`${name} (CLOCK)`,'');add(o.gpio_c,'output',`${name} (LATCH)`,'');add(o.brightness_gpio,'output',`${name} (BRIGHT)`,'');}if(o.type==='stepper_28byj'){add(o.gpio_b,'output',`${name} (B)`,'');add(o.gpio_c,'output',`${name} (C)`,'');add(o.gpio_d,'output',`${name} (D)`,'');add(o.home_gpio,'io',`${name} (HOME)`,'');}if(o.type==='stepper_a4988'){add(o.gpio_b,'output',`${name} (DIR)`,'');add(o.gpio_c,'output',`${name} (ENABLE)`,'');add(o.home_gpio,'io',`${name} (HOME)`,'');}});cfg.inputs.forEach(o=>add(o.gpio,'io',`${t('io_name')} ${o.id||o.name||'?'}`,''));cfg.buttons.forEach(o=>add(o.gpio,'io',`${t('button_name')} ${o.id||o.name||'?'}`,''));cfg.sensors.forEach(o=>{const name=`${t('sensor_name')} ${o.id||o.name||'?'}`;if(o.type==='ds18b20_bus'){add(o.gpio,'sensor',`${name} (${o.type||'sensor'})`,'');}else{add(o.sda_gpio,'sensor',`${name} SDA`,'i2c_sda');add(o.scl_gpio,'sensor',`${name} SCL`,'i2c_scl');}});return usage;}"
@@ -220,8 +228,8 @@ static const char *WEB_INDEX_HTML =
 "async function restoreBackup(){const input=document.getElementById('backup_file');try{const file=input.files&&input.files[0];if(!file)throw new Error(uxText('backup_choose'));if(!confirm(fmt(uxText('backup_confirm'),{name:file.name})))return;const text=await file.text();const parsed=JSON.parse(text);const r=await apiFetch('/api/restore',{method:'POST',headers:{'Content-Type':'application/json'},body:JSON.stringify(parsed)});const body=await r.text();if(!r.ok)throw new Error(body||('HTTP '+r.status));setMsg(uxText('backup_done'),true);input.value='';await loadCfg();}catch(e){setMsg(String(e),false);}}"
 "function renderSystemStatus(){const diag=document.getElementById('system_diag');const events=document.getElementById('system_events');if(diag){const lines=[];if(systemInfo&&Object.keys(systemInfo).length){lines.push(`uptime_ms: ${pick(systemInfo.uptime_ms,'-')}`);lines.push(`free_heap: ${pick(systemInfo.free_heap,'-')}`);lines.push(`min_free_heap: ${pick(systemInfo.min_free_heap,'-')}`);lines.push(`reset_reason: ${pick(systemInfo.reset_reason,'-')}`);lines.push(`wifi_mode: ${pick(systemInfo.mode,'-')}`);lines.push(`sta_has_ip: ${!!systemInfo.sta_has_ip}`);lines.push(`sta_rssi: ${pick(systemInfo.sta_rssi,'-')}`);lines.push(`mqtt_connected: ${!!systemInfo.mqtt_connected}`);lines.push(`auth_enabled: ${!!systemInfo.auth_enabled}`);}diag.textContent=lines.length?lines.join('\\n'):uxText('diag_loading');}if(events){const list=Array.isArray(systemInfo.events)?systemInfo.events:[];events.innerHTML=list.length?`<strong>${esc(uxText('events_title'))}</strong><br>${list.map(ev=>`${esc(ev.ts_ms)} · ${esc(ev.source)} · ${esc(ev.level)} · ${esc(ev.message)}`).join('<br>')}`:`<strong>${esc(uxText('events_title'))}</strong><br><span class='muted'>-</span>`;}}"
 "async function refreshSystemStatus(){try{const [sysResp,eventsResp]=await Promise.all([apiFetch('/api/system'),apiFetch('/api/events')]);if(sysResp.status===401||eventsResp.status===401)throw new Error(uxText('auth_required'));if(!sysResp.ok)throw new Error(await sysResp.text()||('HTTP '+sysResp.status));if(!eventsResp.ok)throw new Error(await eventsResp.text()||('HTTP '+eventsResp.status));const sys=await sysResp.json();const eventsJson=await eventsResp.json();systemInfo=Object.assign({},sys,{events:Array.isArray(eventsJson.events)?eventsJson.events:[]});renderSystemStatus();}catch(e){setMsg(String(e),false);}}"
-"async function reloadWithAuth(){authToken=document.getElementById('auth_token').value||'';localStorage.setItem('ui_auth_token',authToken);await loadCfg();}"
-"function applyI18n(){const subtitle=firmwareSubtitle();document.documentElement.lang=(lang==='ru'?'ru':'en');document.title=t('title');document.getElementById('lang_select').value=lang;document.getElementById('page_title').textContent=t('title');document.getElementById('page_subtitle').textContent=subtitle;document.getElementById('page_subtitle').style.display=subtitle?'block':'none';document.getElementById('btn_save_apply').textContent=t('save_apply');document.getElementById('btn_factory_reset').textContent=t('factory_reset');document.getElementById('connectivity_title').textContent=t('connectivity');document.getElementById('lbl_device_name').textContent=t('device_name');document.getElementById('lbl_sta_ssid').textContent=t('sta_ssid');document.getElementById('lbl_sta_pass').textContent=t('sta_pass');document.getElementById('lbl_mqtt_host').textContent=t('mqtt_host');document.getElementById('lbl_mqtt_port').textContent=t('mqtt_port');document.getElementById('lbl_mqtt_user').textContent=t('mqtt_user');document.getElementById('lbl_mqtt_pass').textContent=t('mqtt_pass');document.getElementById('lbl_topic_prefix').textContent=t('topic_prefix');document.getElementById('lbl_client_id').textContent=t('client_id');document.getElementById('lbl_discovery_prefix').textContent=t('discovery_prefix');document.getElementById('lbl_board_profile').textContent=t('board_profile');document.getElementById('lbl_mqtt_enable').textContent=t('mqtt_enabled');document.getElementById('lbl_mqtt_discovery').textContent=t('ha_discovery');document.getElementById('lbl_mqtt_retain').textContent=t('retain');document.getElementById('ota_title').textContent=t('ota_title');document.getElementById('lbl_ota_file').textContent=t('ota_file');document.getElementById('btn_ota_upload').textContent=t('ota_upload');document.getElementById('ota_hint').textContent=t('ota_hint');document.getElementById('outputs_title').textContent=t('outputs');document.getElementById('btn_add_output').textContent=t('add_output');document.getElementById('io_title').textContent=t('io_title');document.getElementById('btn_add_io').textContent=t('add_io');document.getElementById('sensors_title').textContent=t('sensors');document.getElementById('btn_add_sensor').textContent=t('add_sensor');document.getElementById('auth_token').placeholder=uxText('auth_token');document.getElementById('btn_auth_unlock').textContent=uxText('unlock');document.getElementById('lbl_web_auth_enable').textContent=uxText('web_auth_enable');document.getElementById('lbl_web_auth_pass').textContent=uxText('web_auth_pass');document.getElementById('backup_title').textContent=uxText('backup_title');document.getElementById('lbl_backup_file').textContent=uxText('backup_file');document.getElementById('btn_backup_export').textContent=uxText('backup_export');document.getElementById('btn_backup_import').textContent=uxText('backup_import');document.getElementById('backup_hint').textContent=uxText('backup_hint');document.getElementById('system_title').textContent=uxText('system_title');document.getElementById('btn_refresh_system').textContent=uxText('refresh');}"
+"async function reloadWithAuth(){authToken=document.getElementById('auth_token').value||'';localStorage.setItem('ui_auth_token',authToken);if(liveSocket){const ws=liveSocket;liveSocket=null;ws.close();}await loadCfg();}"
+"function applyI18n(){const subtitle=firmwareSubtitle();document.documentElement.lang=(lang==='ru'?'ru':'en');document.title=t('title');document.getElementById('lang_select').value=lang;document.getElementById('page_title').textContent=t('title');document.getElementById('page_subtitle').textContent=subtitle;document.getElementById('page_subtitle').style.display=subtitle?'block':'none';document.getElementById('btn_save_apply').textContent=t('save_apply');document.getElementById('btn_factory_reset').textContent=t('factory_reset');document.getElementById('connectivity_title').textContent=t('connectivity');document.getElementById('lbl_device_name').textContent=t('device_name');document.getElementById('lbl_sta_ssid').textContent=t('sta_ssid');document.getElementById('lbl_sta_pass').textContent=t('sta_pass');document.getElementById('lbl_mqtt_host').textContent=t('mqtt_host');document.getElementById('lbl_mqtt_port').textContent=t('mqtt_port');document.getElementById('lbl_mqtt_user').textContent=t('mqtt_user');document.getElementById('lbl_mqtt_pass').textContent=t('mqtt_pass');document.getElementById('lbl_topic_prefix').textContent=t('topic_prefix');document.getElementById('lbl_client_id').textContent=t('client_id');document.getElementById('lbl_discovery_prefix').textContent=t('discovery_prefix');document.getElementById('lbl_board_profile').textContent=t('board_profile');document.getElementById('lbl_mqtt_enable').textContent=t('mqtt_enabled');document.getElementById('lbl_mqtt_discovery').textContent=t('ha_discovery');document.getElementById('lbl_mqtt_retain').textContent=t('retain');document.getElementById('lbl_mqtt_state_mode').textContent=t('state_mode');document.getElementById('lbl_mqtt_state_window_ms').textContent=t('state_window_ms');document.getElementById('ota_title').textContent=t('ota_title');document.getElementById('lbl_ota_file').textContent=t('ota_file');document.getElementById('btn_ota_upload').textContent=t('ota_upload');document.getElementById('ota_hint').textContent=t('ota_hint');document.getElementById('outputs_title').textContent=t('outputs');document.getElementById('btn_add_output').textContent=t('add_output');document.getElementById('io_title').textContent=t('io_title');document.getElementById('btn_add_io').textContent=t('add_io');document.getElementById('sensors_title').textContent=t('sensors');document.getElementById('btn_add_sensor').textContent=t('add_sensor');document.getElementById('auth_token').placeholder=uxText('auth_token');document.getElementById('btn_auth_unlock').textContent=uxText('unlock');document.getElementById('lbl_web_auth_enable').textContent=uxText('web_auth_enable');document.getElementById('lbl_web_auth_pass').textContent=uxText('web_auth_pass');document.getElementById('backup_title').textContent=uxText('backup_title');document.getElementById('lbl_backup_file').textContent=uxText('backup_file');document.getElementById('btn_backup_export').textContent=uxText('backup_export');document.getElementById('btn_backup_import').textContent=uxText('backup_import');document.getElementById('backup_hint').textContent=uxText('backup_hint');document.getElementById('system_title').textContent=uxText('system_title');document.getElementById('btn_refresh_system').textContent=uxText('refresh');}"
 "async function ensureWifiScan(){if(wifiScanLoaded)return;if(wifiScanInFlight){await wifiScanInFlight;return;}wifiScanInFlight=scanWifi(true).finally(()=>{wifiScanInFlight=null;});await wifiScanInFlight;}"
 "function render(){ensure();applyI18n();renderMeta();renderOutputs();renderWs2812GammaOptions();renderClock4094Options();renderStepperOptions();renderIo();renderSensors();renderPinout();validateGpios();refreshLiveWidgets();renderSystemStatus();startLivePolling();}"
 "function setLang(value){lang=(value==='en'?'en':'ru');localStorage.setItem('ui_lang',lang);render();}"
@@ -0,0 +1,265 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "core/motion.h"
+#include "core/ws2812_render.h"
+#include "fake/fake_led_strip.h"
+
+#if HOST_BENCH_CJSON
+#include "core/cfg_codec.h"
+#include "net/json_stream.h"
+#endif
+
+// Host-side cost of the hot paths. Absolute numbers are for comparing builds on one machine, not a
+// stand-in for on-target timings; /api/perf reports those.
+
+#define BENCH_PIXELS 300
+
+static volatile uint32_t s_sink;
+
+static int64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void report(const char *name, int64_t elapsed_ns, uint64_t units, const char *unit)
+{
+    printf("%-28s %10.2f ns/%s\n", name, (double)elapsed_ns / (double)units, unit);
+}
+
+static void bench_motion(void)
+{
+    const int moves = 2000;
+    const int distance = 4000;
+    motion_profile_t profile;
+    uint64_t steps = 0;
+    int64_t start = now_ns();
+
+    // Same per-step sequence as the stepper service: interval, then advance with the steps left.
+    for (int m = 0; m < moves; ++m) {
+        motion_profile_init(&profile, 1000 + (m & 1023), 2000 + (m & 4095));
+        motion_profile_start(&profile, distance);
+        for (int left = distance; left > 0 && motion_profile_running(&profile);) {
+            s_sink += motion_profile_interval_us(&profile);
+            motion_profile_advance(&profile, --left);
+            steps++;
+        }
+    }
+    report("motion step", now_ns() - start, steps, "step");
+}
+
+static void bench_ws2812(void)
+{
+    static const uint8_t base[3] = {255, 128, 32};
+    static uint8_t frame[BENCH_PIXELS * WS2812_BYTES_PER_PIXEL];
+    const int iterations = 20000;
+    ws2812_palette_t palette;
+    ws2812_effect_cfg_t fx = {
+        .speed = 64,
+        .gradient_rgb = {0, 0, 255},
+        .segments = {{0, 100, {255, 0, 0}}, {150, 100, {0, 255, 0}}},
+        .segment_count = 2,
+    };
+    char name[40];
+    int64_t start;
+
+    ws2812_palette_init(&palette, "GRB", true);
+
+    // Alternating levels rebuild the LUT every frame, the worst case for a fade.
+    start = now_ns();
+    for (int i = 0; i < iterations; ++i) {
+        ws2812_render_solid(&palette, frame, BENCH_PIXELS, 128 + (i & 1), base);
+        s_sink += frame[i % sizeof(frame)];
+    }
+    report("ws2812 solid (lut rebuild)", now_ns() - start, (uint64_t)iterations * BENCH_PIXELS, "pixel");
+
+    start = now_ns();
+    for (int i = 0; i < iterations; ++i) {
+        ws2812_render_solid(&palette, frame, BENCH_PIXELS, 200, base);
+        s_sink += frame[i % sizeof(frame)];
+    }
+    report("ws2812 solid", now_ns() - start, (uint64_t)iterations * BENCH_PIXELS, "pixel");
+
+    start = now_ns();
+    for (int i = 0; i < iterations; ++i) {
+        ws2812_render_mono(&palette, frame, BENCH_PIXELS, 200, i % (BENCH_PIXELS * WS2812_BYTES_PER_PIXEL));
+        s_sink += frame[i % sizeof(frame)];
+    }
+    report("ws2812 mono wipe", now_ns() - start, (uint64_t)iterations * BENCH_PIXELS, "pixel");
+
+    for (int e = WS2812_EFFECT_RAINBOW; e < WS2812_EFFECT_COUNT; ++e) {
+        fx.effect = (ws2812_effect_t)e;
+        start = now_ns();
+        for (int i = 0; i < iterations; ++i) {
+            ws2812_render_effect(&palette, frame, BENCH_PIXELS, &fx, 200, base, (uint32_t)i);
+            s_sink += frame[i % sizeof(frame)];
+        }
+        snprintf(name, sizeof(name), "ws2812 %s", ws2812_effect_name((ws2812_effect_t)e));
+        report(name, now_ns() - start, (uint64_t)iterations * BENCH_PIXELS, "pixel");
+    }
+
+    // A fade frame as modules.c produces it: step the transition, then render the solid fill.
+    static const uint8_t black[3] = {0, 0, 0};
+    ws2812_transition_t transition;
+    ws2812_transition_frame_t step;
+    start = now_ns();
+    for (int i = 0; i < iterations; ++i) {
+        if (i % 1000 == 0) {
+            ws2812_transition_start(&transition, 1000, WS2812_EASING_CIE, false, 0, black, 255, base);
+        }
+        ws2812_transition_step(&transition, (int64_t)(i % 1000) * 1000, BENCH_PIXELS, &step);
+        ws2812_render_solid(&palette, frame, BENCH_PIXELS, step.level, step.rgb);
+        s_sink += frame[i % sizeof(frame)];
+    }
+    report("ws2812 fade step", now_ns() - start, (uint64_t)iterations * BENCH_PIXELS, "pixel");
+
+    // Copy into the led_strip buffer; the fake strip only adds a memcpy at refresh.
+    led_strip_handle_t strip = fake_led_strip_new(BENCH_PIXELS);
+    if (strip) {
+        start = now_ns();
+        for (int i = 0; i < iterations; ++i) {
+            s_sink += (uint32_t)ws2812_transmit(strip, frame, BENCH_PIXELS);
+        }
+        report("ws2812 transmit (fake)", now_ns() - start, (uint64_t)iterations * BENCH_PIXELS, "pixel");
+        led_strip_del(strip);
+    }
+}
+
+#if HOST_BENCH_CJSON
+struct httpd_req {
+    uint64_t bytes;
+    uint32_t chunks;
+};
+
+esp_err_t httpd_resp_send_chunk(httpd_req_t *req, const char *buf, ssize_t buf_len)
+{
+    if (buf) {
+        req->bytes += (uint64_t)buf_len;
+        req->chunks++;
+        s_sink += (uint8_t)buf[0];
+    }
+    return ESP_OK;
+}
+
+// Shaped like a full config: a few scalar sections and a list of outputs with the usual fields.
+static cJSON *make_config(int outputs)
+{
+    cJSON *root = cJSON_CreateObject();
+    cJSON *wifi = cJSON_AddObjectToObject(root, "wifi");
+    cJSON *list = cJSON_AddArrayToObject(root, "outputs");
+    char id[24];
+
+    cJSON_AddStringToObject(wifi, "ssid", "workshop-iot");
+    cJSON_AddStringToObject(wifi, "hostname", "esp32-c3-relay-board");
+    cJSON_AddBoolToObject(wifi, "dhcp", true);
+    for (int i = 0; i < outputs; ++i) {
+        cJSON *out = cJSON_CreateObject();
+        snprintf(id, sizeof(id), "output_%02d", i);
+        cJSON_AddStringToObject(out, "id", id);
+        cJSON_AddStringToObject(out, "name", "Living room \"ceiling\" light");
+        cJSON_AddStringToObject(out, "type", i & 1 ? "pwm" : "relay");
+        cJSON_AddNumberToObject(out, "gpio", i % 22);
+        cJSON_AddNumberToObject(out, "freq_hz", 1000);
+        cJSON_AddNumberToObject(out, "max_level_pct", 87.5);
+        cJSON_AddBoolToObject(out, "inverted", i % 3 == 0);
+        cJSON_AddBoolToObject(out, "default_on", false);
+        cJSON_AddItemToArray(list, out);
+    }
+    return root;
+}
+
+static void bench_json_stream(void)
+{
+    const int iterations = 5000;
+    cJSON *cfg = make_config(16);
+    struct httpd_req req = {0};
+    json_stream_t js;
+    int64_t start;
+
+    start = now_ns();
+    for (int i = 0; i < iterations; ++i) {
+        json_stream_init(&js, &req);
+        json_stream_item(&js, NULL, cfg);
+        if (json_stream_finish(&js) != ESP_OK) {
+            abort();
+        }
+    }
+    report("json_stream item", now_ns() - start, req.bytes, "byte");
+    printf("%-28s %10.2f bytes/chunk\n", "json_stream chunking", (double)req.bytes / (double)req.chunks);
+
+    // The buffered print it replaced, for comparison.
+    uint64_t bytes = 0;
+    start = now_ns();
+    for (int i = 0; i < iterations; ++i) {
+        char *text = cJSON_PrintUnformatted(cfg);
+        bytes += strlen(text);
+        cJSON_free(text);
+    }
+    report("cJSON_PrintUnformatted", now_ns() - start, bytes, "byte");
+    cJSON_Delete(cfg);
+}
+
+static void bench_cfg_codec(void)
+{
+    const int iterations = 2000;
+    cJSON *cfg = make_config(16);
+    uint64_t bytes = 0;
+    uint64_t text_bytes = 0;
+    int64_t encode_ns = 0;
+    int64_t decode_ns = 0;
+    int64_t parse_ns = 0;
+
+    for (int i = 0; i < iterations; ++i) {
+        uint8_t *blob = NULL;
+        size_t len = 0;
+        cJSON *decoded = NULL;
+        int64_t t0 = now_ns();
+        if (cfg_codec_encode(cfg, 0, &blob, &len) != ESP_OK) {
+            abort();
+        }
+        int64_t t1 = now_ns();
+        if (cfg_codec_decode(blob, len, &decoded) != ESP_OK) {
+            abort();
+        }
+        int64_t t2 = now_ns();
+        encode_ns += t1 - t0;
+        decode_ns += t2 - t1;
+        bytes += len;
+        cJSON_Delete(decoded);
+        free(blob);
+
+        char *text = cJSON_PrintUnformatted(cfg);
+        int64_t t3 = now_ns();
+        decoded = cJSON_Parse(text);
+        parse_ns += now_ns() - t3;
+        text_bytes += strlen(text);
+        cJSON_Delete(decoded);
+        cJSON_free(text);
+    }
+    report("cfg_codec encode", encode_ns, bytes, "byte");
+    report("cfg_codec decode", decode_ns, bytes, "byte");
+    report("cJSON_Parse", parse_ns, text_bytes, "byte");
+    printf("%-28s %10.2f %% of JSON text\n", "cfg_codec size", 100.0 * (double)bytes / (double)text_bytes);
+    cJSON_Delete(cfg);
+}
+#endif
+
+int main(void)
+{
+    bench_motion();
+    bench_ws2812();
+#if HOST_BENCH_CJSON
+    bench_json_stream();
+    bench_cfg_codec();
+#else
+    printf("json_stream, cfg_codec: skipped, built without cJSON\n");
+#endif
+    return 0;
+}
@@ -0,0 +1,250 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "app_config.h"
+#include "cJSON.h"
+#include "core/cfg_json.h"
+#include "core/modules.h"
+#include "fake/fake_idf.h"
+#include "fake/fake_mqtt.h"
+#include "net/mqtt_mgr.h"
+#include "sim/sim_hooks.h"
+
+// modules, cfg_json and mqtt_mgr built unchanged against the simulated HAL in fake/, swept from a
+// minimal board to the firmware limits. Numbers compare builds on one machine; /api/perf has the
+// on-target ones. Rows that need more pins than the board profile offers skip cfg_json validation
+// and go straight to modules_apply_config ("raw").
+
+#define BENCH_POLL_ITERATIONS 20000
+#define BENCH_POLL_STEP_US 1000
+#define BENCH_INPUT_TOGGLE_EVERY 64
+#define BENCH_STATUS_ITERATIONS 2000
+#define BENCH_PUBLISH_ITERATIONS 2000
+
+typedef struct {
+    int relays;
+    int pwms;
+    int ws2812s;
+    int inputs;
+    int sensors;
+} bench_row_t;
+
+static const bench_row_t k_rows[] = {
+    {.relays = 1, .inputs = 1},
+    {.relays = 2, .pwms = 1, .ws2812s = 1, .inputs = 2},
+    // Every pin of the esp32-c3-luatos profile.
+    {.relays = 3, .pwms = 2, .ws2812s = 1, .inputs = 2, .sensors = 4},
+    {.relays = 8, .pwms = 6, .ws2812s = 2, .inputs = APP_MODULES_MAX_INPUTS_AND_BUTTONS,
+     .sensors = APP_MODULES_MAX_SENSORS},
+};
+
+static const int k_board_gpios[] = {0, 1, 3, 4, 5, 6, 7, 10, 12, 13};
+
+static volatile uint32_t s_sink;
+
+static int64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static int row_pins(const bench_row_t *row)
+{
+    return row->relays + row->pwms + row->ws2812s + row->inputs + (row->sensors > 0 ? 2 : 0);
+}
+
+static int next_gpio(int *used, bool board)
+{
+    int n = (*used)++;
+    return board ? k_board_gpios[n] : n;
+}
+
+static cJSON *make_config(const bench_row_t *row, int *input_gpios)
+{
+    static const char *const k_sensor_types[] = {"aht20", "sht3x", "bme280", "bme280"};
+    static const int k_sensor_addresses[] = {0x38, 0x44, 0x76, 0x77};
+    bool board = row_pins(row) <= (int)(sizeof(k_board_gpios) / sizeof(k_board_gpios[0]));
+    cJSON *root = cJSON_CreateObject();
+    cJSON *device = cJSON_AddObjectToObject(root, "device");
+    cJSON *mqtt = cJSON_AddObjectToObject(cJSON_AddObjectToObject(root, "connectivity"), "mqtt");
+    cJSON *outputs = cJSON_AddArrayToObject(root, "outputs");
+    cJSON *inputs = cJSON_AddArrayToObject(root, "inputs");
+    cJSON *sensors = cJSON_AddArrayToObject(root, "sensors");
+    int used = 0;
+    char id[24];
+
+    cJSON_AddStringToObject(device, "name", "Bench board");
+    cJSON_AddStringToObject(device, "board_profile", "esp32-c3-luatos");
+    cJSON_AddStringToObject(device, "node_id", "bench");
+    cJSON_AddBoolToObject(mqtt, "enable", true);
+    cJSON_AddStringToObject(mqtt, "host", "broker.local");
+    cJSON_AddNumberToObject(mqtt, "state_window_ms", 0);
+
+    for (int i = 0; i < row->relays + row->pwms + row->ws2812s; ++i) {
+        cJSON *out = cJSON_CreateObject();
+        snprintf(id, sizeof(id), "out_%02d", i);
+        cJSON_AddStringToObject(out, "id", id);
+        cJSON_AddNumberToObject(out, "gpio", next_gpio(&used, board));
+        if (i < row->relays) {
+            cJSON_AddStringToObject(out, "type", "relay");
+            cJSON_AddBoolToObject(out, "default_on", i & 1);
+        } else if (i < row->relays + row->pwms) {
+            cJSON_AddStringToObject(out, "type", "pwm");
+            cJSON_AddNumberToObject(out, "freq_hz", 1000);
+            cJSON_AddNumberToObject(out, "default_level", 40);
+        } else {
+            // An animated strip re-renders on its own schedule: the heaviest poll-task client.
+            cJSON_AddStringToObject(out, "type", "ws2812");
+            cJSON_AddNumberToObject(out, "pixel_count", 60);
+            cJSON_AddBoolToObject(out, "default_power_on", true);
+            cJSON_AddStringToObject(out, "effect", "rainbow");
+        }
+        cJSON_AddItemToArray(outputs, out);
+    }
+    for (int i = 0; i < row->inputs; ++i) {
+        cJSON *in = cJSON_CreateObject();
+        snprintf(id, sizeof(id), "in_%02d", i);
+        input_gpios[i] = next_gpio(&used, board);
+        cJSON_AddStringToObject(in, "id", id);
+        cJSON_AddNumberToObject(in, "gpio", input_gpios[i]);
+        cJSON_AddStringToObject(in, "role", i & 1 ? "contact" : "motion");
+        cJSON_AddItemToArray(inputs, in);
+    }
+    if (row->sensors > 0) {
+        int sda = next_gpio(&used, board);
+        int scl = next_gpio(&used, board);
+        for (int i = 0; i < row->sensors; ++i) {
+            cJSON *sensor = cJSON_CreateObject();
+            snprintf(id, sizeof(id), "env_%02d", i);
+            cJSON_AddStringToObject(sensor, "id", id);
+            cJSON_AddStringToObject(sensor, "type", k_sensor_types[i]);
+            cJSON_AddNumberToObject(sensor, "sda_gpio", sda);
+            cJSON_AddNumberToObject(sensor, "scl_gpio", scl);
+            cJSON_AddNumberToObject(sensor, "address", k_sensor_addresses[i]);
+            cJSON_AddItemToArray(sensors, sensor);
+        }
+    }
+    return root;
+}
+
+static int status_entities(void)
+{
+    static const char *const k_sections[] = {"outputs", "inputs", "sensors", "buttons"};
+    cJSON *status = modules_build_status_json();
+    int count = 0;
+
+    for (size_t i = 0; status && i < sizeof(k_sections) / sizeof(k_sections[0]); ++i) {
+        count += cJSON_GetArraySize(cJSON_GetObjectItem(status, k_sections[i]));
+    }
+    cJSON_Delete(status);
+    return count;
+}
+
+static bool apply_row(const bench_row_t *row, int *input_gpios, bool *validated, int64_t *save_ns)
+{
+    cJSON *cfg = make_config(row, input_gpios);
+    const cJSON *applied = cfg;
+    esp_err_t err;
+    int64_t start = now_ns();
+
+    *validated = cfg_json_set_and_save(cfg) == ESP_OK;
+    *save_ns = now_ns() - start;
+    if (*validated) {
+        applied = cfg_json_get();
+    }
+    err = modules_apply_config(applied);
+    if (err == ESP_OK) {
+        err = mqtt_mgr_restart_from_cfg(applied);
+    }
+    cJSON_Delete(cfg);
+    if (err != ESP_OK) {
+        fprintf(stderr, "bench_runtime: apply failed: %s (%s)\n", esp_err_to_name(err), modules_last_error());
+        return false;
+    }
+    fake_mqtt_deliver(MQTT_EVENT_CONNECTED);
+    return true;
+}
+
+static void bench_row(const bench_row_t *row)
+{
+    int input_gpios[APP_MODULES_MAX_INPUTS_AND_BUTTONS] = {0};
+    int input_levels[APP_MODULES_MAX_INPUTS_AND_BUTTONS] = {0};
+    fake_mqtt_stats_t mqtt;
+    bool validated;
+    int64_t save_ns;
+    int64_t start;
+    int64_t poll_ns;
+    int64_t status_ns;
+    int64_t publish_ns;
+    uint32_t poll_publishes;
+
+    if (!apply_row(row, input_gpios, &validated, &save_ns)) {
+        exit(1);
+    }
+    for (int i = 0; i < row->inputs; ++i) {
+        input_levels[i] = 1;
+    }
+    // The sensor task never runs on the host; one pass gives every sensor a reading to publish.
+    sim_modules_sensor_once();
+
+    // Inputs change one at a time, so the timing includes edge capture, debounce and the delta publish.
+    fake_mqtt_get_stats(&mqtt, true);
+    start = now_ns();
+    for (int i = 0; i < BENCH_POLL_ITERATIONS; ++i) {
+        fake_clock_advance_us(BENCH_POLL_STEP_US);
+        if (row->inputs > 0 && i % BENCH_INPUT_TOGGLE_EVERY == 0) {
+            int in = (i / BENCH_INPUT_TOGGLE_EVERY) % row->inputs;
+            input_levels[in] = !input_levels[in];
+            fake_gpio_drive(input_gpios[in], input_levels[in]);
+        }
+        s_sink += (uint32_t)sim_modules_poll_once();
+    }
+    poll_ns = now_ns() - start;
+    fake_mqtt_get_stats(&mqtt, true);
+    poll_publishes = mqtt.publishes;
+
+    start = now_ns();
+    for (int i = 0; i < BENCH_STATUS_ITERATIONS; ++i) {
+        cJSON *status = modules_build_status_json();
+        s_sink += status ? 1U : 0U;
+        cJSON_Delete(status);
+    }
+    status_ns = now_ns() - start;
+
+    // force_all is the reconnect sync: every entity is rebuilt and published.
+    start = now_ns();
+    for (int i = 0; i < BENCH_PUBLISH_ITERATIONS; ++i) {
+        if (sim_mqtt_publish_state_snapshot(true, false) != ESP_OK) {
+            fprintf(stderr, "bench_runtime: publish_state_snapshot failed\n");
+            exit(1);
+        }
+    }
+    publish_ns = now_ns() - start;
+    fake_mqtt_get_stats(&mqtt, true);
+
+    printf("%8d %6s %10.2f %12.2f %10.2f %12.2f %8.1f %8.2f\n", status_entities(), validated ? "board" : "raw",
+           validated ? (double)save_ns / 1000.0 : 0.0, (double)poll_ns / BENCH_POLL_ITERATIONS,
+           (double)poll_publishes / (BENCH_POLL_ITERATIONS / 1000.0), (double)status_ns / BENCH_STATUS_ITERATIONS,
+           (double)publish_ns / BENCH_PUBLISH_ITERATIONS, (double)mqtt.publishes / BENCH_PUBLISH_ITERATIONS);
+}
+
+int main(void)
+{
+    if (modules_init() != ESP_OK || cfg_json_load_or_default() != ESP_OK) {
+        fprintf(stderr, "bench_runtime: init failed\n");
+        return 1;
+    }
+
+    printf("%8s %6s %10s %12s %10s %12s %8s %8s\n", "entities", "cfg", "save us", "poll ns/it", "pub/s",
+           "status ns", "snap ns", "msg/snap");
+    for (size_t i = 0; i < sizeof(k_rows) / sizeof(k_rows[0]); ++i) {
+        bench_row(&k_rows[i]);
+    }
+    return 0;
+}
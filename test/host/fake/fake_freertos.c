@@ -0,0 +1,98 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "fake_idf.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+// Single-threaded FreeRTOS: a mutex that is already held when taken again would deadlock on the
+// device, so it aborts here instead of being silently re-entered.
+struct host_semaphore {
+    bool taken;
+};
+
+struct host_task {
+    TaskFunction_t fn;
+    const char *name;
+    void *arg;
+    uint32_t notify_count;
+};
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return calloc(1, sizeof(struct host_semaphore));
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks)
+{
+    if (sem->taken) {
+        if (ticks == portMAX_DELAY) {
+            fprintf(stderr, "fake_freertos: mutex %p taken twice\n", (void *)sem);
+            abort();
+        }
+        return pdFALSE;
+    }
+    sem->taken = true;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    if (!sem->taken) {
+        return pdFALSE;
+    }
+    sem->taken = false;
+    return pdTRUE;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack_depth, void *arg,
+                       UBaseType_t priority, TaskHandle_t *out_handle)
+{
+    (void)stack_depth;
+    (void)priority;
+    TaskHandle_t task = calloc(1, sizeof(*task));
+
+    if (!task) {
+        return pdFAIL;
+    }
+    task->fn = fn;
+    task->name = name;
+    task->arg = arg;
+    if (out_handle) {
+        *out_handle = task;
+    }
+    return pdPASS;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    fake_clock_advance_us((int64_t)ticks * portTICK_PERIOD_MS * 1000);
+}
+
+// The calling "task" is the test itself, which is never notified, so there is nothing to consume.
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks)
+{
+    (void)clear_on_exit;
+    (void)ticks;
+    return 0;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    if (task) {
+        task->notify_count++;
+    }
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken)
+{
+    if (task) {
+        task->notify_count++;
+    }
+    if (woken) {
+        *woken = pdFALSE;
+    }
+}
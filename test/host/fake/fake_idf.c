@@ -0,0 +1,457 @@
+#include "fake_idf.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "driver/gpio.h"
+#include "driver/ledc.h"
+#include "driver/rmt_tx.h"
+#include "esp_adc/adc_oneshot.h"
+#include "esp_err.h"
+#include "esp_mac.h"
+#include "esp_rom_sys.h"
+#include "esp_task_wdt.h"
+#include "esp_timer.h"
+
+#define FAKE_GPIO_COUNT 32
+#define FAKE_ADC_CHANNELS 5
+#define FAKE_TIMER_MAX 8
+
+typedef struct {
+    int level;
+    gpio_int_type_t intr_type;
+    bool intr_enabled;
+    gpio_isr_t isr;
+    void *isr_arg;
+} fake_gpio_t;
+
+struct esp_timer {
+    esp_timer_cb_t callback;
+    void *arg;
+    int64_t due_us;
+    bool armed;
+};
+
+struct rmt_channel_t {
+    int unused;
+};
+
+struct rmt_encoder_t {
+    int unused;
+};
+
+struct adc_oneshot_unit_ctx_t {
+    int unused;
+};
+
+// Starts away from zero: the firmware treats a zero timestamp as "never".
+static int64_t s_now_us = 1000000;
+static fake_gpio_t s_gpio[FAKE_GPIO_COUNT];
+static uint32_t s_ledc_duty[SOC_LEDC_CHANNEL_NUM];
+static int s_adc_raw[FAKE_ADC_CHANNELS];
+static struct esp_timer s_timers[FAKE_TIMER_MAX];
+static int s_timer_count;
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code) {
+        case ESP_OK: return "ESP_OK";
+        case ESP_FAIL: return "ESP_FAIL";
+        case ESP_ERR_NO_MEM: return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG: return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_INVALID_SIZE: return "ESP_ERR_INVALID_SIZE";
+        case ESP_ERR_NOT_FOUND: return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+        case ESP_ERR_TIMEOUT: return "ESP_ERR_TIMEOUT";
+        case ESP_ERR_INVALID_CRC: return "ESP_ERR_INVALID_CRC";
+        case ESP_ERR_INVALID_VERSION: return "ESP_ERR_INVALID_VERSION";
+        case ESP_ERR_NVS_NOT_FOUND: return "ESP_ERR_NVS_NOT_FOUND";
+        default: return "UNKNOWN ERROR";
+    }
+}
+
+void fake_clock_advance_us(int64_t us)
+{
+    s_now_us += us;
+    for (int i = 0; i < s_timer_count; ++i) {
+        struct esp_timer *timer = &s_timers[i];
+        if (timer->armed && timer->due_us <= s_now_us) {
+            timer->armed = false;
+            timer->callback(timer->arg);
+        }
+    }
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return s_now_us;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *create_args, esp_timer_handle_t *out_handle)
+{
+    if (!create_args || !create_args->callback || !out_handle) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_timer_count >= FAKE_TIMER_MAX) {
+        return ESP_ERR_NO_MEM;
+    }
+    struct esp_timer *timer = &s_timers[s_timer_count++];
+    timer->callback = create_args->callback;
+    timer->arg = create_args->arg;
+    *out_handle = timer;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    if (!timer) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (timer->armed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->due_us = s_now_us + (int64_t)timeout_us;
+    timer->armed = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    if (!timer) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!timer->armed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->armed = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+    if (!timer) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    timer->armed = false;
+    return ESP_OK;
+}
+
+void esp_rom_delay_us(uint32_t us)
+{
+    fake_clock_advance_us(us);
+}
+
+esp_err_t esp_efuse_mac_get_default(uint8_t *mac)
+{
+    static const uint8_t k_mac[6] = {0x84, 0xf7, 0x03, 0x12, 0x34, 0x56};
+
+    for (int i = 0; i < 6; ++i) {
+        mac[i] = k_mac[i];
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_task_wdt_init(const esp_task_wdt_config_t *config)
+{
+    (void)config;
+    return ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t esp_task_wdt_status(void *task_handle)
+{
+    (void)task_handle;
+    return ESP_OK;
+}
+
+esp_err_t esp_task_wdt_add(void *task_handle)
+{
+    (void)task_handle;
+    return ESP_OK;
+}
+
+esp_err_t esp_task_wdt_reset(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_task_wdt_delete(void *task_handle)
+{
+    (void)task_handle;
+    return ESP_OK;
+}
+
+static fake_gpio_t *gpio_at(gpio_num_t gpio)
+{
+    return (gpio >= 0 && gpio < FAKE_GPIO_COUNT) ? &s_gpio[gpio] : NULL;
+}
+
+void fake_gpio_drive(int gpio, int level)
+{
+    fake_gpio_t *pin = gpio_at(gpio);
+
+    if (!pin || pin->level == (level != 0)) {
+        return;
+    }
+    pin->level = level != 0;
+    if (!pin->isr || !pin->intr_enabled) {
+        return;
+    }
+    if (pin->intr_type == GPIO_INTR_ANYEDGE ||
+        (pin->intr_type == GPIO_INTR_POSEDGE && pin->level) ||
+        (pin->intr_type == GPIO_INTR_NEGEDGE && !pin->level)) {
+        pin->isr(pin->isr_arg);
+    }
+}
+
+esp_err_t gpio_config(const gpio_config_t *cfg)
+{
+    if (!cfg) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int gpio = 0; gpio < FAKE_GPIO_COUNT; ++gpio) {
+        if (cfg->pin_bit_mask & (1ULL << gpio)) {
+            s_gpio[gpio].intr_type = cfg->intr_type;
+            // Inputs idle at their pull level, like an open contact.
+            if (cfg->mode == GPIO_MODE_INPUT) {
+                s_gpio[gpio].level = cfg->pull_down_en != GPIO_PULLDOWN_ENABLE;
+            }
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t gpio_reset_pin(gpio_num_t gpio)
+{
+    fake_gpio_t *pin = gpio_at(gpio);
+
+    if (!pin) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *pin = (fake_gpio_t){0};
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t gpio, uint32_t level)
+{
+    fake_gpio_t *pin = gpio_at(gpio);
+
+    if (!pin) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pin->level = level != 0;
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t gpio)
+{
+    fake_gpio_t *pin = gpio_at(gpio);
+
+    return pin ? pin->level : 0;
+}
+
+esp_err_t gpio_install_isr_service(int intr_alloc_flags)
+{
+    (void)intr_alloc_flags;
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_add(gpio_num_t gpio, gpio_isr_t isr, void *arg)
+{
+    fake_gpio_t *pin = gpio_at(gpio);
+
+    if (!pin || !isr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pin->isr = isr;
+    pin->isr_arg = arg;
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_remove(gpio_num_t gpio)
+{
+    fake_gpio_t *pin = gpio_at(gpio);
+
+    if (!pin) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pin->isr = NULL;
+    pin->isr_arg = NULL;
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_intr_type(gpio_num_t gpio, gpio_int_type_t type)
+{
+    fake_gpio_t *pin = gpio_at(gpio);
+
+    if (!pin) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pin->intr_type = type;
+    return ESP_OK;
+}
+
+esp_err_t gpio_intr_enable(gpio_num_t gpio)
+{
+    fake_gpio_t *pin = gpio_at(gpio);
+
+    if (!pin) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pin->intr_enabled = true;
+    return ESP_OK;
+}
+
+esp_err_t gpio_intr_disable(gpio_num_t gpio)
+{
+    fake_gpio_t *pin = gpio_at(gpio);
+
+    if (!pin) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pin->intr_enabled = false;
+    return ESP_OK;
+}
+
+esp_err_t ledc_timer_config(const ledc_timer_config_t *cfg)
+{
+    return (cfg && cfg->timer_num >= 0 && cfg->timer_num < SOC_LEDC_TIMER_NUM) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t ledc_channel_config(const ledc_channel_config_t *cfg)
+{
+    if (!cfg || cfg->channel < 0 || cfg->channel >= SOC_LEDC_CHANNEL_NUM) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_ledc_duty[cfg->channel] = cfg->duty;
+    return ESP_OK;
+}
+
+esp_err_t ledc_set_duty(ledc_mode_t mode, ledc_channel_t channel, uint32_t duty)
+{
+    (void)mode;
+    if (channel < 0 || channel >= SOC_LEDC_CHANNEL_NUM) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_ledc_duty[channel] = duty;
+    return ESP_OK;
+}
+
+esp_err_t ledc_update_duty(ledc_mode_t mode, ledc_channel_t channel)
+{
+    (void)mode;
+    return (channel >= 0 && channel < SOC_LEDC_CHANNEL_NUM) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t ledc_stop(ledc_mode_t mode, ledc_channel_t channel, uint32_t idle_level)
+{
+    (void)mode;
+    (void)idle_level;
+    if (channel < 0 || channel >= SOC_LEDC_CHANNEL_NUM) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_ledc_duty[channel] = 0;
+    return ESP_OK;
+}
+
+void fake_adc_set_raw(int channel, int raw)
+{
+    if (channel >= 0 && channel < FAKE_ADC_CHANNELS) {
+        s_adc_raw[channel] = raw;
+    }
+}
+
+esp_err_t adc_oneshot_new_unit(const adc_oneshot_unit_init_cfg_t *init_config, adc_oneshot_unit_handle_t *ret_unit)
+{
+    if (!init_config || !ret_unit) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *ret_unit = calloc(1, sizeof(**ret_unit));
+    return *ret_unit ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+esp_err_t adc_oneshot_config_channel(adc_oneshot_unit_handle_t handle, adc_channel_t channel,
+                                     const adc_oneshot_chan_cfg_t *config)
+{
+    return (handle && config && channel >= 0 && channel < FAKE_ADC_CHANNELS) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t adc_oneshot_read(adc_oneshot_unit_handle_t handle, adc_channel_t chan, int *out_raw)
+{
+    if (!handle || !out_raw || chan < 0 || chan >= FAKE_ADC_CHANNELS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *out_raw = s_adc_raw[chan];
+    return ESP_OK;
+}
+
+esp_err_t adc_oneshot_del_unit(adc_oneshot_unit_handle_t handle)
+{
+    free(handle);
+    return ESP_OK;
+}
+
+esp_err_t adc_oneshot_io_to_channel(int io_num, adc_unit_t *unit_id, adc_channel_t *channel)
+{
+    // ESP32-C3: GPIO0..4 are ADC1 channels 0..4.
+    if (io_num < 0 || io_num >= FAKE_ADC_CHANNELS) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    *unit_id = ADC_UNIT_1;
+    *channel = io_num;
+    return ESP_OK;
+}
+
+esp_err_t rmt_new_tx_channel(const rmt_tx_channel_config_t *config, rmt_channel_handle_t *ret_chan)
+{
+    if (!config || !ret_chan) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *ret_chan = calloc(1, sizeof(**ret_chan));
+    return *ret_chan ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+esp_err_t rmt_new_copy_encoder(const rmt_copy_encoder_config_t *config, rmt_encoder_handle_t *ret_encoder)
+{
+    if (!config || !ret_encoder) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *ret_encoder = calloc(1, sizeof(**ret_encoder));
+    return *ret_encoder ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+esp_err_t rmt_tx_register_event_callbacks(rmt_channel_handle_t channel, const rmt_tx_event_callbacks_t *cbs,
+                                          void *user_data)
+{
+    (void)user_data;
+    return (channel && cbs) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t rmt_enable(rmt_channel_handle_t channel)
+{
+    return channel ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t rmt_disable(rmt_channel_handle_t channel)
+{
+    return channel ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t rmt_del_channel(rmt_channel_handle_t channel)
+{
+    free(channel);
+    return ESP_OK;
+}
+
+esp_err_t rmt_del_encoder(rmt_encoder_handle_t encoder)
+{
+    free(encoder);
+    return ESP_OK;
+}
+
+esp_err_t rmt_transmit(rmt_channel_handle_t channel, rmt_encoder_handle_t encoder, const void *payload,
+                       size_t payload_bytes, const rmt_transmit_config_t *config)
+{
+    (void)payload_bytes;
+    return (channel && encoder && payload && config) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
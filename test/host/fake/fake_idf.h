@@ -0,0 +1,11 @@
+#pragma once
+
+#include <stdint.h>
+
+// Test-side controls for the simulated HAL in fake_idf.c. Time only moves when the test moves it (or
+// when the code under test calls esp_rom_delay_us / vTaskDelay); due esp_timer callbacks then run inline.
+void fake_clock_advance_us(int64_t us);
+
+// Drives an input pin as the outside world would; an enabled ISR handler sees the edge immediately.
+void fake_gpio_drive(int gpio, int level);
+void fake_adc_set_raw(int channel, int raw);
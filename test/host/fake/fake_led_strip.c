@@ -0,0 +1,81 @@
+#include "fake_led_strip.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+led_strip_handle_t fake_led_strip_new(uint32_t max_leds)
+{
+    led_strip_handle_t strip = calloc(1, sizeof(*strip));
+
+    if (!strip) {
+        return NULL;
+    }
+    strip->max_leds = max_leds;
+    strip->pixels = calloc(max_leds, 3);
+    strip->pushed = calloc(max_leds, 3);
+    if (!strip->pixels || !strip->pushed) {
+        led_strip_del(strip);
+        return NULL;
+    }
+    return strip;
+}
+
+esp_err_t led_strip_new_rmt_device(const led_strip_config_t *led_config, const led_strip_rmt_config_t *rmt_config,
+                                   led_strip_handle_t *ret_strip)
+{
+    if (!led_config || !rmt_config || !ret_strip) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *ret_strip = fake_led_strip_new(led_config->max_leds);
+    return *ret_strip ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+esp_err_t led_strip_new_spi_device(const led_strip_config_t *led_config, const led_strip_spi_config_t *spi_config,
+                                   led_strip_handle_t *ret_strip)
+{
+    if (!led_config || !spi_config || !ret_strip) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *ret_strip = fake_led_strip_new(led_config->max_leds);
+    return *ret_strip ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+esp_err_t led_strip_set_pixel(led_strip_handle_t strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue)
+{
+    if (!strip || index >= strip->max_leds) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    strip->pixels[index * 3 + 0] = (uint8_t)green;
+    strip->pixels[index * 3 + 1] = (uint8_t)red;
+    strip->pixels[index * 3 + 2] = (uint8_t)blue;
+    return ESP_OK;
+}
+
+esp_err_t led_strip_refresh(led_strip_handle_t strip)
+{
+    if (!strip) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memcpy(strip->pushed, strip->pixels, (size_t)strip->max_leds * 3);
+    strip->refreshes++;
+    return ESP_OK;
+}
+
+esp_err_t led_strip_clear(led_strip_handle_t strip)
+{
+    if (!strip) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(strip->pixels, 0, (size_t)strip->max_leds * 3);
+    return led_strip_refresh(strip);
+}
+
+esp_err_t led_strip_del(led_strip_handle_t strip)
+{
+    if (strip) {
+        free(strip->pixels);
+        free(strip->pushed);
+        free(strip);
+    }
+    return ESP_OK;
+}
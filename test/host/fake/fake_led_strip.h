@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "led_strip.h"
+
+// Keeps the pixel buffer the way the led_strip component fills it for LED_PIXEL_FORMAT_GRB, and a copy
+// of it at every refresh: pushed is what would have gone out on the wire.
+struct led_strip_t {
+    uint32_t max_leds;
+    uint8_t *pixels;
+    uint8_t *pushed;
+    uint32_t refreshes;
+};
+
+led_strip_handle_t fake_led_strip_new(uint32_t max_leds);
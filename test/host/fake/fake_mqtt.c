@@ -0,0 +1,101 @@
+#include "fake_mqtt.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+struct esp_mqtt_client {
+    esp_event_handler_t handler;
+    void *handler_arg;
+    int next_msg_id;
+};
+
+static esp_mqtt_client_handle_t s_client;
+static fake_mqtt_stats_t s_stats;
+
+void fake_mqtt_deliver(esp_mqtt_event_id_t event_id)
+{
+    esp_mqtt_event_t event = {
+        .event_id = event_id,
+        .client = s_client,
+    };
+
+    if (s_client && s_client->handler) {
+        s_client->handler(s_client->handler_arg, "MQTT_EVENTS", event_id, &event);
+    }
+}
+
+void fake_mqtt_get_stats(fake_mqtt_stats_t *out, bool reset)
+{
+    *out = s_stats;
+    if (reset) {
+        memset(&s_stats, 0, sizeof(s_stats));
+    }
+}
+
+esp_mqtt_client_handle_t esp_mqtt_client_init(const esp_mqtt_client_config_t *config)
+{
+    if (!config) {
+        return NULL;
+    }
+    s_client = calloc(1, sizeof(*s_client));
+    return s_client;
+}
+
+esp_err_t esp_mqtt_client_register_event(esp_mqtt_client_handle_t client, esp_mqtt_event_id_t event,
+                                         esp_event_handler_t event_handler, void *event_handler_arg)
+{
+    (void)event;
+    if (!client || !event_handler) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    client->handler = event_handler;
+    client->handler_arg = event_handler_arg;
+    return ESP_OK;
+}
+
+esp_err_t esp_mqtt_client_start(esp_mqtt_client_handle_t client)
+{
+    return client ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t esp_mqtt_client_stop(esp_mqtt_client_handle_t client)
+{
+    return client ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t esp_mqtt_client_destroy(esp_mqtt_client_handle_t client)
+{
+    if (client == s_client) {
+        s_client = NULL;
+    }
+    free(client);
+    return ESP_OK;
+}
+
+int esp_mqtt_client_publish(esp_mqtt_client_handle_t client, const char *topic, const char *data, int len, int qos,
+                            int retain)
+{
+    (void)retain;
+    if (!client || !topic) {
+        return -1;
+    }
+    s_stats.publishes++;
+    s_stats.payload_bytes += (uint64_t)(len > 0 ? len : (data ? (int)strlen(data) : 0));
+    return qos > 0 ? ++client->next_msg_id : 0;
+}
+
+int esp_mqtt_client_subscribe(esp_mqtt_client_handle_t client, const char *topic, int qos)
+{
+    (void)qos;
+    if (!client || !topic) {
+        return -1;
+    }
+    s_stats.subscribes++;
+    return ++client->next_msg_id;
+}
+
+int esp_mqtt_client_get_outbox_size(esp_mqtt_client_handle_t client)
+{
+    (void)client;
+    return 0;
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "mqtt_client.h"
+
+// The client is never connected until the test says so; publishes are counted, not sent.
+typedef struct {
+    uint32_t publishes;
+    uint64_t payload_bytes;
+    uint32_t subscribes;
+} fake_mqtt_stats_t;
+
+// Delivers event_id (e.g. MQTT_EVENT_CONNECTED) to the handler of the most recently created client.
+void fake_mqtt_deliver(esp_mqtt_event_id_t event_id);
+void fake_mqtt_get_stats(fake_mqtt_stats_t *out, bool reset);
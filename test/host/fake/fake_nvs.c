@@ -0,0 +1,189 @@
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "nvs.h"
+
+// In-memory NVS. A handle is the index of its namespace plus one; commits are immediate.
+#define FAKE_NVS_NAMESPACES 8
+#define FAKE_NVS_ENTRIES 64
+#define FAKE_NVS_NAME_LEN 16
+
+typedef enum {
+    FAKE_NVS_BLOB,
+    FAKE_NVS_STR,
+    FAKE_NVS_U64,
+} fake_nvs_type_t;
+
+typedef struct {
+    bool used;
+    int ns;
+    char key[FAKE_NVS_NAME_LEN];
+    fake_nvs_type_t type;
+    void *data;
+    size_t len;
+    uint64_t u64;
+} fake_nvs_entry_t;
+
+static char s_namespaces[FAKE_NVS_NAMESPACES][FAKE_NVS_NAME_LEN];
+static fake_nvs_entry_t s_entries[FAKE_NVS_ENTRIES];
+
+static fake_nvs_entry_t *find_entry(nvs_handle_t handle, const char *key)
+{
+    for (int i = 0; i < FAKE_NVS_ENTRIES; ++i) {
+        if (s_entries[i].used && s_entries[i].ns == (int)handle - 1 && strcmp(s_entries[i].key, key) == 0) {
+            return &s_entries[i];
+        }
+    }
+    return NULL;
+}
+
+static fake_nvs_entry_t *new_entry(nvs_handle_t handle, const char *key, fake_nvs_type_t type)
+{
+    fake_nvs_entry_t *entry = find_entry(handle, key);
+
+    if (!entry) {
+        for (int i = 0; i < FAKE_NVS_ENTRIES && !entry; ++i) {
+            if (!s_entries[i].used) {
+                entry = &s_entries[i];
+            }
+        }
+        if (!entry) {
+            return NULL;
+        }
+        entry->used = true;
+        entry->ns = (int)handle - 1;
+        strncpy(entry->key, key, sizeof(entry->key) - 1);
+        entry->key[sizeof(entry->key) - 1] = 0;
+    }
+    free(entry->data);
+    entry->data = NULL;
+    entry->len = 0;
+    entry->type = type;
+    return entry;
+}
+
+static void free_entry(fake_nvs_entry_t *entry)
+{
+    free(entry->data);
+    *entry = (fake_nvs_entry_t){0};
+}
+
+esp_err_t nvs_open(const char *name, nvs_open_mode_t open_mode, nvs_handle_t *out_handle)
+{
+    (void)open_mode;
+    if (!name || !out_handle || strlen(name) >= FAKE_NVS_NAME_LEN) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int i = 0; i < FAKE_NVS_NAMESPACES; ++i) {
+        if (s_namespaces[i][0] == 0) {
+            strcpy(s_namespaces[i], name);
+        }
+        if (strcmp(s_namespaces[i], name) == 0) {
+            *out_handle = (nvs_handle_t)(i + 1);
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+void nvs_close(nvs_handle_t handle)
+{
+    (void)handle;
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle)
+{
+    (void)handle;
+    return ESP_OK;
+}
+
+static esp_err_t get_bytes(nvs_handle_t handle, const char *key, fake_nvs_type_t type, void *out_value,
+                           size_t *length)
+{
+    fake_nvs_entry_t *entry = find_entry(handle, key);
+
+    if (!entry || entry->type != type) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    if (!out_value) {
+        *length = entry->len;
+        return ESP_OK;
+    }
+    if (*length < entry->len) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(out_value, entry->data, entry->len);
+    *length = entry->len;
+    return ESP_OK;
+}
+
+esp_err_t nvs_get_str(nvs_handle_t handle, const char *key, char *out_value, size_t *length)
+{
+    return get_bytes(handle, key, FAKE_NVS_STR, out_value, length);
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out_value, size_t *length)
+{
+    return get_bytes(handle, key, FAKE_NVS_BLOB, out_value, length);
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t length)
+{
+    fake_nvs_entry_t *entry = new_entry(handle, key, FAKE_NVS_BLOB);
+
+    if (!entry) {
+        return ESP_ERR_NO_MEM;
+    }
+    entry->data = malloc(length ? length : 1);
+    if (!entry->data) {
+        free_entry(entry);
+        return ESP_ERR_NO_MEM;
+    }
+    memcpy(entry->data, value, length);
+    entry->len = length;
+    return ESP_OK;
+}
+
+esp_err_t nvs_get_u64(nvs_handle_t handle, const char *key, uint64_t *out_value)
+{
+    fake_nvs_entry_t *entry = find_entry(handle, key);
+
+    if (!entry || entry->type != FAKE_NVS_U64) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    *out_value = entry->u64;
+    return ESP_OK;
+}
+
+esp_err_t nvs_set_u64(nvs_handle_t handle, const char *key, uint64_t value)
+{
+    fake_nvs_entry_t *entry = new_entry(handle, key, FAKE_NVS_U64);
+
+    if (!entry) {
+        return ESP_ERR_NO_MEM;
+    }
+    entry->u64 = value;
+    return ESP_OK;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char *key)
+{
+    fake_nvs_entry_t *entry = find_entry(handle, key);
+
+    if (!entry) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    free_entry(entry);
+    return ESP_OK;
+}
+
+esp_err_t nvs_erase_all(nvs_handle_t handle)
+{
+    for (int i = 0; i < FAKE_NVS_ENTRIES; ++i) {
+        if (s_entries[i].used && s_entries[i].ns == (int)handle - 1) {
+            free_entry(&s_entries[i]);
+        }
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,218 @@
+#include <stdlib.h>
+
+#include "aht20.h"
+#include "bme280.h"
+#include "ds18b20.h"
+#include "i2c_bus.h"
+#include "onewire_bus.h"
+#include "sht3x.h"
+
+// Every I2C sensor answers with fixed room readings; the 1-Wire bus has no devices on it.
+struct i2c_bus_t {
+    int unused;
+};
+
+struct aht20_dev_t {
+    int unused;
+};
+
+struct sht3x_dev_t {
+    int unused;
+};
+
+struct bme280_dev_t {
+    int unused;
+};
+
+struct onewire_bus_t {
+    int unused;
+};
+
+struct onewire_device_iter_t {
+    int unused;
+};
+
+i2c_bus_handle_t i2c_bus_create(i2c_port_t port, const i2c_config_t *conf)
+{
+    (void)port;
+    return conf ? calloc(1, sizeof(struct i2c_bus_t)) : NULL;
+}
+
+esp_err_t i2c_bus_delete(i2c_bus_handle_t *p_bus)
+{
+    free(*p_bus);
+    *p_bus = NULL;
+    return ESP_OK;
+}
+
+esp_err_t aht20_new_sensor(const aht20_i2c_config_t *i2c_conf, aht20_dev_handle_t *handle_out)
+{
+    if (!i2c_conf || !i2c_conf->bus_inst || !handle_out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *handle_out = calloc(1, sizeof(**handle_out));
+    return *handle_out ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+esp_err_t aht20_del_sensor(aht20_dev_handle_t handle)
+{
+    free(handle);
+    return ESP_OK;
+}
+
+esp_err_t aht20_read_temperature_humidity(aht20_dev_handle_t handle, uint32_t *temperature_raw, float *temperature,
+                                          uint32_t *humidity_raw, float *humidity)
+{
+    if (!handle) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *temperature_raw = 0;
+    *humidity_raw = 0;
+    *temperature = 21.5f;
+    *humidity = 45.0f;
+    return ESP_OK;
+}
+
+sht3x_handle_t sht3x_create(i2c_bus_handle_t bus, uint8_t dev_addr)
+{
+    (void)dev_addr;
+    return bus ? calloc(1, sizeof(struct sht3x_dev_t)) : NULL;
+}
+
+esp_err_t sht3x_delete(sht3x_handle_t *sensor)
+{
+    free(*sensor);
+    *sensor = NULL;
+    return ESP_OK;
+}
+
+esp_err_t sht3x_soft_reset(sht3x_handle_t sensor)
+{
+    return sensor ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t sht3x_get_single_shot(sht3x_handle_t sensor, float *tem_val, float *hum_val)
+{
+    if (!sensor) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *tem_val = 22.0f;
+    *hum_val = 40.0f;
+    return ESP_OK;
+}
+
+bme280_handle_t bme280_create(i2c_bus_handle_t bus, uint8_t dev_addr)
+{
+    (void)dev_addr;
+    return bus ? calloc(1, sizeof(struct bme280_dev_t)) : NULL;
+}
+
+esp_err_t bme280_delete(bme280_handle_t *sensor)
+{
+    free(*sensor);
+    *sensor = NULL;
+    return ESP_OK;
+}
+
+esp_err_t bme280_default_init(bme280_handle_t sensor)
+{
+    return sensor ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t bme280_read_temperature(bme280_handle_t sensor, float *temperature)
+{
+    if (!sensor) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *temperature = 20.5f;
+    return ESP_OK;
+}
+
+esp_err_t bme280_read_humidity(bme280_handle_t sensor, float *humidity)
+{
+    if (!sensor) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *humidity = 50.0f;
+    return ESP_OK;
+}
+
+esp_err_t bme280_read_pressure(bme280_handle_t sensor, float *pressure)
+{
+    if (!sensor) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *pressure = 1013.25f;
+    return ESP_OK;
+}
+
+esp_err_t onewire_new_bus_rmt(const onewire_bus_config_t *bus_config, const onewire_bus_rmt_config_t *rmt_config,
+                              onewire_bus_handle_t *ret_bus)
+{
+    if (!bus_config || !rmt_config || !ret_bus) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *ret_bus = calloc(1, sizeof(**ret_bus));
+    return *ret_bus ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+esp_err_t onewire_bus_del(onewire_bus_handle_t bus)
+{
+    free(bus);
+    return ESP_OK;
+}
+
+esp_err_t onewire_new_device_iter(onewire_bus_handle_t bus, onewire_device_iter_handle_t *ret_iter)
+{
+    if (!bus || !ret_iter) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *ret_iter = calloc(1, sizeof(**ret_iter));
+    return *ret_iter ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+esp_err_t onewire_device_iter_get_next(onewire_device_iter_handle_t iter, onewire_device_t *dev)
+{
+    (void)dev;
+    return iter ? ESP_ERR_NOT_FOUND : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t onewire_del_device_iter(onewire_device_iter_handle_t iter)
+{
+    free(iter);
+    return ESP_OK;
+}
+
+esp_err_t ds18b20_new_device_from_enumeration(onewire_device_t *device, const ds18b20_config_t *config,
+                                              ds18b20_device_handle_t *ret_ds18b20)
+{
+    (void)device;
+    (void)config;
+    (void)ret_ds18b20;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t ds18b20_del_device(ds18b20_device_handle_t ds18b20)
+{
+    (void)ds18b20;
+    return ESP_OK;
+}
+
+esp_err_t ds18b20_set_resolution(ds18b20_device_handle_t ds18b20, ds18b20_resolution_t resolution)
+{
+    (void)ds18b20;
+    (void)resolution;
+    return ESP_OK;
+}
+
+esp_err_t ds18b20_trigger_temperature_conversion_for_all(onewire_bus_handle_t bus)
+{
+    return bus ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t ds18b20_get_temperature(ds18b20_device_handle_t ds18b20, float *temperature)
+{
+    (void)ds18b20;
+    (void)temperature;
+    return ESP_ERR_NOT_SUPPORTED;
+}
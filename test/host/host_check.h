@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdio.h>
+
+// Minimal check macros for the host tests: failures are counted and reported, main returns the count.
+static int s_host_failures = 0;
+
+#define CHECK(cond)                                                                    \
+    do {                                                                               \
+        if (!(cond)) {                                                                 \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            s_host_failures++;                                                         \
+        }                                                                              \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance)                                                      \
+    do {                                                                                             \
+        double a_ = (double)(actual);                                                                \
+        double e_ = (double)(expected);                                                              \
+        if (a_ < e_ - (tolerance) || a_ > e_ + (tolerance)) {                                        \
+            fprintf(stderr, "%s:%d: %s = %g, expected %g +- %g\n", __FILE__, __LINE__, #actual, a_, \
+                    e_, (double)(tolerance));                                                        \
+            s_host_failures++;                                                                       \
+        }                                                                                            \
+    } while (0)
+
+#define HOST_TEST_RESULT(name)                                                  \
+    (s_host_failures ? (fprintf(stderr, "%s: %d failure(s)\n", name, s_host_failures), 1) \
+                     : (printf("%s: ok\n", name), 0))
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "i2c_bus.h"
+
+// Host stand-in for the aht20 component.
+typedef struct aht20_dev_t *aht20_dev_handle_t;
+
+typedef struct {
+    i2c_bus_handle_t bus_inst;
+    uint8_t i2c_addr;
+} aht20_i2c_config_t;
+
+esp_err_t aht20_new_sensor(const aht20_i2c_config_t *i2c_conf, aht20_dev_handle_t *handle_out);
+esp_err_t aht20_del_sensor(aht20_dev_handle_t handle);
+esp_err_t aht20_read_temperature_humidity(aht20_dev_handle_t handle, uint32_t *temperature_raw, float *temperature,
+                                          uint32_t *humidity_raw, float *humidity);
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "i2c_bus.h"
+
+// Host stand-in for the bme280 component.
+typedef struct bme280_dev_t *bme280_handle_t;
+
+bme280_handle_t bme280_create(i2c_bus_handle_t bus, uint8_t dev_addr);
+esp_err_t bme280_delete(bme280_handle_t *sensor);
+esp_err_t bme280_default_init(bme280_handle_t sensor);
+esp_err_t bme280_read_temperature(bme280_handle_t sensor, float *temperature);
+esp_err_t bme280_read_humidity(bme280_handle_t sensor, float *humidity);
+esp_err_t bme280_read_pressure(bme280_handle_t sensor, float *pressure);
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "esp_err.h"
+
+// Host stand-in for the ADC oneshot driver; fake/fake_idf.c returns a raw value per channel.
+typedef struct adc_oneshot_unit_ctx_t *adc_oneshot_unit_handle_t;
+typedef int adc_unit_t;
+typedef int adc_channel_t;
+
+#define ADC_UNIT_1 0
+#define ADC_CHANNEL_0 0
+#define ADC_ATTEN_DB_12 3
+#define ADC_BITWIDTH_DEFAULT 0
+#define ADC_ULP_MODE_DISABLE 0
+
+typedef struct {
+    adc_unit_t unit_id;
+    int clk_src;
+    int ulp_mode;
+} adc_oneshot_unit_init_cfg_t;
+
+typedef struct {
+    int atten;
+    int bitwidth;
+} adc_oneshot_chan_cfg_t;
+
+esp_err_t adc_oneshot_new_unit(const adc_oneshot_unit_init_cfg_t *init_config, adc_oneshot_unit_handle_t *ret_unit);
+esp_err_t adc_oneshot_config_channel(adc_oneshot_unit_handle_t handle, adc_channel_t channel,
+                                     const adc_oneshot_chan_cfg_t *config);
+esp_err_t adc_oneshot_read(adc_oneshot_unit_handle_t handle, adc_channel_t chan, int *out_raw);
+esp_err_t adc_oneshot_del_unit(adc_oneshot_unit_handle_t handle);
+esp_err_t adc_oneshot_io_to_channel(int io_num, adc_unit_t *unit_id, adc_channel_t *channel);
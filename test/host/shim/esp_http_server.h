@@ -0,0 +1,10 @@
+#pragma once
+
+#include <sys/types.h>
+
+#include "esp_err.h"
+
+// Host stand-in for esp_http_server: the test or benchmark defines httpd_req and the chunk sink.
+typedef struct httpd_req httpd_req_t;
+
+esp_err_t httpd_resp_send_chunk(httpd_req_t *req, const char *buf, ssize_t buf_len);
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <stdio.h>
+
+// Host stand-in for esp_log: logging is compiled out but the format strings are still checked.
+#define ESP_HOST_LOG(tag, fmt, ...) do { if (0) { (void)(tag); printf(fmt, ##__VA_ARGS__); } } while (0)
+#define ESP_LOGE(tag, fmt, ...) ESP_HOST_LOG(tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) ESP_HOST_LOG(tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) ESP_HOST_LOG(tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) ESP_HOST_LOG(tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGV(tag, fmt, ...) ESP_HOST_LOG(tag, fmt, ##__VA_ARGS__)
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+
+// Host stand-in for esp_mac; the fake returns a fixed address.
+esp_err_t esp_efuse_mac_get_default(uint8_t *mac);
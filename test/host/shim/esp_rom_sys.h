@@ -0,0 +1,6 @@
+#pragma once
+
+#include <stdint.h>
+
+// Host stand-in for esp_rom_sys: the delay advances the simulated clock instead of spinning.
+void esp_rom_delay_us(uint32_t us);
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+// Host stand-in for the task watchdog; fake/fake_idf.c reports every task as already subscribed.
+typedef struct {
+    uint32_t timeout_ms;
+    uint32_t idle_core_mask;
+    bool trigger_panic;
+} esp_task_wdt_config_t;
+
+esp_err_t esp_task_wdt_init(const esp_task_wdt_config_t *config);
+esp_err_t esp_task_wdt_status(void *task_handle);
+esp_err_t esp_task_wdt_add(void *task_handle);
+esp_err_t esp_task_wdt_reset(void);
+esp_err_t esp_task_wdt_delete(void *task_handle);
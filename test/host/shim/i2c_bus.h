@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "driver/gpio.h"
+#include "esp_err.h"
+
+// Host stand-in for the i2c_bus component; fake/fake_sensors.c answers for every address.
+typedef struct i2c_bus_t *i2c_bus_handle_t;
+typedef int i2c_port_t;
+
+#define I2C_NUM_0 0
+#define I2C_MODE_MASTER 1
+
+typedef struct {
+    int mode;
+    int sda_io_num;
+    int scl_io_num;
+    gpio_pullup_t sda_pullup_en;
+    gpio_pullup_t scl_pullup_en;
+    struct {
+        uint32_t clk_speed;
+    } master;
+    uint32_t clk_flags;
+} i2c_config_t;
+
+i2c_bus_handle_t i2c_bus_create(i2c_port_t port, const i2c_config_t *conf);
+esp_err_t i2c_bus_delete(i2c_bus_handle_t *p_bus);
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+
+// Host stand-in for the onewire_bus component; the fake bus enumerates no devices.
+typedef struct onewire_bus_t *onewire_bus_handle_t;
+typedef struct onewire_device_iter_t *onewire_device_iter_handle_t;
+typedef uint64_t onewire_device_address_t;
+
+typedef struct {
+    onewire_bus_handle_t bus;
+    onewire_device_address_t address;
+} onewire_device_t;
+
+typedef struct {
+    int bus_gpio_num;
+    struct {
+        uint32_t en_pull_up : 1;
+    } flags;
+} onewire_bus_config_t;
+
+typedef struct {
+    uint32_t max_rx_bytes;
+} onewire_bus_rmt_config_t;
+
+esp_err_t onewire_new_bus_rmt(const onewire_bus_config_t *bus_config, const onewire_bus_rmt_config_t *rmt_config,
+                              onewire_bus_handle_t *ret_bus);
+esp_err_t onewire_bus_del(onewire_bus_handle_t bus);
+esp_err_t onewire_new_device_iter(onewire_bus_handle_t bus, onewire_device_iter_handle_t *ret_iter);
+esp_err_t onewire_device_iter_get_next(onewire_device_iter_handle_t iter, onewire_device_t *dev);
+esp_err_t onewire_del_device_iter(onewire_device_iter_handle_t iter);
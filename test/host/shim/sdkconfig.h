@@ -0,0 +1,4 @@
+#pragma once
+
+// Host stand-in for the generated sdkconfig.h: only the options the host-built sources read.
+#define CONFIG_ESP_TASK_WDT_TIMEOUT_S 5
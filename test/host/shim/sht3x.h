@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "i2c_bus.h"
+
+// Host stand-in for the sht3x component.
+typedef struct sht3x_dev_t *sht3x_handle_t;
+
+sht3x_handle_t sht3x_create(i2c_bus_handle_t bus, uint8_t dev_addr);
+esp_err_t sht3x_delete(sht3x_handle_t *sensor);
+esp_err_t sht3x_soft_reset(sht3x_handle_t sensor);
+esp_err_t sht3x_get_single_shot(sht3x_handle_t sensor, float *tem_val, float *hum_val);
@@ -0,0 +1,9 @@
+#pragma once
+
+// Host stand-in for the ESP32-C3 SoC capabilities the firmware sizes its allocators by.
+#define SOC_LEDC_CHANNEL_NUM 6
+#define SOC_LEDC_TIMER_NUM 4
+#define SOC_RMT_MEM_WORDS_PER_CHANNEL 48
+#define SOC_RMT_GROUPS 1
+#define SOC_RMT_TX_CANDIDATES_PER_GROUP 2
+#define SOC_RMT_RX_CANDIDATES_PER_GROUP 2
@@ -0,0 +1,13 @@
+#include "sim_hooks.h"
+
+#include "core/modules.c"
+
+int64_t sim_modules_poll_once(void)
+{
+    return modules_poll_once();
+}
+
+void sim_modules_sensor_once(void)
+{
+    modules_sensor_once();
+}
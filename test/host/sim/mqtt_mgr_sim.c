@@ -0,0 +1,8 @@
+#include "sim_hooks.h"
+
+#include "net/mqtt_mgr.c"
+
+esp_err_t sim_mqtt_publish_state_snapshot(bool force_all, bool allow_throttle)
+{
+    return publish_state_snapshot(force_all, allow_throttle);
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+// Entry points into firmware statics for host benchmarks. Each is defined in a TU that includes the
+// firmware .c file whole, so the firmware itself needs no test-only exports.
+
+// One iteration of modules_poll_task's loop; returns the next due time as the task would sleep to it.
+int64_t sim_modules_poll_once(void);
+// One iteration of modules_sensor_task's loop, without its sleep.
+void sim_modules_sensor_once(void);
+// mqtt_mgr's publish_state_snapshot, as the broker sync (force_all) and the worker call it.
+esp_err_t sim_mqtt_publish_state_snapshot(bool force_all, bool allow_throttle);
@@ -0,0 +1,127 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "core/motion.h"
+#include "host_check.h"
+
+typedef struct {
+    int steps;
+    int accel_steps;  // steps taken while v^2 was still rising
+    int cruise_steps; // steps at the vmax interval
+    int decel_steps;  // steps taken while v^2 was falling
+    uint32_t first_interval_us;
+    uint32_t min_interval_us;
+    uint64_t total_us;
+} move_trace_t;
+
+// Drives the profile the way stepper_axis_run_locked does: one interval per step, then advance with
+// the steps still to go.
+static move_trace_t run_move(int vmax, int accel, int distance)
+{
+    motion_profile_t profile;
+    move_trace_t trace = {0};
+    uint32_t cruise_us = 1000000U / (uint32_t)vmax;
+
+    motion_profile_init(&profile, vmax, accel);
+    motion_profile_start(&profile, distance);
+    trace.min_interval_us = UINT32_MAX;
+    for (int left = abs(distance); left > 0 && motion_profile_running(&profile);) {
+        uint32_t interval = motion_profile_interval_us(&profile);
+        uint32_t v_sq = profile.v_sq;
+        if (trace.steps == 0) {
+            trace.first_interval_us = interval;
+        }
+        if (interval == cruise_us) {
+            trace.cruise_steps++;
+        }
+        if (interval < trace.min_interval_us) {
+            trace.min_interval_us = interval;
+        }
+        trace.total_us += interval;
+        trace.steps++;
+        motion_profile_advance(&profile, --left);
+        if (profile.v_sq > v_sq) {
+            trace.accel_steps++;
+        } else if (profile.v_sq < v_sq && profile.v_sq != 0) {
+            trace.decel_steps++;
+        }
+    }
+    return trace;
+}
+
+static void test_trapezoid(void)
+{
+    // v^2 / 2a = 2000^2 / 8000 = 500 steps to reach vmax and 500 to stop again, 1000 at cruise.
+    move_trace_t t = run_move(2000, 4000, 2000);
+
+    CHECK(t.steps == 2000);
+    CHECK_NEAR(t.accel_steps, 500, 2);
+    CHECK_NEAR(t.decel_steps, 500, 2);
+    CHECK_NEAR(t.cruise_steps, 1000, 4);
+    CHECK(t.min_interval_us == 500);
+    // Ideal: 0.5 s per ramp (500 steps at an average 1000 steps/s) plus 0.5 s cruise = 1.5 s. Evaluating v
+    // once per step rather than continuously comes in slightly under, at ~1.479 s.
+    CHECK_NEAR(t.total_us / 1e6, 1.479, 0.005);
+}
+
+static void test_triangle(void)
+{
+    // 400 steps at 4000 steps/s^2 peak at sqrt(a * d) = sqrt(4000 * 400) ~ 1265 steps/s, below vmax.
+    move_trace_t t = run_move(2000, 4000, 400);
+
+    CHECK(t.steps == 400);
+    CHECK(t.cruise_steps == 0);
+    CHECK(t.min_interval_us > 500);
+    CHECK_NEAR(1e6 / t.min_interval_us, 1265, 25);
+    CHECK_NEAR(t.accel_steps, 200, 2);
+    CHECK_NEAR(t.decel_steps, 200, 2);
+}
+
+static void test_no_accel_limit(void)
+{
+    move_trace_t t = run_move(2000, 0, 300);
+
+    CHECK(t.steps == 300);
+    CHECK(t.first_interval_us == 500);
+    CHECK(t.cruise_steps == 300);
+    CHECK(t.accel_steps == 0 && t.decel_steps == 0);
+}
+
+static void test_stop_distance(void)
+{
+    motion_profile_t profile;
+
+    motion_profile_init(&profile, 2000, 4000);
+    CHECK(motion_profile_stop_distance(&profile) == 0);
+    motion_profile_start(&profile, 1);
+    for (int i = 0; i < 1000; ++i) {
+        motion_profile_advance(&profile, 100000);
+    }
+    // At vmax: v^2 / 2a = 500 steps.
+    CHECK(motion_profile_stop_distance(&profile) == 500);
+
+    // Braking after that many steps brings the profile to rest.
+    int steps = 0;
+    for (int left = motion_profile_stop_distance(&profile); motion_profile_running(&profile); ++steps) {
+        motion_profile_advance(&profile, --left);
+    }
+    CHECK_NEAR(steps, 500, 2);
+
+    motion_profile_halt(&profile);
+    CHECK(!motion_profile_running(&profile));
+    CHECK(motion_profile_stop_distance(&profile) == 0);
+
+    motion_profile_init(&profile, 2000, 0);
+    motion_profile_start(&profile, -1);
+    CHECK(profile.dir == -1);
+    CHECK(motion_profile_stop_distance(&profile) == 0);
+}
+
+int main(void)
+{
+    test_trapezoid();
+    test_triangle();
+    test_no_accel_limit();
+    test_stop_distance();
+    return HOST_TEST_RESULT("motion");
+}
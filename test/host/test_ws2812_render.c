@@ -0,0 +1,248 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "core/hash_util.h"
+#include "core/ws2812_render.h"
+#include "fake/fake_led_strip.h"
+#include "host_check.h"
+
+#define PIXELS 60
+
+// FNV-1a of each frame as it reached the strip. The table was produced by the renderer as it was in
+// modules.c before it moved to ws2812_render.c, driven through the same cases and the same fake strip,
+// so it pins the refactor to the old output. `test_ws2812_render --print` regenerates it after an
+// intended change to the rendered output; review the diff like any other behavior change.
+typedef struct {
+    const char *name;
+    uint32_t fnv;
+} golden_t;
+
+static const golden_t k_golden[] = {
+#include "ws2812_golden.inc"
+};
+
+static bool s_print;
+static size_t s_checked;
+static led_strip_handle_t s_strip;
+
+static void expect_hash(const char *name, const uint8_t *frame, size_t len)
+{
+    uint32_t fnv = hash_fnv1a(HASH_FNV1A_SEED, frame, len);
+
+    if (s_print) {
+        printf("    {\"%s\", 0x%08XU},\n", name, (unsigned)fnv);
+        return;
+    }
+    for (size_t i = 0; i < sizeof(k_golden) / sizeof(k_golden[0]); ++i) {
+        if (strcmp(k_golden[i].name, name) == 0) {
+            s_checked++;
+            if (k_golden[i].fnv != fnv) {
+                fprintf(stderr, "%s: frame fnv 0x%08X, golden 0x%08X\n", name, (unsigned)fnv,
+                        (unsigned)k_golden[i].fnv);
+                s_host_failures++;
+            }
+            return;
+        }
+    }
+    fprintf(stderr, "%s: no golden hash\n", name);
+    s_host_failures++;
+}
+
+// Pushes the frame through ws2812_transmit and checks what the strip received, so the led_strip
+// argument order is covered along with the rendering.
+static void expect_frame(const char *name, const uint8_t *frame, size_t len)
+{
+    uint32_t refreshes = s_strip->refreshes;
+
+    CHECK(ws2812_transmit(s_strip, frame, PIXELS) == ESP_OK);
+    CHECK(s_strip->refreshes == refreshes + 1);
+    CHECK(memcmp(s_strip->pushed, frame, len) == 0);
+    expect_hash(name, s_strip->pushed, len);
+}
+
+static void test_solid(void)
+{
+    static const char *const orders[] = {"RGB", "RBG", "GRB", "GBR", "BRG", "BGR"};
+    static const uint8_t colors[][3] = {{255, 255, 255}, {255, 128, 0}, {12, 200, 77}};
+    static const int levels[] = {255, 128, 1, 0};
+    uint8_t frame[PIXELS * WS2812_BYTES_PER_PIXEL];
+    ws2812_palette_t palette;
+    char name[64];
+
+    for (size_t o = 0; o < sizeof(orders) / sizeof(orders[0]); ++o) {
+        for (int gamma = 0; gamma < 2; ++gamma) {
+            ws2812_palette_init(&palette, orders[o], gamma != 0);
+            for (size_t c = 0; c < sizeof(colors) / sizeof(colors[0]); ++c) {
+                for (size_t l = 0; l < sizeof(levels) / sizeof(levels[0]); ++l) {
+                    memset(frame, 0xA5, sizeof(frame));
+                    ws2812_render_solid(&palette, frame, PIXELS, levels[l], colors[c]);
+                    snprintf(name, sizeof(name), "solid/%s/%s/c%zu/l%d", orders[o], gamma ? "gamma" : "linear", c,
+                             levels[l]);
+                    expect_frame(name, frame, sizeof(frame));
+                }
+            }
+        }
+    }
+
+    // Wire order is the only difference between color orders: GRB puts green first.
+    ws2812_palette_init(&palette, "GRB", false);
+    ws2812_render_solid(&palette, frame, PIXELS, 255, colors[1]);
+    CHECK(frame[0] == 128 && frame[1] == 255 && frame[2] == 0);
+    CHECK(memcmp(frame, frame + (PIXELS - 1) * WS2812_BYTES_PER_PIXEL, WS2812_BYTES_PER_PIXEL) == 0);
+    ws2812_palette_init(&palette, "bogus", false);
+    CHECK(palette.wire_perm[0] == 1 && palette.wire_perm[1] == 0 && palette.wire_perm[2] == 2);
+}
+
+static void test_mono_wipe(void)
+{
+    static const int lit[] = {0, 1, 2, 3, 7, 90, 179, 180, 500, -1};
+    uint8_t frame[PIXELS * WS2812_BYTES_PER_PIXEL];
+    ws2812_palette_t palette;
+    char name[64];
+
+    for (int gamma = 0; gamma < 2; ++gamma) {
+        ws2812_palette_init(&palette, "GRB", gamma != 0);
+        for (size_t i = 0; i < sizeof(lit) / sizeof(lit[0]); ++i) {
+            ws2812_render_mono(&palette, frame, PIXELS, 200, lit[i]);
+            snprintf(name, sizeof(name), "mono/%s/lit%d", gamma ? "gamma" : "linear", lit[i]);
+            expect_frame(name, frame, sizeof(frame));
+        }
+    }
+
+    // A wipe is a lit prefix: byte 6 is the last lit one with 7 segments.
+    ws2812_palette_init(&palette, "GRB", false);
+    ws2812_render_mono(&palette, frame, PIXELS, 200, 7);
+    CHECK(frame[6] == 200 && frame[7] == 0);
+}
+
+static void test_effects(void)
+{
+    static const uint32_t frames[] = {0, 1, 17, 100, 1000, 65535};
+    static const uint8_t base[3] = {255, 128, 32};
+    uint8_t frame[PIXELS * WS2812_BYTES_PER_PIXEL];
+    ws2812_palette_t palette;
+    ws2812_effect_cfg_t fx = {
+        .speed = 64,
+        .gradient_rgb = {0, 0, 255},
+        .segments = {{0, 10, {255, 0, 0}}, {25, 10, {0, 255, 0}}, {55, 20, {0, 0, 255}}},
+        .segment_count = 3,
+    };
+    char name[64];
+
+    ws2812_palette_init(&palette, "GRB", true);
+    fx.effect = WS2812_EFFECT_NONE;
+    memset(frame, 0xA5, sizeof(frame));
+    CHECK(!ws2812_render_effect(&palette, frame, PIXELS, &fx, 200, base, 0));
+    CHECK(frame[0] == 0xA5);
+
+    for (int e = WS2812_EFFECT_RAINBOW; e < WS2812_EFFECT_COUNT; ++e) {
+        fx.effect = (ws2812_effect_t)e;
+        for (size_t f = 0; f < sizeof(frames) / sizeof(frames[0]); ++f) {
+            memset(frame, 0xA5, sizeof(frame));
+            CHECK(ws2812_render_effect(&palette, frame, PIXELS, &fx, 200, base, frames[f]));
+            snprintf(name, sizeof(name), "effect/%s/f%u", ws2812_effect_name(fx.effect), (unsigned)frames[f]);
+            expect_frame(name, frame, sizeof(frame));
+        }
+    }
+}
+
+static void test_easing(void)
+{
+    static const char *const names[] = {"linear", "ease_in_out", "cie"};
+    // Every 64th Q16 phase, so both table samples and the interpolation between them are covered.
+    uint32_t steps[1025];
+    char name[64];
+
+    for (int easing = WS2812_EASING_LINEAR; easing <= WS2812_EASING_CIE; ++easing) {
+        uint32_t prev = 0;
+        bool monotonic = true;
+        for (uint32_t i = 0; i < 1025; ++i) {
+            steps[i] = ws2812_ease((ws2812_easing_t)easing, i * 64U);
+            monotonic = monotonic && steps[i] >= prev;
+            prev = steps[i];
+        }
+        CHECK(monotonic);
+        CHECK(steps[0] == 0);
+        CHECK(ws2812_ease((ws2812_easing_t)easing, 0xFFFFU) >= 0xFFF0U);
+        // Phases past the end clamp rather than reading past the table.
+        CHECK(ws2812_ease((ws2812_easing_t)easing, 0x20000U) == ws2812_ease((ws2812_easing_t)easing, 0xFFFFU));
+        snprintf(name, sizeof(name), "ease/%s", names[easing]);
+        expect_hash(name, (const uint8_t *)steps, sizeof(steps));
+    }
+    CHECK(ws2812_ease(WS2812_EASING_EASE_IN_OUT, 0x8000U) == 32768U);
+
+    CHECK(ws2812_lerp(0, 255, 0) == 0);
+    CHECK(ws2812_lerp(0, 255, 65536U) == 255);
+    CHECK(ws2812_lerp(255, 0, 32768U) == 128);
+    CHECK(ws2812_lerp(40, 40, 12345U) == 40);
+}
+
+// Frames at fixed points of a 300 ms transition, rendered the way modules.c renders each step.
+static void test_transitions(void)
+{
+    static const struct {
+        const char *name;
+        bool mono;
+        bool use_wipe;
+        ws2812_easing_t easing;
+        int start_level;
+        uint8_t start_rgb[3];
+        int target_level;
+        uint8_t target_rgb[3];
+    } cases[] = {
+        {"fade_on", false, false, WS2812_EASING_LINEAR, 0, {255, 128, 0}, 255, {255, 128, 0}},
+        {"color", false, false, WS2812_EASING_EASE_IN_OUT, 200, {255, 0, 0}, 200, {0, 0, 255}},
+        {"fade_off", false, false, WS2812_EASING_CIE, 255, {12, 200, 77}, 0, {12, 200, 77}},
+        {"dim", false, false, WS2812_EASING_CIE, 255, {255, 255, 255}, 40, {255, 160, 60}},
+        {"wipe_on", true, true, WS2812_EASING_LINEAR, 0, {255, 255, 255}, 200, {255, 255, 255}},
+        {"wipe_off", true, true, WS2812_EASING_EASE_IN_OUT, 200, {255, 255, 255}, 0, {255, 255, 255}},
+    };
+    static const int64_t times_us[] = {0, 1, 1000, 33333, 75000, 150000, 225000, 299999, 300000, 450000};
+    uint8_t frame[PIXELS * WS2812_BYTES_PER_PIXEL];
+    ws2812_palette_t palette;
+    char name[64];
+
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); ++c) {
+        ws2812_transition_t transition;
+        ws2812_transition_frame_t step = {0};
+
+        ws2812_palette_init(&palette, "GRB", true);
+        ws2812_transition_start(&transition, 300, cases[c].easing, cases[c].use_wipe, cases[c].start_level,
+                                cases[c].start_rgb, cases[c].target_level, cases[c].target_rgb);
+        for (size_t t = 0; t < sizeof(times_us) / sizeof(times_us[0]); ++t) {
+            ws2812_transition_step(&transition, times_us[t], PIXELS, &step);
+            CHECK(transition.active == (times_us[t] < 300000));
+            if (cases[c].mono) {
+                ws2812_render_mono(&palette, frame, PIXELS, step.level, step.segments);
+            } else {
+                CHECK(step.segments == -1);
+                ws2812_render_solid(&palette, frame, PIXELS, step.level, step.rgb);
+            }
+            snprintf(name, sizeof(name), "transition/%s/t%lld", cases[c].name, (long long)times_us[t]);
+            expect_frame(name, frame, sizeof(frame));
+        }
+        CHECK(step.level == cases[c].target_level && step.segments == -1);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    s_print = argc > 1 && strcmp(argv[1], "--print") == 0;
+    s_strip = fake_led_strip_new(PIXELS);
+    if (!s_strip) {
+        return 1;
+    }
+
+    test_solid();
+    test_mono_wipe();
+    test_effects();
+    test_easing();
+    test_transitions();
+    led_strip_del(s_strip);
+    if (s_print) {
+        return 0;
+    }
+    CHECK(s_checked == sizeof(k_golden) / sizeof(k_golden[0]));
+    return HOST_TEST_RESULT("ws2812_render");
+}
@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+"""Compress the web UI string literal from net/web_ui.h into a C header.
+
+Usage: web_ui_gzip.py <web_ui.h> <output.h>
+
+The output defines WEB_INDEX_HTML_GZ (gzip bytes) and WEB_INDEX_HTML_GZ_ETAG
+(a quoted content hash for the ETag header). The gzip header carries no
+timestamp, so identical input always produces identical output.
+"""
+
+import gzip
+import hashlib
+import re
+import sys
+
+LITERAL_RE = re.compile(r'"((?:[^"\\]|\\.)*)"')
+SIMPLE_ESCAPES = {
+    "n": "\n",
+    "t": "\t",
+    "r": "\r",
+    "0": "\0",
+    "\\": "\\",
+    '"': '"',
+    "'": "'",
+}
+
+
+def unescape(body):
+    out = []
+    i = 0
+    while i < len(body):
+        c = body[i]
+        if c != "\\":
+            out.append(c)
+            i += 1
+            continue
+        nxt = body[i + 1]
+        if nxt == "x":
+            m = re.match(r"[0-9a-fA-F]+", body[i + 2:])
+            out.append(chr(int(m.group(0), 16)))
+            i += 2 + len(m.group(0))
+        elif nxt in SIMPLE_ESCAPES:
+            out.append(SIMPLE_ESCAPES[nxt])
+            i += 2
+        else:
+            raise ValueError("unsupported escape \\%s" % nxt)
+    return "".join(out)
+
+
+def extract_html(source):
+    start = source.index("WEB_INDEX_HTML")
+    start = source.index("=", start) + 1
+    end = source.index(";\n", start) if ";\n" in source[start:] else source.rindex(";")
+    parts = LITERAL_RE.findall(source[start:end + 1])
+    if not parts:
+        raise ValueError("no string literal found for WEB_INDEX_HTML")
+    return "".join(unescape(p) for p in parts)
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.stderr.write(__doc__)
+        return 2
+
+    with open(sys.argv[1], encoding="utf-8") as f:
+        html = extract_html(f.read()).encode("utf-8")
+
+    blob = gzip.compress(html, compresslevel=9, mtime=0)
+    etag = hashlib.sha256(html).hexdigest()[:16]
+
+    lines = [
+        "#pragma once",
+        "",
+        "// Generated from net/web_ui.h by tools/web_ui_gzip.py. Do not edit.",
+        "",
+        "#include <stdint.h>",
+        "",
+        '#define WEB_INDEX_HTML_GZ_ETAG "\\"%s\\""' % etag,
+        "",
+        "static const uint8_t WEB_INDEX_HTML_GZ[%d] = {" % len(blob),
+    ]
+    for i in range(0, len(blob), 16):
+        lines.append("    " + ", ".join("0x%02x" % b for b in blob[i:i + 16]) + ",")
+    lines.append("};")
+    lines.append("")
+
+    with open(sys.argv[2], "w", encoding="utf-8") as f:
+        f.write("\n".join(lines))
+
+    sys.stdout.write("web UI: %d bytes -> %d bytes gzip\n" % (len(html), len(blob)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())